@@ -0,0 +1,87 @@
+/* 리눅스 타깃용 GPIO 드라이버 대체 구현 */
+
+#include "driver/gpio.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+static gpio_int_type_t pin_intr_type[GPIO_NUM_MAX];
+static gpio_isr_t pin_handler[GPIO_NUM_MAX];
+static void *pin_handler_arg[GPIO_NUM_MAX];
+static bool pin_intr_disabled[GPIO_NUM_MAX];
+static bool isr_service_installed = false;
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+        if (config->pin_bit_mask & (1ULL << pin)) {
+            pin_intr_type[pin] = config->intr_type;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    if (isr_service_installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    isr_service_installed = true;
+    return ESP_OK;
+}
+
+void gpio_uninstall_isr_service(void)
+{
+    isr_service_installed = false;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (!isr_service_installed || gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pin_handler_arg[gpio_num] = args;
+    pin_handler[gpio_num] = isr_handler;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin_handler[gpio_num] = NULL;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin_intr_disabled[gpio_num] = false;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pin_intr_disabled[gpio_num] = true;
+    return ESP_OK;
+}
+
+void gpio_sim_raise_edge(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return;
+    }
+
+    gpio_isr_t handler = pin_handler[gpio_num];
+    gpio_int_type_t type = pin_intr_type[gpio_num];
+    if (handler != NULL && !pin_intr_disabled[gpio_num] &&
+        (type == GPIO_INTR_POSEDGE || type == GPIO_INTR_ANYEDGE)) {
+        handler(pin_handler_arg[gpio_num]);
+    }
+}
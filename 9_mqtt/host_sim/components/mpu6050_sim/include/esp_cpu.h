@@ -0,0 +1,20 @@
+/* 리눅스 타깃용 esp_cpu.h 대체 헤더
+ * 사이클 카운터 대신 단조 시계의 나노초 값을 반환합니다 (벤치마크 결과 단위가 ns가 됨).
+ */
+
+#ifndef ESP_CPU_SIM_H
+#define ESP_CPU_SIM_H
+
+#include <stdint.h>
+#include <time.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+#endif // ESP_CPU_SIM_H
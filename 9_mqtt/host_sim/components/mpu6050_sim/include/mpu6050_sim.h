@@ -0,0 +1,79 @@
+/* MPU6050 시뮬레이터 헤더
+ * 리눅스 타깃에서 I2C 버스에 추가한 0x68/0x69 디바이스의 레지스터 맵을 흉내냅니다.
+ * (WHO_AM_I, PWR_MGMT_1, 설정 레지스터, 데이터 레지스터, FIFO, INT, 움직임 감지)
+ */
+
+#ifndef MPU6050_SIM_H
+#define MPU6050_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// 모션 샘플 (물리 단위)
+typedef struct {
+    float accel_g[3];
+    float gyro_dps[3];
+    float temp_c;
+} mpu6050_sim_motion_t;
+
+// 디바이스별 통계 (처리량 / 지연 회귀 측정용)
+typedef struct {
+    uint32_t transactions;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint32_t samples_generated;     // FIFO에 넣은 샘플 수
+    uint32_t samples_read;          // 데이터 레지스터 / FIFO에서 끝까지 읽어 간 샘플 수
+    uint32_t fifo_overflows;
+    uint32_t data_ready_interrupts;
+    uint32_t motion_interrupts;
+} mpu6050_sim_stats_t;
+
+/**
+ * @brief 녹화된 모션 CSV 재생 설정 (모든 디바이스 공통, 끝나면 처음부터 반복)
+ *
+ * 한 줄 형식: time_s,ax_g,ay_g,az_g,gx_dps,gy_dps,gz_dps[,temp_c] ('#'로 시작하는 줄은 무시)
+ * 설정하지 않으면 기본 스크립트(roll ±30° 0.5Hz 흔들림 + yaw 20°/s 회전)를 사용합니다.
+ *
+ * @param path CSV 파일 경로
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NOT_FOUND 파일 없음, ESP_ERR_INVALID_SIZE 샘플 없음
+ */
+esp_err_t mpu6050_sim_load_motion_csv(const char *path);
+
+/**
+ * @brief 디바이스 INT 출력을 연결할 GPIO 설정 (DATA_RDY / 움직임 감지 인터럽트 시뮬레이션)
+ *
+ * @param address I2C 주소 (0x68 또는 0x69)
+ * @param gpio_num GPIO 번호 (-1: 연결 안 함)
+ */
+void mpu6050_sim_set_int_pin(uint8_t address, int gpio_num);
+
+/**
+ * @brief 디바이스 응답 끊김 시뮬레이션 (배선 불량 등)
+ *
+ * @param address I2C 주소 (0x68 또는 0x69)
+ * @param nack true면 이후 모든 전송에 NACK
+ */
+void mpu6050_sim_set_nack(uint8_t address, bool nack);
+
+/**
+ * @brief 디바이스 전송 멈춤 시뮬레이션 (SCL을 잡고 놓지 않는 경우 등)
+ *
+ * 큐 모드에서는 멈춘 디바이스(와 그 뒤)의 전송이 버스 큐에 남고, 멈춤이 풀리면 늦게 완료됩니다.
+ * i2c_master_bus_wait_all_done()은 멈춘 동안 ESP_ERR_TIMEOUT, i2c_master_bus_reset()은 남은 전송을 버립니다.
+ *
+ * @param address I2C 주소 (0x68 또는 0x69)
+ * @param stall true면 멈춤
+ */
+void mpu6050_sim_set_stall(uint8_t address, bool stall);
+
+/**
+ * @brief 디바이스 통계 조회
+ *
+ * @param address I2C 주소
+ * @param stats 통계를 저장할 포인터
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NOT_FOUND 버스에 추가되지 않은 주소
+ */
+esp_err_t mpu6050_sim_get_stats(uint8_t address, mpu6050_sim_stats_t *stats);
+
+#endif // MPU6050_SIM_H
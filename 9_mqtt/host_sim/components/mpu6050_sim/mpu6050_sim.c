@@ -0,0 +1,813 @@
+/* MPU6050 시뮬레이터 + 리눅스 타깃용 I2C 마스터 드라이버 대체 구현 */
+
+#include "mpu6050_sim.h"
+#include "driver/i2c_master.h"
+#include "driver/gpio.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *TAG = "MPU6050_SIM";
+
+// 레지스터 주소
+#define SIM_REG_SMPLRT_DIV 0x19
+#define SIM_REG_CONFIG 0x1A
+#define SIM_REG_GYRO_CONFIG 0x1B
+#define SIM_REG_ACCEL_CONFIG 0x1C
+#define SIM_REG_MOT_THR 0x1F
+#define SIM_REG_MOT_DUR 0x20
+#define SIM_REG_FIFO_EN 0x23
+#define SIM_REG_INT_ENABLE 0x38
+#define SIM_REG_INT_STATUS 0x3A
+#define SIM_REG_ACCEL_XOUT_H 0x3B
+#define SIM_REG_GYRO_ZOUT_L 0x48
+#define SIM_REG_USER_CTRL 0x6A
+#define SIM_REG_PWR_MGMT_1 0x6B
+#define SIM_REG_FIFO_COUNTH 0x72
+#define SIM_REG_FIFO_COUNTL 0x73
+#define SIM_REG_FIFO_R_W 0x74
+#define SIM_REG_WHO_AM_I 0x75
+#define SIM_REG_COUNT 0x80
+
+// 비트
+#define SIM_PWR_MGMT_1_RESET 0x80
+#define SIM_PWR_MGMT_1_SLEEP 0x40
+#define SIM_USER_CTRL_FIFO_EN 0x40
+#define SIM_USER_CTRL_FIFO_RESET 0x04
+#define SIM_FIFO_EN_TEMP 0x80
+#define SIM_FIFO_EN_XG 0x40
+#define SIM_FIFO_EN_YG 0x20
+#define SIM_FIFO_EN_ZG 0x10
+#define SIM_FIFO_EN_ACCEL 0x08
+#define SIM_INT_DATA_RDY 0x01
+#define SIM_INT_FIFO_OFLOW 0x10
+#define SIM_INT_MOT 0x40
+
+#define SIM_FIFO_SIZE 1024
+#define SIM_FRAME_SIZE 14
+#define SIM_MAX_CATCH_UP_SAMPLES 200    // 한 번에 FIFO에 채울 최대 샘플 수 (오래 안 읽은 경우)
+#define SIM_ACCEL_NOISE_G 0.002f
+#define SIM_GYRO_NOISE_DPS 0.05f
+#define SIM_DEG_TO_RAD 0.017453292f
+#define SIM_MOT_THR_G_PER_LSB 0.002f
+#define SIM_MOT_HPF_HZ 5.0f            // 움직임 감지 고역 통과 필터 (ACCEL_HPF 설정과 무관하게 5Hz로 근사)
+
+// 시뮬레이션 디바이스 (0x68, 0x69)
+typedef struct {
+    bool present;
+    uint8_t address;
+    uint8_t regs[SIM_REG_COUNT];
+    uint8_t reg_pointer;
+    uint8_t fifo[SIM_FIFO_SIZE];
+    size_t fifo_head;
+    size_t fifo_count;
+    int64_t fifo_last_index;    // FIFO에 마지막으로 넣은 샘플 번호
+    int64_t drdy_last_index;    // 마지막으로 DATA_RDY를 낸 샘플 번호
+    size_t fifo_read_bytes;     // FIFO에서 읽은 바이트 중 아직 한 프레임이 안 된 바이트 수
+    float mot_ref_g[3];         // 움직임 감지 고역 통과 필터의 저역 성분
+    int64_t mot_over_us;        // 임계값을 연속으로 넘은 시간
+    esp_timer_handle_t drdy_timer;
+    int int_pin;
+    bool nack;                  // 응답 끊김 시뮬레이션
+    bool stall;                 // 버스 멈춤 시뮬레이션 (전송이 큐에 남음)
+    uint32_t noise_state;
+    mpu6050_sim_stats_t stats;
+} sim_device_t;
+
+// 멈춘 디바이스에 큐로 넣은 전송 (멈춤이 풀리거나 버스를 리셋할 때까지 남음)
+typedef struct {
+    struct i2c_master_dev_t *dev;
+    const uint8_t *write_buffer;
+    size_t write_size;
+    uint8_t *read_buffer;
+    size_t read_size;
+} sim_transfer_t;
+
+#define SIM_MAX_QUEUED_TRANSFERS 8
+
+struct i2c_master_bus_t {
+    i2c_master_bus_config_t config;
+    sim_transfer_t queued[SIM_MAX_QUEUED_TRANSFERS];
+    size_t queued_count;
+};
+
+struct i2c_master_dev_t {
+    struct i2c_master_bus_t *bus;
+    uint16_t address;
+    sim_device_t *sim;          // NULL이면 응답 없는 주소 (NACK)
+    i2c_master_event_callbacks_t cbs;
+    void *user_data;
+};
+
+static sim_device_t sim_devices[2] = {
+    {.int_pin = -1},
+    {.int_pin = -1},
+};
+
+// 큐로 전송하는 버스 (멈춤이 풀릴 때 남은 전송을 마무리)
+static struct i2c_master_bus_t *sim_bus = NULL;
+
+// 녹화 모션 (없으면 기본 스크립트)
+static float *motion_time_s = NULL;
+static mpu6050_sim_motion_t *motion_samples = NULL;
+static size_t motion_count = 0;
+
+/**
+ * @brief 기본 모션 스크립트: roll ±30° 0.5Hz 흔들림 + yaw 20°/s 회전 (ZYX, pitch = 0)
+ */
+static void sim_scripted_motion(float t, mpu6050_sim_motion_t *m)
+{
+    const float w = 2.0f * 3.14159265f * 0.5f;
+    const float roll = 30.0f * SIM_DEG_TO_RAD * sinf(w * t);
+    const float roll_rate_dps = 30.0f * w * cosf(w * t);
+    const float yaw_rate_dps = 20.0f;
+
+    // 정지 상태 가속도계는 중력 반대 방향(+1g)을 측정
+    m->accel_g[0] = 0.0f;
+    m->accel_g[1] = sinf(roll);
+    m->accel_g[2] = cosf(roll);
+    // 오일러각 변화율 → 센서 좌표계 각속도
+    m->gyro_dps[0] = roll_rate_dps;
+    m->gyro_dps[1] = yaw_rate_dps * sinf(roll);
+    m->gyro_dps[2] = yaw_rate_dps * cosf(roll);
+    m->temp_c = 25.0f;
+}
+
+/**
+ * @brief 시각 t(초)의 모션 샘플
+ */
+static void sim_motion_at(float t, mpu6050_sim_motion_t *m)
+{
+    if (motion_count == 0) {
+        sim_scripted_motion(t, m);
+        return;
+    }
+
+    // 녹화 구간을 반복 재생, 해당 시각 직전 샘플 사용
+    const float duration = motion_time_s[motion_count - 1];
+    if (duration > 0.0f) {
+        t = fmodf(t, duration);
+    }
+    size_t lo = 0, hi = motion_count;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (motion_time_s[mid] <= t) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    *m = motion_samples[lo];
+}
+
+/**
+ * @brief 대략 정규분포 잡음 (디바이스별 LCG, 재현 가능)
+ */
+static float sim_noise(sim_device_t *dev, float amplitude)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        dev->noise_state = dev->noise_state * 1664525u + 1013904223u;
+        sum += (float)(dev->noise_state >> 8) / (float)(1u << 24) - 0.5f;
+    }
+    return sum * amplitude;
+}
+
+static int16_t sim_saturate(float value)
+{
+    if (value > 32767.0f) {
+        return 32767;
+    }
+    if (value < -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)lroundf(value);
+}
+
+/**
+ * @brief 현재 설정의 샘플 주기 (마이크로초)
+ */
+static int64_t sim_sample_period_us(const sim_device_t *dev)
+{
+    const uint8_t dlpf = dev->regs[SIM_REG_CONFIG] & 0x07;
+    const int64_t gyro_rate_hz = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+    return (1000000 * (1 + dev->regs[SIM_REG_SMPLRT_DIV])) / gyro_rate_hz;
+}
+
+static int64_t sim_sample_index(const sim_device_t *dev, int64_t now_us)
+{
+    return now_us / sim_sample_period_us(dev);
+}
+
+static bool sim_is_sleeping(const sim_device_t *dev)
+{
+    return (dev->regs[SIM_REG_PWR_MGMT_1] & SIM_PWR_MGMT_1_SLEEP) != 0;
+}
+
+/**
+ * @brief 샘플 번호의 14바이트 데이터 프레임 (레지스터 0x3B~0x48 순서, 빅 엔디안)
+ */
+static void sim_build_frame(sim_device_t *dev, int64_t index, uint8_t *frame)
+{
+    mpu6050_sim_motion_t m;
+    sim_motion_at((float)(index * sim_sample_period_us(dev)) * 1e-6f, &m);
+
+    const float accel_lsb = (float)(16384 >> ((dev->regs[SIM_REG_ACCEL_CONFIG] >> 3) & 0x03));
+    const float gyro_lsb = 131.0f / (float)(1 << ((dev->regs[SIM_REG_GYRO_CONFIG] >> 3) & 0x03));
+    int16_t values[7];
+
+    for (int axis = 0; axis < 3; axis++) {
+        values[axis] = sim_saturate((m.accel_g[axis] + sim_noise(dev, SIM_ACCEL_NOISE_G)) * accel_lsb);
+        values[4 + axis] = sim_saturate((m.gyro_dps[axis] + sim_noise(dev, SIM_GYRO_NOISE_DPS)) * gyro_lsb);
+    }
+    values[3] = sim_saturate((m.temp_c - 36.53f) * 340.0f);
+
+    for (int i = 0; i < 7; i++) {
+        frame[2 * i] = (uint8_t)((uint16_t)values[i] >> 8);
+        frame[2 * i + 1] = (uint8_t)values[i];
+    }
+}
+
+static void sim_fifo_reset(sim_device_t *dev)
+{
+    dev->fifo_head = 0;
+    dev->fifo_count = 0;
+    dev->fifo_read_bytes = 0;
+    dev->fifo_last_index = sim_sample_index(dev, esp_timer_get_time());
+}
+
+/**
+ * @brief FIFO_EN 설정에 따른 FIFO 프레임 크기 (바이트)
+ */
+static size_t sim_fifo_frame_size(const sim_device_t *dev)
+{
+    const uint8_t fifo_en = dev->regs[SIM_REG_FIFO_EN];
+
+    return ((fifo_en & SIM_FIFO_EN_ACCEL) ? 6 : 0) + ((fifo_en & SIM_FIFO_EN_TEMP) ? 2 : 0) +
+           ((fifo_en & SIM_FIFO_EN_XG) ? 2 : 0) + ((fifo_en & SIM_FIFO_EN_YG) ? 2 : 0) +
+           ((fifo_en & SIM_FIFO_EN_ZG) ? 2 : 0);
+}
+
+/**
+ * @brief FIFO에 바이트 추가 (가득 차면 가장 오래된 바이트를 덮어씀, 실제 칩과 동일)
+ */
+static bool sim_fifo_push(sim_device_t *dev, const uint8_t *data, size_t len)
+{
+    bool overflow = false;
+
+    for (size_t i = 0; i < len; i++) {
+        if (dev->fifo_count == SIM_FIFO_SIZE) {
+            dev->fifo_head = (dev->fifo_head + 1) % SIM_FIFO_SIZE;
+            dev->fifo_count--;
+            overflow = true;
+        }
+        dev->fifo[(dev->fifo_head + dev->fifo_count) % SIM_FIFO_SIZE] = data[i];
+        dev->fifo_count++;
+    }
+
+    return overflow;
+}
+
+/**
+ * @brief 마지막 갱신 이후 생성된 샘플을 FIFO_EN 설정대로 FIFO에 채움
+ */
+static void sim_fifo_update(sim_device_t *dev, int64_t now_us)
+{
+    const uint8_t fifo_en = dev->regs[SIM_REG_FIFO_EN];
+    const int64_t now_index = sim_sample_index(dev, now_us);
+
+    if (!(dev->regs[SIM_REG_USER_CTRL] & SIM_USER_CTRL_FIFO_EN) || fifo_en == 0 || sim_is_sleeping(dev)) {
+        dev->fifo_last_index = now_index;
+        return;
+    }
+
+    if (now_index - dev->fifo_last_index > SIM_MAX_CATCH_UP_SAMPLES) {
+        dev->fifo_last_index = now_index - SIM_MAX_CATCH_UP_SAMPLES;
+    }
+
+    for (int64_t index = dev->fifo_last_index + 1; index <= now_index; index++) {
+        uint8_t frame[SIM_FRAME_SIZE];
+        bool overflow = false;
+        sim_build_frame(dev, index, frame);
+
+        // FIFO 기록 순서는 레지스터 순서 (가속도, 온도, 자이로 X/Y/Z)
+        if (fifo_en & SIM_FIFO_EN_ACCEL) {
+            overflow |= sim_fifo_push(dev, &frame[0], 6);
+        }
+        if (fifo_en & SIM_FIFO_EN_TEMP) {
+            overflow |= sim_fifo_push(dev, &frame[6], 2);
+        }
+        if (fifo_en & SIM_FIFO_EN_XG) {
+            overflow |= sim_fifo_push(dev, &frame[8], 2);
+        }
+        if (fifo_en & SIM_FIFO_EN_YG) {
+            overflow |= sim_fifo_push(dev, &frame[10], 2);
+        }
+        if (fifo_en & SIM_FIFO_EN_ZG) {
+            overflow |= sim_fifo_push(dev, &frame[12], 2);
+        }
+
+        if (overflow) {
+            dev->regs[SIM_REG_INT_STATUS] |= SIM_INT_FIFO_OFLOW;
+            dev->stats.fifo_overflows++;
+        }
+        dev->stats.samples_generated++;
+    }
+    dev->fifo_last_index = now_index;
+}
+
+/**
+ * @brief 움직임 감지: 고역 통과 필터 출력의 어느 축이든 MOT_THR를 MOT_DUR ms 동안 넘으면 true
+ */
+static bool sim_motion_detect(sim_device_t *dev, int64_t index)
+{
+    mpu6050_sim_motion_t m;
+    const int64_t period_us = sim_sample_period_us(dev);
+    const float threshold_g = dev->regs[SIM_REG_MOT_THR] * SIM_MOT_THR_G_PER_LSB;
+    const float alpha = 1.0f - expf(-2.0f * 3.14159265f * SIM_MOT_HPF_HZ * period_us * 1e-6f);
+    bool over = false;
+
+    sim_motion_at((float)(index * period_us) * 1e-6f, &m);
+    for (int axis = 0; axis < 3; axis++) {
+        over |= fabsf(m.accel_g[axis] - dev->mot_ref_g[axis]) > threshold_g;
+        dev->mot_ref_g[axis] += alpha * (m.accel_g[axis] - dev->mot_ref_g[axis]);
+    }
+
+    dev->mot_over_us = over ? dev->mot_over_us + period_us : 0;
+    if (dev->mot_over_us < (int64_t)dev->regs[SIM_REG_MOT_DUR] * 1000) {
+        return false;
+    }
+    dev->mot_over_us = 0;
+    return true;
+}
+
+/**
+ * @brief 인터럽트 타이머: 새 샘플 번호가 되면 DATA_RDY / 움직임 감지 조건에 따라 INT 핀에 상승엣지 발생
+ */
+static void sim_drdy_timer_cb(void *arg)
+{
+    sim_device_t *dev = (sim_device_t *)arg;
+    const int64_t index = sim_sample_index(dev, esp_timer_get_time());
+    const uint8_t int_enable = dev->regs[SIM_REG_INT_ENABLE];
+    uint8_t status = 0;
+
+    if (index == dev->drdy_last_index) {
+        return;
+    }
+    dev->drdy_last_index = index;
+
+    if (sim_is_sleeping(dev)) {
+        return;
+    }
+    if (int_enable & SIM_INT_DATA_RDY) {
+        status |= SIM_INT_DATA_RDY;
+        dev->stats.data_ready_interrupts++;
+    }
+    if ((int_enable & SIM_INT_MOT) && sim_motion_detect(dev, index)) {
+        status |= SIM_INT_MOT;
+        dev->stats.motion_interrupts++;
+    }
+    if (status == 0) {
+        return;
+    }
+    dev->regs[SIM_REG_INT_STATUS] |= status;
+    if (dev->int_pin >= 0) {
+        gpio_sim_raise_edge(dev->int_pin);
+    }
+}
+
+/**
+ * @brief INT_ENABLE / 샘플 주기에 맞춰 인터럽트 타이머 시작/정지
+ */
+static void sim_drdy_timer_update(sim_device_t *dev)
+{
+    if (dev->drdy_timer == NULL) {
+        esp_timer_create_args_t args = {
+            .callback = sim_drdy_timer_cb,
+            .arg = dev,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "mpu6050_sim_drdy",
+        };
+        if (esp_timer_create(&args, &dev->drdy_timer) != ESP_OK) {
+            ESP_LOGE(TAG, "DATA_RDY timer create failed");
+            return;
+        }
+    }
+
+    esp_timer_stop(dev->drdy_timer);
+    if (dev->regs[SIM_REG_INT_ENABLE] & (SIM_INT_DATA_RDY | SIM_INT_MOT)) {
+        // 샘플 주기의 절반마다 확인해서 샘플 경계를 놓치지 않음
+        int64_t check_period_us = sim_sample_period_us(dev) / 2;
+        esp_timer_start_periodic(dev->drdy_timer, check_period_us > 100 ? check_period_us : 100);
+    }
+}
+
+/**
+ * @brief 전원 인가 / DEVICE_RESET 상태
+ */
+static void sim_device_reset(sim_device_t *dev)
+{
+    memset(dev->regs, 0, sizeof(dev->regs));
+    dev->regs[SIM_REG_PWR_MGMT_1] = SIM_PWR_MGMT_1_SLEEP;
+    dev->regs[SIM_REG_WHO_AM_I] = 0x68;     // AD0와 무관하게 0x68
+    dev->reg_pointer = 0;
+    sim_fifo_reset(dev);
+    if (dev->drdy_timer != NULL) {
+        esp_timer_stop(dev->drdy_timer);
+    }
+}
+
+/**
+ * @brief 레지스터 쓰기 (자동 증가)
+ */
+static void sim_write(sim_device_t *dev, const uint8_t *data, size_t len)
+{
+    const int64_t now_us = esp_timer_get_time();
+    uint8_t reg = dev->reg_pointer;
+
+    sim_fifo_update(dev, now_us);
+
+    for (size_t i = 0; i < len; i++, reg = (reg + 1) % SIM_REG_COUNT) {
+        const uint8_t value = data[i];
+
+        switch (reg) {
+        case SIM_REG_WHO_AM_I:
+        case SIM_REG_INT_STATUS:
+            break;  // 읽기 전용
+        case SIM_REG_FIFO_R_W:
+            sim_fifo_push(dev, &value, 1);
+            break;
+        case SIM_REG_PWR_MGMT_1:
+            if (value & SIM_PWR_MGMT_1_RESET) {
+                sim_device_reset(dev);
+            } else {
+                dev->regs[reg] = value;
+            }
+            break;
+        case SIM_REG_USER_CTRL:
+            if (value & SIM_USER_CTRL_FIFO_RESET) {
+                sim_fifo_reset(dev);
+            }
+            if ((value & SIM_USER_CTRL_FIFO_EN) && !(dev->regs[reg] & SIM_USER_CTRL_FIFO_EN)) {
+                dev->fifo_last_index = sim_sample_index(dev, now_us);
+            }
+            dev->regs[reg] = value & ~SIM_USER_CTRL_FIFO_RESET;    // 리셋 비트는 자동 해제
+            break;
+        case SIM_REG_SMPLRT_DIV:
+        case SIM_REG_CONFIG:
+            dev->regs[reg] = value;
+            // 샘플 번호 기준이 바뀌므로 다시 맞춤
+            dev->fifo_last_index = sim_sample_index(dev, now_us);
+            sim_drdy_timer_update(dev);
+            break;
+        case SIM_REG_INT_ENABLE:
+            dev->regs[reg] = value;
+            sim_drdy_timer_update(dev);
+            break;
+        default:
+            dev->regs[reg] = value;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 레지스터 읽기 (자동 증가, FIFO_R_W는 증가하지 않음)
+ */
+static void sim_read(sim_device_t *dev, uint8_t *data, size_t len)
+{
+    const int64_t now_us = esp_timer_get_time();
+    uint8_t frame[SIM_FRAME_SIZE];
+    bool frame_ready = false;
+    uint16_t fifo_count;
+    uint8_t reg = dev->reg_pointer;
+
+    sim_fifo_update(dev, now_us);
+    fifo_count = (uint16_t)dev->fifo_count;
+
+    for (size_t i = 0; i < len; i++) {
+        if (reg >= SIM_REG_ACCEL_XOUT_H && reg <= SIM_REG_GYRO_ZOUT_L) {
+            // 데이터 레지스터는 샘플 주기마다 갱신되는 값을 한 번에 래치
+            if (!frame_ready) {
+                if (sim_is_sleeping(dev)) {
+                    memset(frame, 0, sizeof(frame));
+                } else {
+                    sim_build_frame(dev, sim_sample_index(dev, now_us), frame);
+                }
+                frame_ready = true;
+            }
+            data[i] = frame[reg - SIM_REG_ACCEL_XOUT_H];
+            if (reg == SIM_REG_GYRO_ZOUT_L && !sim_is_sleeping(dev)) {
+                dev->stats.samples_read++;
+            }
+        } else if (reg == SIM_REG_FIFO_COUNTH) {
+            data[i] = (uint8_t)(fifo_count >> 8);
+        } else if (reg == SIM_REG_FIFO_COUNTL) {
+            data[i] = (uint8_t)fifo_count;
+        } else if (reg == SIM_REG_FIFO_R_W) {
+            if (dev->fifo_count > 0) {
+                data[i] = dev->fifo[dev->fifo_head];
+                dev->fifo_head = (dev->fifo_head + 1) % SIM_FIFO_SIZE;
+                dev->fifo_count--;
+                const size_t frame_size = sim_fifo_frame_size(dev);
+                if (frame_size > 0 && ++dev->fifo_read_bytes >= frame_size) {
+                    dev->fifo_read_bytes = 0;
+                    dev->stats.samples_read++;
+                }
+            } else {
+                data[i] = 0xFF;
+            }
+            continue;
+        } else if (reg == SIM_REG_INT_STATUS) {
+            data[i] = dev->regs[reg];
+            dev->regs[reg] = 0;     // 읽으면 해제
+        } else {
+            data[i] = dev->regs[reg];
+        }
+        reg = (reg + 1) % SIM_REG_COUNT;
+    }
+    dev->reg_pointer = reg;
+}
+
+/**
+ * @brief 전송 완료 처리 (완료 콜백이 있으면 호출)
+ */
+static esp_err_t sim_complete(i2c_master_dev_handle_t i2c_dev, bool acked)
+{
+    if (i2c_dev->bus->config.trans_queue_depth > 0 && i2c_dev->cbs.on_trans_done != NULL) {
+        // 큐 모드: 결과는 콜백으로 전달하고 전송 함수는 바로 성공 반환
+        i2c_master_event_data_t evt = {
+            .event = acked ? I2C_EVENT_DONE : I2C_EVENT_NACK,
+        };
+        i2c_dev->cbs.on_trans_done(i2c_dev, &evt, i2c_dev->user_data);
+        return ESP_OK;
+    }
+    return acked ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+/* ========== driver/i2c_master.h API ========== */
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *bus_config, i2c_master_bus_handle_t *ret_bus_handle)
+{
+    struct i2c_master_bus_t *bus = calloc(1, sizeof(struct i2c_master_bus_t));
+    if (bus == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    bus->config = *bus_config;
+    sim_bus = bus;
+    *ret_bus_handle = bus;
+    ESP_LOGI(TAG, "Simulated I2C bus %d created (queue depth %u)",
+             bus_config->i2c_port, (unsigned)bus_config->trans_queue_depth);
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t bus_handle)
+{
+    if (sim_bus == bus_handle) {
+        sim_bus = NULL;
+    }
+    free(bus_handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus_handle, const i2c_device_config_t *dev_config,
+                                    i2c_master_dev_handle_t *ret_handle)
+{
+    struct i2c_master_dev_t *dev = calloc(1, sizeof(struct i2c_master_dev_t));
+    if (dev == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->bus = bus_handle;
+    dev->address = dev_config->device_address;
+
+    if (dev->address == 0x68 || dev->address == 0x69) {
+        sim_device_t *sim = &sim_devices[dev->address & 0x01];
+        if (!sim->present) {
+            sim->present = true;
+            sim->address = dev->address;
+            sim->noise_state = dev->address;
+            sim_device_reset(sim);
+        }
+        dev->sim = sim;
+    } else {
+        ESP_LOGW(TAG, "No simulated device at 0x%02X, transfers will NACK", dev->address);
+    }
+
+    *ret_handle = dev;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_register_event_callbacks(i2c_master_dev_handle_t i2c_dev,
+                                              const i2c_master_event_callbacks_t *cbs, void *user_data)
+{
+    i2c_dev->cbs = *cbs;
+    i2c_dev->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              int xfer_timeout_ms)
+{
+    return i2c_master_transmit_receive(i2c_dev, write_buffer, write_size, NULL, 0, xfer_timeout_ms);
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer, size_t read_size,
+                             int xfer_timeout_ms)
+{
+    return i2c_master_transmit_receive(i2c_dev, NULL, 0, read_buffer, read_size, xfer_timeout_ms);
+}
+
+/**
+ * @brief 전송 한 건 실행 (레지스터 접근 + 완료 처리)
+ */
+static esp_err_t sim_transfer(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer, size_t write_size,
+                              uint8_t *read_buffer, size_t read_size)
+{
+    sim_device_t *sim = i2c_dev->sim;
+    if (sim == NULL || sim->nack) {
+        return sim_complete(i2c_dev, false);
+    }
+
+    // 첫 바이트는 레지스터 주소, 나머지는 쓰기 데이터
+    if (write_size > 0) {
+        sim->reg_pointer = write_buffer[0] % SIM_REG_COUNT;
+        if (write_size > 1) {
+            sim_write(sim, &write_buffer[1], write_size - 1);
+        }
+    }
+    if (read_size > 0) {
+        sim_read(sim, read_buffer, read_size);
+    }
+
+    sim->stats.transactions++;
+    sim->stats.bytes_written += write_size;
+    sim->stats.bytes_read += read_size;
+
+    return sim_complete(i2c_dev, true);
+}
+
+/**
+ * @brief 큐에 남은 전송을 순서대로 마무리 (멈춘 디바이스 앞에서 멈춤)
+ */
+static void sim_bus_flush(struct i2c_master_bus_t *bus)
+{
+    size_t done = 0;
+
+    while (done < bus->queued_count &&
+           !(bus->queued[done].dev->sim != NULL && bus->queued[done].dev->sim->stall)) {
+        const sim_transfer_t *t = &bus->queued[done];
+        sim_transfer(t->dev, t->write_buffer, t->write_size, t->read_buffer, t->read_size);
+        done++;
+    }
+    memmove(bus->queued, &bus->queued[done], (bus->queued_count - done) * sizeof(sim_transfer_t));
+    bus->queued_count -= done;
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size,
+                                      int xfer_timeout_ms)
+{
+    struct i2c_master_bus_t *bus = i2c_dev->bus;
+    const bool stalled = i2c_dev->sim != NULL && i2c_dev->sim->stall;
+
+    if (bus->config.trans_queue_depth > 0 && i2c_dev->cbs.on_trans_done != NULL &&
+        (stalled || bus->queued_count > 0)) {
+        // 큐 모드: 앞선 전송이 끝나지 않았으면 뒤에 줄을 섬 (버퍼는 완료될 때까지 호출자가 유지)
+        if (bus->queued_count >= bus->config.trans_queue_depth ||
+            bus->queued_count >= SIM_MAX_QUEUED_TRANSFERS) {
+            return ESP_ERR_TIMEOUT;
+        }
+        bus->queued[bus->queued_count++] = (sim_transfer_t) {
+            .dev = i2c_dev,
+            .write_buffer = write_buffer,
+            .write_size = write_size,
+            .read_buffer = read_buffer,
+            .read_size = read_size,
+        };
+        return ESP_OK;
+    }
+    if (stalled) {
+        return ESP_ERR_TIMEOUT;
+    }
+    return sim_transfer(i2c_dev, write_buffer, write_size, read_buffer, read_size);
+}
+
+esp_err_t i2c_master_bus_wait_all_done(i2c_master_bus_handle_t bus_handle, int timeout_ms)
+{
+    sim_bus_flush(bus_handle);
+    return bus_handle->queued_count == 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus_handle)
+{
+    // 큐에 남은 전송은 완료 콜백 없이 버림
+    ESP_LOGW(TAG, "Bus reset, dropped %u queued transfers", (unsigned)bus_handle->queued_count);
+    bus_handle->queued_count = 0;
+    return ESP_OK;
+}
+
+/* ========== 시뮬레이터 API ========== */
+
+esp_err_t mpu6050_sim_load_motion_csv(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    size_t capacity = 0;
+    size_t count = 0;
+    float *times = NULL;
+    mpu6050_sim_motion_t *samples = NULL;
+    char line[256];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        float t;
+        mpu6050_sim_motion_t m = {.temp_c = 25.0f};
+        if (line[0] == '#') {
+            continue;
+        }
+        int fields = sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%f", &t,
+                            &m.accel_g[0], &m.accel_g[1], &m.accel_g[2],
+                            &m.gyro_dps[0], &m.gyro_dps[1], &m.gyro_dps[2], &m.temp_c);
+        if (fields < 7) {
+            continue;   // 헤더 줄 등
+        }
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            float *new_times = realloc(times, capacity * sizeof(float));
+            mpu6050_sim_motion_t *new_samples = realloc(samples, capacity * sizeof(mpu6050_sim_motion_t));
+            if (new_times == NULL || new_samples == NULL) {
+                free(new_times ? new_times : times);
+                free(new_samples ? new_samples : samples);
+                fclose(file);
+                return ESP_ERR_NO_MEM;
+            }
+            times = new_times;
+            samples = new_samples;
+        }
+        times[count] = t;
+        samples[count] = m;
+        count++;
+    }
+    fclose(file);
+
+    if (count == 0) {
+        free(times);
+        free(samples);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    free(motion_time_s);
+    free(motion_samples);
+    motion_time_s = times;
+    motion_samples = samples;
+    motion_count = count;
+    ESP_LOGI(TAG, "Loaded %u motion samples (%.2f s) from %s", (unsigned)count, times[count - 1], path);
+    return ESP_OK;
+}
+
+void mpu6050_sim_set_int_pin(uint8_t address, int gpio_num)
+{
+    if (address == 0x68 || address == 0x69) {
+        sim_devices[address & 0x01].int_pin = gpio_num;
+    }
+}
+
+void mpu6050_sim_set_nack(uint8_t address, bool nack)
+{
+    if (address == 0x68 || address == 0x69) {
+        sim_devices[address & 0x01].nack = nack;
+    }
+}
+
+void mpu6050_sim_set_stall(uint8_t address, bool stall)
+{
+    if (address == 0x68 || address == 0x69) {
+        sim_devices[address & 0x01].stall = stall;
+        // 멈춤이 풀리면 남은 전송이 늦게 완료됨 (완료 콜백 포함)
+        if (!stall && sim_bus != NULL) {
+            sim_bus_flush(sim_bus);
+        }
+    }
+}
+
+esp_err_t mpu6050_sim_get_stats(uint8_t address, mpu6050_sim_stats_t *stats)
+{
+    if ((address != 0x68 && address != 0x69) || !sim_devices[address & 0x01].present) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *stats = sim_devices[address & 0x01].stats;
+    return ESP_OK;
+}
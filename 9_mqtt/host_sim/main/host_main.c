@@ -0,0 +1,233 @@
+/* 호스트(리눅스 타깃) 시뮬레이션 - 메인 파일
+ *
+ * Wi-Fi 대신 호스트 네트워크로 MQTT 브로커에 접속하고,
+ * I2C 버스에는 MPU6050 시뮬레이터를 연결해서 9_mqtt/main 코드를 그대로 실행합니다.
+ * HOST_SIM_DURATION_S를 주면 그 시간만큼 실행한 뒤 요약을 출력하고,
+ * 샘플 수 / FIFO 오버플로 / 손실 카운터가 범위를 벗어나면 0이 아닌 코드로 종료합니다 (CI용).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "config.h"
+#include "mqtt_handler.h"
+#include "sensor_task.h"
+#include "binlog.h"
+#include "mpu6050_sim.h"
+
+#define HOST_SIM_STATS_PERIOD_MS 10000
+#define HOST_SIM_WARMUP_MS 3000                 // 측정 제외 구간 (초기화 / 보정 읽기)
+#define HOST_SIM_SAMPLE_TOLERANCE_PCT 10        // 읽은 샘플 수 허용 오차 (기대값 대비 %)
+#define HOST_SIM_MAX_FIFO_OVERFLOWS 0           // 측정 구간 FIFO 오버플로 상한
+#define HOST_SIM_MAX_LOST_SAMPLES 0             // 측정 구간 손실 샘플 상한 (샘플 큐 + outbox)
+
+// 측정 구간 시작 시점의 누적 카운터
+typedef struct {
+    int64_t time_us;
+    mpu6050_sim_stats_t sim[MPU6050_MAX_DEVICES];
+    sensor_queue_stats_t queue;
+    sensor_rbe_stats_t rbe;
+    mqtt_outbox_stats_t outbox;
+} host_sim_snapshot_t;
+
+static const uint8_t sim_addresses[] = MPU6050_DEVICE_ADDRESSES;
+
+/**
+ * @brief 시뮬레이터 통계 출력 (I2C 처리량 회귀 확인용)
+ */
+static void host_sim_log_stats(const mpu6050_sim_stats_t *prev, uint8_t address)
+{
+    mpu6050_sim_stats_t stats;
+    if (mpu6050_sim_get_stats(address, &stats) != ESP_OK) {
+        return;
+    }
+
+    const float period_s = HOST_SIM_STATS_PERIOD_MS / 1000.0f;
+    ESP_LOGI(TAG_MAIN, "[0x%02X] %.1f trans/s, %.0f B/s read, %.1f samples/s, %.1f DRDY/s, %.1f MOT/s, "
+             "FIFO overflows %" PRIu32,
+             address,
+             (stats.transactions - prev->transactions) / period_s,
+             (stats.bytes_read - prev->bytes_read) / period_s,
+             (stats.samples_read - prev->samples_read) / period_s,
+             (stats.data_ready_interrupts - prev->data_ready_interrupts) / period_s,
+             (stats.motion_interrupts - prev->motion_interrupts) / period_s,
+             stats.fifo_overflows);
+}
+
+/**
+ * @brief 환경 변수 정수 값 (없거나 잘못되면 기본값)
+ */
+static uint32_t host_sim_env_u32(const char *name, uint32_t default_value)
+{
+    const char *value = getenv(name);
+    char *end;
+
+    if (value == NULL || *value == '\0') {
+        return default_value;
+    }
+    const unsigned long parsed = strtoul(value, &end, 10);
+    if (*end != '\0') {
+        ESP_LOGW(TAG_MAIN, "Invalid %s=%s, using %" PRIu32, name, value, default_value);
+        return default_value;
+    }
+    return (uint32_t)parsed;
+}
+
+static void host_sim_snapshot(host_sim_snapshot_t *snap)
+{
+    snap->time_us = esp_timer_get_time();
+    for (size_t i = 0; i < sizeof(sim_addresses); i++) {
+        mpu6050_sim_get_stats(sim_addresses[i], &snap->sim[i]);
+    }
+    sensor_get_queue_stats(&snap->queue);
+    sensor_get_rbe_stats(&snap->rbe);
+    mqtt_get_outbox_stats(&snap->outbox, false);
+}
+
+/**
+ * @brief 디바이스당 기대 샘플 주파수 (수집 방식별 설정값)
+ */
+static float host_sim_expected_rate_hz(void)
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_POLL
+    return 1000.0f / sensor_get_publish_interval();
+#else
+    mpu6050_config_t config;
+    sensor_get_mpu6050_config(&config);
+    return config.sample_rate_hz;
+#endif
+}
+
+/**
+ * @brief 측정 구간 요약 출력 및 범위 검사
+ *
+ * @return int 범위를 벗어난 항목 수 (0: 통과)
+ */
+static int host_sim_report(const host_sim_snapshot_t *start)
+{
+    host_sim_snapshot_t end;
+    int failures = 0;
+
+    host_sim_snapshot(&end);
+
+    const uint32_t tolerance_pct = host_sim_env_u32("HOST_SIM_SAMPLE_TOLERANCE_PCT", HOST_SIM_SAMPLE_TOLERANCE_PCT);
+    const uint32_t max_overflows = host_sim_env_u32("HOST_SIM_MAX_FIFO_OVERFLOWS", HOST_SIM_MAX_FIFO_OVERFLOWS);
+    const uint32_t max_lost = host_sim_env_u32("HOST_SIM_MAX_LOST_SAMPLES", HOST_SIM_MAX_LOST_SAMPLES);
+
+    // 움직임이 없어 샘플링을 멈춘 시간은 기대값에서 뺌 (SENSOR_MOTION_WAKE)
+    const uint32_t slept_ms = end.rbe.sleep_ms - start->rbe.sleep_ms;
+    const int64_t window_ms = (end.time_us - start->time_us) / 1000;
+    const int64_t active_ms = window_ms > slept_ms ? window_ms - slept_ms : 0;
+    const float expected = host_sim_expected_rate_hz() * active_ms / 1000.0f;
+    // 구간 경계에서 한 샘플씩 어긋날 수 있으므로 최소 1샘플 허용
+    const float slack = fmaxf(expected * tolerance_pct / 100.0f, 1.0f);
+
+    printf("\n=== Host Simulation Summary (%" PRId64 " ms, %" PRIu32 " ms asleep) ===\n", window_ms, slept_ms);
+    for (size_t i = 0; i < sizeof(sim_addresses); i++) {
+        const mpu6050_sim_stats_t *a = &start->sim[i];
+        const mpu6050_sim_stats_t *b = &end.sim[i];
+        const uint32_t read = b->samples_read - a->samples_read;
+        const uint32_t overflows = b->fifo_overflows - a->fifo_overflows;
+        const bool read_ok = fabsf(read - expected) <= slack;
+        const bool overflow_ok = overflows <= max_overflows;
+
+        printf("[0x%02X] samples read %" PRIu32 " (expected %.0f +/- %.0f)%s, transactions %" PRIu32
+               ", FIFO overflows %" PRIu32 "%s\n",
+               sim_addresses[i], read, expected, slack, read_ok ? "" : " FAIL",
+               b->transactions - a->transactions, overflows, overflow_ok ? "" : " FAIL");
+        failures += !read_ok + !overflow_ok;
+    }
+
+    const uint32_t queue_lost = (end.queue.dropped - start->queue.dropped) +
+                                (end.queue.overwritten - start->queue.overwritten);
+    const uint32_t outbox_lost = end.outbox.dropped_samples - start->outbox.dropped_samples;
+    const uint32_t expired = end.outbox.expired - start->outbox.expired;
+    const bool lost_ok = queue_lost + outbox_lost <= max_lost && expired == 0;
+
+    printf("queue: enqueued %" PRIu32 ", published %" PRIu32 ", dropped %" PRIu32 ", overwritten %" PRIu32
+           ", peak depth %" PRIu32 "\n",
+           end.queue.enqueued - start->queue.enqueued, end.queue.published - start->queue.published,
+           end.queue.dropped - start->queue.dropped, end.queue.overwritten - start->queue.overwritten,
+           end.queue.peak_depth);
+    printf("outbox: enqueued %" PRIu32 ", dropped %" PRIu32 ", downsampled %" PRIu32 ", lost samples %" PRIu32
+           ", expired %" PRIu32 ", peak %" PRIu32 " bytes\n",
+           end.outbox.enqueued - start->outbox.enqueued, end.outbox.dropped - start->outbox.dropped,
+           end.outbox.downsampled - start->outbox.downsampled, outbox_lost, expired, end.outbox.peak);
+    printf("lost samples %" PRIu32 " (max %" PRIu32 "), expired messages %" PRIu32 " (max 0)%s\n",
+           queue_lost + outbox_lost, max_lost, expired, lost_ok ? "" : " FAIL");
+    failures += !lost_ok;
+
+    printf("%s: %d check(s) out of bounds\n", failures == 0 ? "PASSED" : "FAILED", failures);
+    return failures;
+}
+
+void app_main(void)
+{
+#if BINLOG_ENABLE
+    binlog_init();
+#endif
+    ESP_LOGI(TAG_MAIN, "=== Host Simulation Started ===");
+
+    // NVS 초기화 (호스트에서는 파일 기반 에뮬레이션)
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+
+    // 녹화 모션 재생 (MPU6050_SIM_MOTION=파일.csv), 없으면 기본 스크립트
+    const char *motion_path = getenv("MPU6050_SIM_MOTION");
+    if (motion_path != NULL && mpu6050_sim_load_motion_csv(motion_path) != ESP_OK) {
+        ESP_LOGW(TAG_MAIN, "Failed to load motion %s, using scripted motion", motion_path);
+    }
+
+    // 첫 번째 디바이스 INT를 DATA_RDY / 움직임 감지 입력 핀에 연결
+    mpu6050_sim_set_int_pin(sim_addresses[0], MPU6050_INT_PIN);
+
+    mqtt_init_and_start();
+    sensor_task_start();
+
+    ESP_LOGI(TAG_MAIN, "System initialization complete");
+
+    // 실행 시간 (0 또는 없음: 계속 실행)
+    const uint32_t duration_s = host_sim_env_u32("HOST_SIM_DURATION_S", 0);
+    if (duration_s > 0 && duration_s * 1000 <= HOST_SIM_WARMUP_MS) {
+        ESP_LOGE(TAG_MAIN, "HOST_SIM_DURATION_S must be longer than the %d ms warm-up", HOST_SIM_WARMUP_MS);
+        exit(2);
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(HOST_SIM_WARMUP_MS));
+    host_sim_snapshot_t start;
+    host_sim_snapshot(&start);
+
+    mpu6050_sim_stats_t prev[sizeof(sim_addresses)];
+    memcpy(prev, start.sim, sizeof(prev));
+    const int64_t end_us = start.time_us + ((int64_t)duration_s * 1000 - HOST_SIM_WARMUP_MS) * 1000;
+    while (1) {
+        int64_t wait_ms = HOST_SIM_STATS_PERIOD_MS;
+        if (duration_s > 0) {
+            const int64_t remaining_ms = (end_us - esp_timer_get_time()) / 1000;
+            if (remaining_ms <= 0) {
+                exit(host_sim_report(&start) == 0 ? 0 : 1);
+            }
+            wait_ms = remaining_ms < wait_ms ? remaining_ms : wait_ms;
+        }
+        vTaskDelay(pdMS_TO_TICKS(wait_ms));
+        if (wait_ms == HOST_SIM_STATS_PERIOD_MS) {
+            for (size_t i = 0; i < sizeof(sim_addresses); i++) {
+                host_sim_log_stats(&prev[i], sim_addresses[i]);
+                mpu6050_sim_get_stats(sim_addresses[i], &prev[i]);
+            }
+        }
+    }
+}
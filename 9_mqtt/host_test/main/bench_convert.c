@@ -0,0 +1,114 @@
+/* Raw 샘플 일괄 변환 벤치마크
+ *
+ * FIFO 한 번 분량(SENSOR_FIFO_MAX_SAMPLES)의 Raw 샘플을 mpu6050_convert_samples()로 변환하는 시간과,
+ * 기존 드라이버처럼 샘플마다 감도로 나누고 온도를 double로 계산하는 경로를 비교합니다.
+ * 두 결과가 float 반올림 오차 안에서 같은지도 확인합니다.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "esp_cpu.h"
+#include "host_test.h"
+#include "config.h"
+
+#define BENCH_CONVERT_ROUNDS 20000
+#define BENCH_CONVERT_TOLERANCE 1e-6f   // 상대 오차 (나눗셈 ↔ 역수 곱셈, double ↔ float 온도)
+
+// 기존 드라이버의 감도 (±2g, ±250°/s)
+static float legacy_accel_sensitivity = 16384.0f;
+static float legacy_gyro_sensitivity = 131.0f;
+
+/**
+ * @brief 기존 변환 (샘플 하나, 나눗셈 + double 온도)
+ */
+static void __attribute__((noinline)) bench_convert_legacy(const mpu6050_raw_sample_t *raw, mpu6050_data_t *data)
+{
+    data->accel_x = raw->accel_x / legacy_accel_sensitivity;
+    data->accel_y = raw->accel_y / legacy_accel_sensitivity;
+    data->accel_z = raw->accel_z / legacy_accel_sensitivity;
+    data->gyro_x = raw->gyro_x / legacy_gyro_sensitivity;
+    data->gyro_y = raw->gyro_y / legacy_gyro_sensitivity;
+    data->gyro_z = raw->gyro_z / legacy_gyro_sensitivity;
+    data->temperature = (raw->temp / 340.0) + 36.53;
+}
+
+/**
+ * @brief 상대 오차 비교 (magnitude: 계산 중 값의 크기, 온도는 36.53을 더하므로 그 크기 기준)
+ */
+static bool bench_convert_close(float value, float expected, float magnitude)
+{
+    return fabsf(value - expected) <= BENCH_CONVERT_TOLERANCE * fmaxf(magnitude, fabsf(expected));
+}
+
+/**
+ * @brief 일괄 변환 vs 샘플별 변환
+ */
+void bench_convert_run(void)
+{
+    static mpu6050_raw_sample_t raw[SENSOR_FIFO_MAX_SAMPLES];
+    static mpu6050_data_t batch[SENSOR_FIFO_MAX_SAMPLES];
+    static mpu6050_data_t legacy[SENSOR_FIFO_MAX_SAMPLES];
+    const size_t count = SENSOR_FIFO_MAX_SAMPLES;
+
+    printf("\n== mpu6050_convert_samples (%u samples x %d rounds)\n", (unsigned)count, BENCH_CONVERT_ROUNDS);
+
+    mpu6050_handle_t dev = host_test_device();
+    HOST_TEST_CHECK(dev != NULL, "MPU6050 simulator device not created");
+    if (dev == NULL) {
+        return;
+    }
+
+    // 전체 범위의 값 (양 끝 포함)
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < count; i++) {
+        int16_t v[7];
+        for (int k = 0; k < 7; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            v[k] = (int16_t)(seed >> 16);
+        }
+        raw[i] = (mpu6050_raw_sample_t) {
+            .timestamp_us = (int64_t)i * 1000,
+            .accel_x = i == 0 ? INT16_MIN : v[0], .accel_y = i == 0 ? INT16_MAX : v[1], .accel_z = v[2],
+            .temp = v[3], .gyro_x = v[4], .gyro_y = v[5], .gyro_z = v[6],
+        };
+    }
+
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < BENCH_CONVERT_ROUNDS; n++) {
+        for (size_t i = 0; i < count; i++) {
+            bench_convert_legacy(&raw[i], &legacy[i]);
+        }
+        __asm__ volatile("" ::: "memory");
+    }
+    const uint64_t legacy_ns = (uint32_t)(esp_cpu_get_cycle_count() - start);
+
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < BENCH_CONVERT_ROUNDS; n++) {
+        mpu6050_convert_samples(dev, raw, batch, count);
+        __asm__ volatile("" ::: "memory");
+    }
+    const uint64_t batch_ns = (uint32_t)(esp_cpu_get_cycle_count() - start);
+
+    const double samples = (double)count * BENCH_CONVERT_ROUNDS;
+    printf("  legacy per-sample (div + double temp): %7.2f ns/sample\n", legacy_ns / samples);
+    printf("  mpu6050_convert_samples:               %7.2f ns/sample (x%.2f)\n",
+           batch_ns / samples, batch_ns ? (double)legacy_ns / batch_ns : 0.0);
+    printf("  queued sample size: raw %u bytes, converted %u bytes\n",
+           (unsigned)sizeof(mpu6050_raw_sample_t), (unsigned)sizeof(mpu6050_data_t));
+
+    // 보정 오프셋은 Raw 샘플에 이미 적용되어 있으므로 두 경로 결과가 같아야 함
+    for (size_t i = 0; i < count; i++) {
+        const mpu6050_data_t *a = &batch[i];
+        const mpu6050_data_t *b = &legacy[i];
+        const float got[7] = { a->accel_x, a->accel_y, a->accel_z, a->gyro_x, a->gyro_y, a->gyro_z, a->temperature };
+        const float want[7] = { b->accel_x, b->accel_y, b->accel_z, b->gyro_x, b->gyro_y, b->gyro_z, b->temperature };
+        for (int k = 0; k < 7; k++) {
+            HOST_TEST_CHECK(bench_convert_close(got[k], want[k], k == 6 ? 64.0f : 1.0f), "sample %u field %d: %.7g != %.7g",
+                            (unsigned)i, k, got[k], want[k]);
+        }
+    }
+    HOST_TEST_CHECK(sizeof(mpu6050_raw_sample_t) == 24, "mpu6050_raw_sample_t is %u bytes",
+                    (unsigned)sizeof(mpu6050_raw_sample_t));
+}
@@ -0,0 +1,78 @@
+/* 호스트 테스트 공통 헤더
+ * 테스트는 실패해도 멈추지 않고 끝까지 실행하며, 실패 수를 종료 코드로 돌려줍니다.
+ * 벤치마크 시간은 리눅스 타깃 esp_cpu_get_cycle_count()(단조 시계 ns) 기준입니다.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdbool.h>
+#include "mpu6050.h"
+
+// 조건이 거짓이면 실패로 기록하고 계속 진행
+#define HOST_TEST_CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            host_test_fail(__FILE__, __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+/**
+ * @brief 실패 기록 (파일 / 줄 / 메시지 출력)
+ */
+void host_test_fail(const char *file, int line, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief 시뮬레이터 I2C 버스 핸들 (처음 호출할 때 생성)
+ *
+ * @return 핸들 (생성 실패 시 NULL)
+ */
+i2c_master_bus_handle_t host_test_bus(void);
+
+/**
+ * @brief 시뮬레이터 버스에 MPU6050 생성 (±2g / ±250°/s, 1kHz)
+ *
+ * @param address I2C 주소 (0x68 또는 0x69)
+ * @param device_id 디바이스 번호
+ * @return 핸들 (생성 실패 시 NULL)
+ */
+mpu6050_handle_t host_test_create_device(uint8_t address, uint8_t device_id);
+
+/**
+ * @brief 시뮬레이터 0x68에 연결한 MPU6050 핸들 (처음 호출할 때 생성, ±2g / ±250°/s)
+ *
+ * @return 핸들 (생성 실패 시 NULL)
+ */
+mpu6050_handle_t host_test_device(void);
+
+/**
+ * @brief Raw 샘플 일괄 변환(mpu6050_convert_samples)과 기존 샘플별 float 변환 비교
+ */
+void bench_convert_run(void);
+
+/**
+ * @brief 여러 디바이스 일괄 읽기의 디바이스별 결과 (한 디바이스가 실패해도 나머지 샘플은 유효)
+ */
+void test_read_all_run(void);
+
+/**
+ * @brief 비동기 읽기 타임아웃 후 버스 정리 (늦은 완료 신호가 다음 읽기에 섞이지 않음)
+ */
+void test_read_timeout_run(void);
+
+/**
+ * @brief DLPF별 샘플링 주파수 검사와 실제 주파수 (분주 후)
+ */
+void test_sample_rate_run(void);
+
+/**
+ * @brief 캡처 시점 측정 범위로 변환 / 다시 양자화 (설정이 바뀐 뒤에도 캡처할 때의 감도)
+ */
+void test_scale_run(void);
+
+/**
+ * @brief 상보 / Madgwick 자세 추정 정확도 (참값, double 참조 구현과 비교)와 갱신 비용
+ */
+void test_imu_fusion_run(void);
+
+#endif // HOST_TEST_H
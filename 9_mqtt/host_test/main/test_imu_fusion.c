@@ -0,0 +1,361 @@
+/* 자세 추정(imu_fusion) 정확도 테스트 / 벤치마크
+ *
+ * 상보 필터와 Madgwick 필터를 참값 및 double 정밀도 Madgwick 참조 구현과 비교합니다.
+ * - 정지 기울기: roll / pitch 고정 (roll ±180° 경계 포함)
+ * - 일정 각속도: 기울어진 채 수직축 회전, roll 축 연속 회전 (±180° 통과)
+ * - 녹화 모션: host_sim/motion/pitch_step.csv (pitch 0 → 45° → 0)
+ * 오차는 roll / pitch(와 yaw) 각도 차이를 ±180°로 감싼 값의 최대 / RMS입니다.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host_test.h"
+#include "imu_fusion.h"
+
+#define TEST_FUSION_RATE_HZ 100
+#define TEST_FUSION_DT_US (1000000 / TEST_FUSION_RATE_HZ)
+#define TEST_FUSION_ALPHA 0.98f             // 상보 필터 alpha
+#define TEST_FUSION_BETA 0.1f               // Madgwick beta
+#define TEST_FUSION_SETTLE_S 5.0            // 정지 기울기: 이 시간 뒤 오차 확인
+#define TEST_FUSION_STATIC_MAX_DEG 0.5      // 정지 기울기 최대 오차
+#define TEST_FUSION_RATE_MAX_DEG 1.0        // 일정 각속도 최대 오차 (초기 수렴 뒤)
+#define TEST_FUSION_STEP_MAX_DEG 1.0        // pitch_step.csv 최대 오차
+// float Madgwick vs double 참조 최대 차이: 정규화한 기울기로 매 샘플 beta * dt씩 움직이므로 오차가 0 근처에서
+// ±beta * dt로 진동하고, float / double의 진동 위상이 어긋나도 되도록 그 4배까지 허용
+#define TEST_FUSION_REF_MAX_DEG (4.0 * TEST_FUSION_BETA * TEST_FUSION_DEG / TEST_FUSION_RATE_HZ)
+#define TEST_FUSION_BENCH_ITERATIONS 1000000
+#define TEST_FUSION_MAX_CSV_SAMPLES 4096
+#define TEST_FUSION_PI 3.14159265358979323846
+#define TEST_FUSION_DEG 57.29577951308232
+
+// 입력 샘플 + 참값 (rad, ZYX)
+typedef struct {
+    double t;
+    float accel[3];     // g
+    float gyro[3];      // °/s
+    double roll, pitch, yaw;
+    bool has_yaw;       // yaw 참값이 있는 경우만 비교 (녹화 모션은 roll / pitch만)
+} test_fusion_input_t;
+
+// double 정밀도 Madgwick 6축 필터 (참조 구현)
+typedef struct {
+    double q[4];
+    bool initialized;
+} test_fusion_ref_t;
+
+// 필터별 오차 누적
+typedef struct {
+    double max_deg;
+    double sum_sq;
+    size_t count;
+} test_fusion_error_t;
+
+static test_fusion_input_t test_fusion_csv[TEST_FUSION_MAX_CSV_SAMPLES];
+
+/**
+ * @brief 각도 차이를 ±π로 감쌈
+ */
+static double test_fusion_wrap(double a)
+{
+    while (a > TEST_FUSION_PI) {
+        a -= 2.0 * TEST_FUSION_PI;
+    }
+    while (a < -TEST_FUSION_PI) {
+        a += 2.0 * TEST_FUSION_PI;
+    }
+    return a;
+}
+
+/**
+ * @brief 쿼터니언(w, x, y, z) → 오일러각(rad, ZYX)
+ */
+static void test_fusion_euler(const double q[4], double *roll, double *pitch, double *yaw)
+{
+    double sp = 2.0 * (q[0] * q[2] - q[3] * q[1]);
+    sp = sp > 1.0 ? 1.0 : (sp < -1.0 ? -1.0 : sp);
+    *roll = atan2(2.0 * (q[0] * q[1] + q[2] * q[3]), 1.0 - 2.0 * (q[1] * q[1] + q[2] * q[2]));
+    *pitch = asin(sp);
+    *yaw = atan2(2.0 * (q[0] * q[3] + q[1] * q[2]), 1.0 - 2.0 * (q[2] * q[2] + q[3] * q[3]));
+}
+
+/**
+ * @brief 참조 Madgwick 갱신 (imu_fusion.c와 같은 식, 첫 샘플은 가속도 기울기로 시작)
+ */
+static void test_fusion_ref_update(test_fusion_ref_t *ref, const test_fusion_input_t *in, double dt)
+{
+    double ax = in->accel[0], ay = in->accel[1], az = in->accel[2];
+
+    if (!ref->initialized) {
+        const double roll = atan2(ay, az);
+        const double pitch = atan2(-ax, sqrt(ay * ay + az * az));
+        ref->q[0] = cos(roll / 2) * cos(pitch / 2);
+        ref->q[1] = sin(roll / 2) * cos(pitch / 2);
+        ref->q[2] = cos(roll / 2) * sin(pitch / 2);
+        ref->q[3] = -sin(roll / 2) * sin(pitch / 2);
+        ref->initialized = true;
+        return;
+    }
+
+    const double gx = in->gyro[0] / TEST_FUSION_DEG;
+    const double gy = in->gyro[1] / TEST_FUSION_DEG;
+    const double gz = in->gyro[2] / TEST_FUSION_DEG;
+    double q0 = ref->q[0], q1 = ref->q[1], q2 = ref->q[2], q3 = ref->q[3];
+    double d0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+    double d1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+    double d2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+    double d3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+    const double norm = sqrt(ax * ax + ay * ay + az * az);
+    if (norm > 0.0) {
+        ax /= norm;
+        ay /= norm;
+        az /= norm;
+        // 목적 함수 f = 예상 중력 - 측정 가속도, 기울기 = Jᵀf
+        const double f0 = 2.0 * (q1 * q3 - q0 * q2) - ax;
+        const double f1 = 2.0 * (q0 * q1 + q2 * q3) - ay;
+        const double f2 = 2.0 * (0.5 - q1 * q1 - q2 * q2) - az;
+        double s0 = -2.0 * q2 * f0 + 2.0 * q1 * f1;
+        double s1 = 2.0 * q3 * f0 + 2.0 * q0 * f1 - 4.0 * q1 * f2;
+        double s2 = -2.0 * q0 * f0 + 2.0 * q3 * f1 - 4.0 * q2 * f2;
+        double s3 = 2.0 * q1 * f0 + 2.0 * q2 * f1;
+        const double s_norm = sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+        if (s_norm > 0.0) {
+            d0 -= TEST_FUSION_BETA * s0 / s_norm;
+            d1 -= TEST_FUSION_BETA * s1 / s_norm;
+            d2 -= TEST_FUSION_BETA * s2 / s_norm;
+            d3 -= TEST_FUSION_BETA * s3 / s_norm;
+        }
+    }
+
+    q0 += d0 * dt;
+    q1 += d1 * dt;
+    q2 += d2 * dt;
+    q3 += d3 * dt;
+    const double q_norm = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    ref->q[0] = q0 / q_norm;
+    ref->q[1] = q1 / q_norm;
+    ref->q[2] = q2 / q_norm;
+    ref->q[3] = q3 / q_norm;
+}
+
+/**
+ * @brief 추정 자세와 참값의 각도 오차 누적
+ */
+static void test_fusion_error_add(test_fusion_error_t *err, const test_fusion_input_t *in,
+                                  double roll, double pitch, double yaw)
+{
+    const double diffs[3] = {
+        test_fusion_wrap(roll - in->roll),
+        test_fusion_wrap(pitch - in->pitch),
+        in->has_yaw ? test_fusion_wrap(yaw - in->yaw) : 0.0,
+    };
+
+    for (int k = 0; k < 3; k++) {
+        const double deg = fabs(diffs[k]) * TEST_FUSION_DEG;
+        if (deg > err->max_deg) {
+            err->max_deg = deg;
+        }
+        err->sum_sq += deg * deg;
+    }
+    err->count++;
+}
+
+/**
+ * @brief 입력을 세 필터에 넣고 참값 / 참조 구현과 비교
+ *
+ * @param skip_s 이 시간 전의 오차는 무시 (초기 수렴 구간)
+ */
+static void test_fusion_run_case(const char *name, const test_fusion_input_t *inputs, size_t count,
+                                 double skip_s, double max_deg)
+{
+    imu_fusion_t comp, madg;
+    test_fusion_ref_t ref = {0};
+    test_fusion_error_t comp_err = {0}, madg_err = {0}, ref_err = {0};
+    double ref_diff_max = 0.0;
+
+    imu_fusion_init(&comp, IMU_FUSION_COMPLEMENTARY, TEST_FUSION_ALPHA);
+    imu_fusion_init(&madg, IMU_FUSION_MADGWICK, TEST_FUSION_BETA);
+
+    for (size_t i = 0; i < count; i++) {
+        const test_fusion_input_t *in = &inputs[i];
+        const int64_t timestamp_us = (int64_t)llround(in->t * 1e6) + TEST_FUSION_DT_US;
+        imu_quaternion_t q;
+        double fq[4], roll, pitch, yaw;
+
+        imu_fusion_update(&comp, in->accel[0], in->accel[1], in->accel[2],
+                          in->gyro[0], in->gyro[1], in->gyro[2], timestamp_us);
+        imu_fusion_update(&madg, in->accel[0], in->accel[1], in->accel[2],
+                          in->gyro[0], in->gyro[1], in->gyro[2], timestamp_us);
+        test_fusion_ref_update(&ref, in, i > 0 ? in->t - inputs[i - 1].t : 0.0);
+        if (in->t < skip_s) {
+            continue;
+        }
+
+        imu_fusion_get_quaternion(&comp, &q);
+        fq[0] = q.w, fq[1] = q.x, fq[2] = q.y, fq[3] = q.z;
+        test_fusion_euler(fq, &roll, &pitch, &yaw);
+        test_fusion_error_add(&comp_err, in, roll, pitch, yaw);
+
+        imu_fusion_get_quaternion(&madg, &q);
+        fq[0] = q.w, fq[1] = q.x, fq[2] = q.y, fq[3] = q.z;
+        test_fusion_euler(fq, &roll, &pitch, &yaw);
+        test_fusion_error_add(&madg_err, in, roll, pitch, yaw);
+
+        double rr, rp, ry;
+        test_fusion_euler(ref.q, &rr, &rp, &ry);
+        test_fusion_error_add(&ref_err, in, rr, rp, ry);
+        const double d = fmax(fabs(test_fusion_wrap(roll - rr)),
+                              fmax(fabs(test_fusion_wrap(pitch - rp)), fabs(test_fusion_wrap(yaw - ry))));
+        if (d * TEST_FUSION_DEG > ref_diff_max) {
+            ref_diff_max = d * TEST_FUSION_DEG;
+        }
+    }
+
+    // imu_fusion_get_euler()도 쿼터니언과 같은 자세를 돌려주는지 확인
+    imu_euler_t euler;
+    imu_quaternion_t q;
+    double fq[4], roll, pitch, yaw;
+    imu_fusion_get_euler(&comp, &euler);
+    imu_fusion_get_quaternion(&comp, &q);
+    fq[0] = q.w, fq[1] = q.x, fq[2] = q.y, fq[3] = q.z;
+    test_fusion_euler(fq, &roll, &pitch, &yaw);
+    HOST_TEST_CHECK(fabs(test_fusion_wrap(euler.roll / TEST_FUSION_DEG - roll)) * TEST_FUSION_DEG < 0.01 &&
+                    fabs(euler.pitch - pitch * TEST_FUSION_DEG) < 0.01,
+                    "%s: complementary euler (%.3f, %.3f) != quaternion (%.3f, %.3f)", name,
+                    euler.roll, euler.pitch, roll * TEST_FUSION_DEG, pitch * TEST_FUSION_DEG);
+
+    const test_fusion_error_t *errs[3] = { &comp_err, &madg_err, &ref_err };
+    static const char *const names[3] = { "complementary", "madgwick", "madgwick (double)" };
+    for (int k = 0; k < 3; k++) {
+        const double rms = errs[k]->count ? sqrt(errs[k]->sum_sq / (3.0 * errs[k]->count)) : 0.0;
+        printf("  %-22s %-18s max %6.3f deg  rms %6.3f deg\n", name, names[k], errs[k]->max_deg, rms);
+        HOST_TEST_CHECK(errs[k]->count > 0 && errs[k]->max_deg <= max_deg, "%s: %s max error %.3f deg > %.3f",
+                        name, names[k], errs[k]->max_deg, max_deg);
+    }
+    printf("  %-22s madgwick float vs double: max %.4f deg\n", name, ref_diff_max);
+    HOST_TEST_CHECK(ref_diff_max <= TEST_FUSION_REF_MAX_DEG, "%s: float Madgwick differs from reference by %.4f deg",
+                    name, ref_diff_max);
+}
+
+/**
+ * @brief 자세(ZYX)와 센서 좌표계 각속도(rad/s)로 입력 생성
+ */
+static void test_fusion_make_input(test_fusion_input_t *in, double t, double roll, double pitch, double yaw,
+                                   const double omega_body[3])
+{
+    in->t = t;
+    // 정지 가속도계는 중력 반대 방향 +1g를 측정 (센서 좌표계 = Rᵀ (0, 0, 1))
+    in->accel[0] = (float)(-sin(pitch));
+    in->accel[1] = (float)(sin(roll) * cos(pitch));
+    in->accel[2] = (float)(cos(roll) * cos(pitch));
+    for (int k = 0; k < 3; k++) {
+        in->gyro[k] = (float)(omega_body[k] * TEST_FUSION_DEG);
+    }
+    in->roll = test_fusion_wrap(roll);
+    in->pitch = pitch;
+    in->yaw = test_fusion_wrap(yaw);
+    in->has_yaw = true;
+}
+
+/**
+ * @brief 정지 기울기
+ */
+static void test_fusion_static(const char *name, double roll_deg, double pitch_deg)
+{
+    const size_t count = (size_t)(TEST_FUSION_SETTLE_S * 2 * TEST_FUSION_RATE_HZ);
+    const double zero[3] = {0};
+
+    for (size_t i = 0; i < count; i++) {
+        test_fusion_input_t *in = &test_fusion_csv[i];
+        test_fusion_make_input(in, (double)i / TEST_FUSION_RATE_HZ, roll_deg / TEST_FUSION_DEG,
+                               pitch_deg / TEST_FUSION_DEG, 0.0, zero);
+        // roll 180° 경계: 가속도 y 부호가 샘플마다 바뀌는 작은 잡음
+        in->accel[1] += (i & 1) ? 0.002f : -0.002f;
+    }
+    test_fusion_run_case(name, test_fusion_csv, count, TEST_FUSION_SETTLE_S, TEST_FUSION_STATIC_MAX_DEG);
+}
+
+/**
+ * @brief 기울어진 채 수직축으로 일정 속도 회전 (센서 좌표계 각속도가 세 축에 나뉨)
+ */
+static void test_fusion_tilted_yaw(void)
+{
+    const double pitch = 30.0 / TEST_FUSION_DEG;
+    const double rate = 90.0 / TEST_FUSION_DEG;
+    const double omega[3] = { -sin(pitch) * rate, 0.0, cos(pitch) * rate };     // Ry(pitch)ᵀ (0, 0, ω)
+    const size_t count = 10 * TEST_FUSION_RATE_HZ;
+
+    for (size_t i = 0; i < count; i++) {
+        const double t = (double)i / TEST_FUSION_RATE_HZ;
+        test_fusion_make_input(&test_fusion_csv[i], t, 0.0, pitch, rate * t, omega);
+    }
+    test_fusion_run_case("tilted yaw 90 deg/s", test_fusion_csv, count, 0.0, TEST_FUSION_RATE_MAX_DEG);
+}
+
+/**
+ * @brief roll 축 연속 회전 (±180° 통과)
+ */
+static void test_fusion_roll_spin(void)
+{
+    const double rate = 60.0 / TEST_FUSION_DEG;
+    const double omega[3] = { rate, 0.0, 0.0 };
+    const size_t count = 12 * TEST_FUSION_RATE_HZ;
+
+    for (size_t i = 0; i < count; i++) {
+        const double t = (double)i / TEST_FUSION_RATE_HZ;
+        test_fusion_make_input(&test_fusion_csv[i], t, rate * t, 0.0, 0.0, omega);
+    }
+    test_fusion_run_case("roll spin 60 deg/s", test_fusion_csv, count, 0.0, TEST_FUSION_RATE_MAX_DEG);
+}
+
+/**
+ * @brief 녹화 모션 CSV (참값은 선형 가속도가 없으므로 가속도 기울기)
+ */
+static void test_fusion_pitch_step(void)
+{
+    const char *path = HOST_TEST_MOTION_DIR "/pitch_step.csv";
+    FILE *file = fopen(path, "r");
+    char line[256];
+    size_t count = 0;
+
+    HOST_TEST_CHECK(file != NULL, "cannot open %s", path);
+    if (file == NULL) {
+        return;
+    }
+    while (fgets(line, sizeof(line), file) != NULL && count < TEST_FUSION_MAX_CSV_SAMPLES) {
+        test_fusion_input_t *in = &test_fusion_csv[count];
+        if (line[0] == '#' ||
+            sscanf(line, "%lf,%f,%f,%f,%f,%f,%f", &in->t, &in->accel[0], &in->accel[1], &in->accel[2],
+                   &in->gyro[0], &in->gyro[1], &in->gyro[2]) != 7) {
+            continue;
+        }
+        in->roll = atan2(in->accel[1], in->accel[2]);
+        in->pitch = atan2(-in->accel[0], hypot(in->accel[1], in->accel[2]));
+        in->has_yaw = false;
+        count++;
+    }
+    fclose(file);
+
+    HOST_TEST_CHECK(count > 0, "no samples in %s", path);
+    test_fusion_run_case("pitch_step.csv", test_fusion_csv, count, 0.0, TEST_FUSION_STEP_MAX_DEG);
+}
+
+void test_imu_fusion_run(void)
+{
+    printf("\n== imu_fusion accuracy (%d Hz, alpha %.2f, beta %.2f)\n", TEST_FUSION_RATE_HZ,
+           TEST_FUSION_ALPHA, TEST_FUSION_BETA);
+
+    test_fusion_static("static roll 30 pitch -20", 30.0, -20.0);
+    test_fusion_static("static roll 180", 180.0, 10.0);
+    test_fusion_tilted_yaw();
+    test_fusion_roll_spin();
+    test_fusion_pitch_step();
+
+    printf("\n== imu_fusion_benchmark (%d updates)\n", TEST_FUSION_BENCH_ITERATIONS);
+    const uint32_t comp = imu_fusion_benchmark(IMU_FUSION_COMPLEMENTARY, TEST_FUSION_BENCH_ITERATIONS);
+    const uint32_t madg = imu_fusion_benchmark(IMU_FUSION_MADGWICK, TEST_FUSION_BENCH_ITERATIONS);
+    printf("  complementary: %lu cycles/update\n", (unsigned long)comp);
+    printf("  madgwick:      %lu cycles/update\n", (unsigned long)madg);
+    HOST_TEST_CHECK(comp > 0 && madg > 0, "imu_fusion_benchmark returned 0");
+}
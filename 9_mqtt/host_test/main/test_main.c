@@ -0,0 +1,105 @@
+/* 호스트 테스트 - 메인 파일
+ *
+ * 9_mqtt/main 모듈을 리눅스 타깃에서 실행해 결과를 확인하고 처리 시간을 측정합니다.
+ * 모든 테스트가 끝나면 요약을 출력하고, 실패가 있으면 종료 코드 1로 끝냅니다 (CI에서 실행).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "nvs_flash.h"
+#include "host_test.h"
+#include "config.h"
+
+static int host_test_failures = 0;
+static i2c_master_bus_handle_t test_bus = NULL;
+static mpu6050_handle_t test_device = NULL;
+
+/**
+ * @brief 실패 기록
+ */
+void host_test_fail(const char *file, int line, const char *fmt, ...)
+{
+    va_list args;
+
+    host_test_failures++;
+    printf("FAIL %s:%d: ", file, line);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
+/**
+ * @brief 시뮬레이터 I2C 버스 핸들
+ */
+i2c_master_bus_handle_t host_test_bus(void)
+{
+    if (test_bus == NULL &&
+        mpu6050_bus_init(I2C_MASTER_NUM, I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO, &test_bus) != ESP_OK) {
+        test_bus = NULL;
+    }
+    return test_bus;
+}
+
+/**
+ * @brief 시뮬레이터 MPU6050 생성 (±2g / ±250°/s, 1kHz)
+ */
+mpu6050_handle_t host_test_create_device(uint8_t address, uint8_t device_id)
+{
+    i2c_master_bus_handle_t bus = host_test_bus();
+    mpu6050_handle_t dev = NULL;
+
+    if (bus == NULL) {
+        return NULL;
+    }
+    const mpu6050_device_config_t device_config = {
+        .i2c_address = address,
+        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+        .device_id = device_id,
+        .config = {
+            .accel_range = MPU6050_ACCEL_RANGE_2G,
+            .gyro_range = MPU6050_GYRO_RANGE_250,
+            .dlpf = MPU6050_DLPF_184HZ,
+            .sample_rate_hz = 1000,
+        },
+    };
+    if (mpu6050_create(bus, &device_config, &dev) != ESP_OK) {
+        return NULL;
+    }
+    return dev;
+}
+
+/**
+ * @brief 시뮬레이터 MPU6050 핸들
+ */
+mpu6050_handle_t host_test_device(void)
+{
+    if (test_device == NULL) {
+        test_device = host_test_create_device(0x68, 0);
+    }
+    return test_device;
+}
+
+void app_main(void)
+{
+    // 보정 값 저장 / 조회용 NVS (호스트에서는 파일 기반 에뮬레이션)
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        ret = nvs_flash_init();
+    }
+    HOST_TEST_CHECK(ret == ESP_OK, "nvs_flash_init: %s", esp_err_to_name(ret));
+
+    bench_convert_run();
+    test_read_all_run();
+    test_read_timeout_run();
+    test_sample_rate_run();
+    test_scale_run();
+    test_imu_fusion_run();
+
+    printf("\n%s: %d failure(s)\n", host_test_failures ? "FAILED" : "PASSED", host_test_failures);
+    fflush(stdout);
+    exit(host_test_failures ? 1 : 0);
+}
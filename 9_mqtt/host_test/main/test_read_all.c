@@ -0,0 +1,74 @@
+/* 여러 디바이스 일괄 읽기 테스트
+ *
+ * 0x68 / 0x69 두 디바이스 중 하나가 응답하지 않을 때 mpu6050_read_raw_all*()이 디바이스별 결과를 돌려주고,
+ * 응답한 디바이스의 샘플은 그대로 쓸 수 있는지 확인합니다.
+ */
+
+#include <stdio.h>
+
+#include "host_test.h"
+#include "mpu6050_sim.h"
+
+#define TEST_READ_ALL_DEVICES 2
+
+/**
+ * @brief 쓸 수 있는 샘플인지 확인 (기본 모션은 회전만 하므로 가속도 크기가 약 1g)
+ */
+static bool test_read_all_plausible(mpu6050_handle_t dev, const mpu6050_raw_sample_t *raw)
+{
+    mpu6050_data_t data;
+
+    mpu6050_convert_samples(dev, raw, &data, 1);
+    const float g2 = data.accel_x * data.accel_x + data.accel_y * data.accel_y + data.accel_z * data.accel_z;
+    return raw->timestamp_us > 0 && g2 > 0.8f * 0.8f && g2 < 1.2f * 1.2f;
+}
+
+void test_read_all_run(void)
+{
+    mpu6050_handle_t devs[TEST_READ_ALL_DEVICES] = {
+        host_test_device(),
+        host_test_create_device(0x69, 1),
+    };
+    mpu6050_raw_sample_t samples[TEST_READ_ALL_DEVICES];
+    esp_err_t results[TEST_READ_ALL_DEVICES];
+
+    printf("\n== mpu6050_read_raw_all per-device results\n");
+
+    HOST_TEST_CHECK(devs[0] != NULL && devs[1] != NULL, "MPU6050 simulator devices not created");
+    if (devs[0] == NULL || devs[1] == NULL) {
+        return;
+    }
+
+    // 두 디바이스 모두 정상
+    esp_err_t ret = mpu6050_read_raw_all(devs, TEST_READ_ALL_DEVICES, samples, results);
+    HOST_TEST_CHECK(ret == ESP_OK, "both devices: %s", esp_err_to_name(ret));
+    for (int i = 0; i < TEST_READ_ALL_DEVICES; i++) {
+        HOST_TEST_CHECK(results[i] == ESP_OK, "both devices: #%d %s", i, esp_err_to_name(results[i]));
+    }
+
+    // 첫 번째 디바이스가 응답하지 않아도 두 번째 샘플은 유효
+    mpu6050_sim_set_nack(0x68, true);
+    ret = mpu6050_read_raw_all(devs, TEST_READ_ALL_DEVICES, samples, results);
+    HOST_TEST_CHECK(ret != ESP_OK, "#0 NACK: aggregate result is ESP_OK");
+    HOST_TEST_CHECK(results[0] != ESP_OK, "#0 NACK: #0 reported ESP_OK");
+    HOST_TEST_CHECK(results[1] == ESP_OK, "#0 NACK: #1 %s", esp_err_to_name(results[1]));
+    HOST_TEST_CHECK(test_read_all_plausible(devs[1], &samples[1]), "#0 NACK: #1 sample not usable");
+    printf("  #0 NACK -> #0 %s, #1 %s\n", esp_err_to_name(results[0]), esp_err_to_name(results[1]));
+
+    // 분리 시작 / 완료 경로 (DATA_RDY 모드)
+    mpu6050_sim_set_nack(0x68, false);
+    mpu6050_sim_set_nack(0x69, true);
+    mpu6050_read_raw_all_start(devs, TEST_READ_ALL_DEVICES, NULL);
+    ret = mpu6050_read_raw_all_finish(devs, TEST_READ_ALL_DEVICES, samples, results);
+    HOST_TEST_CHECK(ret != ESP_OK, "#1 NACK: aggregate result is ESP_OK");
+    HOST_TEST_CHECK(results[0] == ESP_OK, "#1 NACK: #0 %s", esp_err_to_name(results[0]));
+    HOST_TEST_CHECK(results[1] != ESP_OK, "#1 NACK: #1 reported ESP_OK");
+    HOST_TEST_CHECK(test_read_all_plausible(devs[0], &samples[0]), "#1 NACK: #0 sample not usable");
+    printf("  #1 NACK -> #0 %s, #1 %s\n", esp_err_to_name(results[0]), esp_err_to_name(results[1]));
+
+    // 복구 후 다시 모두 정상
+    mpu6050_sim_set_nack(0x69, false);
+    ret = mpu6050_read_raw_all(devs, TEST_READ_ALL_DEVICES, samples, results);
+    HOST_TEST_CHECK(ret == ESP_OK && results[0] == ESP_OK && results[1] == ESP_OK, "recovered: %s / %s",
+                    esp_err_to_name(results[0]), esp_err_to_name(results[1]));
+}
@@ -0,0 +1,54 @@
+/* 비동기 읽기 타임아웃 테스트
+ *
+ * 전송이 버스 큐에 남은 채로 mpu6050_read_raw_finish()가 타임아웃되면 드라이버가 버스를 정리하고
+ * 늦은 완료 신호를 버려서, 다음 읽기가 이전 전송의 신호로 끝나거나 아직 받는 중인 버퍼를 디코딩하지 않는지 확인합니다.
+ * (타임아웃마다 I2C_MASTER_TIMEOUT_MS만큼 걸림)
+ */
+
+#include <stdio.h>
+
+#include "host_test.h"
+#include "mpu6050_sim.h"
+
+void test_read_timeout_run(void)
+{
+    mpu6050_handle_t dev = host_test_device();
+    mpu6050_raw_sample_t sample = {0};
+    esp_err_t ret;
+
+    printf("\n== mpu6050_read_raw_finish timeout recovery\n");
+
+    HOST_TEST_CHECK(dev != NULL, "MPU6050 simulator device not created");
+    if (dev == NULL) {
+        return;
+    }
+
+    // 전송이 멈춘 채로 타임아웃
+    mpu6050_sim_set_stall(0x68, true);
+    ret = mpu6050_read_raw_start(dev);
+    HOST_TEST_CHECK(ret == ESP_OK, "stalled start: %s", esp_err_to_name(ret));
+    ret = mpu6050_read_raw_finish(dev, &sample);
+    HOST_TEST_CHECK(ret == ESP_ERR_TIMEOUT, "stalled finish: %s", esp_err_to_name(ret));
+
+    // 멈춤이 풀려도 버린 전송의 완료 신호가 남지 않아야 함
+    mpu6050_sim_set_stall(0x68, false);
+    ret = mpu6050_read_raw(dev, &sample);
+    HOST_TEST_CHECK(ret == ESP_OK, "read after recovery: %s", esp_err_to_name(ret));
+    const int64_t first_us = sample.timestamp_us;
+
+    mpu6050_sim_set_stall(0x68, true);
+    ret = mpu6050_read_raw_start(dev);
+    HOST_TEST_CHECK(ret == ESP_OK, "second stalled start: %s", esp_err_to_name(ret));
+    ret = mpu6050_read_raw_finish(dev, &sample);
+    HOST_TEST_CHECK(ret == ESP_ERR_TIMEOUT, "second stalled finish completed with a stale signal: %s",
+                    esp_err_to_name(ret));
+    mpu6050_sim_set_stall(0x68, false);
+
+    // 정상 전송은 다시 한 번에 하나씩 완료
+    for (int i = 0; i < 3; i++) {
+        ret = mpu6050_read_raw(dev, &sample);
+        HOST_TEST_CHECK(ret == ESP_OK && sample.timestamp_us > first_us, "read %d after recovery: %s", i,
+                        esp_err_to_name(ret));
+    }
+    printf("  stalled read timed out twice, bus recovered\n");
+}
@@ -0,0 +1,75 @@
+/* 샘플링 주파수 검사 테스트
+ *
+ * mpu6050_check_sample_rate()가 DLPF에 따른 자이로 출력(8kHz / 1kHz)으로 분주 가능한 값만 받고
+ * 실제로 동작할 주파수를 돌려주는지, mpu6050_set_config()가 그 주파수를 저장하는지 확인합니다.
+ */
+
+#include <stdio.h>
+
+#include "host_test.h"
+
+typedef struct {
+    mpu6050_dlpf_t dlpf;
+    uint16_t request_hz;
+    esp_err_t expected_ret;
+    uint16_t expected_hz;
+} test_sample_rate_case_t;
+
+static const test_sample_rate_case_t test_sample_rate_cases[] = {
+    { MPU6050_DLPF_184HZ, 1000, ESP_OK, 1000 },
+    { MPU6050_DLPF_184HZ, 300, ESP_OK, 333 },       // 분주비 3
+    { MPU6050_DLPF_184HZ, 4, ESP_OK, 4 },           // 분주비 250
+    { MPU6050_DLPF_184HZ, 3, ESP_ERR_INVALID_ARG, 0 },
+    { MPU6050_DLPF_184HZ, 0, ESP_ERR_INVALID_ARG, 0 },
+    { MPU6050_DLPF_184HZ, 1001, ESP_ERR_INVALID_ARG, 0 },
+    { MPU6050_DLPF_260HZ, 1000, ESP_OK, 1000 },
+    { MPU6050_DLPF_260HZ, 300, ESP_OK, 307 },       // 8kHz / 26
+    { MPU6050_DLPF_260HZ, 32, ESP_OK, 32 },         // 분주비 250
+    { MPU6050_DLPF_260HZ, 31, ESP_ERR_INVALID_ARG, 0 },
+};
+
+void test_sample_rate_run(void)
+{
+    printf("\n== mpu6050_check_sample_rate\n");
+
+    for (size_t i = 0; i < sizeof(test_sample_rate_cases) / sizeof(test_sample_rate_cases[0]); i++) {
+        const test_sample_rate_case_t *c = &test_sample_rate_cases[i];
+        uint16_t actual_hz = 0;
+        esp_err_t ret = mpu6050_check_sample_rate(c->dlpf, c->request_hz, &actual_hz);
+
+        HOST_TEST_CHECK(ret == c->expected_ret, "DLPF %u, %u Hz: %s", mpu6050_dlpf_to_hz(c->dlpf), c->request_hz,
+                        esp_err_to_name(ret));
+        if (ret == ESP_OK) {
+            HOST_TEST_CHECK(actual_hz == c->expected_hz, "DLPF %u, %u Hz: actual %u Hz, expected %u Hz",
+                            mpu6050_dlpf_to_hz(c->dlpf), c->request_hz, actual_hz, c->expected_hz);
+            // 실제 주파수로 다시 검사해도 같은 주파수 (저장 후 다시 적용해도 바뀌지 않음)
+            uint16_t again_hz = 0;
+            mpu6050_check_sample_rate(c->dlpf, actual_hz, &again_hz);
+            HOST_TEST_CHECK(again_hz == actual_hz, "DLPF %u, %u Hz: re-check gives %u Hz",
+                            mpu6050_dlpf_to_hz(c->dlpf), actual_hz, again_hz);
+        }
+    }
+
+    // set_config는 요청값 대신 실제 주파수를 저장
+    mpu6050_handle_t dev = host_test_device();
+    HOST_TEST_CHECK(dev != NULL, "MPU6050 simulator device not created");
+    if (dev == NULL) {
+        return;
+    }
+    mpu6050_config_t saved;
+    mpu6050_config_t config;
+    mpu6050_get_config(dev, &saved);
+
+    config = saved;
+    config.sample_rate_hz = 300;
+    HOST_TEST_CHECK(mpu6050_set_config(dev, &config) == ESP_OK, "set_config 300 Hz failed");
+    mpu6050_get_config(dev, &config);
+    HOST_TEST_CHECK(config.sample_rate_hz == 333, "set_config 300 Hz stored %u Hz", config.sample_rate_hz);
+    printf("  RATE 300 (DLPF %u) -> %u Hz\n", mpu6050_dlpf_to_hz(config.dlpf), config.sample_rate_hz);
+
+    config.dlpf = MPU6050_DLPF_260HZ;
+    config.sample_rate_hz = 20;
+    HOST_TEST_CHECK(mpu6050_set_config(dev, &config) == ESP_ERR_INVALID_ARG, "set_config DLPF 260, 20 Hz accepted");
+
+    HOST_TEST_CHECK(mpu6050_set_config(dev, &saved) == ESP_OK, "restoring config failed");
+}
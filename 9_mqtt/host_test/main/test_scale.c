@@ -0,0 +1,79 @@
+/* 캡처 시점 측정 범위 변환 테스트
+ *
+ * 큐 / 배치 / 스풀에 raw 샘플과 함께 보관한 mpu6050_scale_t로 변환하면 디바이스 설정이 바뀐 뒤에도
+ * 캡처할 때의 감도를 쓰는지, 필터 출력을 같은 범위로 다시 양자화하면 raw 값이 그대로 돌아오는지 확인합니다.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "host_test.h"
+
+static const mpu6050_raw_sample_t test_scale_samples[] = {
+    { .accel_x = 0, .accel_y = 1, .accel_z = -1, .temp = 0, .gyro_x = 131, .gyro_y = -131, .gyro_z = 7 },
+    { .accel_x = 16384, .accel_y = -8192, .accel_z = 2048, .temp = -3400,
+      .gyro_x = 32767, .gyro_y = -32768, .gyro_z = 1000 },
+    { .accel_x = 32767, .accel_y = -32768, .accel_z = 12345, .temp = 3400,
+      .gyro_x = -1, .gyro_y = 1, .gyro_z = -4321 },
+};
+
+void test_scale_run(void)
+{
+    printf("\n== mpu6050_convert_scaled / mpu6050_quantize_samples\n");
+
+    const size_t count = sizeof(test_scale_samples) / sizeof(test_scale_samples[0]);
+    for (int a = MPU6050_ACCEL_RANGE_2G; a <= MPU6050_ACCEL_RANGE_16G; a++) {
+        for (int g = MPU6050_GYRO_RANGE_250; g <= MPU6050_GYRO_RANGE_2000; g++) {
+            const mpu6050_scale_t scale = { .accel_range = a, .gyro_range = g };
+            mpu6050_data_t data[sizeof(test_scale_samples) / sizeof(test_scale_samples[0])];
+            mpu6050_raw_sample_t back[sizeof(test_scale_samples) / sizeof(test_scale_samples[0])];
+
+            mpu6050_convert_scaled(&scale, test_scale_samples, data, count);
+            mpu6050_quantize_samples(&scale, data, back, count);
+            for (size_t i = 0; i < count; i++) {
+                const mpu6050_raw_sample_t *r = &test_scale_samples[i];
+                HOST_TEST_CHECK(back[i].accel_x == r->accel_x && back[i].accel_y == r->accel_y &&
+                                back[i].accel_z == r->accel_z && back[i].temp == r->temp &&
+                                back[i].gyro_x == r->gyro_x && back[i].gyro_y == r->gyro_y &&
+                                back[i].gyro_z == r->gyro_z,
+                                "range %d/%d sample %u: round trip changed raw values", a, g, (unsigned)i);
+            }
+        }
+    }
+
+    // 포화: 범위를 넘는 필터 출력은 int16 끝값
+    const mpu6050_scale_t scale_2g = { .accel_range = MPU6050_ACCEL_RANGE_2G, .gyro_range = MPU6050_GYRO_RANGE_250 };
+    const mpu6050_data_t over = { .accel_x = 3.0f, .accel_y = -3.0f, .gyro_z = 300.0f, .temperature = 36.53f };
+    mpu6050_raw_sample_t sat;
+    mpu6050_quantize_samples(&scale_2g, &over, &sat, 1);
+    HOST_TEST_CHECK(sat.accel_x == 32767 && sat.accel_y == -32768 && sat.gyro_z == 32767 && sat.temp == 0,
+                    "saturation: %d %d %d %d", sat.accel_x, sat.accel_y, sat.gyro_z, sat.temp);
+
+    // 캡처 후 측정 범위가 바뀌어도 스냅샷으로 변환한 값은 캡처할 때의 감도
+    mpu6050_handle_t dev = host_test_device();
+    HOST_TEST_CHECK(dev != NULL, "MPU6050 simulator device not created");
+    if (dev == NULL) {
+        return;
+    }
+    mpu6050_config_t saved;
+    mpu6050_config_t config;
+    mpu6050_scale_t captured;
+    mpu6050_data_t expected;
+    mpu6050_data_t converted;
+    mpu6050_get_config(dev, &saved);
+    mpu6050_get_scale(dev, &captured);
+    mpu6050_convert_samples(dev, &test_scale_samples[1], &expected, 1);
+
+    config = saved;
+    config.accel_range = MPU6050_ACCEL_RANGE_16G;
+    config.gyro_range = MPU6050_GYRO_RANGE_2000;
+    HOST_TEST_CHECK(mpu6050_set_config(dev, &config) == ESP_OK, "set_config 16g / 2000 dps failed");
+    mpu6050_convert_scaled(&captured, &test_scale_samples[1], &converted, 1);
+    HOST_TEST_CHECK(converted.accel_x == expected.accel_x && converted.gyro_z == expected.gyro_z,
+                    "captured scale: accel %.4f g (expected %.4f), gyro %.3f dps (expected %.3f)",
+                    converted.accel_x, expected.accel_x, converted.gyro_z, expected.gyro_z);
+    printf("  raw %d LSB captured at ±%dg -> %.3f g after switching to ±16g\n",
+           test_scale_samples[1].accel_x, 2 << captured.accel_range, converted.accel_x);
+
+    HOST_TEST_CHECK(mpu6050_set_config(dev, &saved) == ESP_OK, "restoring config failed");
+}
@@ -14,12 +14,18 @@
 #include "wifi_handler.h"
 #include "mqtt_handler.h"
 #include "sensor_task.h"
+#include "binlog.h"
 
 /**
  * @brief 메인 함수 - ESP32 부팅 시 자동 실행
  */
 void app_main(void)
 {
+#if BINLOG_ENABLE
+    // 이후의 ESP_LOGx는 문자열 대신 바이너리 레코드로 기록
+    binlog_init();
+#endif
+
     ESP_LOGI(TAG_MAIN, "=== ESP32 Sensor MQTT System Started ===");
     ESP_LOGI(TAG_MAIN, "Free memory: %" PRIu32 " bytes", esp_get_free_heap_size());
     ESP_LOGI(TAG_MAIN, "IDF version: %s", esp_get_idf_version());
@@ -0,0 +1,505 @@
+/* 바이너리 로그 구현 */
+
+#include "binlog.h"
+#include "command_handler.h"
+#include "mqtt_handler.h"
+#include "metrics.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#define BINLOG_IN_FLASH(ptr) false      // 호스트는 모든 문자열을 복사
+#else
+#include "esp_memory_utils.h"
+#define BINLOG_IN_FLASH(ptr) esp_ptr_in_drom(ptr)
+#endif
+
+#if portNUM_PROCESSORS > 1
+#define BINLOG_CORE BINLOG_TASK_CORE
+#else
+#define BINLOG_CORE 0
+#endif
+
+_Static_assert((BINLOG_RING_SIZE & (BINLOG_RING_SIZE - 1)) == 0, "BINLOG_RING_SIZE must be a power of two");
+_Static_assert(BINLOG_MAX_RECORD % 4 == 0 && BINLOG_MAX_RECORD <= BINLOG_FRAME_SIZE - 16,
+               "BINLOG_MAX_RECORD must be a multiple of 4 and fit in a frame");
+
+#define BINLOG_VERSION 1
+#define BINLOG_STATE_RECORD 1           // 기록 완료 (0: 예약만 되어 아직 쓰는 중)
+#define BINLOG_STATE_PAD 2              // 링 끝의 빈자리 (다음 레코드는 링 처음부터)
+#define BINLOG_STRING_IN_FLASH 0xFF     // %s 길이 자리: 뒤에 주소
+#define BINLOG_FRAME_HEADER_SIZE (8 + sizeof(void *))
+#define BINLOG_LINE_PREFIX "BINLOG:"
+#define BINLOG_LINE_SIZE (sizeof(BINLOG_LINE_PREFIX) + (BINLOG_FRAME_SIZE + 2) / 3 * 4 + 1)
+
+// 디코더가 ELF 심볼 주소와 비교해 빌드가 맞는지 / 주소 이동(호스트 PIE)을 확인
+static const char binlog_anchor[] = "binlog";
+
+// 링 (생산자는 head를 CAS로 예약, 로그 태스크만 tail을 옮김, 위치는 증가만 하고 & (크기 - 1)로 접근)
+static uint8_t ring[BINLOG_RING_SIZE] __attribute__((aligned(4)));
+static uint32_t head = 0;
+static uint32_t tail = 0;
+
+// 통계 (여러 태스크에서 원자적으로 증가)
+static uint32_t stat_records = 0;
+static uint32_t stat_dropped = 0;
+static uint32_t stat_truncated = 0;
+static uint32_t stat_peak = 0;
+
+// 로그 태스크에서만 사용
+static uint8_t frame[BINLOG_FRAME_SIZE] __attribute__((aligned(4)));
+static char line[BINLOG_LINE_SIZE];
+static uint32_t stat_frames = 0;
+static uint32_t stat_bytes = 0;
+static uint32_t stat_mqtt_frames = 0;
+
+static vprintf_like_t text_vprintf = NULL;     // 원래 출력 함수
+static volatile bool binary_enabled = false;
+static volatile int output_mode = BINLOG_OUTPUT;
+
+// 레코드 작성 위치 (로그를 남기는 태스크의 스택)
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    uint8_t flags;
+    bool full;          // 자리가 없어 이후 인자는 기록하지 않음
+} binlog_writer_t;
+
+/**
+ * @brief 인자 추가 (자리가 없으면 잘림 표시)
+ */
+static inline bool binlog_put(binlog_writer_t *w, const void *data, size_t size)
+{
+    if (w->len + size > BINLOG_MAX_RECORD) {
+        w->flags |= BINLOG_FLAG_TRUNCATED;
+        w->full = true;
+        return false;
+    }
+    memcpy(w->buf + w->len, data, size);
+    w->len += size;
+    return true;
+}
+
+/**
+ * @brief %s 인자 추가 (플래시 문자열은 주소, RAM 문자열은 내용 복사)
+ *
+ * @param precision %.Ns의 N (없으면 -1, 이때만 주소로 기록 가능)
+ */
+static void binlog_put_string(binlog_writer_t *w, const char *str, int precision)
+{
+    if (str == NULL) {
+        str = "(null)";
+    }
+    if (precision < 0 && BINLOG_IN_FLASH(str)) {
+        const uint8_t marker = BINLOG_STRING_IN_FLASH;
+        if (w->len + 1 + sizeof(str) <= BINLOG_MAX_RECORD) {
+            binlog_put(w, &marker, 1);
+            binlog_put(w, &str, sizeof(str));
+            return;
+        }
+    }
+
+    size_t limit = BINLOG_MAX_STRING;
+    if (precision >= 0 && (size_t)precision < limit) {
+        limit = precision;
+    }
+    if (w->len + 1 + limit > BINLOG_MAX_RECORD) {
+        limit = w->len + 1 < BINLOG_MAX_RECORD ? BINLOG_MAX_RECORD - w->len - 1 : 0;
+    }
+    const size_t n = strnlen(str, limit);
+    if (n == limit && (precision < 0 || n < (size_t)precision) && str[n] != '\0') {
+        w->flags |= BINLOG_FLAG_TRUNCATED;
+    }
+    const uint8_t len = n;
+    if (binlog_put(w, &len, 1)) {
+        binlog_put(w, str, n);
+    }
+}
+
+/**
+ * @brief 형식 문자열을 따라가며 인자 원본 기록 (문자열은 만들지 않음)
+ *
+ * 변환 지정자는 %[플래그][폭][.정밀도][hh|h|l|ll|q|j|z|t|L]<diouxXcsfFeEgGaApn>만 지원하고,
+ * 모르는 지정자를 만나면 거기서 멈춥니다 (디코더도 같은 규칙).
+ */
+static void binlog_put_args(binlog_writer_t *w, const char *p, va_list args)
+{
+    while ((p = strchr(p, '%')) != NULL) {
+        p++;
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+            p++;
+        }
+        if (*p == '*') {
+            const int width = va_arg(args, int);
+            binlog_put(w, &width, sizeof(width));
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+        int precision = -1;
+        if (*p == '.') {
+            p++;
+            precision = 0;
+            if (*p == '*') {
+                precision = va_arg(args, int);
+                binlog_put(w, &precision, sizeof(precision));
+                p++;
+            }
+            while (*p >= '0' && *p <= '9') {
+                precision = precision * 10 + (*p++ - '0');
+            }
+        }
+
+        char length = 0;        // 'H': hh, 'Q': ll / q
+        if (*p == 'h' || *p == 'l') {
+            length = *p++;
+            if (*p == length) {
+                length = length == 'h' ? 'H' : 'Q';
+                p++;
+            }
+        } else if (*p == 'q' || *p == 'j' || *p == 'z' || *p == 't' || *p == 'L') {
+            length = *p == 'q' ? 'Q' : *p;
+            p++;
+        }
+
+        switch (*p++) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+            if (length == 'l') {
+                const unsigned long value = va_arg(args, unsigned long);
+                binlog_put(w, &value, sizeof(value));
+            } else if (length == 'Q') {
+                const unsigned long long value = va_arg(args, unsigned long long);
+                binlog_put(w, &value, sizeof(value));
+            } else if (length == 'j') {
+                const uintmax_t value = va_arg(args, uintmax_t);
+                binlog_put(w, &value, sizeof(value));
+            } else if (length == 'z') {
+                const size_t value = va_arg(args, size_t);
+                binlog_put(w, &value, sizeof(value));
+            } else if (length == 't') {
+                const ptrdiff_t value = va_arg(args, ptrdiff_t);
+                binlog_put(w, &value, sizeof(value));
+            } else {
+                const unsigned int value = va_arg(args, unsigned int);
+                binlog_put(w, &value, sizeof(value));
+            }
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+            const double value = length == 'L' ? (double)va_arg(args, long double) : va_arg(args, double);
+            binlog_put(w, &value, sizeof(value));
+            break;
+        }
+        case 's':
+            binlog_put_string(w, va_arg(args, const char *), precision);
+            break;
+        case 'p': {
+            const void *value = va_arg(args, const void *);
+            binlog_put(w, &value, sizeof(value));
+            break;
+        }
+        case 'n':
+            (void)va_arg(args, void *);
+            break;
+        default:
+            w->flags |= BINLOG_FLAG_TRUNCATED;
+            return;
+        }
+        if (w->full) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 레코드 헤더를 마지막에 써서 로그 태스크에 공개
+ */
+static inline void binlog_commit(uint8_t *record, uint32_t size, uint32_t state, uint32_t flags)
+{
+    __atomic_store_n((uint32_t *)record, size | (state << 16) | (flags << 24), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief 링에 자리 예약 (잠금 없음, 링 끝에 들어가지 않으면 빈자리 레코드를 두고 처음부터)
+ *
+ * @return 레코드 위치, 자리가 없으면 NULL
+ */
+static uint8_t *binlog_reserve(uint32_t size)
+{
+    uint32_t h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    uint32_t offset;
+    uint32_t pad;
+
+    do {
+        offset = h & (BINLOG_RING_SIZE - 1);
+        pad = offset + size > BINLOG_RING_SIZE ? BINLOG_RING_SIZE - offset : 0;
+        if (h + pad + size - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) > BINLOG_RING_SIZE) {
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&head, &h, h + pad + size, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (pad > 0) {
+        binlog_commit(&ring[offset], pad, BINLOG_STATE_PAD, 0);
+        offset = 0;
+    }
+    return &ring[offset];
+}
+
+/**
+ * @brief ESP_LOGx 출력 함수 (esp_log_set_vprintf, 로그를 남기는 태스크에서 호출)
+ *
+ * format은 LOG_FORMAT()으로 합쳐진 "I (%lu) %s: ...\n" 전체이고 플래시에 있으므로 주소만 기록합니다.
+ */
+static int binlog_vprintf(const char *format, va_list args)
+{
+    uint8_t buf[BINLOG_MAX_RECORD] __attribute__((aligned(4)));
+    binlog_writer_t w = { .buf = buf, .len = 4, .flags = 0, .full = false };
+    const uint32_t now_us = (uint32_t)esp_timer_get_time();
+    va_list copy;
+
+    binlog_put(&w, &format, sizeof(format));
+    binlog_put(&w, &now_us, sizeof(now_us));
+    va_copy(copy, args);
+    binlog_put_args(&w, format, copy);
+    va_end(copy);
+
+    const uint32_t size = (w.len + 3) & ~3u;
+    uint8_t *record = binlog_reserve(size);
+    if (record == NULL) {
+        __atomic_fetch_add(&stat_dropped, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    memcpy(record + 4, buf + 4, w.len - 4);
+    binlog_commit(record, size, BINLOG_STATE_RECORD, w.flags);
+
+    __atomic_fetch_add(&stat_records, 1, __ATOMIC_RELAXED);
+    if (w.flags & BINLOG_FLAG_TRUNCATED) {
+        __atomic_fetch_add(&stat_truncated, 1, __ATOMIC_RELAXED);
+    }
+    return size;
+}
+
+/**
+ * @brief base64 인코딩 (UART 줄)
+ *
+ * @return 문자 수
+ */
+static size_t binlog_base64(const uint8_t *data, size_t len, char *out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i += 3) {
+        const uint32_t v = (uint32_t)data[i] << 16 | (i + 1 < len ? data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+        out[n++] = alphabet[(v >> 18) & 0x3F];
+        out[n++] = alphabet[(v >> 12) & 0x3F];
+        out[n++] = i + 1 < len ? alphabet[(v >> 6) & 0x3F] : '=';
+        out[n++] = i + 2 < len ? alphabet[v & 0x3F] : '=';
+    }
+    return n;
+}
+
+/**
+ * @brief 프레임 내보내기 (MQTT가 안 되면 UART)
+ */
+static void binlog_send_frame(size_t len)
+{
+    const uint32_t dropped = __atomic_load_n(&stat_dropped, __ATOMIC_RELAXED);
+    memcpy(frame + 4, &dropped, sizeof(dropped));
+
+    stat_frames++;
+    stat_bytes += len;
+    if (output_mode == BINLOG_OUTPUT_MQTT && mqtt_publish_log(frame, len)) {
+        stat_mqtt_frames++;
+        return;
+    }
+
+    size_t n = strlen(BINLOG_LINE_PREFIX);
+    memcpy(line, BINLOG_LINE_PREFIX, n);
+    n += binlog_base64(frame, len, line + n);
+    line[n++] = '\n';
+    fwrite(line, 1, n, stdout);
+    fflush(stdout);
+}
+
+/**
+ * @brief 링 비우기 (다 쓴 레코드를 프레임에 모으고, 읽은 자리는 0으로 지워 다음 바퀴의 상태 표시와 섞이지 않게 함)
+ */
+static void binlog_drain(void)
+{
+    const uint32_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    uint32_t t = tail;
+    size_t len = BINLOG_FRAME_HEADER_SIZE;
+
+    if (h - t > stat_peak) {
+        stat_peak = h - t;
+    }
+
+    while (t != h) {
+        uint8_t *record = &ring[t & (BINLOG_RING_SIZE - 1)];
+        const uint32_t header = __atomic_load_n((uint32_t *)record, __ATOMIC_ACQUIRE);
+        const uint32_t size = header & 0xFFFF;
+        const uint32_t state = (header >> 16) & 0xFF;
+        if (state == 0) {
+            break;      // 예약한 태스크가 아직 쓰는 중 (다음 주기에 이어서)
+        }
+
+        if (state == BINLOG_STATE_RECORD) {
+            if (len + size > BINLOG_FRAME_SIZE) {
+                binlog_send_frame(len);
+                len = BINLOG_FRAME_HEADER_SIZE;
+            }
+            memcpy(frame + len, record, size);
+            len += size;
+        }
+        memset(record, 0, size);
+        t += size;
+        __atomic_store_n(&tail, t, __ATOMIC_RELEASE);
+    }
+
+    if (len > BINLOG_FRAME_HEADER_SIZE) {
+        binlog_send_frame(len);
+    }
+}
+
+/**
+ * @brief 로그 태스크
+ */
+static void binlog_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(BINLOG_DRAIN_PERIOD_MS));
+        binlog_drain();
+    }
+}
+
+/**
+ * @brief LOG (조회), LOG:<TEXT|BINARY>, LOG:<UART|MQTT>
+ */
+static esp_err_t binlog_cmd_log(const command_t *cmd, char *response, size_t size)
+{
+    if (cmd->args != NULL) {
+        if (strcmp(cmd->args, "TEXT") == 0 || strcmp(cmd->args, "BINARY") == 0) {
+            binlog_set_binary(cmd->args[0] == 'B');
+        } else if (strcmp(cmd->args, "UART") == 0 || strcmp(cmd->args, "MQTT") == 0) {
+            binlog_set_output(cmd->args[0] == 'M' ? BINLOG_OUTPUT_MQTT : BINLOG_OUTPUT_UART);
+        } else {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    binlog_stats_t stats;
+    binlog_get_stats(&stats);
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"log\":{\"mode\":\"%s\",\"output\":\"%s\",\"records\":%lu,\"dropped\":%lu,"
+             "\"truncated\":%lu,\"peak\":%lu,\"ring\":%d,\"frames\":%lu,\"mqtt_frames\":%lu,\"bytes\":%lu}}",
+             stats.binary ? "binary" : "text", stats.output == BINLOG_OUTPUT_MQTT ? "mqtt" : "uart",
+             (unsigned long)stats.records, (unsigned long)stats.dropped, (unsigned long)stats.truncated,
+             (unsigned long)stats.peak_bytes, BINLOG_RING_SIZE, (unsigned long)stats.frames,
+             (unsigned long)stats.mqtt_frames, (unsigned long)stats.bytes);
+    return ESP_OK;
+}
+
+static const command_def_t binlog_commands[] = {
+    { "LOG", binlog_cmd_log },
+};
+
+/**
+ * @brief 링과 로그 태스크 생성, ESP_LOGx 출력 전환
+ */
+esp_err_t binlog_init(void)
+{
+    TaskHandle_t task = NULL;
+
+    // 프레임 머리 (버린 로그 수는 보낼 때마다 갱신)
+    const uintptr_t anchor = (uintptr_t)binlog_anchor;
+    frame[0] = 'B';
+    frame[1] = 'L';
+    frame[2] = BINLOG_VERSION;
+    frame[3] = sizeof(void *);
+    memcpy(frame + 8, &anchor, sizeof(anchor));
+
+#if APP_STATIC_ALLOC
+    static StaticTask_t task_buffer;
+    static StackType_t task_stack[BINLOG_TASK_STACK_SIZE / sizeof(StackType_t)];
+    task = xTaskCreateStaticPinnedToCore(binlog_task, "binlog_task", BINLOG_TASK_STACK_SIZE, NULL,
+                                         BINLOG_TASK_PRIORITY, task_stack, &task_buffer, BINLOG_CORE);
+#else
+    xTaskCreatePinnedToCore(binlog_task, "binlog_task", BINLOG_TASK_STACK_SIZE, NULL,
+                            BINLOG_TASK_PRIORITY, &task, BINLOG_CORE);
+#endif
+    if (task == NULL) {
+        ESP_LOGE(TAG_MAIN, "Failed to create binlog task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    command_register(binlog_commands, sizeof(binlog_commands) / sizeof(binlog_commands[0]));
+    metrics_register_task(task);
+    metrics_add_ram_budget("binlog", sizeof(ring) + sizeof(frame) + sizeof(line) + BINLOG_TASK_STACK_SIZE +
+                                     sizeof(StaticTask_t));
+
+    ESP_LOGI(TAG_MAIN, "Binary log enabled (ring %d bytes, output %s), decode with tools/binlog_decode.py",
+             BINLOG_RING_SIZE, output_mode == BINLOG_OUTPUT_MQTT ? MQTT_TOPIC_LOG : "UART");
+    binlog_set_binary(true);
+    return ESP_OK;
+}
+
+/**
+ * @brief ESP_LOGx 출력 전환
+ */
+void binlog_set_binary(bool binary)
+{
+    if (binary == binary_enabled) {
+        return;
+    }
+    if (binary) {
+        text_vprintf = esp_log_set_vprintf(binlog_vprintf);
+    } else {
+        esp_log_set_vprintf(text_vprintf);
+    }
+    binary_enabled = binary;
+}
+
+/**
+ * @brief 출력 경로 설정
+ */
+esp_err_t binlog_set_output(int output)
+{
+    if (output != BINLOG_OUTPUT_UART && output != BINLOG_OUTPUT_MQTT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    output_mode = output;
+    return ESP_OK;
+}
+
+/**
+ * @brief 바이너리 로그 통계 조회
+ */
+void binlog_get_stats(binlog_stats_t *stats)
+{
+    stats->records = __atomic_load_n(&stat_records, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&stat_dropped, __ATOMIC_RELAXED);
+    stats->truncated = __atomic_load_n(&stat_truncated, __ATOMIC_RELAXED);
+    stats->peak_bytes = stat_peak;
+    stats->frames = stat_frames;
+    stats->bytes = stat_bytes;
+    stats->mqtt_frames = stat_mqtt_frames;
+    stats->binary = binary_enabled;
+    stats->output = output_mode;
+}
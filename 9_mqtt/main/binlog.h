@@ -0,0 +1,71 @@
+/* 바이너리 로그 헤더
+ * ESP_LOGx 출력을 가로채(esp_log_set_vprintf) 문자열을 만들지 않고 형식 문자열 주소, 시각, 인자 원본만
+ * 잠금 없는 RAM 링에 기록합니다. 로그 태스크가 링을 비워 UART 또는 MQTT_TOPIC_LOG로 내보내고,
+ * 수신 쪽 tools/binlog_decode.py가 빌드한 ELF에서 형식 문자열을 찾아 원래 로그 줄을 복원합니다.
+ * 기존 ESP_LOGI(TAG_SENSOR, ...) 호출은 그대로 사용합니다 (태그 / 레벨 필터도 그대로).
+ *
+ * 레코드 (4바이트 정렬, 리틀 엔디언):
+ *   uint32 헤더     bit 0-15 크기(헤더 포함), bit 16-23 상태, bit 24-31 BINLOG_FLAG_*
+ *   형식 문자열 주소 (포인터 크기)
+ *   uint32 시각     esp_timer µs 하위 32비트
+ *   인자            정수 / 포인터는 C 타입 크기 그대로, 실수는 double 8바이트,
+ *                   %s는 길이(1바이트) + 내용, 플래시 문자열은 0xFF + 주소
+ *
+ * 프레임 (UART 줄 하나 / MQTT 메시지 하나):
+ *   "BL", 버전(1), 포인터 크기, uint32 누적 버린 로그 수, binlog_anchor 주소, 레코드...
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define BINLOG_FLAG_TRUNCATED 0x01      // 레코드가 BINLOG_MAX_RECORD를 넘거나 문자열이 잘림
+
+// 바이너리 로그 통계 (누적)
+typedef struct {
+    uint32_t records;       // 기록한 로그 수
+    uint32_t dropped;       // 링이 가득 차서 버린 로그 수
+    uint32_t truncated;     // 인자 / 문자열이 잘린 로그 수
+    uint32_t peak_bytes;    // 링 최대 사용량 (바이트)
+    uint32_t frames;        // 내보낸 프레임 수
+    uint32_t bytes;         // 내보낸 바이트 수 (base64 / MQTT 헤더 제외)
+    uint32_t mqtt_frames;   // 그중 MQTT로 보낸 프레임 수
+    bool binary;            // 현재 ESP_LOGx가 바이너리 로그로 가는지
+    uint8_t output;         // BINLOG_OUTPUT_UART / BINLOG_OUTPUT_MQTT
+} binlog_stats_t;
+
+/**
+ * @brief 링과 로그 태스크를 만들고 ESP_LOGx 출력을 바이너리 로그로 전환 (app_main 맨 앞에서 호출)
+ *
+ * LOG 명령(조회 / 전환)도 명령 등록 표에 추가합니다.
+ *
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NO_MEM 태스크 생성 실패
+ */
+esp_err_t binlog_init(void);
+
+/**
+ * @brief ESP_LOGx 출력 전환
+ *
+ * @param binary true: 바이너리 로그, false: 원래 문자열 출력 (링에 남은 로그는 계속 내보냄)
+ */
+void binlog_set_binary(bool binary);
+
+/**
+ * @brief 출력 경로 설정
+ *
+ * @param output BINLOG_OUTPUT_UART 또는 BINLOG_OUTPUT_MQTT
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 잘못된 값
+ */
+esp_err_t binlog_set_output(int output);
+
+/**
+ * @brief 바이너리 로그 통계 조회
+ *
+ * @param stats 결과를 저장할 포인터
+ */
+void binlog_get_stats(binlog_stats_t *stats);
+
+#endif // BINLOG_H
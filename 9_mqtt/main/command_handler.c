@@ -0,0 +1,423 @@
+/* 명령 처리 구현 */
+
+#include "command_handler.h"
+#include "metrics.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#define COMMAND_MAX_TABLES 8     // 명령을 등록하는 모듈 수 (mqtt, sensor, spool, command, binlog)
+#define COMMAND_ID_PREFIX_SIZE 48   // "id":<번호>,"apply_us":<µs>, (응답 앞에 끼움)
+#define COMMAND_REJECT_QUEUE_LENGTH 2   // 명령 태스크가 보낼 거절 응답 (넘으면 응답 없이 통계에만 기록)
+
+#if portNUM_PROCESSORS > 1
+#define COMMAND_CORE COMMAND_TASK_CORE
+#else
+#define COMMAND_CORE 0
+#endif
+
+// 명령 슬롯 (MQTT 태스크가 채우고 명령 태스크가 비움, 작업 큐 / 빈 슬롯 큐로 주고받음)
+typedef struct {
+    char text[COMMAND_MAX_LEN + 1];
+    size_t len;                 // 지금까지 받은 길이
+    size_t total_len;
+    int64_t received_us;
+} command_slot_t;
+
+// 거절한 명령 (MQTT 태스크는 발행하지 않고 명령 태스크가 응답)
+typedef struct {
+    const char *reason;
+    int total_len;
+} command_reject_t;
+
+static command_slot_t slots[COMMAND_QUEUE_LENGTH];
+static QueueHandle_t free_queue = NULL;    // 빈 슬롯 번호
+static QueueHandle_t work_queue = NULL;    // 다 모인 슬롯 번호
+static QueueHandle_t reject_queue = NULL;  // 거절 응답
+static TaskHandle_t command_task_handle = NULL;    // 작업 / 거절을 넣은 뒤 깨움
+
+// 조각을 모으는 중인 슬롯 (MQTT 태스크에서만 접근)
+static command_slot_t *assembling = NULL;
+static bool skipping = false;               // 거절한 메시지의 나머지 조각 건너뛰기
+
+// 등록 표 (초기화 중에만 추가)
+static const command_def_t *tables[COMMAND_MAX_TABLES];
+static size_t table_sizes[COMMAND_MAX_TABLES];
+static size_t table_count = 0;
+
+static command_respond_fn_t respond_fn = NULL;
+static command_stats_t stats;
+static uint32_t next_id = 1;               // ";id="가 없는 명령에 매기는 번호 (명령 태스크)
+static char response[COMMAND_RESPONSE_SIZE];   // 명령 태스크에서만 사용
+
+/**
+ * @brief 슬롯 번호
+ */
+static inline uint8_t command_slot_index(const command_slot_t *slot)
+{
+    return (uint8_t)(slot - slots);
+}
+
+/**
+ * @brief 거절 응답을 명령 태스크로 넘김 (MQTT 태스크)
+ *
+ * 이벤트 핸들러는 클라이언트 잠금을 쥔 채 호출되므로 여기서 발행하지 않습니다 (발행 잠금과 교착).
+ */
+static void command_reject(const char *reason, int total_len)
+{
+    const command_reject_t reject = {
+        .reason = reason,
+        .total_len = total_len,
+    };
+
+    ESP_LOGW(TAG_MQTT, "Command rejected (%s, %d bytes)", reason, total_len);
+    if (reject_queue != NULL && xQueueSend(reject_queue, &reject, 0) == pdTRUE) {
+        xTaskNotifyGive(command_task_handle);
+    }
+}
+
+/**
+ * @brief 거절 응답 발행 (명령 태스크)
+ */
+static void command_send_reject(const command_reject_t *reject)
+{
+    char out[96];
+    snprintf(out, sizeof(out), "{\"status\":\"error\",\"reason\":\"%s\",\"length\":%d}", reject->reason,
+             reject->total_len);
+    respond_fn(out);
+}
+
+/**
+ * @brief 수신한 명령 조각 추가
+ */
+void command_receive(const char *data, int len, int offset, int total_len)
+{
+    if (offset == 0) {
+        if (assembling != NULL) {
+            // 이전 메시지의 나머지 조각이 오지 않음
+            stats.incomplete++;
+            uint8_t index = command_slot_index(assembling);
+            xQueueSend(free_queue, &index, 0);
+            assembling = NULL;
+        }
+        skipping = false;
+
+        uint8_t index;
+        if (total_len > COMMAND_MAX_LEN) {
+            stats.too_long++;
+            skipping = true;
+            command_reject("too_long", total_len);
+            return;
+        }
+        if (free_queue == NULL || xQueueReceive(free_queue, &index, 0) != pdTRUE) {
+            stats.busy++;
+            skipping = true;
+            command_reject("busy", total_len);
+            return;
+        }
+        assembling = &slots[index];
+        assembling->len = 0;
+        assembling->total_len = total_len;
+    }
+
+    if (skipping) {
+        return;
+    }
+    if (assembling == NULL || offset != (int)assembling->len || offset + len > (int)assembling->total_len) {
+        // 첫 조각을 놓쳤거나 순서가 맞지 않음
+        ESP_LOGW(TAG_MQTT, "Dropping out-of-order command fragment (offset %d)", offset);
+        if (assembling != NULL) {
+            stats.incomplete++;
+            uint8_t index = command_slot_index(assembling);
+            xQueueSend(free_queue, &index, 0);
+            assembling = NULL;
+        }
+        skipping = true;
+        return;
+    }
+
+    memcpy(assembling->text + offset, data, len);
+    assembling->len += len;
+    if (assembling->len < assembling->total_len) {
+        return;
+    }
+
+    // 다 모임 (슬롯 수와 큐 길이가 같으므로 넣기는 실패하지 않음)
+    assembling->text[assembling->len] = '\0';
+    assembling->received_us = esp_timer_get_time();
+    if (offset > 0) {
+        stats.fragmented++;
+    }
+    stats.received++;
+    uint8_t index = command_slot_index(assembling);
+    xQueueSend(work_queue, &index, 0);
+    xTaskNotifyGive(command_task_handle);
+    assembling = NULL;
+}
+
+/**
+ * @brief 등록 표에서 이름 찾기
+ */
+static command_fn_t command_lookup(const char *name)
+{
+    for (size_t t = 0; t < table_count; t++) {
+        for (size_t i = 0; i < table_sizes[t]; i++) {
+            if (strcmp(tables[t][i].name, name) == 0) {
+                return tables[t][i].handler;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 슬롯의 명령 실행 후 응답 발행 (명령 태스크)
+ */
+static void command_execute(command_slot_t *slot)
+{
+    command_t cmd = {
+        .text = slot->text,
+        .name = slot->text,
+        .args = NULL,
+        .received_us = slot->received_us,
+    };
+
+    // 끝의 공백 / 줄바꿈 제거 (mosquitto_pub -l 등)
+    size_t len = slot->len;
+    while (len > 0 && (slot->text[len - 1] == '\n' || slot->text[len - 1] == '\r' || slot->text[len - 1] == ' ')) {
+        slot->text[--len] = '\0';
+    }
+
+    // ";id=<번호>" 옵션
+    char *options = strchr(slot->text, ';');
+    bool has_id = false;
+    if (options != NULL) {
+        *options++ = '\0';
+        has_id = strncmp(options, "id=", 3) == 0 && command_parse_u32(options + 3, UINT32_MAX, &cmd.id);
+    }
+    if (!has_id) {
+        cmd.id = next_id++;
+    }
+
+    char *sep = strchr(slot->text, ':');
+    char *name_end = sep ? sep : slot->text + strlen(slot->text);
+    char saved = *name_end;
+    *name_end = '\0';
+    command_fn_t handler = command_lookup(cmd.name);
+    if (sep != NULL) {
+        cmd.args = sep + 1;
+    } else {
+        *name_end = saved;
+    }
+
+    // 응답 앞에 번호 / 처리 시간을 끼울 자리를 남기고 처리
+    char *body = response + COMMAND_ID_PREFIX_SIZE;
+    const size_t body_size = sizeof(response) - COMMAND_ID_PREFIX_SIZE;
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    body[0] = '\0';
+    if (handler != NULL) {
+        ret = handler(&cmd, body, body_size);
+    } else {
+        stats.unknown++;
+    }
+    if (sep != NULL) {
+        *sep = ':';     // 오류 응답에 명령 전체를 다시 쓰도록
+    }
+    if (ret != ESP_OK && body[0] == '\0') {
+        ESP_LOGW(TAG_MQTT, "%s command: %.64s", handler ? "Invalid" : "Unknown", cmd.text);
+        snprintf(body, body_size, "{\"status\":\"error\",\"command\":\"%.64s\"%s}", cmd.text,
+                 handler ? "" : ",\"reason\":\"unknown\"");
+    }
+
+    const uint32_t apply_us = (uint32_t)(esp_timer_get_time() - cmd.received_us);
+    if (apply_us > stats.max_apply_us) {
+        stats.max_apply_us = apply_us;
+    }
+    if (body[0] != '{') {
+        return;     // 응답 없음 (PONG, CALIBRATE는 나중에 센서 태스크가 응답)
+    }
+
+    // {"id":7,"apply_us":153, + 처리 함수 응답의 '{' 뒤
+    char prefix[COMMAND_ID_PREFIX_SIZE + 1];
+    int prefix_len = snprintf(prefix, sizeof(prefix), "{\"id\":%lu,\"apply_us\":%lu%s", (unsigned long)cmd.id,
+                              (unsigned long)apply_us, body[1] == '}' ? "" : ",");
+    char *out = body + 1 - prefix_len;
+    memcpy(out, prefix, prefix_len);
+    ESP_LOGI(TAG_MQTT, "Command %lu (%s) applied in %lu us", (unsigned long)cmd.id, cmd.name, (unsigned long)apply_us);
+    respond_fn(out);
+}
+
+/**
+ * @brief 명령 태스크 (작업 / 거절을 넣을 때마다 알림으로 깨어나 두 큐를 비움)
+ */
+static void command_task(void *pvParameters)
+{
+    command_reject_t reject;
+    uint8_t index;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (xQueueReceive(reject_queue, &reject, 0) == pdTRUE) {
+            command_send_reject(&reject);
+        }
+        while (xQueueReceive(work_queue, &index, 0) == pdTRUE) {
+            command_execute(&slots[index]);
+            xQueueSend(free_queue, &index, 0);
+        }
+    }
+}
+
+/**
+ * @brief CMD_STATS (명령 수신 / 거절 통계)
+ */
+static esp_err_t command_cmd_stats(const command_t *cmd, char *response, size_t size)
+{
+    command_stats_t snapshot;
+    command_get_stats(&snapshot);
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"commands\":{\"received\":%lu,\"fragmented\":%lu,\"busy\":%lu,\"too_long\":%lu,"
+             "\"incomplete\":%lu,\"unknown\":%lu,\"max_apply_us\":%lu}}",
+             (unsigned long)snapshot.received, (unsigned long)snapshot.fragmented, (unsigned long)snapshot.busy,
+             (unsigned long)snapshot.too_long, (unsigned long)snapshot.incomplete, (unsigned long)snapshot.unknown,
+             (unsigned long)snapshot.max_apply_us);
+    return ESP_OK;
+}
+
+static const command_def_t command_commands[] = {
+    { "CMD_STATS", command_cmd_stats },
+};
+
+/**
+ * @brief 명령 슬롯 / 작업 큐 / 명령 태스크 생성
+ */
+esp_err_t command_init(command_respond_fn_t respond)
+{
+    TaskHandle_t task = NULL;
+
+    respond_fn = respond;
+
+#if APP_STATIC_ALLOC
+    static StaticQueue_t free_queue_buffer;
+    static StaticQueue_t work_queue_buffer;
+    static uint8_t free_queue_storage[COMMAND_QUEUE_LENGTH];
+    static uint8_t work_queue_storage[COMMAND_QUEUE_LENGTH];
+    static StaticQueue_t reject_queue_buffer;
+    static uint8_t reject_queue_storage[COMMAND_REJECT_QUEUE_LENGTH * sizeof(command_reject_t)];
+    static StaticTask_t task_buffer;
+    static StackType_t task_stack[COMMAND_TASK_STACK_SIZE / sizeof(StackType_t)];
+
+    free_queue = xQueueCreateStatic(COMMAND_QUEUE_LENGTH, sizeof(uint8_t), free_queue_storage, &free_queue_buffer);
+    work_queue = xQueueCreateStatic(COMMAND_QUEUE_LENGTH, sizeof(uint8_t), work_queue_storage, &work_queue_buffer);
+    reject_queue = xQueueCreateStatic(COMMAND_REJECT_QUEUE_LENGTH, sizeof(command_reject_t), reject_queue_storage,
+                                      &reject_queue_buffer);
+#else
+    free_queue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(uint8_t));
+    work_queue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(uint8_t));
+    reject_queue = xQueueCreate(COMMAND_REJECT_QUEUE_LENGTH, sizeof(command_reject_t));
+#endif
+    if (free_queue == NULL || work_queue == NULL || reject_queue == NULL) {
+        ESP_LOGE(TAG_MQTT, "Failed to create command queues");
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint8_t i = 0; i < COMMAND_QUEUE_LENGTH; i++) {
+        xQueueSend(free_queue, &i, 0);
+    }
+
+#if APP_STATIC_ALLOC
+    task = xTaskCreateStaticPinnedToCore(command_task, "command_task", COMMAND_TASK_STACK_SIZE, NULL,
+                                         COMMAND_TASK_PRIORITY, task_stack, &task_buffer, COMMAND_CORE);
+#else
+    xTaskCreatePinnedToCore(command_task, "command_task", COMMAND_TASK_STACK_SIZE, NULL,
+                            COMMAND_TASK_PRIORITY, &task, COMMAND_CORE);
+#endif
+    if (task == NULL) {
+        ESP_LOGE(TAG_MQTT, "Failed to create command task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    command_task_handle = task;
+    command_register(command_commands, sizeof(command_commands) / sizeof(command_commands[0]));
+    metrics_register_task(task);
+    metrics_add_ram_budget("command", sizeof(slots) + sizeof(response) + COMMAND_TASK_STACK_SIZE +
+                                      2 * (COMMAND_QUEUE_LENGTH + sizeof(StaticQueue_t)) +
+                                      COMMAND_REJECT_QUEUE_LENGTH * sizeof(command_reject_t) + sizeof(StaticQueue_t) +
+                                      sizeof(StaticTask_t));
+    return ESP_OK;
+}
+
+/**
+ * @brief 명령 등록 표 추가
+ */
+esp_err_t command_register(const command_def_t *defs, size_t count)
+{
+    if (table_count >= COMMAND_MAX_TABLES) {
+        return ESP_ERR_NO_MEM;
+    }
+    tables[table_count] = defs;
+    table_sizes[table_count] = count;
+    table_count++;
+    return ESP_OK;
+}
+
+/**
+ * @brief 인자 목록에서 다음 "키=값" 꺼내기
+ */
+bool command_next_pair(char **cursor, const char **key, const char **value)
+{
+    char *item = *cursor;
+    if (item == NULL || *item == '\0') {
+        return false;
+    }
+
+    char *next = strchr(item, ',');
+    if (next != NULL) {
+        *next++ = '\0';
+    }
+    *cursor = next;
+
+    char *eq = strchr(item, '=');
+    if (eq != NULL) {
+        *eq++ = '\0';
+    }
+    *key = item;
+    *value = eq ? eq : "";
+    return true;
+}
+
+/**
+ * @brief 10진수 부호 없는 정수 변환
+ */
+bool command_parse_u32(const char *text, uint32_t max, uint32_t *value)
+{
+    uint64_t result = 0;
+
+    if (text == NULL || *text == '\0') {
+        return false;
+    }
+    for (; *text != '\0'; text++) {
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+        result = result * 10 + (*text - '0');
+        if (result > max) {
+            return false;
+        }
+    }
+    *value = (uint32_t)result;
+    return true;
+}
+
+/**
+ * @brief 명령 통계 조회
+ */
+void command_get_stats(command_stats_t *out)
+{
+    // 단일 값 갱신만 하므로 잠금 없이 복사
+    *out = stats;
+}
@@ -0,0 +1,113 @@
+/* 명령 처리 헤더
+ * MQTT 명령 토픽으로 받은 명령을 등록 표에서 찾아 명령 태스크에서 실행하고 응답을 발행합니다.
+ *
+ * 명령 형식: <이름>[:<인자>][;id=<번호>]
+ *   INTERVAL:1000;id=7
+ *   SET:interval=1000,batch=10,accel_range=8,format=binary;id=8
+ *
+ * MQTT 태스크는 수신한 조각(MQTT_BUFFER_SIZE보다 긴 메시지는 여러 MQTT_EVENT_DATA로 나뉨)을
+ * 명령 슬롯(COMMAND_QUEUE_LENGTH개)에 이어 붙이기만 하고, 다 모이면 슬롯 번호를 작업 큐에 넣습니다.
+ * 명령 태스크가 슬롯 안에서 바로 잘라(복사 없이 구분자 자리에 '\0') 처리 함수를 호출하고,
+ * 응답 JSON 앞에 "id"(없으면 디바이스가 매긴 번호)와 "apply_us"(수신 완료 → 처리 완료)를 붙여 발행합니다.
+ */
+
+#ifndef COMMAND_HANDLER_H
+#define COMMAND_HANDLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// 실행할 명령 (슬롯 안의 문자열을 가리킴)
+typedef struct {
+    const char *text;       // 명령 전체 (";id=" 앞까지, 오류 응답에 사용)
+    const char *name;       // 이름 (':' 앞까지)
+    char *args;             // ':' 뒤 인자, ':'가 없으면 NULL (슬롯 안이므로 처리 함수가 잘라 써도 됨)
+    uint32_t id;            // 명령 번호 (";id=" 또는 디바이스가 매긴 번호)
+    int64_t received_us;    // 마지막 조각을 받은 시각 (esp_timer, µs)
+} command_t;
+
+/**
+ * @brief 명령 처리 함수 (명령 태스크에서 호출)
+ *
+ * 응답 JSON('{'로 시작)을 response에 쓰고 ESP_OK를 반환합니다. 응답이 없으면 비워 둡니다.
+ * 실패하면 오류를 반환하고, 응답을 비워 두면 {"status":"error","command":...}를 대신 보냅니다.
+ */
+typedef esp_err_t (*command_fn_t)(const command_t *cmd, char *response, size_t size);
+
+// 등록 표 항목
+typedef struct {
+    const char *name;       // 명령 이름 (대소문자 구분)
+    command_fn_t handler;
+} command_def_t;
+
+// 응답 발행 함수 (MQTT_TOPIC_RESPONSE, 거절 응답을 포함해 명령 태스크에서만 호출)
+typedef void (*command_respond_fn_t)(const char *response);
+
+// 명령 통계 (누적)
+typedef struct {
+    uint32_t received;      // 다 모인 명령
+    uint32_t fragmented;    // 여러 조각으로 받은 명령
+    uint32_t busy;          // 빈 슬롯이 없어 거절
+    uint32_t too_long;      // COMMAND_MAX_LEN을 넘어 거절
+    uint32_t incomplete;    // 조각이 빠져 버린 명령
+    uint32_t unknown;       // 등록되지 않은 이름
+    uint32_t max_apply_us;  // 가장 긴 수신 → 처리 완료 시간
+} command_stats_t;
+
+/**
+ * @brief 명령 슬롯 / 작업 큐 / 명령 태스크 생성
+ *
+ * @param respond 응답 발행 함수
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NO_MEM 생성 실패
+ */
+esp_err_t command_init(command_respond_fn_t respond);
+
+/**
+ * @brief 명령 등록 표 추가 (command_init 전후 모두 가능, 표는 프로그램이 끝날 때까지 유지되어야 함)
+ *
+ * @param defs 등록 표
+ * @param count 항목 수
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NO_MEM 표 자리 없음
+ */
+esp_err_t command_register(const command_def_t *defs, size_t count);
+
+/**
+ * @brief 수신한 명령 조각 추가 (MQTT 태스크, MQTT_EVENT_DATA마다 호출, 기다리지 않음)
+ *
+ * @param data 조각 데이터
+ * @param len 조각 길이
+ * @param offset 메시지 안의 위치 (current_data_offset)
+ * @param total_len 메시지 전체 길이 (total_data_len)
+ */
+void command_receive(const char *data, int len, int offset, int total_len);
+
+/**
+ * @brief 인자 목록에서 다음 "키=값" 꺼내기 (','로 구분, 인자 문자열 안에서 바로 잘라 냄)
+ *
+ * @param cursor 읽을 위치 (다음 항목으로 이동, 끝이면 NULL)
+ * @param key 키
+ * @param value 값 ('='가 없으면 빈 문자열)
+ * @return true 항목 있음
+ */
+bool command_next_pair(char **cursor, const char **key, const char **value);
+
+/**
+ * @brief 10진수 부호 없는 정수 변환 (문자열 전체가 숫자이고 max 이하일 때만)
+ *
+ * @param text 문자열
+ * @param max 최댓값
+ * @param value 결과
+ * @return true 성공
+ */
+bool command_parse_u32(const char *text, uint32_t max, uint32_t *value);
+
+/**
+ * @brief 명령 통계 조회
+ *
+ * @param stats 결과를 저장할 포인터
+ */
+void command_get_stats(command_stats_t *stats);
+
+#endif // COMMAND_HANDLER_H
@@ -13,21 +13,207 @@
 #define WIFI_MAX_RETRY 5
 
 // ========== MQTT 브로커 설정 ==========
+#ifndef MQTT_BROKER_URL   // 호스트 시뮬레이션 빌드에서는 컴파일 옵션으로 지정
 #define MQTT_BROKER_URL "mqtt://10.10.16.111:1883"
+#endif
 
 // ========== MQTT 토픽 설정 ==========
 #define MQTT_TOPIC_SENSOR_DATA "esp32/sensor/data"
 #define MQTT_TOPIC_COMMAND "esp32/command"
 #define MQTT_TOPIC_RESPONSE "esp32/response"
+#define MQTT_TOPIC_SENSOR_STATS "esp32/sensor/stats"   // 샘플링 주기 오차 / 지연 통계
+#define MQTT_TOPIC_METRICS "esp32/metrics"              // 단계별 처리 사이클, 힙, 태스크 스택 여유
+#define MQTT_TOPIC_LOG "esp32/log"                      // 바이너리 로그 프레임 (BINLOG_OUTPUT_MQTT)
+
+// ========== 배치 발행 설정 ==========
+// 여러 샘플을 메시지 하나로 묶어 발행 (BATCH:, FLUSH: 명령으로 변경 가능)
+// 배치를 사용하면 전송 주기와 관계없이 모든 샘플(필터 출력)을 발행
+#define MQTT_BATCH_DEFAULT_SIZE 1         // 메시지당 샘플 수 (1: 배치 사용 안 함, 전송 주기마다 1샘플)
+#define MQTT_BATCH_MAX_SAMPLES 50         // 최대 배치 크기
+#define MQTT_BATCH_DEFAULT_FLUSH_MS 100   // 배치가 다 차지 않아도 첫 샘플 후 이 시간이 지나면 발행
+
+// ========== 데이터 형식 설정 ==========
+#define MQTT_PAYLOAD_BINARY_DEFAULT 0     // 1: 6축 데이터를 바이너리로 발행 (FORMAT: 명령으로 디바이스별 변경 가능)
+#define MQTT_JSON_FAST 1                  // 1: JSON을 고정 소수점 작성기로 생성 (json_writer.h), 0: snprintf (출력 바이트는 같음)
+#define MQTT_ENCODE_BENCH_ITERATIONS 100  // ENCODE_BENCH 명령 반복 횟수
+
+// ========== MQTT outbox 설정 ==========
+// 발행 태스크는 esp_mqtt_client_enqueue()로 outbox에 넣기만 하고 전송은 MQTT 태스크가 담당 (네트워크를 기다리지 않음)
+// 텔레메트리가 MQTT_OUTBOX_LIMIT을 넘으면 정책에 따라 처리 (OUTBOX: 명령으로 변경 가능)
+#define MQTT_OUTBOX_LIMIT 16384                   // 텔레메트리가 쓸 수 있는 outbox 크기 (바이트)
+#define MQTT_OUTBOX_RESERVE 4096                  // 명령 응답용 여유 (클라이언트 outbox 상한 = LIMIT + RESERVE)
+#define MQTT_OUTBOX_POLICY MQTT_OUTBOX_DROP_NEWEST // MQTT_OUTBOX_DROP_NEWEST, MQTT_OUTBOX_DROP_OLDEST, MQTT_OUTBOX_DOWNSAMPLE
+#define MQTT_OUTBOX_DOWNSAMPLE_START_PCT 50       // DOWNSAMPLE: outbox가 상한의 이 비율을 넘으면 다운샘플링 시작
+#define MQTT_OUTBOX_DOWNSAMPLE_FACTOR 4           // DOWNSAMPLE: 디바이스별 메시지 N개 중 1개만 발행
+
+// ========== 발행 QoS / MQTT v5 설정 ==========
+// 토픽 종류별 QoS (QOS: 명령으로 변경 가능), QoS 0은 PUBACK을 기다리지 않음 (큐 → PUBACK 지연은 QoS 1에서만 측정)
+#define MQTT_QOS_TELEMETRY 0              // 6축 / 자세 / 배치 / 재전송 (esp32/sensor/data...)
+#define MQTT_QOS_STATS 0                  // 주기 통계 (esp32/sensor/stats, esp32/metrics)
+#define MQTT_QOS_RESPONSE 1               // 명령 응답 / 이벤트 (esp32/response)
+#define MQTT_QOS_SYNC 0                   // 시계 차이 ping / sync (esp32/response)
+// MQTT v5 (sdkconfig에 CONFIG_MQTT_PROTOCOL_5=y 필요): QoS 0 토픽은 연결마다 첫 메시지만 전체 토픽을 보내고
+// 이후는 토픽 별칭(2바이트)만 보냄, 메시지 만료 시간이 지나면 브로커가 구독자에게 전달하지 않음
+#define MQTT_PROTOCOL_V5 1
+#define MQTT_TOPIC_ALIAS_MAX 10           // 사용할 별칭 수 (브로커의 Topic Alias Maximum 이하, mosquitto 기본 10)
+#define MQTT_EXPIRY_TELEMETRY_S 10        // 메시지 만료 시간 (초, 0: 만료 없음)
+#define MQTT_EXPIRY_STATS_S 60
+#define MQTT_EXPIRY_RESPONSE_S 0
+#define MQTT_EXPIRY_SYNC_S 5
+
+// ========== 오프라인 스풀 설정 ==========
+// MQTT 연결이 끊긴 동안 6축 샘플을 보관했다가 다시 연결되면 배치로 재전송 (자세 발행은 보관하지 않음)
+#define SPOOL_ENABLE 1
+#define SPOOL_RAM_RECORDS 400             // RAM 링 크기 (샘플 32바이트, 짧은 끊김은 RAM에서 처리)
+#define SPOOL_BLOCK_RECORDS 80            // 플래시에 한 번에 쓰는 샘플 수 (80 x 32 = 2560바이트, 섹터 4KB 이하)
+#define SPOOL_SEGMENT_BLOCKS 24           // 세그먼트 파일 하나의 블록 수 (약 60KB)
+#define SPOOL_MAX_SEGMENTS 28             // 최대 세그먼트 수 (약 1.7MB), 넘치면 가장 오래된 세그먼트를 버림
+#define SPOOL_PARTITION_LABEL "spool"     // partitions.csv의 SPIFFS 파티션 이름
+#ifndef SPOOL_BASE_PATH                   // 호스트 시뮬레이션 빌드에서는 컴파일 옵션으로 지정
+#define SPOOL_BASE_PATH "/spool"
+#endif
+#define SPOOL_REPLAY_INTERVAL_MS 50       // 재전송 메시지 간격 (메시지당 최대 MQTT_BATCH_MAX_SAMPLES개)
+#define SPOOL_REPLAY_MAX_OUTBOX 8192      // MQTT outbox가 이 크기(바이트)를 넘으면 재전송을 미룸 (실시간 발행 우선)
+
+// ========== 지연 추적 설정 ==========
+// 6축 데이터에 디바이스별 샘플 번호(seq)와 µs 캡처 시각(ts_us)을 싣고,
+// 큐에 넣은 시각부터 PUBACK까지의 지연 히스토그램과 수신 쪽과의 시계 차이(ping/pong)를 측정
+#define LATENCY_SYNC_INTERVAL_MS 5000     // 시계 차이 측정 ping 주기 (0: 사용 안 함)
+#define LATENCY_STATS_PERIOD_MS 10000     // PUBACK 지연 통계 발행 주기 (0: 발행 안 함, LATENCY_STATS 명령으로 조회)
+
+// ========== 파이프라인 계측 설정 ==========
+// 센서 읽기 → 변환 → 큐 → JSON 생성 → 발행 단계별 CPU 사이클 히스토그램 (0: 계측 코드를 컴파일하지 않음)
+#define METRICS_ENABLE 1
+#define METRICS_PERIOD_MS 10000           // MQTT_TOPIC_METRICS 발행 주기 (0: 발행 안 함, METRICS 명령으로 조회)
+
+// ========== 바이너리 로그 설정 ==========
+// 1: ESP_LOGx를 문자열로 만들지 않고 형식 문자열 주소 + 시각 + 인자 원본만 RAM 링에 기록
+// (로그 태스크가 모아서 내보내고 수신 쪽에서 tools/binlog_decode.py와 ELF로 복원, LOG: 명령으로 전환 가능)
+#define BINLOG_ENABLE 0
+#define BINLOG_OUTPUT_UART 0              // 콘솔에 "BINLOG:<base64>" 줄로 출력
+#define BINLOG_OUTPUT_MQTT 1              // MQTT_TOPIC_LOG로 발행 (연결 전이나 outbox가 차면 UART)
+#define BINLOG_OUTPUT BINLOG_OUTPUT_UART
+#define BINLOG_RING_SIZE 8192             // 링 크기 (바이트, 2의 거듭제곱), 가득 차면 새 로그를 버리고 횟수를 셈
+#define BINLOG_MAX_RECORD 160             // 로그 하나의 최대 크기 (바이트, 넘는 인자는 잘림, 로그를 남기는 태스크의 스택 사용)
+#define BINLOG_MAX_STRING 48              // RAM에 있는 %s 문자열 복사 최대 길이 (플래시 문자열은 주소만 기록)
+#define BINLOG_DRAIN_PERIOD_MS 100        // 링을 비우는 주기
+#define BINLOG_FRAME_SIZE 768             // 한 번에 내보내는 최대 크기 (UART 줄 하나 / MQTT 메시지 하나)
+#define BINLOG_TASK_CORE 0
+#define BINLOG_TASK_PRIORITY 1            // 가장 낮게 (남는 시간에만 출력)
 
 // ========== 센서 설정 ==========
 #define DEFAULT_PUBLISH_INTERVAL_MS 5000  // 기본 전송 주기: 5초
 
+// 수집 모드
+#define SENSOR_ACQ_MODE_POLL 0            // 전송 주기마다 1샘플 읽기
+#define SENSOR_ACQ_MODE_FIFO 1            // MPU6050 FIFO에 쌓고 버스트로 읽기
+#define SENSOR_ACQ_MODE_DRDY 2            // INT 핀 DATA_RDY 인터럽트마다 1샘플 읽기
+#define SENSOR_ACQ_MODE SENSOR_ACQ_MODE_POLL
+
+// FIFO 모드 설정 (FIFO 1024바이트 = 최대 73샘플)
+#define SENSOR_FIFO_SAMPLE_RATE_HZ 500    // FIFO 샘플링 주파수 (4 ~ 1000Hz)
+#define SENSOR_FIFO_DRAIN_MS 50           // FIFO 비우는 주기 (오버플로 전에 비워야 함)
+#define SENSOR_FIFO_MAX_SAMPLES 73        // 한 번에 비울 최대 샘플 수
+
+// DATA_RDY 인터럽트 모드 설정
+#define SENSOR_DRDY_SAMPLE_RATE_HZ 100    // 센서 샘플링 주파수 (4 ~ 1000Hz)
+#define SENSOR_DRDY_TIMEOUT_MS 100        // 인터럽트가 이 시간 안에 오지 않으면 경고
+
+// ========== 자세 추정(센서 퓨전) 설정 ==========
+// 모든 샘플로 자세를 갱신하므로 FIFO 또는 DATA_RDY 모드에서 사용
+// (폴링 모드는 샘플 간격이 길어 매번 가속도로 기울기만 다시 계산)
+#define SENSOR_FUSION_ENABLE 1
+#define SENSOR_FUSION_ALGORITHM IMU_FUSION_MADGWICK  // IMU_FUSION_COMPLEMENTARY 또는 IMU_FUSION_MADGWICK
+#define SENSOR_FUSION_COMP_ALPHA 0.98f                // 상보 필터 자이로 가중치 (0 < alpha < 1, 클수록 가속도 보정이 느림)
+#define SENSOR_FUSION_MADGWICK_BETA 0.1f              // Madgwick 보정 이득 (0 < beta <= 1, 보통 0.01 ~ 0.5)
+#define SENSOR_PUBLISH_ORIENTATION 0                 // 1: 6축 값 대신 자세 발행 (OUTPUT: 명령으로 변경 가능)
+#define SENSOR_FUSION_BENCH_ITERATIONS 1000          // FUSION_BENCH 명령 갱신 횟수
+
+// ========== DSP 필터 설정 (FIFO / DATA_RDY 모드에서 발행 전 적용) ==========
+// 처리 순서: biquad 저역 통과 → 이동 평균 → FIR 데시메이션
+#define SENSOR_DSP_ENABLE 1
+#define SENSOR_DSP_BIQUAD_CUTOFF_HZ 40.0f  // biquad 차단 주파수 (0: 사용 안 함, 샘플링 주파수/2 미만)
+#define SENSOR_DSP_MA_WINDOW 1             // 이동 평균 창 크기 (1: 사용 안 함, 최대 16)
+#define SENSOR_DSP_DECIMATION 5            // FIR 데시메이션 비율 (1: 사용 안 함)
+#define SENSOR_DSP_FIR_TAPS 15             // FIR 탭 수 (최대 32, 계수는 런타임에 설계)
+// FIR 계수를 직접 지정하려면 (탭 수는 배열 크기로 결정):
+// #define SENSOR_DSP_FIR_COEFFS { 0.02f, 0.06f, 0.12f, 0.16f, 0.28f, 0.16f, 0.12f, 0.06f, 0.02f }
+#define SENSOR_DSP_BENCH_ITERATIONS 100    // DSP_BENCH 명령 반복 횟수
+
+// ========== 수집 / 발행 태스크 설정 ==========
+// 수집 태스크와 발행 태스크를 서로 다른 코어에 고정하고 샘플 큐로 연결
+// (브로커 지연으로 발행이 막혀도 샘플링 타이밍은 그대로 유지)
+#define SENSOR_ACQ_TASK_CORE 1            // 수집 태스크 코어 (APP CPU)
+#define SENSOR_ACQ_TASK_PRIORITY 10
+#define SENSOR_PUB_TASK_CORE 0            // 발행 태스크 코어 (Wi-Fi / lwIP와 같은 PRO CPU)
+#define SENSOR_PUB_TASK_PRIORITY 5
+#define SENSOR_QUEUE_LENGTH 64            // 샘플 큐 크기 (배치 모드에서는 모든 샘플이 지나감)
+#define SENSOR_QUEUE_OVERWRITE 1          // 큐가 가득 차면 1: 가장 오래된 샘플을 버림, 0: 새 샘플을 버림
+
+// ========== 명령 처리 설정 ==========
+// MQTT 태스크는 명령을 슬롯에 모으기만 하고(MQTT_BUFFER_SIZE보다 긴 명령은 여러 조각으로 도착) 명령 태스크가 실행
+#define COMMAND_TASK_CORE 0
+#define COMMAND_TASK_PRIORITY 4           // 발행 태스크보다 낮게 (벤치마크 명령이 발행을 막지 않도록)
+#define COMMAND_QUEUE_LENGTH 4            // 동시에 대기할 수 있는 명령 수 (넘으면 busy 응답)
+#define COMMAND_MAX_LEN 1536              // 명령 최대 길이 (바이트, 넘으면 too_long 응답)
+#define COMMAND_RESPONSE_SIZE 2048        // 응답 버퍼 (METRICS 응답이 가장 김)
+
+// ========== 메모리 설정 ==========
+// 1: 태스크, 큐, MPU6050 인스턴스, 측정용 버퍼를 모두 정적 할당 (시작 후 애플리케이션의 힙 할당 없음)
+// MQTT 클라이언트(버퍼, 태스크, outbox)와 Wi-Fi는 ESP-IDF가 힙에 할당
+#define APP_STATIC_ALLOC 0
+// 태스크 스택 크기 (바이트) = 최대 사용량 + APP_STACK_MARGIN, 512 단위로 올림
+// 최대 사용량: tools/stack_report.py 정적 분석 (POLL / FIFO / DRDY x BINLOG 0 / 1, 퓨전 + DSP 중 최대,
+// 프레임당 32바이트 창 레지스터 여유 + printf 계열 약 1.2KB 추정 포함). 실행 중에는 esp32/metrics의
+// stack_free(최소 여유)가 APP_STACK_MARGIN보다 작아지면 경고 로그가 출력되므로 그때 다시 측정
+#define SENSOR_ACQ_TASK_STACK_SIZE 4608   // 최대 3216 (DRDY 재보정 → 로그) + 여유 1024 = 4240
+#define SENSOR_PUB_TASK_STACK_SIZE 3584   // 최대 2464 (스풀 세그먼트 정리 → 로그) + 여유 1024 = 3488
+#define MQTT_TASK_STACK_SIZE 6144         // esp-mqtt 태스크: 이벤트 핸들러 최대 1504 + esp-mqtt 내부 (분석 불가, ESP-IDF 기본값 유지)
+#define BINLOG_TASK_STACK_SIZE 3072       // 최대 1616 (프레임 발행 → snprintf) + 여유 1024 = 2640
+#define COMMAND_TASK_STACK_SIZE 4608      // 최대 3264 (ENCODE_BENCH → JSON 형식화) + 여유 1024 = 4288
+#define MQTT_BUFFER_SIZE 1024             // esp-mqtt 송신 / 수신 버퍼 (각각)
+#define APP_STACK_MARGIN 1024             // 스택 최소 여유가 이보다 작으면 경고 로그
+
+// ========== 샘플링 스케줄러 설정 ==========
+// 폴링 모드 샘플 주기와 FIFO 비우는 주기는 esp_timer 주기 콜백으로 맞춤 (처리 시간이 주기에 더해지지 않음)
+#define SENSOR_SCHED_MIN_PERIOD_US 500        // PERIOD_US: 명령 최소 주기 (14바이트 I2C 읽기 약 0.4ms)
+#define SENSOR_SCHED_STATS_PERIOD_MS 10000    // 주기 오차 통계 발행 주기 (0: 발행 안 함, SCHED_STATS 명령으로 조회)
+
+// ========== 변화 기반 발행 설정 ==========
+// 축별 변화가 데드밴드를 넘거나 heartbeat 시간이 지났을 때만 발행 (RBE: 명령으로 변경 가능)
+// 폴링 모드에서는 전송 주기가 변화를 확인하는 주기이므로 짧게(예: INTERVAL:100) 설정
+#define SENSOR_RBE_ENABLE 0
+#define SENSOR_RBE_ACCEL_DEADBAND_G 0.02f     // 가속도 축별 임계값 (g)
+#define SENSOR_RBE_GYRO_DEADBAND_DPS 1.0f     // 각속도 축별 임계값 (°/s)
+#define SENSOR_RBE_HEARTBEAT_MS 60000         // 변화가 없어도 이 시간마다 1샘플 발행 (최소 100ms)
+
+// 움직임 감지 인터럽트 대기 (폴링 모드 전용, 첫 번째 MPU6050의 INT 핀 = MPU6050_INT_PIN)
+// 변화 기반 발행 중 SENSOR_MOTION_IDLE_MS 동안 변화가 없으면 샘플링을 멈추고 MOT 인터럽트나 heartbeat로 깨어남
+#define SENSOR_MOTION_WAKE_ENABLE 0
+#define SENSOR_MOTION_THRESHOLD_MG 40         // MOT_THR (2mg 단위, 2 ~ 510mg, 고역 통과 필터 출력 기준)
+#define SENSOR_MOTION_DURATION_MS 5           // MOT_DUR (임계값을 넘어야 하는 시간, 1 ~ 255ms)
+#define SENSOR_MOTION_IDLE_MS 3000            // 마지막 변화 후 샘플링을 멈출 때까지의 시간
+
 // ========== MPU6050 I2C 설정 ==========
 #define I2C_MASTER_SCL_IO 22           // I2C 클럭 핀 (SCL)
 #define I2C_MASTER_SDA_IO 21           // I2C 데이터 핀 (SDA)
 #define I2C_MASTER_NUM I2C_NUM_0       // I2C 포트 번호
 #define I2C_MASTER_FREQ_HZ 400000      // I2C 주파수 (400kHz)
+// I2C 트랜잭션 큐 깊이 (0: 블로킹 전송, >0: 큐 + 완료 콜백 비동기 전송)
+// 디바이스당 최대 2개 전송이 동시에 큐에 있으므로 디바이스 수 x 2 이상
+#define MPU6050_I2C_TRANS_QUEUE_DEPTH 8
+#define MPU6050_INT_PIN 19             // 첫 번째 MPU6050의 INT 핀 (DATA_RDY / 움직임 감지 인터럽트)
+
+// 연결된 MPU6050 주소 목록 (같은 버스에 AD0 핀으로 0x68/0x69 두 개까지)
+// 두 개 연결 시: { 0x68, 0x69 }
+#define MPU6050_DEVICE_ADDRESSES { 0x68 }
+#define MPU6050_MAX_DEVICES 4          // 디바이스별 버퍼 크기 상한
+
+// ========== MPU6050 측정 설정 (MQTT 명령으로 런타임 변경 가능) ==========
+#define MPU6050_DEFAULT_ACCEL_RANGE MPU6050_ACCEL_RANGE_2G   // ±2g
+#define MPU6050_DEFAULT_GYRO_RANGE MPU6050_GYRO_RANGE_250    // ±250°/s
+#define MPU6050_DEFAULT_DLPF MPU6050_DLPF_184HZ              // DLPF 184Hz (자이로 출력 1kHz)
+#define MPU6050_DEFAULT_SAMPLE_RATE_HZ 1000                  // 출력 데이터 주파수
 
 // ========== 로그 태그 ==========
 #define TAG_MAIN "ESP32_MAIN"
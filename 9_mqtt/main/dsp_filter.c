@@ -0,0 +1,295 @@
+/* 스트리밍 DSP 필터 구현 */
+
+#include "dsp_filter.h"
+
+#include <math.h>
+#include <string.h>
+#include "esp_cpu.h"
+
+#define DSP_PI 3.14159265f
+#define DSP_FIR_CUTOFF_RATIO 0.8f   // 데시메이션 후 나이퀴스트 대비 FIR 차단 주파수
+
+/**
+ * @brief biquad 저역 통과 계수 설계
+ */
+void dsp_biquad_lowpass(float cutoff_hz, float sample_rate_hz, dsp_biquad_coeffs_t *coeffs)
+{
+    const float w0 = 2.0f * DSP_PI * cutoff_hz / sample_rate_hz;
+    const float cos_w0 = cosf(w0);
+    const float alpha = sinf(w0) / (2.0f * 0.70710678f);
+    const float a0 = 1.0f + alpha;
+
+    coeffs->b0 = (1.0f - cos_w0) * 0.5f / a0;
+    coeffs->b1 = (1.0f - cos_w0) / a0;
+    coeffs->b2 = coeffs->b0;
+    coeffs->a1 = -2.0f * cos_w0 / a0;
+    coeffs->a2 = (1.0f - alpha) / a0;
+}
+
+/**
+ * @brief FIR 저역 통과 계수 설계
+ */
+void dsp_fir_lowpass(float *taps, size_t num_taps, float cutoff)
+{
+    const float center = (num_taps - 1) * 0.5f;
+    float sum = 0.0f;
+
+    for (size_t i = 0; i < num_taps; i++) {
+        float t = i - center;
+        float sinc = (t == 0.0f) ? 2.0f * cutoff : sinf(2.0f * DSP_PI * cutoff * t) / (DSP_PI * t);
+        float window = (num_taps > 1) ? 0.54f - 0.46f * cosf(2.0f * DSP_PI * i / (num_taps - 1)) : 1.0f;
+        taps[i] = sinc * window;
+        sum += taps[i];
+    }
+
+    // DC 이득 1로 정규화
+    for (size_t i = 0; i < num_taps; i++) {
+        taps[i] /= sum;
+    }
+}
+
+/**
+ * @brief 파이프라인 초기화
+ */
+bool dsp_pipeline_init(dsp_pipeline_t *pipeline, const dsp_pipeline_config_t *config)
+{
+    size_t ma_window = config->moving_average_window > 1 ? config->moving_average_window : 1;
+    size_t decimation = config->decimation > 1 ? config->decimation : 1;
+
+    if (ma_window > DSP_MA_MAX_WINDOW ||
+        (decimation > 1 && (config->fir_num_taps == 0 || config->fir_num_taps > DSP_FIR_MAX_TAPS)) ||
+        (config->biquad_coeffs == NULL && config->biquad_cutoff_hz * 2.0f >= config->sample_rate_hz)) {
+        return false;
+    }
+
+    memset(pipeline, 0, sizeof(*pipeline));
+
+    if (config->biquad_coeffs != NULL) {
+        pipeline->biquad = *config->biquad_coeffs;
+        pipeline->biquad_enabled = true;
+    } else if (config->biquad_cutoff_hz > 0.0f) {
+        dsp_biquad_lowpass(config->biquad_cutoff_hz, config->sample_rate_hz, &pipeline->biquad);
+        pipeline->biquad_enabled = true;
+    }
+
+    pipeline->ma_window = ma_window;
+
+    pipeline->decimation = decimation;
+    if (decimation > 1) {
+        pipeline->fir_num_taps = config->fir_num_taps;
+        if (config->fir_taps != NULL) {
+            memcpy(pipeline->fir_taps, config->fir_taps, config->fir_num_taps * sizeof(float));
+        } else {
+            dsp_fir_lowpass(pipeline->fir_taps, config->fir_num_taps,
+                            DSP_FIR_CUTOFF_RATIO * 0.5f / decimation);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 필터 상태 초기화
+ */
+void dsp_pipeline_reset(dsp_pipeline_t *pipeline)
+{
+    memset(pipeline->biquad_z1, 0, sizeof(pipeline->biquad_z1));
+    memset(pipeline->biquad_z2, 0, sizeof(pipeline->biquad_z2));
+    pipeline->ma_index = 0;
+    pipeline->fir_pos = 0;
+    pipeline->fir_phase = 0;
+    pipeline->primed = false;
+}
+
+/**
+ * @brief 첫 샘플 값이 계속 들어온 것처럼 상태를 채움 (시작 과도 응답 제거)
+ */
+static void dsp_pipeline_prime(dsp_pipeline_t *pipeline, const dsp_block_t *block)
+{
+    const dsp_biquad_coeffs_t *c = &pipeline->biquad;
+
+    for (int ch = 0; ch < DSP_CHANNELS; ch++) {
+        const float x = block->ch[ch][0];
+
+        // DC 이득 1인 저역 통과 필터의 정상 상태
+        pipeline->biquad_z2[ch] = (c->b2 - c->a2) * x;
+        pipeline->biquad_z1[ch] = (c->b1 - c->a1) * x + pipeline->biquad_z2[ch];
+
+        for (size_t i = 0; i < pipeline->ma_window; i++) {
+            pipeline->ma_buffer[ch][i] = x;
+        }
+        pipeline->ma_sum[ch] = x * pipeline->ma_window;
+
+        for (size_t i = 0; i < 2 * pipeline->fir_num_taps; i++) {
+            pipeline->fir_history[ch][i] = x;
+        }
+    }
+
+    pipeline->primed = true;
+}
+
+/**
+ * @brief biquad IIR (Direct Form II Transposed), 채널 하나
+ */
+static void dsp_biquad_channel(const dsp_biquad_coeffs_t *c, float *z1, float *z2, float *data, size_t count)
+{
+    // 계수와 상태를 지역 변수로 두어 루프 안에서 레지스터에 유지
+    const float b0 = c->b0, b1 = c->b1, b2 = c->b2, a1 = c->a1, a2 = c->a2;
+    float s1 = *z1, s2 = *z2;
+
+    for (size_t i = 0; i < count; i++) {
+        const float x = data[i];
+        const float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        data[i] = y;
+    }
+
+    *z1 = s1;
+    *z2 = s2;
+}
+
+/**
+ * @brief 이동 평균, 채널 하나 (인덱스는 모든 채널이 공유하므로 다음 위치를 반환)
+ */
+static size_t dsp_moving_average_channel(dsp_pipeline_t *pipeline, int ch, float *data, size_t count)
+{
+    const size_t window = pipeline->ma_window;
+    const float scale = 1.0f / window;
+    float *buffer = pipeline->ma_buffer[ch];
+    float sum = pipeline->ma_sum[ch];
+    size_t index = pipeline->ma_index;
+
+    for (size_t i = 0; i < count; i++) {
+        sum += data[i] - buffer[index];
+        buffer[index] = data[i];
+        data[i] = sum * scale;
+
+        if (++index == window) {
+            index = 0;
+            // 누적 합의 부동소수점 오차가 쌓이지 않도록 한 바퀴마다 다시 계산
+            sum = 0.0f;
+            for (size_t j = 0; j < window; j++) {
+                sum += buffer[j];
+            }
+        }
+    }
+
+    pipeline->ma_sum[ch] = sum;
+    return index;
+}
+
+/**
+ * @brief FIR 데시메이션, 채널 하나 (제자리 처리, 출력 샘플 수 반환)
+ */
+static size_t dsp_fir_decimate_channel(dsp_pipeline_t *pipeline, int ch, float *data, size_t count)
+{
+    const size_t num_taps = pipeline->fir_num_taps;
+    const size_t decimation = pipeline->decimation;
+    const float *taps = pipeline->fir_taps;
+    float *history = pipeline->fir_history[ch];
+    size_t pos = pipeline->fir_pos;
+    size_t phase = pipeline->fir_phase;
+    size_t out = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        history[pos] = data[i];
+        history[pos + num_taps] = data[i];
+        if (++pos == num_taps) {
+            pos = 0;
+        }
+
+        // D개마다 한 번만 출력 계산 (history[pos..pos+N-1] = 오래된 순)
+        if (++phase == decimation) {
+            phase = 0;
+            const float *window = &history[pos];
+            float acc = 0.0f;
+            for (size_t k = 0; k < num_taps; k++) {
+                acc += taps[k] * window[num_taps - 1 - k];
+            }
+            data[out++] = acc;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief 블록 처리
+ */
+void dsp_pipeline_process(dsp_pipeline_t *pipeline, dsp_block_t *block)
+{
+    const size_t count = block->count;
+    if (count == 0) {
+        return;
+    }
+    if (!pipeline->primed) {
+        dsp_pipeline_prime(pipeline, block);
+    }
+
+    // 단계마다 채널 하나의 연속 배열을 끝까지 처리 (캐시/레지스터 지역성)
+    if (pipeline->biquad_enabled) {
+        for (int ch = 0; ch < DSP_CHANNELS; ch++) {
+            dsp_biquad_channel(&pipeline->biquad, &pipeline->biquad_z1[ch], &pipeline->biquad_z2[ch],
+                               block->ch[ch], count);
+        }
+    }
+
+    if (pipeline->ma_window > 1) {
+        size_t next_index = 0;
+        for (int ch = 0; ch < DSP_CHANNELS; ch++) {
+            next_index = dsp_moving_average_channel(pipeline, ch, block->ch[ch], count);
+        }
+        pipeline->ma_index = next_index;
+    }
+
+    if (pipeline->decimation > 1) {
+        size_t out = 0;
+        const size_t pos = pipeline->fir_pos;
+        const size_t phase = pipeline->fir_phase;
+        for (int ch = 0; ch < DSP_CHANNELS; ch++) {
+            // 모든 채널이 같은 위치/위상에서 시작
+            pipeline->fir_pos = pos;
+            pipeline->fir_phase = phase;
+            out = dsp_fir_decimate_channel(pipeline, ch, block->ch[ch], count);
+        }
+        pipeline->fir_pos = (pos + count) % pipeline->fir_num_taps;
+        pipeline->fir_phase = (phase + count) % pipeline->decimation;
+        block->count = out;
+    }
+}
+
+/**
+ * @brief 파이프라인 처리 속도 측정
+ */
+uint32_t dsp_pipeline_benchmark(const dsp_pipeline_config_t *config, dsp_pipeline_t *pipeline, dsp_block_t *block,
+                                size_t block_size, size_t iterations)
+{
+    if (pipeline == NULL || block == NULL || block_size == 0 || block_size > DSP_BLOCK_MAX_SAMPLES || iterations == 0) {
+        return 0;
+    }
+
+    uint32_t cycles_per_sample = 0;
+
+    if (dsp_pipeline_init(pipeline, config)) {
+        uint64_t total_cycles = 0;
+
+        for (size_t n = 0; n < iterations; n++) {
+            // 합성 입력 (DC + 작은 변동)
+            for (int ch = 0; ch < DSP_CHANNELS; ch++) {
+                for (size_t i = 0; i < block_size; i++) {
+                    block->ch[ch][i] = 1.0f + 0.01f * (float)((i + n) % 7);
+                }
+            }
+            block->count = block_size;
+
+            esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+            dsp_pipeline_process(pipeline, block);
+            total_cycles += (uint32_t)(esp_cpu_get_cycle_count() - start);
+        }
+
+        cycles_per_sample = total_cycles / ((uint64_t)block_size * iterations);
+    }
+
+    return cycles_per_sample;
+}
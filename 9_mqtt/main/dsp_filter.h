@@ -0,0 +1,133 @@
+/* 스트리밍 DSP 필터 헤더
+ * 6축 샘플 블록용 biquad IIR → 이동 평균 → FIR 데시메이션 파이프라인
+ */
+
+#ifndef DSP_FILTER_H
+#define DSP_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define DSP_BLOCK_MAX_SAMPLES 80    // 블록당 최대 샘플 수 (FIFO 1회 비우기 분량 이상)
+#define DSP_MA_MAX_WINDOW 16        // 이동 평균 최대 창 크기
+#define DSP_FIR_MAX_TAPS 32         // FIR 최대 탭 수
+
+// 채널 순서
+typedef enum {
+    DSP_CH_ACCEL_X = 0,
+    DSP_CH_ACCEL_Y,
+    DSP_CH_ACCEL_Z,
+    DSP_CH_GYRO_X,
+    DSP_CH_GYRO_Y,
+    DSP_CH_GYRO_Z,
+    DSP_CHANNELS,
+} dsp_channel_t;
+
+// 샘플 블록 (채널별로 연속 배치: structure-of-arrays)
+typedef struct {
+    float ch[DSP_CHANNELS][DSP_BLOCK_MAX_SAMPLES];
+    size_t count;
+} dsp_block_t;
+
+// biquad 계수 (a0 = 1로 정규화)
+typedef struct {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+} dsp_biquad_coeffs_t;
+
+// 파이프라인 설정
+typedef struct {
+    float sample_rate_hz;
+    float biquad_cutoff_hz;                     // biquad 저역 통과 차단 주파수 (0: 사용 안 함)
+    const dsp_biquad_coeffs_t *biquad_coeffs;   // NULL이 아니면 차단 주파수 대신 이 계수 사용
+    size_t moving_average_window;               // 이동 평균 창 크기 (0, 1: 사용 안 함)
+    size_t decimation;                          // 데시메이션 비율 (0, 1: 사용 안 함)
+    size_t fir_num_taps;                        // FIR 탭 수
+    const float *fir_taps;                      // NULL이면 저역 통과 계수를 런타임에 설계
+} dsp_pipeline_config_t;
+
+// 파이프라인 상태 (채널별 상태를 채널 단위 배열로 보관)
+typedef struct {
+    bool biquad_enabled;
+    dsp_biquad_coeffs_t biquad;
+    float biquad_z1[DSP_CHANNELS];
+    float biquad_z2[DSP_CHANNELS];
+
+    size_t ma_window;
+    size_t ma_index;
+    float ma_sum[DSP_CHANNELS];
+    float ma_buffer[DSP_CHANNELS][DSP_MA_MAX_WINDOW];
+
+    size_t decimation;
+    size_t fir_num_taps;
+    size_t fir_pos;
+    size_t fir_phase;
+    float fir_taps[DSP_FIR_MAX_TAPS];
+    float fir_history[DSP_CHANNELS][2 * DSP_FIR_MAX_TAPS];  // 두 번 기록해서 창을 연속으로 읽음
+
+    bool primed;    // 첫 샘플로 상태를 채웠는지 (시작 과도 응답 방지)
+} dsp_pipeline_t;
+
+/**
+ * @brief 파이프라인 초기화
+ *
+ * @param pipeline 파이프라인 상태
+ * @param config 설정
+ * @return true 성공, false 잘못된 설정 (창 크기/탭 수 초과, 차단 주파수가 나이퀴스트 이상)
+ */
+bool dsp_pipeline_init(dsp_pipeline_t *pipeline, const dsp_pipeline_config_t *config);
+
+/**
+ * @brief 필터 상태 초기화 (설정 유지)
+ *
+ * @param pipeline 파이프라인 상태
+ */
+void dsp_pipeline_reset(dsp_pipeline_t *pipeline);
+
+/**
+ * @brief 블록 처리 (제자리 처리, 데시메이션하면 block->count가 줄어듦)
+ *
+ * @param pipeline 파이프라인 상태
+ * @param block 샘플 블록
+ */
+void dsp_pipeline_process(dsp_pipeline_t *pipeline, dsp_block_t *block);
+
+/**
+ * @brief biquad 저역 통과 계수 설계 (RBJ, Q = 1/√2)
+ *
+ * @param cutoff_hz 차단 주파수
+ * @param sample_rate_hz 샘플링 주파수
+ * @param coeffs 계수를 저장할 포인터
+ */
+void dsp_biquad_lowpass(float cutoff_hz, float sample_rate_hz, dsp_biquad_coeffs_t *coeffs);
+
+/**
+ * @brief 윈도우드 싱크(Hamming) FIR 저역 통과 계수 설계
+ *
+ * @param taps 계수를 저장할 배열
+ * @param num_taps 탭 수
+ * @param cutoff 차단 주파수 (샘플링 주파수 대비, 0 ~ 0.5)
+ */
+void dsp_fir_lowpass(float *taps, size_t num_taps, float cutoff);
+
+/**
+ * @brief 파이프라인 처리 속도 측정
+ *
+ * 별도 파이프라인 인스턴스로 합성 데이터를 처리하므로 실행 중인 필터 상태에는 영향이 없습니다.
+ * 작업용 인스턴스와 블록은 호출하는 쪽이 제공합니다 (태스크 스택에 두기에는 큼).
+ *
+ * @param config 측정할 설정
+ * @param pipeline 측정용 파이프라인 (실행 중인 인스턴스와 별도)
+ * @param block 측정용 블록
+ * @param block_size 블록당 샘플 수
+ * @param iterations 반복 횟수
+ * @return 6축 샘플 1개당 CPU 사이클 (실패 시 0)
+ */
+uint32_t dsp_pipeline_benchmark(const dsp_pipeline_config_t *config, dsp_pipeline_t *pipeline, dsp_block_t *block,
+                                size_t block_size, size_t iterations);
+
+#endif // DSP_FILTER_H
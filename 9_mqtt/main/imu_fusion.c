@@ -0,0 +1,292 @@
+/* IMU 자세 추정(센서 퓨전) 구현 */
+
+#include "imu_fusion.h"
+
+#include <math.h>
+#include "esp_cpu.h"
+
+#define IMU_FUSION_DEG_TO_RAD 0.017453292f
+#define IMU_FUSION_RAD_TO_DEG 57.29578f
+#define IMU_FUSION_MAX_DT_S 0.1f    // 이보다 긴 간격은 적분하지 않고 다시 초기화
+#define IMU_FUSION_MIN_CORRECTION 1e-12f       // 보정 회전이 정해지지 않으면(정반대 방향) 보정 생략
+#define IMU_FUSION_BENCH_INPUTS 16             // 측정용 합성 입력 수 (반복해서 사용)
+
+/**
+ * @brief 오일러각(rad, ZYX)을 쿼터니언으로 변환
+ */
+static void imu_fusion_euler_to_quaternion(float roll, float pitch, float yaw, imu_quaternion_t *q)
+{
+    const float cr = cosf(roll * 0.5f);
+    const float sr = sinf(roll * 0.5f);
+    const float cp = cosf(pitch * 0.5f);
+    const float sp = sinf(pitch * 0.5f);
+    const float cy = cosf(yaw * 0.5f);
+    const float sy = sinf(yaw * 0.5f);
+
+    q->w = cr * cp * cy + sr * sp * sy;
+    q->x = sr * cp * cy - cr * sp * sy;
+    q->y = cr * sp * cy + sr * cp * sy;
+    q->z = cr * cp * sy - sr * sp * cy;
+}
+
+/**
+ * @brief 가속도로 기울기(roll, pitch) 계산
+ */
+static void imu_fusion_accel_tilt(float ax, float ay, float az, float *roll, float *pitch)
+{
+    *roll = atan2f(ay, az);
+    *pitch = atan2f(-ax, sqrtf(ay * ay + az * az));
+}
+
+/**
+ * @brief 첫 샘플의 가속도로 자세 초기화 (yaw = 0)
+ */
+static void imu_fusion_start(imu_fusion_t *fusion, float ax, float ay, float az)
+{
+    float roll, pitch;
+
+    imu_fusion_accel_tilt(ax, ay, az, &roll, &pitch);
+    imu_fusion_euler_to_quaternion(roll, pitch, 0.0f, &fusion->q);
+    fusion->initialized = true;
+}
+
+/**
+ * @brief 정규화해서 자세 쿼터니언으로 저장
+ */
+static void imu_fusion_store(imu_fusion_t *fusion, float q0, float q1, float q2, float q3)
+{
+    const float recip_norm = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    fusion->q.w = q0 * recip_norm;
+    fusion->q.x = q1 * recip_norm;
+    fusion->q.y = q2 * recip_norm;
+    fusion->q.z = q3 * recip_norm;
+}
+
+/**
+ * @brief 상보 필터 갱신 (자이로로 쿼터니언 적분 + 가속도로 중력 방향 오차의 약 1 - alpha만큼 보정)
+ *
+ * 센서 좌표계 각속도를 쿼터니언으로 적분하므로 기울어진 상태에서도 축이 섞이지 않고,
+ * 보정은 예상 중력 방향과 측정 가속도 사이의 회전으로 하므로 ±180° 경계에서도 연속입니다.
+ * 보정 회전축은 중력에 수직이라 yaw는 자이로만으로 정해집니다.
+ * 회전의 일부는 삼각함수 대신 단위 회전과의 선형 보간(nlerp)으로 구합니다 (오차가 작을 때 slerp와 같음).
+ */
+static void imu_fusion_complementary_update(imu_fusion_t *fusion, float ax, float ay, float az,
+                                            float gx, float gy, float gz, float dt)
+{
+    const float alpha = fusion->gain;
+    float q0 = fusion->q.w, q1 = fusion->q.x, q2 = fusion->q.y, q3 = fusion->q.z;
+
+    // 자이로 적분 (q += 0.5 * q ⊗ (0, ω) * dt)
+    const float half_dt = 0.5f * dt;
+    const float r0 = q0 + (-q1 * gx - q2 * gy - q3 * gz) * half_dt;
+    const float r1 = q1 + (q0 * gx + q2 * gz - q3 * gy) * half_dt;
+    const float r2 = q2 + (q0 * gy - q1 * gz + q3 * gx) * half_dt;
+    const float r3 = q3 + (q0 * gz + q1 * gy - q2 * gx) * half_dt;
+    imu_fusion_store(fusion, r0, r1, r2, r3);
+
+    // 자유 낙하 등으로 가속도가 0이면 기울기 보정 생략
+    const float a_norm_sq = ax * ax + ay * ay + az * az;
+    if (a_norm_sq == 0.0f) {
+        return;
+    }
+    const float recip_norm = 1.0f / sqrtf(a_norm_sq);
+    ax *= recip_norm;
+    ay *= recip_norm;
+    az *= recip_norm;
+
+    // 현재 자세로 예상한 중력 방향 (센서 좌표계)
+    q0 = fusion->q.w, q1 = fusion->q.x, q2 = fusion->q.y, q3 = fusion->q.z;
+    const float vx = 2.0f * (q1 * q3 - q0 * q2);
+    const float vy = 2.0f * (q0 * q1 + q2 * q3);
+    const float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+    // 측정 가속도를 예상 중력으로 돌리는 회전 e = (1 + a·v, a × v) (정규화 전, 각 = 두 벡터 사이 각)
+    const float e0 = 1.0f + ax * vx + ay * vy + az * vz;
+    const float e1 = ay * vz - az * vy;
+    const float e2 = az * vx - ax * vz;
+    const float e3 = ax * vy - ay * vx;
+    const float e_norm_sq = e0 * e0 + e1 * e1 + e2 * e2 + e3 * e3;
+    if (e_norm_sq < IMU_FUSION_MIN_CORRECTION) {
+        return;
+    }
+
+    // c = nlerp(1, e, 1 - alpha), q ⊗ c로 예상 중력이 측정 가속도 쪽으로 약 (1 - alpha)만큼 이동 (정규화는 저장할 때)
+    const float f = (1.0f - alpha) / sqrtf(e_norm_sq);
+    const float c0 = alpha + f * e0;
+    const float c1 = f * e1;
+    const float c2 = f * e2;
+    const float c3 = f * e3;
+    imu_fusion_store(fusion,
+                     q0 * c0 - q1 * c1 - q2 * c2 - q3 * c3,
+                     q0 * c1 + q1 * c0 + q2 * c3 - q3 * c2,
+                     q0 * c2 - q1 * c3 + q2 * c0 + q3 * c1,
+                     q0 * c3 + q1 * c2 - q2 * c1 + q3 * c0);
+}
+
+/**
+ * @brief Madgwick 6축 필터 갱신 (경사 하강법으로 중력 방향 오차 보정)
+ */
+static void imu_fusion_madgwick_update(imu_fusion_t *fusion, float ax, float ay, float az,
+                                       float gx, float gy, float gz, float dt)
+{
+    const float beta = fusion->gain;
+    float q0 = fusion->q.w, q1 = fusion->q.x, q2 = fusion->q.y, q3 = fusion->q.z;
+
+    // 자이로에 의한 쿼터니언 변화율
+    float q_dot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float q_dot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float q_dot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float q_dot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (ax != 0.0f || ay != 0.0f || az != 0.0f) {
+        float recip_norm = 1.0f / sqrtf(ax * ax + ay * ay + az * az);
+        ax *= recip_norm;
+        ay *= recip_norm;
+        az *= recip_norm;
+
+        const float _2q0 = 2.0f * q0;
+        const float _2q1 = 2.0f * q1;
+        const float _2q2 = 2.0f * q2;
+        const float _2q3 = 2.0f * q3;
+        const float _4q0 = 4.0f * q0;
+        const float _4q1 = 4.0f * q1;
+        const float _4q2 = 4.0f * q2;
+        const float _8q1 = 8.0f * q1;
+        const float _8q2 = 8.0f * q2;
+        const float q0q0 = q0 * q0;
+        const float q1q1 = q1 * q1;
+        const float q2q2 = q2 * q2;
+        const float q3q3 = q3 * q3;
+
+        // 목적 함수의 기울기
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 +
+                   _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 +
+                   _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+
+        float s_norm_sq = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (s_norm_sq > 0.0f) {
+            recip_norm = 1.0f / sqrtf(s_norm_sq);
+            q_dot0 -= beta * s0 * recip_norm;
+            q_dot1 -= beta * s1 * recip_norm;
+            q_dot2 -= beta * s2 * recip_norm;
+            q_dot3 -= beta * s3 * recip_norm;
+        }
+    }
+
+    imu_fusion_store(fusion, q0 + q_dot0 * dt, q1 + q_dot1 * dt, q2 + q_dot2 * dt, q3 + q_dot3 * dt);
+}
+
+/**
+ * @brief 퓨전 상태 초기화
+ */
+void imu_fusion_init(imu_fusion_t *fusion, imu_fusion_algorithm_t algorithm, float gain)
+{
+    fusion->algorithm = algorithm;
+    fusion->gain = gain;
+    imu_fusion_reset(fusion);
+}
+
+/**
+ * @brief 자세 초기화
+ */
+void imu_fusion_reset(imu_fusion_t *fusion)
+{
+    fusion->q = (imu_quaternion_t){1.0f, 0.0f, 0.0f, 0.0f};
+    fusion->last_timestamp_us = 0;
+    fusion->initialized = false;
+}
+
+/**
+ * @brief 샘플 하나로 자세 갱신
+ */
+void imu_fusion_update(imu_fusion_t *fusion, float ax, float ay, float az,
+                       float gx, float gy, float gz, int64_t timestamp_us)
+{
+    const float dt = (float)(timestamp_us - fusion->last_timestamp_us) * 1e-6f;
+    fusion->last_timestamp_us = timestamp_us;
+
+    if (!fusion->initialized || dt <= 0.0f || dt > IMU_FUSION_MAX_DT_S) {
+        imu_fusion_start(fusion, ax, ay, az);
+        return;
+    }
+
+    gx *= IMU_FUSION_DEG_TO_RAD;
+    gy *= IMU_FUSION_DEG_TO_RAD;
+    gz *= IMU_FUSION_DEG_TO_RAD;
+
+    if (fusion->algorithm == IMU_FUSION_MADGWICK) {
+        imu_fusion_madgwick_update(fusion, ax, ay, az, gx, gy, gz, dt);
+    } else {
+        imu_fusion_complementary_update(fusion, ax, ay, az, gx, gy, gz, dt);
+    }
+}
+
+/**
+ * @brief 현재 자세 쿼터니언 조회
+ */
+void imu_fusion_get_quaternion(const imu_fusion_t *fusion, imu_quaternion_t *q)
+{
+    *q = fusion->q;
+}
+
+/**
+ * @brief 현재 자세 오일러각 조회
+ */
+void imu_fusion_get_euler(const imu_fusion_t *fusion, imu_euler_t *euler)
+{
+    const float w = fusion->q.w, x = fusion->q.x, y = fusion->q.y, z = fusion->q.z;
+    float sin_pitch = 2.0f * (w * y - z * x);
+    if (sin_pitch > 1.0f) {
+        sin_pitch = 1.0f;
+    } else if (sin_pitch < -1.0f) {
+        sin_pitch = -1.0f;
+    }
+
+    euler->roll = atan2f(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)) * IMU_FUSION_RAD_TO_DEG;
+    euler->pitch = asinf(sin_pitch) * IMU_FUSION_RAD_TO_DEG;
+    euler->yaw = atan2f(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)) * IMU_FUSION_RAD_TO_DEG;
+}
+
+/**
+ * @brief 자세 갱신 처리 속도 측정
+ */
+uint32_t imu_fusion_benchmark(imu_fusion_algorithm_t algorithm, size_t iterations)
+{
+    if (iterations == 0) {
+        return 0;
+    }
+
+    // 합성 입력: 30° 기울어진 채 수직축으로 90°/s 회전 (센서 좌표계 값, 미리 계산해서 측정에서 제외)
+    float accel[IMU_FUSION_BENCH_INPUTS][3];
+    float gyro[IMU_FUSION_BENCH_INPUTS][3];
+    for (int i = 0; i < IMU_FUSION_BENCH_INPUTS; i++) {
+        const float tilt = 30.0f * IMU_FUSION_DEG_TO_RAD;
+        const float noise = 0.001f * (float)(i % 5);
+        accel[i][0] = -sinf(tilt) + noise;
+        accel[i][1] = noise;
+        accel[i][2] = cosf(tilt);
+        gyro[i][0] = -90.0f * sinf(tilt);
+        gyro[i][1] = 0.0f;
+        gyro[i][2] = 90.0f * cosf(tilt);
+    }
+
+    // gain은 처리 비용에 영향이 없으므로 대표값 사용
+    imu_fusion_t fusion;
+    imu_fusion_init(&fusion, algorithm, algorithm == IMU_FUSION_MADGWICK ? 0.1f : 0.98f);
+    imu_fusion_update(&fusion, accel[0][0], accel[0][1], accel[0][2], 0.0f, 0.0f, 0.0f, 0);
+
+    int64_t timestamp_us = 0;
+    esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+    for (size_t n = 0; n < iterations; n++) {
+        const int i = n % IMU_FUSION_BENCH_INPUTS;
+        timestamp_us += 1000;
+        imu_fusion_update(&fusion, accel[i][0], accel[i][1], accel[i][2], gyro[i][0], gyro[i][1], gyro[i][2],
+                          timestamp_us);
+    }
+    const uint32_t total_cycles = (uint32_t)(esp_cpu_get_cycle_count() - start);
+
+    return total_cycles / iterations;
+}
@@ -0,0 +1,99 @@
+/* IMU 자세 추정(센서 퓨전) 헤더
+ * 가속도 + 자이로로 쿼터니언 / 오일러각 계산 (단정밀도 float 연산만 사용)
+ */
+
+#ifndef IMU_FUSION_H
+#define IMU_FUSION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 퓨전 알고리즘
+typedef enum {
+    IMU_FUSION_COMPLEMENTARY = 0,   // 상보 필터 (gain = 자이로 가중치 alpha, 예: 0.98)
+    IMU_FUSION_MADGWICK,            // Madgwick 6축 필터 (gain = beta, 예: 0.1)
+} imu_fusion_algorithm_t;
+
+// 자세 쿼터니언 (단위 쿼터니언, 센서 좌표계 → 기준 좌표계)
+typedef struct {
+    float w;
+    float x;
+    float y;
+    float z;
+} imu_quaternion_t;
+
+// 오일러각 (단위: 도, ZYX 순서)
+typedef struct {
+    float roll;
+    float pitch;
+    float yaw;
+} imu_euler_t;
+
+// 디바이스 하나의 퓨전 상태 (두 알고리즘 모두 쿼터니언이 상태)
+typedef struct {
+    imu_fusion_algorithm_t algorithm;
+    float gain;
+    imu_quaternion_t q;
+    int64_t last_timestamp_us;
+    bool initialized;
+} imu_fusion_t;
+
+/**
+ * @brief 퓨전 상태 초기화
+ *
+ * @param fusion 퓨전 상태
+ * @param algorithm 사용할 알고리즘
+ * @param gain 상보 필터 alpha(0~1) 또는 Madgwick beta
+ */
+void imu_fusion_init(imu_fusion_t *fusion, imu_fusion_algorithm_t algorithm, float gain);
+
+/**
+ * @brief 자세 초기화 (다음 샘플의 가속도로 기울기부터 다시 시작)
+ *
+ * @param fusion 퓨전 상태
+ */
+void imu_fusion_reset(imu_fusion_t *fusion);
+
+/**
+ * @brief 샘플 하나로 자세 갱신
+ *
+ * 모든 샘플에 대해 순서대로 호출해야 합니다. 샘플 간격은 타임스탬프 차이로 계산하고,
+ * 간격이 너무 길면(폴링 모드 등) 적분하지 않고 가속도로 기울기를 다시 잡습니다.
+ *
+ * @param fusion 퓨전 상태
+ * @param ax, ay, az 가속도 (g)
+ * @param gx, gy, gz 각속도 (°/s)
+ * @param timestamp_us 샘플 타임스탬프 (마이크로초)
+ */
+void imu_fusion_update(imu_fusion_t *fusion, float ax, float ay, float az,
+                       float gx, float gy, float gz, int64_t timestamp_us);
+
+/**
+ * @brief 현재 자세 쿼터니언 조회
+ *
+ * @param fusion 퓨전 상태
+ * @param q 쿼터니언을 저장할 포인터
+ */
+void imu_fusion_get_quaternion(const imu_fusion_t *fusion, imu_quaternion_t *q);
+
+/**
+ * @brief 현재 자세 오일러각 조회
+ *
+ * @param fusion 퓨전 상태
+ * @param euler 오일러각(도)을 저장할 포인터
+ */
+void imu_fusion_get_euler(const imu_fusion_t *fusion, imu_euler_t *euler);
+
+/**
+ * @brief 자세 갱신 처리 속도 측정
+ *
+ * 별도 퓨전 상태로 합성 입력(기울어진 채 일정 속도 회전)을 처리하므로 실행 중인 자세 추정에는 영향이 없습니다.
+ *
+ * @param algorithm 측정할 알고리즘
+ * @param iterations 갱신 횟수
+ * @return 샘플 1개 갱신당 CPU 사이클 (실패 시 0)
+ */
+uint32_t imu_fusion_benchmark(imu_fusion_algorithm_t algorithm, size_t iterations);
+
+#endif // IMU_FUSION_H
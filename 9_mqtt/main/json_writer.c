@@ -0,0 +1,153 @@
+/* 고정 소수점 JSON 작성기 구현 */
+
+#include "json_writer.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// "00" ~ "99"
+static const char digit_pairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+static const uint32_t pow10_table[JSON_FIXED_MAX_DECIMALS + 1] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+/**
+ * @brief 숫자를 end 바로 앞부터 거꾸로 쓰기 (min_digits보다 짧으면 앞을 0으로 채움)
+ *
+ * @return 첫 글자 위치
+ */
+static char *json_digits(char *end, uint32_t value, unsigned min_digits)
+{
+    char *p = end;
+    while (value >= 100) {
+        const uint32_t pair = value % 100;
+        value /= 100;
+        p -= 2;
+        memcpy(p, &digit_pairs[pair * 2], 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, &digit_pairs[value * 2], 2);
+    } else {
+        *--p = '0' + value;
+    }
+    while ((unsigned)(end - p) < min_digits) {
+        *--p = '0';
+    }
+    return p;
+}
+
+/**
+ * @brief 부호 없는 정수 추가
+ */
+void json_put_u32(json_writer_t *w, uint32_t value)
+{
+    char tmp[10];
+    char *p = json_digits(tmp + sizeof(tmp), value, 1);
+    json_put_raw(w, p, tmp + sizeof(tmp) - p);
+}
+
+/**
+ * @brief 부호 있는 64비트 정수 추가
+ */
+void json_put_i64(json_writer_t *w, int64_t value)
+{
+    char tmp[20];
+    char *end = tmp + sizeof(tmp);
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    char *p = end;
+
+    // 64비트 나눗셈은 8자리 단위로만 (나머지는 32비트 연산)
+    while (magnitude > UINT32_MAX) {
+        const uint32_t low = magnitude % 100000000u;
+        magnitude /= 100000000u;
+        p = json_digits(p, low, 8);
+    }
+    p = json_digits(p, (uint32_t)magnitude, 1);
+    if (value < 0) {
+        *--p = '-';
+    }
+    json_put_raw(w, p, end - p);
+}
+
+/**
+ * @brief 실수를 소수점 아래 decimals자리로 추가
+ *
+ * float는 m x 2^e (m은 24비트 이하)이므로 m x 10^d를 64비트로 정확히 계산한 뒤
+ * 2^e만큼 밀면서 버리는 비트로 최근접 짝수 반올림을 합니다 (printf와 같은 규칙, 오차 없음).
+ */
+void json_put_fixed(json_writer_t *w, float value, unsigned decimals)
+{
+    char tmp[64];
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    const bool negative = bits >> 31;
+    const int exponent = (bits >> 23) & 0xFF;
+    const uint32_t fraction = bits & 0x7FFFFF;
+
+    bool ok = exponent != 0xFF && decimals <= JSON_FIXED_MAX_DECIMALS;
+    uint64_t scaled = 0;
+    if (ok) {
+        const uint32_t mantissa = exponent ? fraction | 0x800000 : fraction;
+        const int shift = exponent ? exponent - 150 : -149;
+        const uint64_t product = (uint64_t)mantissa * pow10_table[decimals];    // 2^44 미만
+
+        if (shift >= 0) {
+            ok = shift < 20 && (product << shift) <= UINT32_MAX;
+            scaled = product << shift;
+        } else if (shift < -63) {
+            scaled = 0;     // 0.5 미만이므로 0
+        } else {
+            const uint64_t half = 1ull << (-shift - 1);
+            const uint64_t rest = product & ((half << 1) - 1);
+            scaled = product >> -shift;
+            if (rest > half || (rest == half && (scaled & 1))) {
+                scaled++;
+            }
+            ok = scaled <= UINT32_MAX;
+        }
+    }
+    if (!ok) {
+        // NaN / 무한대 / 정수 부분이 32비트를 넘는 값 (센서 값에서는 나오지 않음)
+        int len = snprintf(tmp, sizeof(tmp), "%.*f", (int)decimals, (double)value);
+        json_put_raw(w, tmp, len < (int)sizeof(tmp) ? len : (int)sizeof(tmp) - 1);
+        return;
+    }
+
+    char *end = tmp + sizeof(tmp);
+    char *p = end;
+    uint32_t integer = (uint32_t)scaled;
+    if (decimals > 0) {
+        const uint32_t divisor = pow10_table[decimals];
+        p = json_digits(p, integer % divisor, decimals);
+        *--p = '.';
+        integer /= divisor;
+    }
+    p = json_digits(p, integer, 1);
+    if (negative) {
+        *--p = '-';     // printf처럼 0으로 반올림된 음수도 "-0.000"
+    }
+    json_put_raw(w, p, end - p);
+}
+
+/**
+ * @brief 끝에 '\0'을 쓰고 길이 반환
+ */
+int json_writer_finish(json_writer_t *w)
+{
+    if (w->size > 0) {
+        w->buf[w->len < w->size ? w->len : w->size - 1] = '\0';
+    }
+    return (int)w->len;
+}
@@ -0,0 +1,76 @@
+/* 고정 소수점 JSON 작성기 헤더
+ * 6축 JSON(샘플 / 배치)을 snprintf 없이 만들기 위한 작은 출력 함수 모음입니다.
+ *
+ * 실수는 float 비트를 정수로 풀어 10^소수자리를 곱한 정수로 바꾼 뒤(반올림은 printf와 같은 최근접 짝수),
+ * 두 자리씩 미리 만든 숫자 표로 문자열을 씁니다. newlib의 실수 변환(_dtoa_r)을 거치지 않으면서
+ * "%.3f" / "%.2f"와 같은 바이트를 만듭니다 (-0.000 등 부호 포함, NaN / 무한대 / 아주 큰 값은 snprintf로 처리).
+ *
+ * 버퍼가 모자라면 snprintf처럼 쓸 수 있는 만큼만 쓰고 길이는 계속 셉니다.
+ *   json_writer_t w;
+ *   json_writer_init(&w, buf, size);
+ *   json_put_literal(&w, "{\"x\":");
+ *   json_put_fixed(&w, value, 3);
+ *   int len = json_writer_finish(&w);   // len >= size면 잘림
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define JSON_FIXED_MAX_DECIMALS 6
+
+// 출력 위치
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;             // 버퍼가 충분했다면 쓴 길이 (size 이상이면 잘림)
+} json_writer_t;
+
+static inline void json_writer_init(json_writer_t *w, char *buf, size_t size)
+{
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+}
+
+/**
+ * @brief 문자열 그대로 추가 (이스케이프 없음)
+ */
+static inline void json_put_raw(json_writer_t *w, const char *text, size_t len)
+{
+    if (w->len + len < w->size) {
+        memcpy(w->buf + w->len, text, len);
+    } else if (w->len < w->size) {
+        memcpy(w->buf + w->len, text, w->size - w->len - 1);
+    }
+    w->len += len;
+}
+
+#define json_put_literal(w, text) json_put_raw((w), (text), sizeof(text) - 1)
+
+/**
+ * @brief 부호 없는 정수 추가 ("%lu")
+ */
+void json_put_u32(json_writer_t *w, uint32_t value);
+
+/**
+ * @brief 부호 있는 64비트 정수 추가 ("%lld")
+ */
+void json_put_i64(json_writer_t *w, int64_t value);
+
+/**
+ * @brief 실수를 소수점 아래 decimals자리로 추가 ("%.<decimals>f"와 같은 결과)
+ *
+ * @param decimals 0 ~ JSON_FIXED_MAX_DECIMALS
+ */
+void json_put_fixed(json_writer_t *w, float value, unsigned decimals);
+
+/**
+ * @brief 끝에 '\0'을 쓰고 길이 반환 (snprintf 반환값과 같음)
+ */
+int json_writer_finish(json_writer_t *w);
+
+#endif // JSON_WRITER_H
@@ -0,0 +1,223 @@
+/* 지연 추적 구현 */
+
+#include "latency_trace.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+// PUBACK을 기다리는 메시지 (발행 태스크에서 추가, MQTT 태스크에서 제거)
+typedef struct {
+    int msg_id;             // 0: 빈 칸
+    int64_t enqueue_us;
+} latency_pending_t;
+
+static portMUX_TYPE latency_lock = portMUX_INITIALIZER_UNLOCKED;
+static latency_pending_t pending[LATENCY_PENDING_MAX];
+static size_t pending_next = 0;
+static uint32_t hist[LATENCY_HIST_BUCKETS + 1];
+static uint32_t ack_count = 0;
+static uint32_t untracked = 0;
+static uint32_t evicted = 0;
+static uint32_t max_us = 0;
+
+// 시계 차이 (최근 LATENCY_SYNC_WINDOW번의 결과, 발행 태스크 / 명령 태스크(PONG))
+typedef struct {
+    int64_t offset_us;
+    uint32_t rtt_us;
+} latency_sync_sample_t;
+
+static latency_sync_sample_t sync_samples[LATENCY_SYNC_WINDOW];
+static uint32_t sync_exchanges = 0;
+static uint32_t last_ping_id = 0;
+
+/**
+ * @brief 지연 → 히스토그램 구간 (8µs 미만은 1µs 간격, 그 위는 옥타브마다 4구간)
+ */
+static uint32_t latency_bucket(uint32_t us)
+{
+    if (us < 8) {
+        return us;
+    }
+    const uint32_t msb = 31 - __builtin_clz(us);
+    const uint32_t bucket = 8 + (msb - 3) * 4 + ((us >> (msb - 2)) & 3);
+    return bucket < LATENCY_HIST_BUCKETS ? bucket : LATENCY_HIST_BUCKETS;
+}
+
+/**
+ * @brief 구간 상한 (µs)
+ */
+static uint32_t latency_bucket_upper(uint32_t bucket)
+{
+    if (bucket < 8) {
+        return bucket + 1;
+    }
+    const uint32_t msb = 3 + (bucket - 8) / 4;
+    const uint32_t sub = (bucket - 8) % 4;
+    return (5 + sub) << (msb - 2);
+}
+
+/**
+ * @brief PUBACK 대기 등록
+ */
+void latency_track_publish(int msg_id, int64_t enqueue_us)
+{
+    if (msg_id < 0) {
+        return;
+    }
+
+    portENTER_CRITICAL(&latency_lock);
+    if (msg_id == 0) {
+        // QoS 0: 전송 완료 이벤트가 없어 측정할 수 없음
+        untracked++;
+        portEXIT_CRITICAL(&latency_lock);
+        return;
+    }
+    if (pending[pending_next].msg_id != 0) {
+        evicted++;
+    }
+    pending[pending_next] = (latency_pending_t) { .msg_id = msg_id, .enqueue_us = enqueue_us };
+    pending_next = (pending_next + 1) % LATENCY_PENDING_MAX;
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+/**
+ * @brief PUBACK 수신 처리
+ */
+void latency_on_puback(int msg_id, int64_t now_us)
+{
+    portENTER_CRITICAL(&latency_lock);
+    for (size_t i = 0; i < LATENCY_PENDING_MAX; i++) {
+        if (pending[i].msg_id != msg_id) {
+            continue;
+        }
+        const int64_t elapsed = now_us - pending[i].enqueue_us;
+        const uint32_t us = elapsed < 0 ? 0 : (elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed);
+        hist[latency_bucket(us)]++;
+        ack_count++;
+        if (us > max_us) {
+            max_us = us;
+        }
+        pending[i].msg_id = 0;
+        break;
+    }
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+/**
+ * @brief 백분위 (누적 개수가 count * percent / 100에 이르는 첫 구간의 상한)
+ */
+static uint32_t latency_percentile(const uint32_t *h, uint32_t count, uint32_t percent)
+{
+    const uint32_t target = count - (uint32_t)((uint64_t)count * (100 - percent) / 100);
+    uint32_t cumulative = 0;
+    for (uint32_t i = 0; i <= LATENCY_HIST_BUCKETS; i++) {
+        cumulative += h[i];
+        if (cumulative >= target) {
+            return i < LATENCY_HIST_BUCKETS ? latency_bucket_upper(i) : UINT32_MAX;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief PUBACK 지연 통계 조회
+ */
+void latency_get_stats(latency_stats_t *stats, bool reset)
+{
+    static uint32_t snapshot[LATENCY_HIST_BUCKETS + 1];
+
+    portENTER_CRITICAL(&latency_lock);
+    memcpy(snapshot, hist, sizeof(snapshot));
+    stats->count = ack_count;
+    stats->untracked = untracked;
+    stats->evicted = evicted;
+    stats->max_us = max_us;
+    if (reset) {
+        memset(hist, 0, sizeof(hist));
+        ack_count = 0;
+        untracked = 0;
+        evicted = 0;
+        max_us = 0;
+    }
+    portEXIT_CRITICAL(&latency_lock);
+
+    // 통계는 발행 태스크에서만 주기적으로 조회하므로 스냅샷 버퍼를 공유
+    stats->p50_us = stats->count ? latency_percentile(snapshot, stats->count, 50) : 0;
+    stats->p90_us = stats->count ? latency_percentile(snapshot, stats->count, 90) : 0;
+    stats->p99_us = stats->count ? latency_percentile(snapshot, stats->count, 99) : 0;
+    if (stats->p99_us > stats->max_us) {
+        stats->p99_us = stats->max_us;
+    }
+}
+
+/**
+ * @brief PUBACK 대기 목록 비우기
+ */
+void latency_clear_pending(void)
+{
+    portENTER_CRITICAL(&latency_lock);
+    memset(pending, 0, sizeof(pending));
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+/**
+ * @brief 보낼 ping 번호 생성
+ */
+uint32_t latency_sync_next_ping(void)
+{
+    portENTER_CRITICAL(&latency_lock);
+    uint32_t id = ++last_ping_id;
+    portEXIT_CRITICAL(&latency_lock);
+    return id;
+}
+
+/**
+ * @brief pong 수신 처리
+ */
+bool latency_sync_on_pong(uint32_t id, int64_t t1_us, int64_t t2_us, int64_t t3_us, int64_t t4_us)
+{
+    const int64_t rtt = (t4_us - t1_us) - (t3_us - t2_us);
+    if (rtt < 0 || t3_us < t2_us) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&latency_lock);
+    const bool current = (id == last_ping_id);
+    if (current) {
+        sync_samples[sync_exchanges % LATENCY_SYNC_WINDOW] = (latency_sync_sample_t) {
+            .offset_us = ((t2_us - t1_us) + (t3_us - t4_us)) / 2,
+            .rtt_us = rtt > UINT32_MAX ? UINT32_MAX : (uint32_t)rtt,
+        };
+        sync_exchanges++;
+    }
+    portEXIT_CRITICAL(&latency_lock);
+    return current;
+}
+
+/**
+ * @brief 시계 차이 추정 결과 조회 (최근 결과 중 RTT가 가장 짧은 것)
+ */
+void latency_sync_get(latency_sync_t *sync)
+{
+    portENTER_CRITICAL(&latency_lock);
+    const uint32_t n = sync_exchanges < LATENCY_SYNC_WINDOW ? sync_exchanges : LATENCY_SYNC_WINDOW;
+    sync->valid = n > 0;
+    sync->exchanges = sync_exchanges;
+    sync->offset_us = 0;
+    sync->rtt_us = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (i == 0 || sync_samples[i].rtt_us < sync->rtt_us) {
+            sync->offset_us = sync_samples[i].offset_us;
+            sync->rtt_us = sync_samples[i].rtt_us;
+        }
+    }
+    portEXIT_CRITICAL(&latency_lock);
+}
+
+/**
+ * @brief 지연 추적용 정적 RAM
+ */
+size_t latency_trace_ram_size(void)
+{
+    return sizeof(pending) + sizeof(hist) + sizeof(sync_samples);
+}
@@ -0,0 +1,104 @@
+/* 지연 추적 헤더
+ * 1) 샘플을 큐에 넣은 시각부터 브로커 PUBACK까지의 지연 히스토그램 (QoS 1 메시지)
+ * 2) 명령 / 응답 토픽의 ping/pong으로 디바이스 시계와 수신 쪽(Jetson) 시계의 차이 추정
+ *
+ * 시계 차이 (NTP 방식, t1/t4는 디바이스 esp_timer µs, t2/t3는 수신 쪽 µs)
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2   (수신 쪽 시각 = 디바이스 시각 + offset)
+ *   rtt    = (t4 - t1) - (t3 - t2)
+ * 최근 LATENCY_SYNC_WINDOW번 중 RTT가 가장 짧은 결과를 사용합니다 (큐 지연이 가장 적게 섞인 값).
+ */
+
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// PUBACK 지연 히스토그램 (1/4 옥타브 구간: 8µs 미만은 1µs, 그 위는 약 19% 간격, 최대 약 134초)
+#define LATENCY_HIST_BUCKETS 104
+#define LATENCY_PENDING_MAX 32      // PUBACK을 기다리는 메시지 수 (넘치면 가장 오래된 것부터 추적 포기)
+#define LATENCY_SYNC_WINDOW 8       // 시계 차이 추정에 쓰는 최근 ping/pong 수
+
+// PUBACK 지연 통계 (마지막 초기화 이후)
+typedef struct {
+    uint32_t count;         // PUBACK을 받은 메시지 수
+    uint32_t untracked;     // QoS 0이라 PUBACK이 없어 측정하지 못한 메시지 수
+    uint32_t evicted;       // PUBACK 전에 추적 목록에서 밀려난 메시지 수
+    uint32_t p50_us;        // 구간 상한 (µs)
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_stats_t;
+
+// 시계 차이 추정 결과
+typedef struct {
+    bool valid;             // pong을 한 번 이상 받음
+    int64_t offset_us;      // 수신 쪽 시각 - 디바이스 시각
+    uint32_t rtt_us;        // 추정에 사용한 왕복 시간
+    uint32_t exchanges;     // 받은 pong 수
+} latency_sync_t;
+
+/**
+ * @brief 발행한 메시지의 PUBACK 대기 등록 (발행 태스크)
+ *
+ * QoS 0 메시지(msg_id 0)는 PUBACK이 없으므로 추적하지 않고 untracked에만 셉니다.
+ *
+ * @param msg_id esp_mqtt_client_enqueue() 반환값 (QoS 1, QoS 0은 0)
+ * @param enqueue_us 메시지의 첫 샘플을 큐에 넣은 시각 (esp_timer, µs)
+ */
+void latency_track_publish(int msg_id, int64_t enqueue_us);
+
+/**
+ * @brief PUBACK 수신 처리 (MQTT_EVENT_PUBLISHED, MQTT 태스크)
+ *
+ * @param msg_id 메시지 ID
+ * @param now_us 현재 시각 (esp_timer, µs)
+ */
+void latency_on_puback(int msg_id, int64_t now_us);
+
+/**
+ * @brief PUBACK 지연 통계 조회
+ *
+ * @param stats 결과를 저장할 포인터
+ * @param reset true면 조회 후 히스토그램 초기화
+ */
+void latency_get_stats(latency_stats_t *stats, bool reset);
+
+/**
+ * @brief 연결이 끊겨 PUBACK을 받을 수 없는 메시지 추적 중단
+ */
+void latency_clear_pending(void);
+
+/**
+ * @brief 지연 추적용 정적 RAM (바이트, 계측의 RAM 사용량 보고용)
+ */
+size_t latency_trace_ram_size(void);
+
+/**
+ * @brief 보낼 ping 번호 생성
+ *
+ * @return ping 번호
+ */
+uint32_t latency_sync_next_ping(void);
+
+/**
+ * @brief pong 수신 처리
+ *
+ * @param id ping 번호
+ * @param t1_us ping을 보낸 디바이스 시각
+ * @param t2_us 수신 쪽이 ping을 받은 시각
+ * @param t3_us 수신 쪽이 pong을 보낸 시각
+ * @param t4_us pong을 받은 디바이스 시각
+ * @return true 유효한 pong (마지막으로 보낸 ping에 대한 응답)
+ */
+bool latency_sync_on_pong(uint32_t id, int64_t t1_us, int64_t t2_us, int64_t t3_us, int64_t t4_us);
+
+/**
+ * @brief 시계 차이 추정 결과 조회
+ *
+ * @param sync 결과를 저장할 포인터
+ */
+void latency_sync_get(latency_sync_t *sync);
+
+#endif // LATENCY_TRACE_H
@@ -0,0 +1,201 @@
+/* 파이프라인 계측 구현 */
+
+#include "metrics.h"
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#define METRICS_CYCLES_PER_US 1000      // 호스트의 esp_cpu_get_cycle_count()는 나노초
+#else
+#define METRICS_CYCLES_PER_US CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#endif
+
+// 단계별 히스토그램 (수집 태스크 / 발행 태스크에서 기록)
+typedef struct {
+    uint32_t hist[METRICS_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+    uint64_t sum;
+} metrics_stage_hist_t;
+
+static const char *const stage_names[METRICS_STAGE_COUNT] = {
+    [METRICS_STAGE_I2C_READ] = "i2c_read",
+    [METRICS_STAGE_CALIBRATION] = "calibration",
+    [METRICS_STAGE_CONVERT] = "convert",
+    [METRICS_STAGE_FUSION] = "fusion",
+    [METRICS_STAGE_DSP] = "dsp",
+    [METRICS_STAGE_ENQUEUE] = "enqueue",
+    [METRICS_STAGE_FORMAT] = "format",
+    [METRICS_STAGE_PUBLISH] = "publish",
+    [METRICS_STAGE_LOG] = "log",
+};
+
+static portMUX_TYPE metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+static metrics_stage_hist_t stages[METRICS_STAGE_COUNT];
+static int64_t window_start_us = 0;
+static TaskHandle_t tasks[METRICS_MAX_TASKS];
+static size_t task_count = 0;
+
+// 서브시스템별 RAM 사용량 (초기화 중에만 등록)
+typedef struct {
+    const char *name;
+    size_t bytes;
+} metrics_ram_entry_t;
+
+static metrics_ram_entry_t ram_entries[METRICS_MAX_RAM_ENTRIES];
+static size_t ram_entry_count = 0;
+
+/**
+ * @brief 사이클 → 히스토그램 구간 (0: 0사이클, b: 2^(b-1) ~ 2^b - 1)
+ */
+static inline uint32_t metrics_bucket(uint32_t cycles)
+{
+    return cycles ? 32 - __builtin_clz(cycles) : 0;
+}
+
+/**
+ * @brief 단계 소요 사이클 기록
+ */
+void metrics_record(metrics_stage_t stage, uint32_t cycles)
+{
+    metrics_stage_hist_t *h = &stages[stage];
+
+    portENTER_CRITICAL(&metrics_lock);
+    h->hist[metrics_bucket(cycles)]++;
+    h->count++;
+    h->sum += cycles;
+    if (cycles > h->max) {
+        h->max = cycles;
+    }
+    portEXIT_CRITICAL(&metrics_lock);
+}
+
+/**
+ * @brief 단계 이름
+ */
+const char *metrics_stage_name(metrics_stage_t stage)
+{
+    return stage < METRICS_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+/**
+ * @brief 스택 여유를 보고할 태스크 등록
+ */
+void metrics_register_task(TaskHandle_t task)
+{
+    if (task == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&metrics_lock);
+    if (task_count < METRICS_MAX_TASKS) {
+        tasks[task_count++] = task;
+    }
+    portEXIT_CRITICAL(&metrics_lock);
+}
+
+/**
+ * @brief 백분위 (누적 개수가 count * percent / 100에 이르는 첫 구간의 상한)
+ */
+static uint32_t metrics_percentile(const metrics_stage_hist_t *h, uint32_t percent)
+{
+    const uint32_t target = h->count - (uint32_t)((uint64_t)h->count * (100 - percent) / 100);
+    uint32_t cumulative = 0;
+    for (uint32_t b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        cumulative += h->hist[b];
+        if (cumulative >= target) {
+            const uint32_t upper = b == 0 ? 0 : (b >= 32 ? UINT32_MAX : (1u << b) - 1);
+            return upper < h->max ? upper : h->max;
+        }
+    }
+    return h->max;
+}
+
+/**
+ * @brief 단계별 통계, 힙, 태스크 스택 여유 조회
+ */
+void metrics_get(metrics_snapshot_t *snapshot, bool reset)
+{
+    TaskHandle_t task_copy[METRICS_MAX_TASKS];
+    const int64_t now_us = esp_timer_get_time();
+
+    // 발행 태스크와 명령 태스크(METRICS 명령)가 모두 조회하므로 잠금 안에서 바로 계산 (구간 33개 x 단계 수)
+    portENTER_CRITICAL(&metrics_lock);
+    for (size_t s = 0; s < METRICS_STAGE_COUNT; s++) {
+        const metrics_stage_hist_t *h = &stages[s];
+        metrics_stage_stats_t *out = &snapshot->stages[s];
+        out->count = h->count;
+        out->mean = h->count ? (uint32_t)(h->sum / h->count) : 0;
+        out->p50 = h->count ? metrics_percentile(h, 50) : 0;
+        out->p99 = h->count ? metrics_percentile(h, 99) : 0;
+        out->max = h->max;
+    }
+    snapshot->window_ms = (now_us - window_start_us) / 1000;
+    if (reset) {
+        memset(stages, 0, sizeof(stages));
+        window_start_us = now_us;
+    }
+    snapshot->task_count = task_count;
+    memcpy(task_copy, tasks, sizeof(task_copy));
+    portEXIT_CRITICAL(&metrics_lock);
+
+    // 태스크 이름 / 스택 조회는 잠금 밖에서
+    for (size_t i = 0; i < snapshot->task_count; i++) {
+        snapshot->tasks[i].name = pcTaskGetName(task_copy[i]);
+        snapshot->tasks[i].stack_free = uxTaskGetStackHighWaterMark(task_copy[i]);
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    snapshot->heap_valid = false;
+    snapshot->heap_free = 0;
+    snapshot->heap_min_free = 0;
+#else
+    snapshot->heap_valid = true;
+    snapshot->heap_free = esp_get_free_heap_size();
+    snapshot->heap_min_free = esp_get_minimum_free_heap_size();
+#endif
+    snapshot->cycles_per_us = METRICS_CYCLES_PER_US;
+}
+
+/**
+ * @brief 서브시스템 RAM 사용량 등록
+ */
+void metrics_add_ram_budget(const char *subsystem, size_t bytes)
+{
+    portENTER_CRITICAL(&metrics_lock);
+    size_t i = 0;
+    while (i < ram_entry_count && strcmp(ram_entries[i].name, subsystem) != 0) {
+        i++;
+    }
+    if (i < ram_entry_count) {
+        ram_entries[i].bytes += bytes;
+    } else if (i < METRICS_MAX_RAM_ENTRIES) {
+        ram_entries[i] = (metrics_ram_entry_t) { .name = subsystem, .bytes = bytes };
+        ram_entry_count++;
+    }
+    portEXIT_CRITICAL(&metrics_lock);
+}
+
+/**
+ * @brief 서브시스템별 RAM 사용량과 힙 여유 로그 출력
+ */
+void metrics_log_ram_budget(void)
+{
+    size_t total = sizeof(stages) + sizeof(tasks) + sizeof(ram_entries);
+
+    ESP_LOGI(TAG_MAIN, "RAM budget (%s allocation):", APP_STATIC_ALLOC ? "static" : "dynamic");
+    for (size_t i = 0; i < ram_entry_count; i++) {
+        ESP_LOGI(TAG_MAIN, "  %-14s %7u bytes", ram_entries[i].name, (unsigned)ram_entries[i].bytes);
+        total += ram_entries[i].bytes;
+    }
+    ESP_LOGI(TAG_MAIN, "  %-14s %7u bytes", "metrics", (unsigned)(sizeof(stages) + sizeof(tasks) + sizeof(ram_entries)));
+    ESP_LOGI(TAG_MAIN, "  %-14s %7u bytes", "total", (unsigned)total);
+#if !CONFIG_IDF_TARGET_LINUX
+    ESP_LOGI(TAG_MAIN, "Heap free %lu bytes, min free %lu bytes",
+             (unsigned long)esp_get_free_heap_size(), (unsigned long)esp_get_minimum_free_heap_size());
+#endif
+}
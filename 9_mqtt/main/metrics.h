@@ -0,0 +1,121 @@
+/* 파이프라인 계측 헤더
+ * 센서 읽기 → 변환 → 큐 → JSON 생성 → 발행 경로의 단계별 소요 CPU 사이클(esp_cpu_get_cycle_count)을
+ * 2배 간격 히스토그램으로 모으고, 힙 여유와 태스크 스택 최소 여유와 함께 조회합니다.
+ *
+ * 서브시스템별 정적 RAM(metrics_add_ram_budget)을 모아 시작할 때 한 번 출력합니다.
+ *
+ * METRICS_ENABLE이 0이면 METRICS_START() / METRICS_STOP()이 빈 매크로가 되어 계측 코드가 컴파일되지 않습니다.
+ *   esp_cpu_cycle_count_t start = METRICS_START();
+ *   ...
+ *   METRICS_STOP(METRICS_STAGE_CONVERT, start);
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "config.h"
+
+#define METRICS_HIST_BUCKETS 33     // 0 사이클 + 2^0 ~ 2^31 구간
+#define METRICS_MAX_TASKS 5         // 스택 여유를 보고할 태스크 수
+#define METRICS_MAX_RAM_ENTRIES 12  // RAM 사용량을 보고할 서브시스템 수
+
+// 계측 단계 (호출 1회 단위, 배치는 메시지 하나가 1회)
+typedef enum {
+    METRICS_STAGE_I2C_READ = 0,     // I2C 읽기 + 디코딩 (보정 포함, DATA_RDY 모드는 완료 대기만)
+    METRICS_STAGE_CALIBRATION,      // 보정 오프셋 적용 (샘플당)
+    METRICS_STAGE_CONVERT,          // 물리 단위 변환
+    METRICS_STAGE_FUSION,           // 자세 갱신
+    METRICS_STAGE_DSP,              // 발행 전 필터
+    METRICS_STAGE_ENQUEUE,          // 샘플 큐에 넣기
+    METRICS_STAGE_FORMAT,           // 물리 단위 변환 + JSON / 바이너리 생성 (발행 태스크)
+    METRICS_STAGE_PUBLISH,          // esp_mqtt_client_enqueue()
+    METRICS_STAGE_LOG,              // 발행 로그 출력
+    METRICS_STAGE_COUNT,
+} metrics_stage_t;
+
+// 단계별 통계 (사이클)
+typedef struct {
+    uint32_t count;
+    uint32_t mean;
+    uint32_t p50;           // 구간 상한 (최대 2배 크게 보고)
+    uint32_t p99;
+    uint32_t max;
+} metrics_stage_stats_t;
+
+// 태스크 스택 최소 여유
+typedef struct {
+    const char *name;
+    uint32_t stack_free;    // 바이트 (uxTaskGetStackHighWaterMark)
+} metrics_task_stats_t;
+
+// 조회 결과 (마지막 초기화 이후 구간)
+typedef struct {
+    metrics_stage_stats_t stages[METRICS_STAGE_COUNT];
+    metrics_task_stats_t tasks[METRICS_MAX_TASKS];
+    size_t task_count;
+    bool heap_valid;        // 호스트 시뮬레이션에서는 false
+    uint32_t heap_free;
+    uint32_t heap_min_free;
+    uint32_t cycles_per_us; // 사이클 → µs 환산 (CPU 클럭 MHz, 호스트는 나노초 단위라 1000)
+    uint32_t window_ms;
+} metrics_snapshot_t;
+
+#if METRICS_ENABLE
+#define METRICS_START() esp_cpu_get_cycle_count()
+#define METRICS_STOP(stage, start) metrics_record((stage), (uint32_t)(esp_cpu_get_cycle_count() - (start)))
+#else
+#define METRICS_START() ((esp_cpu_cycle_count_t)0)
+#define METRICS_STOP(stage, start) ((void)(start))
+#endif
+
+/**
+ * @brief 단계 소요 사이클 기록 (METRICS_STOP()에서 호출, 여러 태스크에서 호출 가능)
+ *
+ * @param stage 계측 단계
+ * @param cycles 소요 사이클
+ */
+void metrics_record(metrics_stage_t stage, uint32_t cycles);
+
+/**
+ * @brief 단계 이름 (JSON 키)
+ *
+ * @param stage 계측 단계
+ * @return 이름 문자열
+ */
+const char *metrics_stage_name(metrics_stage_t stage);
+
+/**
+ * @brief 스택 여유를 보고할 태스크 등록 (최대 METRICS_MAX_TASKS개, NULL은 무시)
+ *
+ * @param task 태스크 핸들
+ */
+void metrics_register_task(TaskHandle_t task);
+
+/**
+ * @brief 단계별 통계, 힙, 태스크 스택 여유 조회
+ *
+ * @param snapshot 결과를 저장할 포인터
+ * @param reset true면 조회 후 히스토그램 초기화
+ */
+void metrics_get(metrics_snapshot_t *snapshot, bool reset);
+
+/**
+ * @brief 서브시스템 RAM 사용량 등록 (각 모듈의 초기화 함수에서 호출, 같은 이름은 더함)
+ *
+ * @param subsystem 서브시스템 이름 (문자열 상수)
+ * @param bytes 정적 할당(또는 시작할 때 한 번 할당하는) 바이트 수
+ */
+void metrics_add_ram_budget(const char *subsystem, size_t bytes);
+
+/**
+ * @brief 서브시스템별 RAM 사용량과 힙 여유 로그 출력 (초기화가 끝난 뒤 호출)
+ */
+void metrics_log_ram_budget(void);
+
+#endif // METRICS_H
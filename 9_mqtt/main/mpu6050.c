@@ -1,270 +1,1371 @@
 /* MPU6050 센서 드라이버 구현 */
 
 #include "mpu6050.h"
+#include "metrics.h"
 #include "config.h"
 
 #include <string.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_crc.h"
+#include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
 
 // MPU6050 레지스터 주소
-#define MPU6050_SENSOR_ADDR 0x68
 #define MPU6050_WHO_AM_I_REG_ADDR 0x75
 #define MPU6050_PWR_MGMT_1_REG_ADDR 0x6B
 #define MPU6050_ACCEL_XOUT_H 0x3B
 #define MPU6050_ACCEL_CONFIG_REG 0x1C
 #define MPU6050_GYRO_CONFIG_REG 0x1B
+#define MPU6050_SMPLRT_DIV_REG 0x19
+#define MPU6050_CONFIG_REG 0x1A
+#define MPU6050_FIFO_EN_REG 0x23
+#define MPU6050_INT_PIN_CFG_REG 0x37
+#define MPU6050_INT_ENABLE_REG 0x38
+#define MPU6050_INT_STATUS_REG 0x3A
+#define MPU6050_MOT_THR_REG 0x1F
+#define MPU6050_MOT_DUR_REG 0x20
+#define MPU6050_USER_CTRL_REG 0x6A
+#define MPU6050_FIFO_COUNTH_REG 0x72
+#define MPU6050_FIFO_R_W_REG 0x74
 #define I2C_MASTER_TIMEOUT_MS 1000
 #define CALIBRATION_SAMPLES 200
 
-// 가속도계/자이로스코프 범위
-#define ACCEL_RANGE_2G 0x00
-#define GYRO_RANGE_250 0x00
+// 샘플링 주파수 설정
+#define MPU6050_GYRO_RATE_DLPF_OFF_HZ 8000  // DLPF 260Hz(꺼짐)일 때 자이로 출력 주파수
+#define MPU6050_GYRO_RATE_DLPF_ON_HZ 1000   // DLPF 사용 시 자이로 출력 주파수
+#define MPU6050_MAX_SAMPLE_RATE_HZ 1000     // 가속도계 출력 주파수 상한
+
+// FIFO 설정
+#define MPU6050_FRAME_SIZE 14              // 가속도(6) + 온도(2) + 자이로(6)
+#define MPU6050_FIFO_SIZE 1024             // 내부 FIFO 크기 (바이트)
+#define MPU6050_FIFO_EN_ALL 0xF8           // TEMP | XG | YG | ZG | ACCEL
+#define MPU6050_USER_CTRL_FIFO_EN 0x40
+#define MPU6050_USER_CTRL_FIFO_RESET 0x04
+#define MPU6050_FIFO_BURST_FRAMES 36       // 한 번의 I2C 읽기로 가져올 최대 샘플 수
+
+// 비동기 읽기 설정
+#define MPU6050_I2C_ASYNC (MPU6050_I2C_TRANS_QUEUE_DEPTH > 0)
+#define MPU6050_READ_BUFFERS 2             // 번갈아 쓰는 수신 버퍼 수 (= 디바이스당 동시 전송 수)
+
+// 인터럽트 설정
+#define MPU6050_INT_PIN_CFG_RD_CLEAR 0x10  // 액티브 하이, 푸시풀, 50us 펄스, 레지스터 읽으면 해제
+#define MPU6050_INT_ENABLE_DATA_RDY 0x01
+#define MPU6050_INT_ENABLE_MOT 0x40
+
+// 움직임 감지 (가속도 고역 통과 필터 출력이 MOT_THR를 MOT_DUR ms 동안 넘으면 인터럽트)
+#define MPU6050_ACCEL_HPF_5HZ 0x01         // ACCEL_CONFIG[2:0], 움직임 감지에만 사용 (데이터 레지스터는 영향 없음)
+#define MPU6050_MOT_THR_MG_PER_LSB 2
+
+// NVS 보정 데이터 저장 형식
+#define MPU6050_CALIB_NVS_NAMESPACE "mpu6050"
+#define MPU6050_CALIB_NVS_KEY_FMT "calib_%u"  // 디바이스 번호별 키
+#define MPU6050_CALIB_VERSION 1   // mpu6050_calibration_t 형식이 바뀌면 올릴 것
 
-// 보정 오프셋
 typedef struct {
-    int16_t accel_x_offset;
-    int16_t accel_y_offset;
-    int16_t accel_z_offset;
-    int16_t gyro_x_offset;
-    int16_t gyro_y_offset;
-    int16_t gyro_z_offset;
-} mpu6050_calibration_t;
-
-// 전역 변수
-static i2c_master_bus_handle_t bus_handle = NULL;
-static i2c_master_dev_handle_t dev_handle = NULL;
-static mpu6050_calibration_t calibration = {0};
-static float accel_sensitivity = 16384.0;  // ±2g
-static float gyro_sensitivity = 131.0;      // ±250°/s
+    uint16_t version;
+    uint16_t reserved;
+    mpu6050_calibration_t calibration;
+    uint32_t crc;                 // version ~ calibration 의 CRC32
+} mpu6050_calibration_blob_t;
+
+// 가속도계 범위 테이블 (인덱스 = AFS_SEL)
+static const struct {
+    uint16_t full_scale_g;
+    float sensitivity;      // LSB/g
+} accel_range_table[] = {
+    [MPU6050_ACCEL_RANGE_2G] = {2, 16384.0f},
+    [MPU6050_ACCEL_RANGE_4G] = {4, 8192.0f},
+    [MPU6050_ACCEL_RANGE_8G] = {8, 4096.0f},
+    [MPU6050_ACCEL_RANGE_16G] = {16, 2048.0f},
+};
+
+// 자이로스코프 범위 테이블 (인덱스 = FS_SEL)
+static const struct {
+    uint16_t full_scale_dps;
+    float sensitivity;      // LSB/(°/s)
+} gyro_range_table[] = {
+    [MPU6050_GYRO_RANGE_250] = {250, 131.0f},
+    [MPU6050_GYRO_RANGE_500] = {500, 65.5f},
+    [MPU6050_GYRO_RANGE_1000] = {1000, 32.8f},
+    [MPU6050_GYRO_RANGE_2000] = {2000, 16.4f},
+};
+
+// DLPF 대역폭 테이블 (인덱스 = DLPF_CFG, 가속도계 기준 Hz)
+static const uint16_t dlpf_bandwidth_table[] = {
+    [MPU6050_DLPF_260HZ] = 260,
+    [MPU6050_DLPF_184HZ] = 184,
+    [MPU6050_DLPF_94HZ] = 94,
+    [MPU6050_DLPF_44HZ] = 44,
+    [MPU6050_DLPF_21HZ] = 21,
+    [MPU6050_DLPF_10HZ] = 10,
+    [MPU6050_DLPF_5HZ] = 5,
+};
+
+// MPU6050 디바이스 인스턴스
+struct mpu6050_dev_t {
+    i2c_master_bus_handle_t bus;
+    i2c_master_dev_handle_t i2c_dev;
+    uint8_t address;
+    uint8_t device_id;
+    // 보정 오프셋은 기준 범위(±2g, ±250°/s)의 LSB로 저장하고 현재 범위에 맞게 환산해서 적용
+    mpu6050_calibration_t calibration;
+    mpu6050_calibration_t active_offsets;
+    mpu6050_config_t config;
+    uint8_t accel_hpf;              // ACCEL_CONFIG 고역 통과 필터 비트 (움직임 감지용)
+    // 변환 커널용 감도 역수 (나눗셈 대신 곱셈)
+    float accel_scale;
+    float gyro_scale;
+    int64_t sample_period_us;
+    bool fifo_enabled;
+    uint32_t fifo_overflow_count;
+    // 다음 청크가 전송되는 동안 이전 청크를 디코딩하도록 두 버퍼를 번갈아 사용
+    uint8_t fifo_buffer[MPU6050_READ_BUFFERS][MPU6050_FIFO_BURST_FRAMES * MPU6050_FRAME_SIZE];
+    // 단일 샘플 읽기 (mpu6050_read_raw_start / finish)
+    // 디코딩한 샘플은 호출자 버퍼로 복사되므로, 호출자가 이전 샘플을 처리하는 동안 다음 프레임을 받는 용도로는 하나면 충분
+    uint8_t frame_buffer[MPU6050_FRAME_SIZE];
+    int64_t frame_timestamp_us;
+    bool read_pending;
+#if MPU6050_I2C_ASYNC
+    SemaphoreHandle_t trans_done;   // 전송이 끝날 때마다 완료 콜백에서 give
+    volatile bool trans_failed;
+#if APP_STATIC_ALLOC
+    StaticSemaphore_t trans_done_buffer;
+#endif
+#endif
+};
+
+#if APP_STATIC_ALLOC
+// 인스턴스 풀 (수집 태스크에서만 생성 / 삭제)
+static struct mpu6050_dev_t device_pool[MPU6050_MAX_DEVICES];
+static bool device_pool_used[MPU6050_MAX_DEVICES];
+#endif
+
+// 비동기 전송 중에도 유효해야 하는 레지스터 주소 버퍼
+static const uint8_t accel_xout_reg = MPU6050_ACCEL_XOUT_H;
+static const uint8_t fifo_rw_reg = MPU6050_FIFO_R_W_REG;
+
+#if MPU6050_I2C_ASYNC
+/**
+ * @brief I2C 전송 완료 콜백 (ISR 컨텍스트)
+ */
+static bool IRAM_ATTR mpu6050_on_trans_done(i2c_master_dev_handle_t i2c_dev,
+                                            const i2c_master_event_data_t *evt_data, void *arg)
+{
+    mpu6050_handle_t dev = (mpu6050_handle_t)arg;
+    BaseType_t high_task_woken = pdFALSE;
+
+    if (evt_data->event != I2C_EVENT_DONE) {
+        dev->trans_failed = true;
+    }
+    xSemaphoreGiveFromISR(dev->trans_done, &high_task_woken);
+
+    return high_task_woken == pdTRUE;
+}
+
+/**
+ * @brief 대기 시간을 넘긴 전송 정리
+ *
+ * 큐에 남은 전송은 나중에라도 수신 버퍼(호출자 스택일 수 있음)에 쓰고 완료 신호를 주므로,
+ * 버스의 전송이 모두 끝날 때까지 기다리고 그래도 끝나지 않으면 버스를 리셋합니다.
+ * 그 뒤 늦게 들어온 완료 신호를 버려서 다음 전송이 이전 신호로 끝난 것처럼 보이지 않게 합니다.
+ */
+static void mpu6050_abort_transfers(mpu6050_handle_t dev)
+{
+    if (i2c_master_bus_wait_all_done(dev->bus, I2C_MASTER_TIMEOUT_MS) != ESP_OK) {
+        ESP_LOGW(TAG_SENSOR, "I2C 전송이 끝나지 않아 버스 리셋 (0x%02X)", dev->address);
+        i2c_master_bus_reset(dev->bus);
+    }
+    xQueueReset(dev->trans_done);
+    dev->trans_failed = false;
+}
+#endif
+
+/**
+ * @brief 큐에 넣은 전송 하나가 끝날 때까지 대기
+ *
+ * 동기 모드에서는 전송 함수가 이미 완료까지 기다리므로 바로 반환합니다.
+ * ESP_ERR_TIMEOUT을 반환할 때는 버스의 전송을 모두 정리한 뒤이므로 남은 전송을 더 기다리지 않아도 됩니다.
+ */
+static esp_err_t mpu6050_wait_trans_done(mpu6050_handle_t dev)
+{
+#if MPU6050_I2C_ASYNC
+    if (xSemaphoreTake(dev->trans_done, pdMS_TO_TICKS(I2C_MASTER_TIMEOUT_MS)) != pdTRUE) {
+        mpu6050_abort_transfers(dev);
+        return ESP_ERR_TIMEOUT;
+    }
+    if (dev->trans_failed) {
+        dev->trans_failed = false;
+        return ESP_FAIL;
+    }
+#endif
+    return ESP_OK;
+}
 
 /**
  * @brief MPU6050 레지스터 읽기
  */
-static esp_err_t mpu6050_register_read(uint8_t reg_addr, uint8_t *data, size_t len)
+static esp_err_t mpu6050_register_read(mpu6050_handle_t dev, uint8_t reg_addr, uint8_t *data, size_t len)
 {
-    return i2c_master_transmit_receive(dev_handle, &reg_addr, 1, data, len, I2C_MASTER_TIMEOUT_MS);
+    esp_err_t ret = i2c_master_transmit_receive(dev->i2c_dev, &reg_addr, 1, data, len, I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return mpu6050_wait_trans_done(dev);
 }
 
 /**
  * @brief MPU6050 레지스터 쓰기
  */
-static esp_err_t mpu6050_register_write_byte(uint8_t reg_addr, uint8_t data)
+static esp_err_t mpu6050_register_write_byte(mpu6050_handle_t dev, uint8_t reg_addr, uint8_t data)
 {
     uint8_t write_buf[2] = {reg_addr, data};
-    return i2c_master_transmit(dev_handle, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    esp_err_t ret = i2c_master_transmit(dev->i2c_dev, write_buf, sizeof(write_buf), I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return mpu6050_wait_trans_done(dev);
+}
+
+/**
+ * @brief 14바이트 프레임(레지스터 0x3B~0x48 순서) 디코딩
+ */
+static void mpu6050_decode_frame(const uint8_t *data, mpu6050_raw_sample_t *sample)
+{
+    sample->accel_x = (int16_t)((data[0] << 8) | data[1]);
+    sample->accel_y = (int16_t)((data[2] << 8) | data[3]);
+    sample->accel_z = (int16_t)((data[4] << 8) | data[5]);
+    sample->temp = (int16_t)((data[6] << 8) | data[7]);
+    sample->gyro_x = (int16_t)((data[8] << 8) | data[9]);
+    sample->gyro_y = (int16_t)((data[10] << 8) | data[11]);
+    sample->gyro_z = (int16_t)((data[12] << 8) | data[13]);
 }
 
 /**
  * @brief 센서 값 읽기
  */
-static esp_err_t mpu6050_read_sensor_raw(int16_t *accel_x, int16_t *accel_y, int16_t *accel_z,
-                                          int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z, int16_t *temp)
+static esp_err_t mpu6050_read_sensor_raw(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample)
 {
-    uint8_t data[14];
-    esp_err_t ret = mpu6050_register_read(MPU6050_ACCEL_XOUT_H, data, 14);
+    uint8_t data[MPU6050_FRAME_SIZE];
+    esp_err_t ret = mpu6050_register_read(dev, MPU6050_ACCEL_XOUT_H, data, MPU6050_FRAME_SIZE);
     if (ret != ESP_OK) {
         return ret;
     }
 
-    *accel_x = (int16_t)((data[0] << 8) | data[1]);
-    *accel_y = (int16_t)((data[2] << 8) | data[3]);
-    *accel_z = (int16_t)((data[4] << 8) | data[5]);
-    *temp = (int16_t)((data[6] << 8) | data[7]);
-    *gyro_x = (int16_t)((data[8] << 8) | data[9]);
-    *gyro_y = (int16_t)((data[10] << 8) | data[11]);
-    *gyro_z = (int16_t)((data[12] << 8) | data[13]);
+    mpu6050_decode_frame(data, sample);
 
     return ESP_OK;
 }
 
+/**
+ * @brief 기준 범위 오프셋을 현재 범위 LSB로 환산
+ */
+static void mpu6050_update_active_offsets(mpu6050_handle_t dev)
+{
+    const float accel_ratio = accel_range_table[dev->config.accel_range].sensitivity /
+                              accel_range_table[MPU6050_ACCEL_RANGE_2G].sensitivity;
+    const float gyro_ratio = gyro_range_table[dev->config.gyro_range].sensitivity /
+                             gyro_range_table[MPU6050_GYRO_RANGE_250].sensitivity;
+
+    dev->active_offsets.accel_x_offset = lroundf(dev->calibration.accel_x_offset * accel_ratio);
+    dev->active_offsets.accel_y_offset = lroundf(dev->calibration.accel_y_offset * accel_ratio);
+    dev->active_offsets.accel_z_offset = lroundf(dev->calibration.accel_z_offset * accel_ratio);
+    dev->active_offsets.gyro_x_offset = lroundf(dev->calibration.gyro_x_offset * gyro_ratio);
+    dev->active_offsets.gyro_y_offset = lroundf(dev->calibration.gyro_y_offset * gyro_ratio);
+    dev->active_offsets.gyro_z_offset = lroundf(dev->calibration.gyro_z_offset * gyro_ratio);
+}
+
 /**
  * @brief 센서 보정
  */
-static esp_err_t mpu6050_calibrate(void)
+static esp_err_t mpu6050_calibrate(mpu6050_handle_t dev)
 {
     ESP_LOGI(TAG_SENSOR, "MPU6050 보정 시작... 센서를 평평한 곳에 두세요!");
 
     int32_t accel_x_sum = 0, accel_y_sum = 0, accel_z_sum = 0;
     int32_t gyro_x_sum = 0, gyro_y_sum = 0, gyro_z_sum = 0;
-    int16_t accel_x, accel_y, accel_z;
-    int16_t gyro_x, gyro_y, gyro_z;
-    int16_t temp;
+    mpu6050_raw_sample_t sample;
 
     for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
-        esp_err_t ret = mpu6050_read_sensor_raw(&accel_x, &accel_y, &accel_z,
-                                                 &gyro_x, &gyro_y, &gyro_z, &temp);
+        esp_err_t ret = mpu6050_read_sensor_raw(dev, &sample);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG_SENSOR, "보정 실패: 샘플 %d", i);
             return ret;
         }
 
-        accel_x_sum += accel_x;
-        accel_y_sum += accel_y;
-        accel_z_sum += accel_z;
-        gyro_x_sum += gyro_x;
-        gyro_y_sum += gyro_y;
-        gyro_z_sum += gyro_z;
+        accel_x_sum += sample.accel_x;
+        accel_y_sum += sample.accel_y;
+        accel_z_sum += sample.accel_z;
+        gyro_x_sum += sample.gyro_x;
+        gyro_y_sum += sample.gyro_y;
+        gyro_z_sum += sample.gyro_z;
 
         vTaskDelay(pdMS_TO_TICKS(5));
     }
 
-    calibration.accel_x_offset = accel_x_sum / CALIBRATION_SAMPLES;
-    calibration.accel_y_offset = accel_y_sum / CALIBRATION_SAMPLES;
-    calibration.accel_z_offset = (accel_z_sum / CALIBRATION_SAMPLES) - 16384;
-    calibration.gyro_x_offset = gyro_x_sum / CALIBRATION_SAMPLES;
-    calibration.gyro_y_offset = gyro_y_sum / CALIBRATION_SAMPLES;
-    calibration.gyro_z_offset = gyro_z_sum / CALIBRATION_SAMPLES;
+    // 현재 범위에서 측정한 오프셋을 기준 범위(±2g, ±250°/s) LSB로 환산해서 저장
+    const float accel_to_base = accel_range_table[MPU6050_ACCEL_RANGE_2G].sensitivity /
+                                accel_range_table[dev->config.accel_range].sensitivity;
+    const float gyro_to_base = gyro_range_table[MPU6050_GYRO_RANGE_250].sensitivity /
+                               gyro_range_table[dev->config.gyro_range].sensitivity;
+    const int32_t one_g = (int32_t)accel_range_table[dev->config.accel_range].sensitivity;
+
+    dev->calibration.accel_x_offset = lroundf((accel_x_sum / CALIBRATION_SAMPLES) * accel_to_base);
+    dev->calibration.accel_y_offset = lroundf((accel_y_sum / CALIBRATION_SAMPLES) * accel_to_base);
+    dev->calibration.accel_z_offset = lroundf(((accel_z_sum / CALIBRATION_SAMPLES) - one_g) * accel_to_base);
+    dev->calibration.gyro_x_offset = lroundf((gyro_x_sum / CALIBRATION_SAMPLES) * gyro_to_base);
+    dev->calibration.gyro_y_offset = lroundf((gyro_y_sum / CALIBRATION_SAMPLES) * gyro_to_base);
+    dev->calibration.gyro_z_offset = lroundf((gyro_z_sum / CALIBRATION_SAMPLES) * gyro_to_base);
+    mpu6050_update_active_offsets(dev);
 
     ESP_LOGI(TAG_SENSOR, "MPU6050 보정 완료!");
     ESP_LOGI(TAG_SENSOR, "가속도 오프셋: X=%d Y=%d Z=%d",
-             calibration.accel_x_offset, calibration.accel_y_offset, calibration.accel_z_offset);
+             dev->calibration.accel_x_offset, dev->calibration.accel_y_offset, dev->calibration.accel_z_offset);
     ESP_LOGI(TAG_SENSOR, "자이로 오프셋: X=%d Y=%d Z=%d",
-             calibration.gyro_x_offset, calibration.gyro_y_offset, calibration.gyro_z_offset);
+             dev->calibration.gyro_x_offset, dev->calibration.gyro_y_offset, dev->calibration.gyro_z_offset);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief NVS에서 보정 값 불러오기 (버전/CRC 검증)
+ */
+static esp_err_t mpu6050_calibration_load(mpu6050_handle_t dev)
+{
+    nvs_handle_t nvs;
+    mpu6050_calibration_blob_t blob;
+    size_t length = sizeof(blob);
+
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    snprintf(key, sizeof(key), MPU6050_CALIB_NVS_KEY_FMT, dev->device_id);
+
+    esp_err_t ret = nvs_open(MPU6050_CALIB_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_get_blob(nvs, key, &blob, &length);
+    nvs_close(nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (length != sizeof(blob) || blob.version != MPU6050_CALIB_VERSION) {
+        ESP_LOGW(TAG_SENSOR, "저장된 보정 값 형식이 다름 (version=%u)", blob.version);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (blob.crc != esp_crc32_le(0, (const uint8_t *)&blob, offsetof(mpu6050_calibration_blob_t, crc))) {
+        ESP_LOGW(TAG_SENSOR, "저장된 보정 값 CRC 불일치");
+        return ESP_ERR_INVALID_CRC;
+    }
 
+    dev->calibration = blob.calibration;
+    mpu6050_update_active_offsets(dev);
     return ESP_OK;
 }
 
 /**
- * @brief 보정 적용
+ * @brief 현재 보정 값을 NVS에 저장
+ */
+static esp_err_t mpu6050_calibration_save(mpu6050_handle_t dev)
+{
+    nvs_handle_t nvs;
+    mpu6050_calibration_blob_t blob = {
+        .version = MPU6050_CALIB_VERSION,
+        .calibration = dev->calibration,
+    };
+    blob.crc = esp_crc32_le(0, (const uint8_t *)&blob, offsetof(mpu6050_calibration_blob_t, crc));
+
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    snprintf(key, sizeof(key), MPU6050_CALIB_NVS_KEY_FMT, dev->device_id);
+
+    esp_err_t ret = nvs_open(MPU6050_CALIB_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(nvs, key, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "보정 값 NVS 저장 실패: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * @brief 오프셋을 빼고 int16 범위로 포화
+ */
+static inline int16_t mpu6050_sub_saturate(int16_t value, int16_t offset)
+{
+    int32_t result = (int32_t)value - offset;
+    if (result > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (result < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)result;
+}
+
+/**
+ * @brief 보정 적용 (정수 연산)
+ */
+static void mpu6050_apply_calibration(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample)
+{
+    sample->accel_x = mpu6050_sub_saturate(sample->accel_x, dev->active_offsets.accel_x_offset);
+    sample->accel_y = mpu6050_sub_saturate(sample->accel_y, dev->active_offsets.accel_y_offset);
+    sample->accel_z = mpu6050_sub_saturate(sample->accel_z, dev->active_offsets.accel_z_offset);
+    sample->gyro_x = mpu6050_sub_saturate(sample->gyro_x, dev->active_offsets.gyro_x_offset);
+    sample->gyro_y = mpu6050_sub_saturate(sample->gyro_y, dev->active_offsets.gyro_y_offset);
+    sample->gyro_z = mpu6050_sub_saturate(sample->gyro_z, dev->active_offsets.gyro_z_offset);
+}
+
+/**
+ * @brief FIFO 리셋 (정렬이 깨진 경우 재동기화에 사용)
  */
-static void mpu6050_apply_calibration(int16_t *accel_x, int16_t *accel_y, int16_t *accel_z,
-                                       int16_t *gyro_x, int16_t *gyro_y, int16_t *gyro_z)
+static esp_err_t mpu6050_fifo_reset(mpu6050_handle_t dev)
 {
-    *accel_x -= calibration.accel_x_offset;
-    *accel_y -= calibration.accel_y_offset;
-    *accel_z -= calibration.accel_z_offset;
-    *gyro_x -= calibration.gyro_x_offset;
-    *gyro_y -= calibration.gyro_y_offset;
-    *gyro_z -= calibration.gyro_z_offset;
+    esp_err_t ret = mpu6050_register_write_byte(dev, MPU6050_USER_CTRL_REG, MPU6050_USER_CTRL_FIFO_RESET);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // FIFO_RESET 비트는 리셋 후 자동으로 0이 됨 → FIFO 다시 활성화
+    return mpu6050_register_write_byte(dev, MPU6050_USER_CTRL_REG, MPU6050_USER_CTRL_FIFO_EN);
+}
+
+/**
+ * @brief DLPF 설정에 따른 자이로 출력 주파수 (SMPLRT_DIV 분주 전)
+ */
+static uint32_t mpu6050_gyro_rate_hz(mpu6050_dlpf_t dlpf)
+{
+    // DLPF를 끄면(260Hz) 자이로 출력이 8kHz, 켜면 1kHz
+    return (dlpf == MPU6050_DLPF_260HZ) ? MPU6050_GYRO_RATE_DLPF_OFF_HZ : MPU6050_GYRO_RATE_DLPF_ON_HZ;
+}
+
+/**
+ * @brief DLPF 설정에서 샘플링 주파수를 만들 수 있는지 확인하고 실제 주파수 계산
+ */
+esp_err_t mpu6050_check_sample_rate(mpu6050_dlpf_t dlpf, uint16_t sample_rate_hz, uint16_t *actual_hz)
+{
+    const uint32_t gyro_rate_hz = mpu6050_gyro_rate_hz(dlpf);
+
+    if (dlpf > MPU6050_DLPF_5HZ || sample_rate_hz == 0 || sample_rate_hz > MPU6050_MAX_SAMPLE_RATE_HZ ||
+        gyro_rate_hz / sample_rate_hz > 256) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 분주비 = 내림(자이로 출력 / 요청값) → 실제 주파수는 요청값 이상
+    // (실제 주파수로 다시 계산해도 같은 분주비가 나오므로 저장 / 재적용해도 주파수가 바뀌지 않음)
+    if (actual_hz != NULL) {
+        *actual_hz = gyro_rate_hz / (gyro_rate_hz / sample_rate_hz);
+    }
+    return ESP_OK;
 }
 
 /**
- * @brief MPU6050 초기화
+ * @brief 측정 범위, DLPF, 샘플링 주파수 설정
  */
-esp_err_t mpu6050_init_sensor(void)
+esp_err_t mpu6050_set_config(mpu6050_handle_t dev, const mpu6050_config_t *config)
 {
     esp_err_t ret;
 
-    // I2C 버스 초기화
-    i2c_master_bus_config_t bus_config = {
-        .i2c_port = I2C_MASTER_NUM,
-        .sda_io_num = I2C_MASTER_SDA_IO,
-        .scl_io_num = I2C_MASTER_SCL_IO,
-        .clk_source = I2C_CLK_SRC_DEFAULT,
-        .glitch_ignore_cnt = 7,
-        .flags.enable_internal_pullup = true,
-    };
-    ret = i2c_new_master_bus(&bus_config, &bus_handle);
+    if (config->accel_range > MPU6050_ACCEL_RANGE_16G ||
+        config->gyro_range > MPU6050_GYRO_RANGE_2000 ||
+        config->dlpf > MPU6050_DLPF_5HZ) {
+        ESP_LOGE(TAG_SENSOR, "잘못된 MPU6050 설정 값");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t actual_rate_hz;
+    if (mpu6050_check_sample_rate(config->dlpf, config->sample_rate_hz, &actual_rate_hz) != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "샘플링 주파수 범위 초과: %u Hz (DLPF %uHz)",
+                 config->sample_rate_hz, dlpf_bandwidth_table[config->dlpf]);
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint32_t gyro_rate_hz = mpu6050_gyro_rate_hz(config->dlpf);
+    uint8_t divider = (gyro_rate_hz / config->sample_rate_hz) - 1;
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_ACCEL_CONFIG_REG, (config->accel_range << 3) | dev->accel_hpf);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG_SENSOR, "I2C 버스 초기화 실패");
+        ESP_LOGE(TAG_SENSOR, "가속도계 범위 설정 실패");
         return ret;
     }
-    ESP_LOGI(TAG_SENSOR, "I2C 버스 초기화 완료: SDA=%d, SCL=%d",
-             I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO);
 
-    // MPU6050 디바이스 추가
-    i2c_device_config_t dev_config = {
-        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
-        .device_address = MPU6050_SENSOR_ADDR,
-        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
-    };
-    ret = i2c_master_bus_add_device(bus_handle, &dev_config, &dev_handle);
+    ret = mpu6050_register_write_byte(dev, MPU6050_GYRO_CONFIG_REG, config->gyro_range << 3);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG_SENSOR, "MPU6050 디바이스 추가 실패");
+        ESP_LOGE(TAG_SENSOR, "자이로스코프 범위 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_CONFIG_REG, config->dlpf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "DLPF 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_SMPLRT_DIV_REG, divider);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "샘플링 주파수 설정 실패");
         return ret;
     }
 
+    dev->config = *config;
+    dev->config.sample_rate_hz = actual_rate_hz;
+    dev->accel_scale = 1.0f / accel_range_table[config->accel_range].sensitivity;
+    dev->gyro_scale = 1.0f / gyro_range_table[config->gyro_range].sensitivity;
+    // 실제 샘플 주기 (분주 후 정수로 떨어지지 않는 요청값도 있으므로 분주비로 계산)
+    dev->sample_period_us = (int64_t)(divider + 1) * 1000000 / gyro_rate_hz;
+    mpu6050_update_active_offsets(dev);
+
+    // 설정 변경 전후 샘플이 FIFO에 섞이지 않도록 비움
+    if (dev->fifo_enabled) {
+        ret = mpu6050_fifo_reset(dev);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    ESP_LOGI(TAG_SENSOR, "MPU6050 설정: ±%ug, ±%u°/s, DLPF %uHz, %lu Hz",
+             accel_range_table[config->accel_range].full_scale_g,
+             gyro_range_table[config->gyro_range].full_scale_dps,
+             dlpf_bandwidth_table[config->dlpf],
+             (unsigned long)(1000000 / dev->sample_period_us));
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 현재 설정 조회
+ */
+void mpu6050_get_config(mpu6050_handle_t dev, mpu6050_config_t *config)
+{
+    *config = dev->config;
+}
+
+/**
+ * @brief 실제 샘플 주기 조회
+ */
+int64_t mpu6050_get_sample_period_us(mpu6050_handle_t dev)
+{
+    return dev->sample_period_us;
+}
+
+/**
+ * @brief 현재 측정 범위 조회
+ */
+void mpu6050_get_scale(mpu6050_handle_t dev, mpu6050_scale_t *scale)
+{
+    scale->accel_range = dev->config.accel_range;
+    scale->gyro_range = dev->config.gyro_range;
+}
+
+/**
+ * @brief 가속도계 풀스케일(g) 값으로 범위 찾기
+ */
+esp_err_t mpu6050_accel_range_from_g(uint16_t full_scale_g, mpu6050_accel_range_t *range)
+{
+    for (size_t i = 0; i < sizeof(accel_range_table) / sizeof(accel_range_table[0]); i++) {
+        if (accel_range_table[i].full_scale_g == full_scale_g) {
+            *range = (mpu6050_accel_range_t)i;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief 자이로 풀스케일(°/s) 값으로 범위 찾기
+ */
+esp_err_t mpu6050_gyro_range_from_dps(uint16_t full_scale_dps, mpu6050_gyro_range_t *range)
+{
+    for (size_t i = 0; i < sizeof(gyro_range_table) / sizeof(gyro_range_table[0]); i++) {
+        if (gyro_range_table[i].full_scale_dps == full_scale_dps) {
+            *range = (mpu6050_gyro_range_t)i;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief DLPF 대역폭(Hz) 값으로 설정 찾기
+ */
+esp_err_t mpu6050_dlpf_from_hz(uint16_t bandwidth_hz, mpu6050_dlpf_t *dlpf)
+{
+    for (size_t i = 0; i < sizeof(dlpf_bandwidth_table) / sizeof(dlpf_bandwidth_table[0]); i++) {
+        if (dlpf_bandwidth_table[i] == bandwidth_hz) {
+            *dlpf = (mpu6050_dlpf_t)i;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief 가속도계 범위를 풀스케일(g) 값으로 변환
+ */
+uint16_t mpu6050_accel_range_to_g(mpu6050_accel_range_t range)
+{
+    return accel_range_table[range].full_scale_g;
+}
+
+/**
+ * @brief 자이로 범위를 풀스케일(°/s) 값으로 변환
+ */
+uint16_t mpu6050_gyro_range_to_dps(mpu6050_gyro_range_t range)
+{
+    return gyro_range_table[range].full_scale_dps;
+}
+
+/**
+ * @brief DLPF 설정을 대역폭(Hz) 값으로 변환
+ */
+uint16_t mpu6050_dlpf_to_hz(mpu6050_dlpf_t dlpf)
+{
+    return dlpf_bandwidth_table[dlpf];
+}
+
+/**
+ * @brief MPU6050 레지스터 초기화 및 보정 값 준비
+ */
+static esp_err_t mpu6050_device_init(mpu6050_handle_t dev, const mpu6050_config_t *config)
+{
+    esp_err_t ret;
+
     // WHO_AM_I 레지스터 확인
     uint8_t who_am_i;
-    ret = mpu6050_register_read(MPU6050_WHO_AM_I_REG_ADDR, &who_am_i, 1);
+    ret = mpu6050_register_read(dev, MPU6050_WHO_AM_I_REG_ADDR, &who_am_i, 1);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG_SENSOR, "WHO_AM_I 읽기 실패. MPU6050이 연결되었는지 확인하세요.");
         return ret;
     }
-    ESP_LOGI(TAG_SENSOR, "MPU6050 WHO_AM_I = 0x%X", who_am_i);
+    ESP_LOGI(TAG_SENSOR, "MPU6050 #%u (0x%02X) WHO_AM_I = 0x%X", dev->device_id, dev->address, who_am_i);
 
     // MPU6050 깨우기
-    ret = mpu6050_register_write_byte(MPU6050_PWR_MGMT_1_REG_ADDR, 0x00);
+    ret = mpu6050_register_write_byte(dev, MPU6050_PWR_MGMT_1_REG_ADDR, 0x00);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG_SENSOR, "MPU6050 전원 관리 실패");
         return ret;
     }
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    // 가속도계 범위 설정 (±2g)
-    ret = mpu6050_register_write_byte(MPU6050_ACCEL_CONFIG_REG, ACCEL_RANGE_2G);
+    // 측정 범위, DLPF, 샘플링 주파수 설정
+    ret = mpu6050_set_config(dev, config);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG_SENSOR, "가속도계 범위 설정 실패");
+        ESP_LOGE(TAG_SENSOR, "MPU6050 설정 실패");
         return ret;
     }
 
-    // 자이로스코프 범위 설정 (±250°/s)
-    ret = mpu6050_register_write_byte(MPU6050_GYRO_CONFIG_REG, GYRO_RANGE_250);
+    ESP_LOGI(TAG_SENSOR, "MPU6050 #%u 초기화 완료", dev->device_id);
+
+    // 저장된 보정 값 사용 (없거나 손상된 경우에만 보정 수행)
+    if (mpu6050_calibration_load(dev) == ESP_OK) {
+        ESP_LOGI(TAG_SENSOR, "NVS 보정 값 사용: 가속도 X=%d Y=%d Z=%d, 자이로 X=%d Y=%d Z=%d",
+                 dev->calibration.accel_x_offset, dev->calibration.accel_y_offset, dev->calibration.accel_z_offset,
+                 dev->calibration.gyro_x_offset, dev->calibration.gyro_y_offset, dev->calibration.gyro_z_offset);
+        return ESP_OK;
+    }
+
+    ESP_LOGW(TAG_SENSOR, "저장된 보정 값 없음, 최초 보정 수행");
+    ret = mpu6050_recalibrate(dev);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG_SENSOR, "자이로스코프 범위 설정 실패");
+        ESP_LOGE(TAG_SENSOR, "MPU6050 보정 실패");
         return ret;
     }
 
-    ESP_LOGI(TAG_SENSOR, "MPU6050 초기화 완료 (±2g, ±250°/s)");
+    return ESP_OK;
+}
+
+/**
+ * @brief 인스턴스 할당 (0으로 초기화, 정적 할당 모드에서는 풀에서)
+ */
+static mpu6050_handle_t mpu6050_alloc(void)
+{
+#if APP_STATIC_ALLOC
+    for (size_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        if (!device_pool_used[i]) {
+            device_pool_used[i] = true;
+            memset(&device_pool[i], 0, sizeof(device_pool[i]));
+            return &device_pool[i];
+        }
+    }
+    return NULL;
+#else
+    return calloc(1, sizeof(struct mpu6050_dev_t));
+#endif
+}
+
+/**
+ * @brief 인스턴스 반환
+ */
+static void mpu6050_free(mpu6050_handle_t dev)
+{
+#if APP_STATIC_ALLOC
+    device_pool_used[dev - device_pool] = false;
+#else
+    free(dev);
+#endif
+}
 
-    // 보정 수행
-    ret = mpu6050_calibrate();
+/**
+ * @brief MPU6050용 I2C 마스터 버스 생성
+ */
+esp_err_t mpu6050_bus_init(i2c_port_num_t port, int sda_io, int scl_io, i2c_master_bus_handle_t *bus)
+{
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = port,
+        .sda_io_num = sda_io,
+        .scl_io_num = scl_io,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .trans_queue_depth = MPU6050_I2C_TRANS_QUEUE_DEPTH,
+        .flags.enable_internal_pullup = true,
+    };
+    esp_err_t ret = i2c_new_master_bus(&bus_config, bus);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG_SENSOR, "MPU6050 보정 실패");
+        ESP_LOGE(TAG_SENSOR, "I2C 버스 초기화 실패");
         return ret;
     }
-
+#if APP_STATIC_ALLOC
+    metrics_add_ram_budget("mpu6050", sizeof(device_pool));
+#endif
+    ESP_LOGI(TAG_SENSOR, "I2C 버스 초기화 완료: port=%d, SDA=%d, SCL=%d", port, sda_io, scl_io);
     return ESP_OK;
 }
 
 /**
- * @brief MPU6050 센서 데이터 읽기
+ * @brief MPU6050 인스턴스 생성 및 초기화
  */
-esp_err_t mpu6050_read_data(mpu6050_data_t *data)
+esp_err_t mpu6050_create(i2c_master_bus_handle_t bus, const mpu6050_device_config_t *device_config,
+                         mpu6050_handle_t *out_handle)
 {
-    int16_t accel_x, accel_y, accel_z;
-    int16_t gyro_x, gyro_y, gyro_z;
-    int16_t temp;
+    esp_err_t ret;
 
-    // Raw 데이터 읽기
-    esp_err_t ret = mpu6050_read_sensor_raw(&accel_x, &accel_y, &accel_z,
-                                             &gyro_x, &gyro_y, &gyro_z, &temp);
+    mpu6050_handle_t dev = mpu6050_alloc();
+    if (dev == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->bus = bus;
+    dev->address = device_config->i2c_address;
+    dev->device_id = device_config->device_id;
+
+    // MPU6050 디바이스 추가
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = device_config->i2c_address,
+        .scl_speed_hz = device_config->scl_speed_hz,
+    };
+    ret = i2c_master_bus_add_device(bus, &dev_config, &dev->i2c_dev);
     if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "MPU6050 디바이스 추가 실패 (0x%02X)", dev->address);
+        mpu6050_free(dev);
         return ret;
     }
 
-    // 보정 적용
-    mpu6050_apply_calibration(&accel_x, &accel_y, &accel_z, &gyro_x, &gyro_y, &gyro_z);
+#if MPU6050_I2C_ASYNC
+    // 완료 콜백을 등록하면 이 디바이스의 전송은 모두 큐에 들어가고 바로 반환됨
+#if APP_STATIC_ALLOC
+    dev->trans_done = xSemaphoreCreateCountingStatic(MPU6050_READ_BUFFERS, 0, &dev->trans_done_buffer);
+#else
+    dev->trans_done = xSemaphoreCreateCounting(MPU6050_READ_BUFFERS, 0);
+#endif
+    if (dev->trans_done == NULL) {
+        mpu6050_delete(dev);
+        return ESP_ERR_NO_MEM;
+    }
+    i2c_master_event_callbacks_t cbs = {
+        .on_trans_done = mpu6050_on_trans_done,
+    };
+    ret = i2c_master_register_event_callbacks(dev->i2c_dev, &cbs, dev);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "I2C 완료 콜백 등록 실패");
+        mpu6050_delete(dev);
+        return ret;
+    }
+#endif
 
-    // 물리 단위로 변환
-    data->accel_x = accel_x / accel_sensitivity;
-    data->accel_y = accel_y / accel_sensitivity;
-    data->accel_z = accel_z / accel_sensitivity;
-    data->gyro_x = gyro_x / gyro_sensitivity;
-    data->gyro_y = gyro_y / gyro_sensitivity;
-    data->gyro_z = gyro_z / gyro_sensitivity;
-    data->temperature = (temp / 340.0) + 36.53;
+    ret = mpu6050_device_init(dev, &device_config->config);
+    if (ret != ESP_OK) {
+        mpu6050_delete(dev);
+        return ret;
+    }
 
+#if !APP_STATIC_ALLOC
+    metrics_add_ram_budget("mpu6050", sizeof(struct mpu6050_dev_t));
+#endif
+    *out_handle = dev;
     return ESP_OK;
 }
 
 /**
- * @brief MPU6050 종료
+ * @brief 보정 다시 수행 후 NVS에 저장
  */
-esp_err_t mpu6050_deinit(void)
+esp_err_t mpu6050_recalibrate(mpu6050_handle_t dev)
 {
-    if (dev_handle != NULL) {
-        i2c_master_bus_rm_device(dev_handle);
-        dev_handle = NULL;
+    esp_err_t ret = mpu6050_calibrate(dev);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    if (bus_handle != NULL) {
-        i2c_del_master_bus(bus_handle);
-        bus_handle = NULL;
+    // 보정하는 동안 FIFO가 넘쳤을 수 있으므로 비움
+    if (dev->fifo_enabled) {
+        ret = mpu6050_fifo_reset(dev);
+        if (ret != ESP_OK) {
+            return ret;
+        }
     }
 
-    ESP_LOGI(TAG_SENSOR, "MPU6050 종료 완료");
-    return ESP_OK;
+    return mpu6050_calibration_save(dev);
+}
+
+/**
+ * @brief 현재 보정 값 조회
+ */
+void mpu6050_get_calibration(mpu6050_handle_t dev, mpu6050_calibration_t *offsets)
+{
+    *offsets = dev->calibration;
+}
+
+/**
+ * @brief 샘플 읽기 전송 시작 (비동기 모드에서는 큐에 넣고 바로 반환)
+ */
+esp_err_t mpu6050_read_raw_start(mpu6050_handle_t dev)
+{
+    if (dev->read_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dev->frame_timestamp_us = esp_timer_get_time();
+    esp_err_t ret = i2c_master_transmit_receive(dev->i2c_dev, &accel_xout_reg, 1, dev->frame_buffer,
+                                                MPU6050_FRAME_SIZE, I2C_MASTER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    dev->read_pending = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief 시작한 샘플 읽기 완료 대기 후 보정된 Raw 샘플로 디코딩
+ */
+esp_err_t mpu6050_read_raw_finish(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample)
+{
+    if (!dev->read_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    dev->read_pending = false;
+
+    esp_err_t ret = mpu6050_wait_trans_done(dev);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    mpu6050_decode_frame(dev->frame_buffer, sample);
+    sample->timestamp_us = dev->frame_timestamp_us;
+    sample->device_id = dev->device_id;
+    esp_cpu_cycle_count_t metrics_start = METRICS_START();
+    mpu6050_apply_calibration(dev, sample);
+    METRICS_STOP(METRICS_STAGE_CALIBRATION, metrics_start);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 보정된 Raw 샘플 읽기
+ */
+esp_err_t mpu6050_read_raw(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample)
+{
+    esp_err_t ret = mpu6050_read_raw_start(dev);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    return mpu6050_read_raw_finish(dev, sample);
+}
+
+/**
+ * @brief Raw 샘플 배열을 물리 단위로 일괄 변환
+ */
+void mpu6050_convert_samples(mpu6050_handle_t dev, const mpu6050_raw_sample_t *raw, mpu6050_data_t *data,
+                             size_t count)
+{
+    // 루프 안에서 전역 변수를 다시 읽지 않도록 지역 변수로 복사
+    const float a_scale = dev->accel_scale;
+    const float g_scale = dev->gyro_scale;
+    const float t_scale = 1.0f / 340.0f;
+
+    for (size_t i = 0; i < count; i++) {
+        data[i].accel_x = raw[i].accel_x * a_scale;
+        data[i].accel_y = raw[i].accel_y * a_scale;
+        data[i].accel_z = raw[i].accel_z * a_scale;
+        data[i].gyro_x = raw[i].gyro_x * g_scale;
+        data[i].gyro_y = raw[i].gyro_y * g_scale;
+        data[i].gyro_z = raw[i].gyro_z * g_scale;
+        data[i].temperature = raw[i].temp * t_scale + 36.53f;
+    }
+}
+
+/**
+ * @brief 캡처 시점의 측정 범위로 Raw 샘플 배열을 물리 단위로 변환
+ */
+void mpu6050_convert_scaled(const mpu6050_scale_t *scale, const mpu6050_raw_sample_t *raw, mpu6050_data_t *data,
+                            size_t count)
+{
+    const float a_scale = 1.0f / accel_range_table[scale->accel_range & 0x03].sensitivity;
+    const float g_scale = 1.0f / gyro_range_table[scale->gyro_range & 0x03].sensitivity;
+    const float t_scale = 1.0f / 340.0f;
+
+    for (size_t i = 0; i < count; i++) {
+        data[i].accel_x = raw[i].accel_x * a_scale;
+        data[i].accel_y = raw[i].accel_y * a_scale;
+        data[i].accel_z = raw[i].accel_z * a_scale;
+        data[i].gyro_x = raw[i].gyro_x * g_scale;
+        data[i].gyro_y = raw[i].gyro_y * g_scale;
+        data[i].gyro_z = raw[i].gyro_z * g_scale;
+        data[i].temperature = raw[i].temp * t_scale + 36.53f;
+    }
+}
+
+/**
+ * @brief 물리 값 → int16 LSB (반올림, 포화)
+ */
+static int16_t mpu6050_quantize(float value, float lsb_per_unit)
+{
+    float scaled = value * lsb_per_unit;
+    if (scaled >= 32767.0f) {
+        return 32767;
+    }
+    if (scaled <= -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)lrintf(scaled);
+}
+
+/**
+ * @brief 물리 단위 샘플을 같은 측정 범위의 LSB로 다시 양자화
+ */
+void mpu6050_quantize_samples(const mpu6050_scale_t *scale, const mpu6050_data_t *data, mpu6050_raw_sample_t *raw,
+                              size_t count)
+{
+    const float a_lsb = accel_range_table[scale->accel_range & 0x03].sensitivity;
+    const float g_lsb = gyro_range_table[scale->gyro_range & 0x03].sensitivity;
+
+    for (size_t i = 0; i < count; i++) {
+        raw[i].accel_x = mpu6050_quantize(data[i].accel_x, a_lsb);
+        raw[i].accel_y = mpu6050_quantize(data[i].accel_y, a_lsb);
+        raw[i].accel_z = mpu6050_quantize(data[i].accel_z, a_lsb);
+        raw[i].temp = mpu6050_quantize(data[i].temperature - 36.53f, 340.0f);
+        raw[i].gyro_x = mpu6050_quantize(data[i].gyro_x, g_lsb);
+        raw[i].gyro_y = mpu6050_quantize(data[i].gyro_y, g_lsb);
+        raw[i].gyro_z = mpu6050_quantize(data[i].gyro_z, g_lsb);
+    }
+}
+
+/**
+ * @brief MPU6050 센서 데이터 읽기
+ */
+esp_err_t mpu6050_read_data(mpu6050_handle_t dev, mpu6050_data_t *data)
+{
+    mpu6050_raw_sample_t sample;
+
+    esp_err_t ret = mpu6050_read_raw(dev, &sample);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    mpu6050_convert_samples(dev, &sample, data, 1);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 샘플링 주파수만 변경 (나머지 설정 유지)
+ */
+static esp_err_t mpu6050_set_sample_rate(mpu6050_handle_t dev, uint16_t sample_rate_hz)
+{
+    mpu6050_config_t config = dev->config;
+    config.sample_rate_hz = sample_rate_hz;
+    return mpu6050_set_config(dev, &config);
+}
+
+/**
+ * @brief FIFO 모드 활성화
+ */
+esp_err_t mpu6050_fifo_enable(mpu6050_handle_t dev, uint16_t sample_rate_hz)
+{
+    esp_err_t ret;
+
+    ret = mpu6050_set_sample_rate(dev, sample_rate_hz);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // FIFO 정지 후 기록할 데이터 선택 (가속도, 온도, 자이로 → 14바이트/샘플)
+    ret = mpu6050_register_write_byte(dev, MPU6050_USER_CTRL_REG, 0x00);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = mpu6050_register_write_byte(dev, MPU6050_FIFO_EN_REG, MPU6050_FIFO_EN_ALL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = mpu6050_fifo_reset(dev);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "FIFO 활성화 실패");
+        return ret;
+    }
+
+    dev->fifo_enabled = true;
+    dev->fifo_overflow_count = 0;
+    ESP_LOGI(TAG_SENSOR, "MPU6050 FIFO 활성화 (%u Hz)", sample_rate_hz);
+
+    return ESP_OK;
+}
+
+/**
+ * @brief FIFO 모드 비활성화
+ */
+esp_err_t mpu6050_fifo_disable(mpu6050_handle_t dev)
+{
+    esp_err_t ret = mpu6050_register_write_byte(dev, MPU6050_USER_CTRL_REG, 0x00);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = mpu6050_register_write_byte(dev, MPU6050_FIFO_EN_REG, 0x00);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    dev->fifo_enabled = false;
+    return ESP_OK;
+}
+
+/**
+ * @brief 다음 FIFO 버스트 청크의 프레임 수
+ */
+static size_t mpu6050_fifo_next_chunk(size_t frames, size_t submitted)
+{
+    size_t chunk = frames - submitted;
+    return (chunk > MPU6050_FIFO_BURST_FRAMES) ? MPU6050_FIFO_BURST_FRAMES : chunk;
+}
+
+/**
+ * @brief FIFO 청크 읽기 전송 시작 (비동기 모드에서는 큐에 넣고 바로 반환)
+ */
+static esp_err_t mpu6050_fifo_submit(mpu6050_handle_t dev, uint8_t buf, size_t frames)
+{
+    return i2c_master_transmit_receive(dev->i2c_dev, &fifo_rw_reg, 1, dev->fifo_buffer[buf],
+                                       frames * MPU6050_FRAME_SIZE, I2C_MASTER_TIMEOUT_MS);
+}
+
+/**
+ * @brief FIFO에 쌓인 샘플을 버스트로 읽기
+ */
+esp_err_t mpu6050_fifo_read(mpu6050_handle_t dev, mpu6050_raw_sample_t *samples, size_t max_samples,
+                            size_t *out_count)
+{
+    *out_count = 0;
+
+    if (!dev->fifo_enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // FIFO_COUNT 읽기 (빅 엔디안 16비트)
+    uint8_t count_buf[2];
+    esp_err_t ret = mpu6050_register_read(dev, MPU6050_FIFO_COUNTH_REG, count_buf, sizeof(count_buf));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    uint16_t fifo_count = (uint16_t)((count_buf[0] << 8) | count_buf[1]);
+    int64_t now_us = esp_timer_get_time();
+
+    // 오버플로 감지: FIFO가 가득 차면 가장 오래된 바이트부터 덮어써서(FIFO_COUNT는 1024에 머묾)
+    // 14바이트 프레임 경계가 어긋나므로 버리고 다시 동기화
+    // (프레임 73개 = 1022바이트는 아직 넘치지 않은 정상 상태이므로 그대로 읽음)
+    if (fifo_count >= MPU6050_FIFO_SIZE) {
+        dev->fifo_overflow_count++;
+        ESP_LOGW(TAG_SENSOR, "FIFO 오버플로 (count=%u, 누적 %lu회), 재동기화",
+                 fifo_count, dev->fifo_overflow_count);
+        return mpu6050_fifo_reset(dev);
+    }
+
+    size_t available = fifo_count / MPU6050_FRAME_SIZE;
+    size_t frames = available;
+    if (frames > max_samples) {
+        frames = max_samples;
+    }
+
+    // 최대 MPU6050_FIFO_BURST_FRAMES 단위로 연속 읽기
+    // 버퍼 두 개를 번갈아 쓰면서 다음 청크 전송을 먼저 큐에 넣고 현재 청크를 디코딩
+    size_t chunk_frames[MPU6050_READ_BUFFERS] = {0};
+    size_t submitted = 0;
+    uint8_t buf = 0;
+
+    chunk_frames[buf] = mpu6050_fifo_next_chunk(frames, submitted);
+    if (chunk_frames[buf] > 0) {
+        ret = mpu6050_fifo_submit(dev, buf, chunk_frames[buf]);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        submitted += chunk_frames[buf];
+    }
+
+    while (*out_count < frames) {
+        uint8_t next = buf ^ 1;
+
+        chunk_frames[next] = mpu6050_fifo_next_chunk(frames, submitted);
+        if (chunk_frames[next] > 0) {
+            ret = mpu6050_fifo_submit(dev, next, chunk_frames[next]);
+            if (ret != ESP_OK) {
+                mpu6050_wait_trans_done(dev);  // 진행 중인 전송은 마무리
+                return ret;
+            }
+            submitted += chunk_frames[next];
+        }
+
+        ret = mpu6050_wait_trans_done(dev);
+        if (ret != ESP_OK) {
+            // 타임아웃이면 다음 청크도 이미 정리됨
+            if (ret != ESP_ERR_TIMEOUT && chunk_frames[next] > 0) {
+                mpu6050_wait_trans_done(dev);
+            }
+            return ret;
+        }
+
+        size_t chunk = chunk_frames[buf];
+        for (size_t i = 0; i < chunk; i++) {
+            mpu6050_raw_sample_t *sample = &samples[*out_count + i];
+            size_t index = *out_count + i;
+
+            mpu6050_decode_frame(&dev->fifo_buffer[buf][i * MPU6050_FRAME_SIZE], sample);
+            esp_cpu_cycle_count_t metrics_start = METRICS_START();
+            mpu6050_apply_calibration(dev, sample);
+            METRICS_STOP(METRICS_STAGE_CALIBRATION, metrics_start);
+            sample->device_id = dev->device_id;
+            // FIFO_COUNT를 읽은 시점의 마지막 샘플을 기준으로 샘플 주기만큼 거슬러 계산
+            sample->timestamp_us = now_us - (int64_t)(available - 1 - index) * dev->sample_period_us;
+        }
+        *out_count += chunk;
+        buf = next;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief FIFO 오버플로 발생 횟수 조회
+ */
+uint32_t mpu6050_fifo_get_overflow_count(mpu6050_handle_t dev)
+{
+    return dev->fifo_overflow_count;
+}
+
+/**
+ * @brief 데이터 준비(DATA_RDY) 인터럽트 활성화
+ */
+esp_err_t mpu6050_enable_data_ready_interrupt(mpu6050_handle_t dev, uint16_t sample_rate_hz)
+{
+    esp_err_t ret = mpu6050_set_sample_rate(dev, sample_rate_hz);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_INT_PIN_CFG_REG, MPU6050_INT_PIN_CFG_RD_CLEAR);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "INT_PIN_CFG 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_INT_ENABLE_REG, MPU6050_INT_ENABLE_DATA_RDY);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "INT_ENABLE 설정 실패");
+        return ret;
+    }
+
+    ESP_LOGI(TAG_SENSOR, "MPU6050 DATA_RDY 인터럽트 활성화 (%u Hz)", sample_rate_hz);
+    return ESP_OK;
+}
+
+/**
+ * @brief 움직임 감지(MOT) 인터럽트 활성화
+ */
+esp_err_t mpu6050_enable_motion_interrupt(mpu6050_handle_t dev, uint16_t threshold_mg, uint8_t duration_ms)
+{
+    uint32_t threshold = threshold_mg / MPU6050_MOT_THR_MG_PER_LSB;
+    if (threshold == 0 || threshold > UINT8_MAX || duration_ms == 0) {
+        ESP_LOGE(TAG_SENSOR, "움직임 감지 설정 범위 초과: %u mg, %u ms", threshold_mg, duration_ms);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 움직임 감지는 고역 통과 필터 출력으로 판단하므로 중력(정지 상태)은 걸리지 않음
+    dev->accel_hpf = MPU6050_ACCEL_HPF_5HZ;
+    esp_err_t ret = mpu6050_register_write_byte(dev, MPU6050_ACCEL_CONFIG_REG,
+                                                (dev->config.accel_range << 3) | dev->accel_hpf);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "가속도계 고역 통과 필터 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_MOT_THR_REG, threshold);
+    if (ret == ESP_OK) {
+        ret = mpu6050_register_write_byte(dev, MPU6050_MOT_DUR_REG, duration_ms);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "MOT_THR / MOT_DUR 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_INT_PIN_CFG_REG, MPU6050_INT_PIN_CFG_RD_CLEAR);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "INT_PIN_CFG 설정 실패");
+        return ret;
+    }
+
+    ret = mpu6050_register_write_byte(dev, MPU6050_INT_ENABLE_REG, MPU6050_INT_ENABLE_MOT);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "INT_ENABLE 설정 실패");
+        return ret;
+    }
+
+    ESP_LOGI(TAG_SENSOR, "MPU6050 움직임 감지 인터럽트 활성화 (%u mg, %u ms)",
+             (unsigned)(threshold * MPU6050_MOT_THR_MG_PER_LSB), duration_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief 인터럽트 상태 읽기 (읽으면 해제)
+ */
+esp_err_t mpu6050_read_int_status(mpu6050_handle_t dev, uint8_t *status)
+{
+    return mpu6050_register_read(dev, MPU6050_INT_STATUS_REG, status, 1);
+}
+
+/**
+ * @brief 모든 MPU6050 인터럽트 비활성화
+ */
+esp_err_t mpu6050_disable_interrupts(mpu6050_handle_t dev)
+{
+    return mpu6050_register_write_byte(dev, MPU6050_INT_ENABLE_REG, 0x00);
+}
+
+/**
+ * @brief 여러 MPU6050 샘플 읽기 전송을 한꺼번에 시작
+ */
+esp_err_t mpu6050_read_raw_all_start(const mpu6050_handle_t *handles, size_t count, esp_err_t *results)
+{
+    esp_err_t result = ESP_OK;
+
+    // 한 디바이스가 실패해도 나머지는 계속 읽고 첫 에러를 반환
+    for (size_t i = 0; i < count; i++) {
+        esp_err_t ret = mpu6050_read_raw_start(handles[i]);
+        if (results != NULL) {
+            results[i] = ret;
+        }
+        if (ret != ESP_OK && result == ESP_OK) {
+            result = ret;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief 한꺼번에 시작한 샘플 읽기 완료 대기
+ */
+esp_err_t mpu6050_read_raw_all_finish(const mpu6050_handle_t *handles, size_t count,
+                                      mpu6050_raw_sample_t *samples, esp_err_t *results)
+{
+    esp_err_t result = ESP_OK;
+
+    for (size_t i = 0; i < count; i++) {
+        esp_err_t ret = mpu6050_read_raw_finish(handles[i], &samples[i]);
+        results[i] = ret;
+        if (ret != ESP_OK && result == ESP_OK) {
+            result = ret;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief 여러 MPU6050을 한 번의 스케줄링 패스에서 읽기
+ *
+ * 비동기 모드에서는 모든 디바이스의 읽기가 버스 큐에 연속으로 들어가므로
+ * 디바이스 사이에 태스크가 깨어났다 다시 잠드는 시간이 없어집니다.
+ */
+esp_err_t mpu6050_read_raw_all(const mpu6050_handle_t *handles, size_t count, mpu6050_raw_sample_t *samples,
+                               esp_err_t *results)
+{
+    esp_err_t started[MPU6050_MAX_DEVICES];
+
+    if (count > MPU6050_MAX_DEVICES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t result = mpu6050_read_raw_all_start(handles, count, started);
+    esp_err_t ret = mpu6050_read_raw_all_finish(handles, count, samples, results);
+
+    // 시작에 실패한 디바이스는 finish의 ESP_ERR_INVALID_STATE 대신 원래 에러를 돌려줌
+    for (size_t i = 0; i < count; i++) {
+        if (started[i] != ESP_OK) {
+            results[i] = started[i];
+        }
+    }
+    return (result != ESP_OK) ? result : ret;
+}
+
+/**
+ * @brief 디바이스 번호 조회
+ */
+uint8_t mpu6050_get_device_id(mpu6050_handle_t dev)
+{
+    return dev->device_id;
+}
+
+/**
+ * @brief MPU6050 인스턴스 삭제
+ */
+esp_err_t mpu6050_delete(mpu6050_handle_t dev)
+{
+    if (dev == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->fifo_enabled) {
+        mpu6050_fifo_disable(dev);
+    }
+
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+    }
+
+#if MPU6050_I2C_ASYNC
+    if (dev->trans_done != NULL) {
+        vSemaphoreDelete(dev->trans_done);
+    }
+#endif
+
+    ESP_LOGI(TAG_SENSOR, "MPU6050 #%u 종료 완료", dev->device_id);
+    mpu6050_free(dev);
+    return ESP_OK;
+}
+
+/**
+ * @brief MPU6050용 I2C 마스터 버스 삭제
+ */
+esp_err_t mpu6050_bus_deinit(i2c_master_bus_handle_t bus)
+{
+    return i2c_del_master_bus(bus);
 }
@@ -5,9 +5,55 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "driver/i2c_master.h"
 #include "esp_err.h"
 
+// 가속도계 측정 범위 (ACCEL_CONFIG AFS_SEL)
+typedef enum {
+    MPU6050_ACCEL_RANGE_2G = 0,
+    MPU6050_ACCEL_RANGE_4G,
+    MPU6050_ACCEL_RANGE_8G,
+    MPU6050_ACCEL_RANGE_16G,
+} mpu6050_accel_range_t;
+
+// 자이로스코프 측정 범위 (GYRO_CONFIG FS_SEL)
+typedef enum {
+    MPU6050_GYRO_RANGE_250 = 0,
+    MPU6050_GYRO_RANGE_500,
+    MPU6050_GYRO_RANGE_1000,
+    MPU6050_GYRO_RANGE_2000,
+} mpu6050_gyro_range_t;
+
+// 디지털 저역 통과 필터 대역폭 (CONFIG DLPF_CFG, 가속도계 기준)
+typedef enum {
+    MPU6050_DLPF_260HZ = 0,   // DLPF 꺼짐, 자이로 출력 8kHz
+    MPU6050_DLPF_184HZ,
+    MPU6050_DLPF_94HZ,
+    MPU6050_DLPF_44HZ,
+    MPU6050_DLPF_21HZ,
+    MPU6050_DLPF_10HZ,
+    MPU6050_DLPF_5HZ,
+} mpu6050_dlpf_t;
+
+// MPU6050 동작 설정
+typedef struct {
+    mpu6050_accel_range_t accel_range;
+    mpu6050_gyro_range_t gyro_range;
+    mpu6050_dlpf_t dlpf;
+    uint16_t sample_rate_hz;  // 출력 데이터 주파수 (최대 1000Hz)
+} mpu6050_config_t;
+
+// 보정 오프셋 (기준 범위 ±2g, ±250°/s 의 LSB)
+typedef struct {
+    int16_t accel_x_offset;
+    int16_t accel_y_offset;
+    int16_t accel_z_offset;
+    int16_t gyro_x_offset;
+    int16_t gyro_y_offset;
+    int16_t gyro_z_offset;
+} mpu6050_calibration_t;
+
 // MPU6050 측정 데이터 구조체
 typedef struct {
     float accel_x;    // 가속도 X축 (g)
@@ -19,26 +65,406 @@ typedef struct {
     float temperature;// 온도 (°C)
 } mpu6050_data_t;
 
+// MPU6050 Raw 샘플 (캡처 시각 + 보정 적용된 정수값 14바이트, 자연 정렬로 24바이트)
+// 큐/배치에 쌓을 때는 이 구조체를 사용하고 물리 단위 변환은 필요한 시점에 일괄 수행
+typedef struct {
+    int64_t timestamp_us; // 캡처 시각 (esp_timer, µs)
+    int16_t accel_x;      // 가속도 X축 (LSB)
+    int16_t accel_y;      // 가속도 Y축 (LSB)
+    int16_t accel_z;      // 가속도 Z축 (LSB)
+    int16_t temp;         // 온도 (LSB)
+    int16_t gyro_x;       // 자이로 X축 (LSB)
+    int16_t gyro_y;       // 자이로 Y축 (LSB)
+    int16_t gyro_z;       // 자이로 Z축 (LSB)
+    uint8_t device_id;    // 샘플을 읽은 디바이스 번호
+} mpu6050_raw_sample_t;
+
+// 캡처 시점의 측정 범위 (raw 샘플과 함께 큐/배치에 보관해서 설정이 바뀐 뒤에도 같은 감도로 변환)
+typedef struct {
+    uint8_t accel_range;  // mpu6050_accel_range_t
+    uint8_t gyro_range;   // mpu6050_gyro_range_t
+} mpu6050_scale_t;
+
+// 인터럽트 상태 비트 (mpu6050_read_int_status)
+#define MPU6050_INT_STATUS_DATA_RDY 0x01
+#define MPU6050_INT_STATUS_MOT 0x40
+
+// MPU6050 인스턴스 핸들
+typedef struct mpu6050_dev_t *mpu6050_handle_t;
+
+// MPU6050 인스턴스 생성 설정
+typedef struct {
+    uint8_t i2c_address;      // 0x68 (AD0=L) 또는 0x69 (AD0=H)
+    uint32_t scl_speed_hz;    // I2C 클럭
+    uint8_t device_id;        // 발행/NVS 보정 키 구분용 번호 (인스턴스마다 달라야 함)
+    mpu6050_config_t config;  // 초기 측정 설정
+} mpu6050_device_config_t;
+
 /**
- * @brief MPU6050 초기화
+ * @brief MPU6050용 I2C 마스터 버스 생성
+ *
+ * 같은 버스에 여러 MPU6050(0x68/0x69)을 붙이거나, 포트마다 한 번씩 호출해서 두 버스를 쓸 수 있습니다.
  *
+ * @param port I2C 포트 번호
+ * @param sda_io SDA 핀
+ * @param scl_io SCL 핀
+ * @param bus 생성된 버스 핸들
  * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
  */
-esp_err_t mpu6050_init_sensor(void);
+esp_err_t mpu6050_bus_init(i2c_port_num_t port, int sda_io, int scl_io, i2c_master_bus_handle_t *bus);
+
+/**
+ * @brief MPU6050용 I2C 마스터 버스 삭제
+ *
+ * @param bus 버스 핸들 (버스의 모든 인스턴스를 먼저 삭제해야 함)
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_bus_deinit(i2c_master_bus_handle_t bus);
+
+/**
+ * @brief MPU6050 인스턴스 생성 및 초기화
+ *
+ * 버스에 디바이스를 추가하고 WHO_AM_I 확인, 깨우기, 측정 설정을 수행합니다.
+ * NVS에 저장된 보정 값이 있으면 그대로 사용하고, 없거나 손상된 경우에만 보정을 수행합니다.
+ *
+ * @param bus I2C 마스터 버스 핸들
+ * @param device_config 인스턴스 설정
+ * @param out_handle 생성된 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_create(i2c_master_bus_handle_t bus, const mpu6050_device_config_t *device_config,
+                         mpu6050_handle_t *out_handle);
+
+/**
+ * @brief MPU6050 인스턴스 삭제 및 리소스 해제
+ *
+ * @param dev 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_delete(mpu6050_handle_t dev);
+
+/**
+ * @brief 디바이스 번호 조회
+ *
+ * @param dev 인스턴스 핸들
+ * @return 생성 시 지정한 디바이스 번호
+ */
+uint8_t mpu6050_get_device_id(mpu6050_handle_t dev);
+
+/**
+ * @brief 보정 다시 수행 후 NVS에 저장
+ *
+ * 약 1초 동안 센서를 평평하게 두고 정지 상태에서 호출해야 합니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_recalibrate(mpu6050_handle_t dev);
+
+/**
+ * @brief 현재 보정 값 조회
+ *
+ * @param dev 인스턴스 핸들
+ * @param offsets 보정 값을 저장할 구조체 포인터
+ */
+void mpu6050_get_calibration(mpu6050_handle_t dev, mpu6050_calibration_t *offsets);
+
+/**
+ * @brief 측정 범위, DLPF, 샘플링 주파수 설정
+ *
+ * 감도는 범위별 상수 테이블에서 가져오고, 보정 오프셋은 새 범위에 맞게 환산됩니다.
+ * FIFO 모드가 켜져 있으면 설정 전후 샘플이 섞이지 않도록 FIFO를 비웁니다.
+ * 샘플링 주파수는 mpu6050_check_sample_rate()의 실제 주파수로 저장되므로 mpu6050_get_config()로 확인합니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param config 적용할 설정
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 범위 밖 값, 그 외 에러 코드
+ */
+esp_err_t mpu6050_set_config(mpu6050_handle_t dev, const mpu6050_config_t *config);
+
+/**
+ * @brief 현재 설정 조회
+ *
+ * @param dev 인스턴스 핸들
+ * @param config 현재 설정을 저장할 구조체 포인터
+ */
+void mpu6050_get_config(mpu6050_handle_t dev, mpu6050_config_t *config);
+
+/**
+ * @brief 실제 샘플 주기 조회 (SMPLRT_DIV 분주비로 계산, 샘플 시각 / 필터 설계 기준)
+ *
+ * @param dev 인스턴스 핸들
+ * @return int64_t 샘플 주기 (µs)
+ */
+int64_t mpu6050_get_sample_period_us(mpu6050_handle_t dev);
+
+/**
+ * @brief 현재 측정 범위 조회 (raw 샘플과 함께 보관할 감도 정보)
+ *
+ * @param dev 인스턴스 핸들
+ * @param scale 현재 측정 범위를 저장할 포인터
+ */
+void mpu6050_get_scale(mpu6050_handle_t dev, mpu6050_scale_t *scale);
+
+/**
+ * @brief 가속도계 풀스케일(2/4/8/16g) 값으로 범위 찾기
+ *
+ * @param full_scale_g 풀스케일 (g)
+ * @param range 찾은 범위를 저장할 포인터
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 지원하지 않는 값
+ */
+esp_err_t mpu6050_accel_range_from_g(uint16_t full_scale_g, mpu6050_accel_range_t *range);
+
+/**
+ * @brief 자이로 풀스케일(250/500/1000/2000°/s) 값으로 범위 찾기
+ *
+ * @param full_scale_dps 풀스케일 (°/s)
+ * @param range 찾은 범위를 저장할 포인터
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 지원하지 않는 값
+ */
+esp_err_t mpu6050_gyro_range_from_dps(uint16_t full_scale_dps, mpu6050_gyro_range_t *range);
+
+/**
+ * @brief DLPF 대역폭(260/184/94/44/21/10/5Hz) 값으로 설정 찾기
+ *
+ * @param bandwidth_hz 대역폭 (Hz)
+ * @param dlpf 찾은 설정을 저장할 포인터
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 지원하지 않는 값
+ */
+esp_err_t mpu6050_dlpf_from_hz(uint16_t bandwidth_hz, mpu6050_dlpf_t *dlpf);
+
+/**
+ * @brief DLPF 설정에서 샘플링 주파수를 만들 수 있는지 확인하고 실제 주파수 계산
+ *
+ * 자이로 출력(DLPF 260Hz면 8kHz, 아니면 1kHz)을 SMPLRT_DIV로 1~256 분주하므로
+ * 나누어 떨어지지 않는 요청값은 가까운 더 높은 주파수로 동작합니다 (예: 1kHz에서 300Hz → 333Hz).
+ *
+ * @param dlpf 적용할 DLPF 설정
+ * @param sample_rate_hz 요청 샘플링 주파수 (Hz)
+ * @param actual_hz 실제 샘플링 주파수를 저장할 포인터 (NULL 가능)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 0, 1kHz 초과 또는 분주 범위 밖
+ */
+esp_err_t mpu6050_check_sample_rate(mpu6050_dlpf_t dlpf, uint16_t sample_rate_hz, uint16_t *actual_hz);
+
+/**
+ * @brief 가속도계 범위를 풀스케일(g) 값으로 변환
+ */
+uint16_t mpu6050_accel_range_to_g(mpu6050_accel_range_t range);
+
+/**
+ * @brief 자이로 범위를 풀스케일(°/s) 값으로 변환
+ */
+uint16_t mpu6050_gyro_range_to_dps(mpu6050_gyro_range_t range);
+
+/**
+ * @brief DLPF 설정을 대역폭(Hz) 값으로 변환
+ */
+uint16_t mpu6050_dlpf_to_hz(mpu6050_dlpf_t dlpf);
 
 /**
  * @brief MPU6050 센서 데이터 읽기
  *
+ * @param dev 인스턴스 핸들
  * @param data 센서 데이터를 저장할 구조체 포인터
  * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
  */
-esp_err_t mpu6050_read_data(mpu6050_data_t *data);
+esp_err_t mpu6050_read_data(mpu6050_handle_t dev, mpu6050_data_t *data);
+
+/**
+ * @brief FIFO 모드 활성화
+ *
+ * 가속도/온도/자이로 14바이트 샘플을 내부 1024바이트 FIFO에 쌓도록 설정합니다.
+ * 샘플링 주파수 외의 설정(범위, DLPF)은 유지됩니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param sample_rate_hz FIFO 샘플링 주파수 (4 ~ 1000Hz)
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_fifo_enable(mpu6050_handle_t dev, uint16_t sample_rate_hz);
+
+/**
+ * @brief FIFO 모드 비활성화
+ *
+ * @param dev 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_fifo_disable(mpu6050_handle_t dev);
+
+/**
+ * @brief FIFO에 쌓인 샘플을 한 번에 읽기
+ *
+ * FIFO_COUNT를 읽고 쌓인 샘플을 버스트로 읽어 보정 후 Raw 샘플 배열에 채웁니다.
+ * 각 샘플의 캡처 시각은 읽은 시점과 샘플 주기로부터 역산합니다.
+ * 오버플로가 감지되면 FIFO를 리셋하고 샘플 0개로 ESP_OK를 반환합니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param samples 샘플을 저장할 배열
+ * @param max_samples 배열 크기
+ * @param out_count 실제로 읽은 샘플 수
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_STATE FIFO 비활성, 그 외 에러 코드
+ */
+esp_err_t mpu6050_fifo_read(mpu6050_handle_t dev, mpu6050_raw_sample_t *samples, size_t max_samples,
+                            size_t *out_count);
+
+/**
+ * @brief FIFO 오버플로 발생 횟수 조회
+ *
+ * @param dev 인스턴스 핸들
+ * @return 누적 오버플로(재동기화) 횟수
+ */
+uint32_t mpu6050_fifo_get_overflow_count(mpu6050_handle_t dev);
+
+/**
+ * @brief 데이터 준비(DATA_RDY) 인터럽트 활성화
+ *
+ * 샘플링 주파수를 설정하고 새 샘플이 준비될 때마다 INT 핀에 50us 하이 펄스를 출력합니다.
+ * 데이터 레지스터를 읽으면 인터럽트 상태가 해제됩니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param sample_rate_hz 샘플링 주파수 (4 ~ 1000Hz)
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_enable_data_ready_interrupt(mpu6050_handle_t dev, uint16_t sample_rate_hz);
+
+/**
+ * @brief 움직임 감지(MOT) 인터럽트 활성화
+ *
+ * 가속도계 고역 통과 필터(5Hz) 출력이 임계값을 지속 시간 동안 넘으면 INT 핀에 50us 하이 펄스를 출력합니다.
+ * DATA_RDY 인터럽트와 같은 INT 핀을 쓰므로 둘 중 하나만 사용합니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param threshold_mg 임계값 (2mg 단위, 2 ~ 510mg)
+ * @param duration_ms 지속 시간 (1 ~ 255ms)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 범위 초과, 그 외 에러 코드
+ */
+esp_err_t mpu6050_enable_motion_interrupt(mpu6050_handle_t dev, uint16_t threshold_mg, uint8_t duration_ms);
+
+/**
+ * @brief 인터럽트 상태(INT_STATUS) 읽기
+ *
+ * 읽으면 상태 비트가 해제됩니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param status MPU6050_INT_STATUS_* 비트를 저장할 포인터
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_read_int_status(mpu6050_handle_t dev, uint8_t *status);
+
+/**
+ * @brief 모든 MPU6050 인터럽트 비활성화
+ *
+ * @param dev 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
+ */
+esp_err_t mpu6050_disable_interrupts(mpu6050_handle_t dev);
 
 /**
- * @brief MPU6050 종료 및 리소스 해제
+ * @brief 보정된 Raw 샘플 읽기
+ *
+ * 보정은 정수 연산으로 적용하며 부동소수점 변환은 하지 않습니다.
  *
+ * @param dev 인스턴스 핸들
+ * @param sample Raw 샘플을 저장할 구조체 포인터
  * @return esp_err_t ESP_OK 성공, 그 외 에러 코드
  */
-esp_err_t mpu6050_deinit(void);
+esp_err_t mpu6050_read_raw(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample);
+
+/**
+ * @brief 샘플 읽기 전송 시작
+ *
+ * MPU6050_I2C_TRANS_QUEUE_DEPTH > 0이면 전송을 버스 큐에 넣고 바로 반환하므로
+ * 전송이 진행되는 동안 이전 샘플을 처리할 수 있습니다.
+ * mpu6050_read_raw_finish() 전에는 같은 인스턴스의 다른 API를 호출하지 마세요.
+ *
+ * @param dev 인스턴스 핸들
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_STATE 이미 진행 중, 그 외 에러 코드
+ */
+esp_err_t mpu6050_read_raw_start(mpu6050_handle_t dev);
+
+/**
+ * @brief 시작한 샘플 읽기 완료 대기 후 보정된 Raw 샘플로 디코딩
+ *
+ * 대기 시간을 넘기면(ESP_ERR_TIMEOUT) 버스의 남은 전송을 정리하고 늦은 완료 신호를 버린 뒤 반환하므로
+ * 바로 다음 읽기를 시작해도 이전 전송의 결과가 섞이지 않습니다.
+ *
+ * @param dev 인스턴스 핸들
+ * @param sample Raw 샘플을 저장할 구조체 포인터 (타임스탬프는 전송 시작 시각)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_STATE 시작한 전송 없음, 그 외 에러 코드
+ */
+esp_err_t mpu6050_read_raw_finish(mpu6050_handle_t dev, mpu6050_raw_sample_t *sample);
+
+/**
+ * @brief Raw 샘플 배열을 물리 단위로 일괄 변환
+ *
+ * @param dev 인스턴스 핸들
+ * @param raw Raw 샘플 배열
+ * @param data 변환 결과를 저장할 배열 (raw와 같은 개수)
+ * @param count 샘플 수
+ */
+void mpu6050_convert_samples(mpu6050_handle_t dev, const mpu6050_raw_sample_t *raw, mpu6050_data_t *data,
+                             size_t count);
+
+/**
+ * @brief 캡처 시점의 측정 범위로 Raw 샘플 배열을 물리 단위로 변환 (인스턴스 없이, 발행 태스크용)
+ *
+ * @param scale 샘플을 캡처한 시점의 측정 범위
+ * @param raw Raw 샘플 배열
+ * @param data 변환 결과를 저장할 배열 (raw와 같은 개수)
+ * @param count 샘플 수
+ */
+void mpu6050_convert_scaled(const mpu6050_scale_t *scale, const mpu6050_raw_sample_t *raw, mpu6050_data_t *data,
+                            size_t count);
+
+/**
+ * @brief 물리 단위 샘플을 같은 측정 범위의 LSB로 다시 양자화 (필터 출력을 raw 샘플로 보관할 때)
+ *
+ * 반올림하고 int16 범위를 넘으면 포화합니다. 캡처 시각과 디바이스 번호는 바꾸지 않습니다.
+ *
+ * @param scale 변환에 사용한 측정 범위
+ * @param data 물리 단위 샘플 배열
+ * @param raw 결과를 저장할 배열 (data와 같은 개수)
+ * @param count 샘플 수
+ */
+void mpu6050_quantize_samples(const mpu6050_scale_t *scale, const mpu6050_data_t *data, mpu6050_raw_sample_t *raw,
+                              size_t count);
+
+/**
+ * @brief 여러 MPU6050을 한 번의 스케줄링 패스에서 읽기
+ *
+ * 한 디바이스가 실패해도 나머지는 계속 읽으며, 결과는 디바이스별로 돌려줍니다.
+ * results[i]가 ESP_OK인 샘플만 유효합니다.
+ *
+ * @param handles 인스턴스 핸들 배열
+ * @param count 인스턴스 수
+ * @param samples 샘플을 저장할 배열 (count개)
+ * @param results 디바이스별 결과를 저장할 배열 (count개)
+ * @return esp_err_t ESP_OK 모두 성공, 그 외 처음 발생한 에러 코드
+ */
+esp_err_t mpu6050_read_raw_all(const mpu6050_handle_t *handles, size_t count, mpu6050_raw_sample_t *samples,
+                               esp_err_t *results);
+
+/**
+ * @brief 여러 MPU6050 샘플 읽기 전송을 한꺼번에 시작
+ *
+ * 시작에 실패한 디바이스는 mpu6050_read_raw_all_finish()에서 ESP_ERR_INVALID_STATE가 됩니다.
+ *
+ * @param handles 인스턴스 핸들 배열
+ * @param count 인스턴스 수
+ * @param results 디바이스별 결과를 저장할 배열 (count개, NULL이면 저장하지 않음)
+ * @return esp_err_t ESP_OK 모두 성공, 그 외 처음 발생한 에러 코드
+ */
+esp_err_t mpu6050_read_raw_all_start(const mpu6050_handle_t *handles, size_t count, esp_err_t *results);
+
+/**
+ * @brief mpu6050_read_raw_all_start()로 시작한 읽기 완료 대기
+ *
+ * @param handles 인스턴스 핸들 배열
+ * @param count 인스턴스 수
+ * @param samples 샘플을 저장할 배열 (count개)
+ * @param results 디바이스별 결과를 저장할 배열 (count개, results[i]가 ESP_OK인 샘플만 유효)
+ * @return esp_err_t ESP_OK 모두 성공, 그 외 처음 발생한 에러 코드
+ */
+esp_err_t mpu6050_read_raw_all_finish(const mpu6050_handle_t *handles, size_t count,
+                                      mpu6050_raw_sample_t *samples, esp_err_t *results);
 
 #endif // MPU6050_H
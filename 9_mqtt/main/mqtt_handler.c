@@ -2,14 +2,27 @@
 
 #include "mqtt_handler.h"
 #include "sensor_task.h"
+#include "telemetry.h"
+#include "spool.h"
+#include "latency_trace.h"
+#include "metrics.h"
+#include "command_handler.h"
+#include "json_writer.h"
+#include "imu_fusion.h"
 #include "config.h"
 
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <stdlib.h>
+#include <math.h>
 #include "esp_log.h"
 #include "esp_system.h"
 #include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_crc.h"
+#include "sdkconfig.h"
+#include "freertos/semphr.h"
 
 // MQTT 클라이언트 핸들
 static esp_mqtt_client_handle_t mqtt_client = NULL;
@@ -17,6 +30,522 @@ static esp_mqtt_client_handle_t mqtt_client = NULL;
 // MQTT 연결 상태
 static bool mqtt_connected = false;
 
+// 배치 JSON 크기 (샘플 하나 최대 약 72자)
+#define MQTT_BATCH_SAMPLE_JSON_MAX 80
+#define MQTT_BATCH_PAYLOAD_SIZE (160 + MQTT_BATCH_MAX_SAMPLES * MQTT_BATCH_SAMPLE_JSON_MAX)
+
+// 토픽 종류별 트래픽 JSON 크기 (종류당 최대 약 100자)
+#define MQTT_TRAFFIC_JSON_SIZE (40 + MQTT_CLASS_COUNT * 100)
+
+// 계측 JSON 크기 (단계당 최대 약 80자 + 힙 / 태스크 스택 + outbox 통계 + 트래픽)
+#define MQTT_METRICS_PAYLOAD_SIZE (448 + METRICS_STAGE_COUNT * 80 + METRICS_MAX_TASKS * 32 + MQTT_TRAFFIC_JSON_SIZE)
+
+// 디바이스별 배치 (발행 태스크에서만 접근)
+typedef struct {
+    int64_t base_us;                                // 첫 샘플 시각
+    int64_t enqueue_us;                             // 첫 샘플을 큐에 넣은 시각 (PUBACK 지연 측정)
+    uint32_t first_seq;                             // 첫 샘플 번호 (배치 안의 번호는 연속)
+    uint32_t offset_us[MQTT_BATCH_MAX_SAMPLES];     // 첫 샘플 기준 상대 시각
+    mpu6050_raw_sample_t samples[MQTT_BATCH_MAX_SAMPLES];  // 보정 적용된 LSB (물리 단위 변환은 인코딩할 때)
+    mpu6050_scale_t scale;                          // 캡처 시점 측정 범위 (배치 안의 샘플은 모두 같음)
+    size_t count;
+} mqtt_batch_t;
+
+static mqtt_batch_t batches[MPU6050_MAX_DEVICES];
+static char batch_payload[MQTT_BATCH_PAYLOAD_SIZE];
+
+// 배치 설정 (명령 태스크에서 변경, 발행 태스크에서 읽음)
+static volatile uint32_t batch_size = MQTT_BATCH_DEFAULT_SIZE;
+static volatile uint32_t batch_flush_ms = MQTT_BATCH_DEFAULT_FLUSH_MS;
+
+// 디바이스별 6축 데이터 형식 (FORMAT: 명령으로 변경)
+static volatile mqtt_payload_format_t payload_format[MPU6050_MAX_DEVICES];
+static const char *const mqtt_format_names[MQTT_FORMAT_COUNT] = { "json", "binary", "delta" };
+
+// outbox 상한 정책 (명령 태스크에서 변경, 발행 태스크에서 읽음)
+static volatile mqtt_outbox_policy_t outbox_policy = MQTT_OUTBOX_POLICY;
+static volatile uint32_t outbox_limit = MQTT_OUTBOX_LIMIT;
+static const char *const mqtt_outbox_policy_names[MQTT_OUTBOX_POLICY_COUNT] = {
+    "drop_newest", "drop_oldest", "downsample"
+};
+
+// outbox 통계 (발행 태스크에서 갱신, expired는 MQTT 태스크)
+static mqtt_outbox_stats_t outbox_stats;
+static uint32_t outbox_last_len = 0;                    // 마지막 텔레메트리 메시지 크기 (DROP_OLDEST 여유 확인)
+static bool outbox_backpressure = false;
+static uint8_t outbox_downsample_count[MPU6050_MAX_DEVICES];
+
+// 토픽 종류별 QoS (명령 태스크에서 변경, 발행 태스크에서 읽음)
+static volatile int class_qos[MQTT_CLASS_COUNT] = {
+    [MQTT_CLASS_TELEMETRY] = MQTT_QOS_TELEMETRY,
+    [MQTT_CLASS_STATS] = MQTT_QOS_STATS,
+    [MQTT_CLASS_RESPONSE] = MQTT_QOS_RESPONSE,
+    [MQTT_CLASS_SYNC] = MQTT_QOS_SYNC,
+};
+static const char *const mqtt_class_names[MQTT_CLASS_COUNT] = { "telemetry", "stats", "response", "sync" };
+
+// 토픽 종류별 트래픽 (발행 / 센서 / 명령 태스크에서 갱신)
+static portMUX_TYPE traffic_lock = portMUX_INITIALIZER_UNLOCKED;
+static mqtt_traffic_stats_t traffic_stats[MQTT_CLASS_COUNT];
+static int64_t traffic_window_start_us = 0;
+
+#if MQTT_PROTOCOL_V5 && !CONFIG_MQTT_PROTOCOL_5
+#error "MQTT_PROTOCOL_V5 requires CONFIG_MQTT_PROTOCOL_5=y in sdkconfig"
+#endif
+
+#if MQTT_PROTOCOL_V5
+// 토픽 종류별 메시지 만료 시간 (초)
+static const uint32_t class_expiry_s[MQTT_CLASS_COUNT] = {
+    [MQTT_CLASS_TELEMETRY] = MQTT_EXPIRY_TELEMETRY_S,
+    [MQTT_CLASS_STATS] = MQTT_EXPIRY_STATS_S,
+    [MQTT_CLASS_RESPONSE] = MQTT_EXPIRY_RESPONSE_S,
+    [MQTT_CLASS_SYNC] = MQTT_EXPIRY_SYNC_S,
+};
+
+// 토픽 별칭 (QoS 0 토픽에 처음 발행할 때 1번부터 배정, 연결마다 첫 메시지에만 전체 토픽을 보냄)
+typedef struct {
+    char topic[64];
+    uint32_t sent_generation;   // 토픽 + 별칭을 보낸 연결 (alias_generation과 같으면 별칭만 보내도 됨)
+} mqtt_topic_alias_t;
+
+static mqtt_topic_alias_t topic_aliases[MQTT_TOPIC_ALIAS_MAX > 0 ? MQTT_TOPIC_ALIAS_MAX : 1];
+static size_t topic_alias_count = 0;
+static volatile uint32_t alias_generation = 1;     // 연결할 때마다 증가 (MQTT 태스크)
+
+// 발행 속성은 클라이언트 전체 설정이므로 속성 설정 → 발행을 발행 잠금 안에서 (발행 / 센서 / 명령 태스크)
+static SemaphoreHandle_t publish_lock = NULL;
+#if APP_STATIC_ALLOC
+static StaticSemaphore_t publish_lock_buffer;
+#endif
+#endif
+
+// 클라이언트 outbox에 넣었지만 정책에 따라 버린 메시지 (esp-mqtt의 -1 실패, -2 outbox 가득 참과 구분)
+#define MQTT_OUTBOX_DROPPED (-3)
+_Static_assert(MQTT_BATCH_PAYLOAD_SIZE >= TELEMETRY_HEADER_SIZE + MQTT_BATCH_MAX_SAMPLES * TELEMETRY_DELTA_SAMPLE_MAX_SIZE,
+               "Batch buffer too small for worst-case delta encoding");
+
+static int mqtt_format_sample_json(const mpu6050_data_t *data, const mqtt_sample_info_t *info, char *buf, size_t size);
+static int mqtt_format_sample_json_fast(const mpu6050_data_t *data, const mqtt_sample_info_t *info,
+                                        char *buf, size_t size);
+static int mqtt_format_sample_json_snprintf(const mpu6050_data_t *data, const mqtt_sample_info_t *info,
+                                            char *buf, size_t size);
+static int mqtt_format_sched_stats(const sample_sched_stats_t *stats, char *buf, size_t size);
+static int mqtt_format_latency_stats(bool reset, char *buf, size_t size);
+static int mqtt_format_metrics(bool reset, char *buf, size_t size);
+static int mqtt_format_outbox_stats(bool reset, char *buf, size_t size);
+static int mqtt_format_traffic_stats(bool reset, char *buf, size_t size);
+static int mqtt_send(mqtt_topic_class_t cls, int qos, const char *topic, const char *payload, int len);
+static int mqtt_format_batch_json(const mqtt_batch_t *batch, char *buf, size_t size);
+static int mqtt_format_batch_json_fast(const mqtt_batch_t *batch, char *buf, size_t size);
+static int mqtt_format_batch_json_snprintf(const mqtt_batch_t *batch, char *buf, size_t size);
+static bool mqtt_json_edge_check(void);
+static size_t mqtt_encode_binary(uint8_t device_id, bool delta, const mpu6050_scale_t *scale, int64_t base_us,
+                                 uint32_t first_seq, const mpu6050_raw_sample_t *samples, const uint32_t *offset_us,
+                                 size_t count,
+                                 uint8_t *buf, size_t size);
+static int mqtt_encode_batch(uint8_t device_id, mqtt_payload_format_t format, const mqtt_batch_t *batch,
+                             char *buf, size_t size);
+
+// 인코딩 비용
+typedef struct {
+    uint32_t cycles;            // 샘플당
+    uint32_t bytes;             // 샘플당
+    uint32_t message_cycles;    // 메시지(샘플 하나 또는 배치 하나)당
+} mqtt_encode_cost_t;
+
+#if APP_STATIC_ALLOC
+// ENCODE_BENCH 작업 버퍼 (명령 태스크에서만 사용)
+static mqtt_batch_t bench_batch;
+static char bench_payload[MQTT_BATCH_PAYLOAD_SIZE];
+static int16_t bench_raw[MQTT_BATCH_MAX_SAMPLES][2][TELEMETRY_AXES];
+#define MQTT_BENCH_RAM (sizeof(bench_batch) + sizeof(bench_payload) + sizeof(bench_raw))
+#else
+#define MQTT_BENCH_RAM 0
+#endif
+
+// 주기 발행 버퍼 (METRICS 명령 응답은 명령 태스크의 응답 버퍼에 씀)
+#define MQTT_METRICS_RAM MQTT_METRICS_PAYLOAD_SIZE
+_Static_assert(COMMAND_RESPONSE_SIZE >= MQTT_METRICS_PAYLOAD_SIZE + 96, "COMMAND_RESPONSE_SIZE too small for METRICS");
+
+// 토픽 별칭 표 + 발행 잠금
+#if MQTT_PROTOCOL_V5
+#define MQTT_ALIAS_RAM (sizeof(topic_aliases) + sizeof(StaticSemaphore_t))
+#else
+#define MQTT_ALIAS_RAM 0
+#endif
+
+/**
+ * @brief 인코딩 속도 측정 (형식별, 합성 샘플)
+ *
+ * count가 1이면 샘플 단위 발행, 2 이상이면 배치 발행 형식을 비교합니다.
+ * 델타 압축 결과를 디코딩해서 일반 바이너리와 같은 값인지(무손실) 함께 확인합니다.
+ * JSON은 snprintf 경로(json_ref)도 측정하고, 고정 소수점 작성기와 같은 바이트인지(json_identical) 확인합니다.
+ *
+ * @return 성공 여부
+ */
+static bool mqtt_encode_benchmark(size_t count, mqtt_encode_cost_t cost[MQTT_FORMAT_COUNT], bool *lossless,
+                                  mqtt_encode_cost_t *json_ref, bool *json_identical)
+{
+    if (count == 0 || count > MQTT_BATCH_MAX_SAMPLES) {
+        return false;
+    }
+
+#if APP_STATIC_ALLOC
+    // 발행 태스크의 버퍼와 겹치지 않도록 별도 버퍼 (명령 태스크에서만 호출)
+    mqtt_batch_t *batch = &bench_batch;
+    char *buf = bench_payload;
+    int16_t (*raw)[2][TELEMETRY_AXES] = bench_raw;
+    bool ok = true;
+#else
+    // 발행 태스크의 버퍼와 겹치지 않도록 힙에 할당
+    mqtt_batch_t *batch = malloc(sizeof(mqtt_batch_t));
+    char *buf = malloc(MQTT_BATCH_PAYLOAD_SIZE);
+    int16_t (*raw)[2][TELEMETRY_AXES] = malloc(sizeof(int16_t[MQTT_BATCH_MAX_SAMPLES][2][TELEMETRY_AXES]));
+    bool ok = (batch != NULL && buf != NULL && raw != NULL);
+#endif
+    mpu6050_data_t first = {0};
+
+    if (ok) {
+        // 합성 입력: 느린 움직임 + 센서 잡음 수준의 변동 (델타 크기가 실제 데이터와 비슷하도록)
+        // 현재 측정 범위로 양자화해서 실제 배치와 같은 raw 샘플로 넣음
+        mpu6050_config_t config;
+        uint32_t noise = 1;
+        sensor_get_mpu6050_config(&config);
+        batch->scale = (mpu6050_scale_t) { .accel_range = config.accel_range, .gyro_range = config.gyro_range };
+        batch->base_us = esp_timer_get_time();
+        batch->first_seq = 0;
+        batch->count = count;
+        for (size_t i = 0; i < count; i++) {
+            float t = i * 0.002f;
+            float n[6];
+            for (int k = 0; k < 6; k++) {
+                noise = noise * 1664525u + 1013904223u;
+                n[k] = (float)(noise >> 8) / (float)(1u << 24) - 0.5f;
+            }
+            const mpu6050_data_t data = {
+                .accel_x = 0.05f * sinf(8.0f * t) + 0.004f * n[0],
+                .accel_y = -0.437f + 0.004f * n[1],
+                .accel_z = 0.899f + 0.004f * n[2],
+                .gyro_x = 12.34f * cosf(8.0f * t) + 0.2f * n[3],
+                .gyro_y = -3.21f + 0.2f * n[4],
+                .gyro_z = 0.56f + 0.2f * n[5],
+                .temperature = 27.41f,
+            };
+            batch->offset_us[i] = i * 2000;
+            batch->samples[i] = (mpu6050_raw_sample_t) { .timestamp_us = batch->base_us + i * 2000 };
+            mpu6050_quantize_samples(&batch->scale, &data, &batch->samples[i], 1);
+        }
+
+        // 샘플 단위 JSON은 발행 경로와 같이 변환 결과를 형식화
+        mpu6050_convert_scaled(&batch->scale, &batch->samples[0], &first, 1);
+
+        const mqtt_sample_info_t info = { .seq = 0, .timestamp_us = batch->base_us, .enqueue_us = batch->base_us };
+        for (int format = 0; format < MQTT_FORMAT_COUNT && ok; format++) {
+            uint64_t total = 0;
+            int len = 0;
+            for (int n = 0; n < MQTT_ENCODE_BENCH_ITERATIONS; n++) {
+                esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+                len = (format == MQTT_FORMAT_JSON && count == 1) ?
+                      mqtt_format_sample_json(&first, &info, buf, MQTT_BATCH_PAYLOAD_SIZE) :
+                      mqtt_encode_batch(0, format, batch, buf, MQTT_BATCH_PAYLOAD_SIZE);
+                total += (uint32_t)(esp_cpu_get_cycle_count() - start);
+            }
+            ok = len > 0;
+            cost[format].cycles = total / ((uint64_t)count * MQTT_ENCODE_BENCH_ITERATIONS);
+            cost[format].bytes = len / count;
+            cost[format].message_cycles = total / MQTT_ENCODE_BENCH_ITERATIONS;
+
+            // 바이너리 두 형식을 디코딩해서 비교
+            if (ok && format != MQTT_FORMAT_JSON) {
+                telemetry_meta_t meta;
+                int16_t decoded[MQTT_BATCH_MAX_SAMPLES][TELEMETRY_AXES];
+                size_t decoded_count;
+                ok = telemetry_decode((const uint8_t *)buf, len, &meta, decoded, NULL, count, &decoded_count) &&
+                     decoded_count == count;
+                for (size_t i = 0; i < count && ok; i++) {
+                    memcpy(raw[i][format == MQTT_FORMAT_BINARY_DELTA], decoded[i], sizeof(decoded[i]));
+                }
+            }
+        }
+    }
+
+    if (ok) {
+        // 두 형식 모두 배치의 raw 값과 같아야 함 (다시 양자화하지 않음)
+        *lossless = true;
+        for (size_t i = 0; i < count; i++) {
+            const mpu6050_raw_sample_t *s = &batch->samples[i];
+            const int16_t expected[TELEMETRY_AXES] = {
+                s->accel_x, s->accel_y, s->accel_z, s->temp, s->gyro_x, s->gyro_y, s->gyro_z,
+            };
+            *lossless &= memcmp(raw[i][0], expected, sizeof(expected)) == 0 &&
+                         memcmp(raw[i][1], expected, sizeof(expected)) == 0;
+        }
+
+        // snprintf JSON (기준) 측정, 결과는 길이 + CRC로 고정 소수점 출력과 비교
+        const mqtt_sample_info_t info = { .seq = 0, .timestamp_us = batch->base_us, .enqueue_us = batch->base_us };
+        uint64_t total = 0;
+        int len = 0;
+        for (int n = 0; n < MQTT_ENCODE_BENCH_ITERATIONS; n++) {
+            esp_cpu_cycle_count_t start = esp_cpu_get_cycle_count();
+            len = count == 1 ?
+                  mqtt_format_sample_json_snprintf(&first, &info, buf, MQTT_BATCH_PAYLOAD_SIZE) :
+                  mqtt_format_batch_json_snprintf(batch, buf, MQTT_BATCH_PAYLOAD_SIZE);
+            total += (uint32_t)(esp_cpu_get_cycle_count() - start);
+        }
+        json_ref->cycles = total / ((uint64_t)count * MQTT_ENCODE_BENCH_ITERATIONS);
+        json_ref->bytes = len / count;
+        json_ref->message_cycles = total / MQTT_ENCODE_BENCH_ITERATIONS;
+
+        const uint32_t crc = esp_crc32_le(0, (const uint8_t *)buf, len);
+        const int fast_len = count == 1 ?
+                             mqtt_format_sample_json_fast(&first, &info, buf, MQTT_BATCH_PAYLOAD_SIZE) :
+                             mqtt_format_batch_json_fast(batch, buf, MQTT_BATCH_PAYLOAD_SIZE);
+        *json_identical = fast_len == len && esp_crc32_le(0, (const uint8_t *)buf, fast_len) == crc &&
+                          mqtt_json_edge_check();
+    }
+
+#if !APP_STATIC_ALLOC
+    free(batch);
+    free(buf);
+    free(raw);
+#endif
+    return ok;
+}
+
+/**
+ * @brief SCHED_STATS (현재 구간의 샘플링 주기 오차, 구간은 주기 발행 시 초기화)
+ */
+static esp_err_t mqtt_cmd_sched_stats(const command_t *cmd, char *response, size_t size)
+{
+    sample_sched_stats_t stats;
+    sensor_get_sched_stats(&stats, false);
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"sched\":");
+    len += mqtt_format_sched_stats(&stats, response + len, size - len);
+    snprintf(response + len, size - len, "}");
+    return ESP_OK;
+}
+
+/**
+ * @brief PONG:<id>:<t1>:<t2>:<t3> (시계 차이 측정 ping 응답, 명령 응답 없이 sync 발행)
+ */
+static esp_err_t mqtt_cmd_pong(const command_t *cmd, char *response, size_t size)
+{
+    // t4는 실행 시각이 아니라 수신 시각 (명령 큐 대기 시간이 RTT에 더해지지 않도록)
+    unsigned long id;
+    long long t1, t2, t3;
+    if (cmd->args == NULL || sscanf(cmd->args, "%lu:%lld:%lld:%lld", &id, &t1, &t2, &t3) != 4 ||
+        !latency_sync_on_pong(id, t1, t2, t3, cmd->received_us)) {
+        ESP_LOGW(TAG_MQTT, "Ignoring stale or invalid pong: %s", cmd->text);
+        return ESP_OK;
+    }
+
+    latency_sync_t sync;
+    char payload[96];
+    latency_sync_get(&sync);
+    snprintf(payload, sizeof(payload), "{\"sync\":{\"offset_us\":%lld,\"rtt_us\":%lu}}",
+             (long long)sync.offset_us, (unsigned long)sync.rtt_us);
+    mqtt_send(MQTT_CLASS_SYNC, class_qos[MQTT_CLASS_SYNC], MQTT_TOPIC_RESPONSE, payload, 0);
+    return ESP_OK;
+}
+
+/**
+ * @brief LATENCY_STATS (큐 → PUBACK 지연, 구간은 주기 발행 시 초기화)
+ */
+static esp_err_t mqtt_cmd_latency_stats(const command_t *cmd, char *response, size_t size)
+{
+    int len = snprintf(response, size, "{\"status\":\"ok\",");
+    len += mqtt_format_latency_stats(false, response + len, size - len);
+    snprintf(response + len, size - len, "}");
+    return ESP_OK;
+}
+
+#if METRICS_ENABLE
+/**
+ * @brief METRICS (단계별 처리 사이클, 구간은 주기 발행 시 초기화)
+ */
+static esp_err_t mqtt_cmd_metrics(const command_t *cmd, char *response, size_t size)
+{
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"metrics\":");
+    len += mqtt_format_metrics(false, response + len, size - len);
+    snprintf(response + len, size - len, "}");
+    return ESP_OK;
+}
+#endif
+
+/**
+ * @brief BATCH:<메시지당 샘플 수>, FLUSH:<최대 대기 ms>
+ */
+static esp_err_t mqtt_cmd_batch(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t value;
+    if (!command_parse_u32(cmd->args, UINT32_MAX, &value)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = cmd->name[0] == 'B' ? mqtt_set_batch_size(value) : mqtt_set_batch_flush_ms(value);
+    if (ret == ESP_OK) {
+        snprintf(response, size, "{\"status\":\"ok\",\"batch\":%lu,\"flush_ms\":%lu}",
+                 (unsigned long)mqtt_get_batch_size(), (unsigned long)mqtt_get_batch_flush_ms());
+    }
+    return ret;
+}
+
+/**
+ * @brief 데이터 형식 이름으로 찾기 (대소문자 무시)
+ */
+mqtt_payload_format_t mqtt_payload_format_from_name(const char *name)
+{
+    int format = 0;
+    while (format < MQTT_FORMAT_COUNT && strcasecmp(name, mqtt_format_names[format]) != 0) {
+        format++;
+    }
+    return (mqtt_payload_format_t)format;
+}
+
+/**
+ * @brief 데이터 형식 이름
+ */
+const char *mqtt_payload_format_name(mqtt_payload_format_t format)
+{
+    return format < MQTT_FORMAT_COUNT ? mqtt_format_names[format] : "unknown";
+}
+
+/**
+ * @brief FORMAT:<JSON|BINARY|DELTA>[:<디바이스 번호>] (번호가 없으면 모든 디바이스)
+ */
+static esp_err_t mqtt_cmd_format(const command_t *cmd, char *response, size_t size)
+{
+    if (cmd->args == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    char *device = strchr(cmd->args, ':');
+    uint32_t device_id = 0;
+    if (device != NULL) {
+        *device++ = '\0';
+        if (!command_parse_u32(device, MPU6050_MAX_DEVICES - 1, &device_id)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    mqtt_payload_format_t format = mqtt_payload_format_from_name(cmd->args);
+    if (format == MQTT_FORMAT_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        if (device == NULL || i == (int)device_id) {
+            mqtt_set_payload_format(i, format);
+        }
+    }
+    snprintf(response, size, "{\"status\":\"ok\",\"format\":\"%s\",\"device\":%s}",
+             mqtt_format_names[format], device ? device : "\"all\"");
+    return ESP_OK;
+}
+
+/**
+ * @brief ENCODE_BENCH[:<샘플 수>] (1: 샘플 단위 발행, 2 이상: 배치 발행)
+ */
+static esp_err_t mqtt_cmd_encode_bench(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t count = MQTT_BATCH_MAX_SAMPLES;
+    mqtt_encode_cost_t cost[MQTT_FORMAT_COUNT];
+    mqtt_encode_cost_t json_ref;
+    bool lossless = false;
+    bool json_identical = false;
+    if ((cmd->args != NULL && !command_parse_u32(cmd->args, UINT16_MAX, &count)) || count == 0 ||
+        !mqtt_encode_benchmark(count, cost, &lossless, &json_ref, &json_identical)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"samples\":%lu", (unsigned long)count);
+    for (int i = 0; i <= MQTT_FORMAT_COUNT; i++) {
+        const mqtt_encode_cost_t *c = i < MQTT_FORMAT_COUNT ? &cost[i] : &json_ref;
+        len += snprintf(response + len, size - len,
+                        ",\"%s\":{\"cycles_per_sample\":%lu,\"cycles_per_message\":%lu,\"bytes_per_sample\":%lu}",
+                        i < MQTT_FORMAT_COUNT ? mqtt_format_names[i] : "json_snprintf",
+                        (unsigned long)c->cycles, (unsigned long)c->message_cycles, (unsigned long)c->bytes);
+    }
+    snprintf(response + len, size - len, ",\"lossless\":%s,\"json_identical\":%s}",
+             lossless ? "true" : "false", json_identical ? "true" : "false");
+    return ESP_OK;
+}
+
+/**
+ * @brief OUTBOX (조회), OUTBOX:<DROP_NEWEST|DROP_OLDEST|DOWNSAMPLE>[:<상한 바이트>]
+ */
+static esp_err_t mqtt_cmd_outbox(const command_t *cmd, char *response, size_t size)
+{
+    static const char *const policy_args[MQTT_OUTBOX_POLICY_COUNT] = { "DROP_NEWEST", "DROP_OLDEST", "DOWNSAMPLE" };
+
+    if (cmd->args != NULL) {
+        char *sep = strchr(cmd->args, ':');
+        uint32_t limit = outbox_limit;
+        if (sep != NULL) {
+            *sep++ = '\0';
+            if (!command_parse_u32(sep, UINT32_MAX, &limit)) {
+                return ESP_ERR_INVALID_ARG;
+            }
+        }
+        int policy = 0;
+        while (policy < MQTT_OUTBOX_POLICY_COUNT && strcmp(cmd->args, policy_args[policy]) != 0) {
+            policy++;
+        }
+        esp_err_t ret = mqtt_set_outbox_policy((mqtt_outbox_policy_t)policy, limit);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"outbox\":");
+    len += mqtt_format_outbox_stats(false, response + len, size - len);
+    snprintf(response + len, size - len, "}");
+    return ESP_OK;
+}
+
+/**
+ * @brief QOS (조회), QOS:<TELEMETRY|STATS|RESPONSE|SYNC>:<0|1> (트래픽은 주기 발행 시 초기화)
+ */
+static esp_err_t mqtt_cmd_qos(const command_t *cmd, char *response, size_t size)
+{
+    static const char *const class_args[MQTT_CLASS_COUNT] = { "TELEMETRY", "STATS", "RESPONSE", "SYNC" };
+
+    if (cmd->args != NULL) {
+        char *sep = strchr(cmd->args, ':');
+        uint32_t qos;
+        if (sep == NULL || !command_parse_u32(sep + 1, 1, &qos)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        *sep = '\0';
+        int cls = 0;
+        while (cls < MQTT_CLASS_COUNT && strcmp(cmd->args, class_args[cls]) != 0) {
+            cls++;
+        }
+        esp_err_t ret = mqtt_set_class_qos((mqtt_topic_class_t)cls, qos);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"traffic\":");
+    len += mqtt_format_traffic_stats(false, response + len, size - len);
+    snprintf(response + len, size - len, "}");
+    return ESP_OK;
+}
+
+// 명령 등록 표 (command_handler.c가 이름으로 찾아 명령 태스크에서 실행, 센서 / 스풀 명령은 각 모듈이 등록)
+static const command_def_t mqtt_commands[] = {
+    { "SCHED_STATS", mqtt_cmd_sched_stats },
+    { "PONG", mqtt_cmd_pong },
+    { "LATENCY_STATS", mqtt_cmd_latency_stats },
+#if METRICS_ENABLE
+    { "METRICS", mqtt_cmd_metrics },
+#endif
+    { "BATCH", mqtt_cmd_batch },
+    { "FLUSH", mqtt_cmd_batch },
+    { "FORMAT", mqtt_cmd_format },
+    { "ENCODE_BENCH", mqtt_cmd_encode_bench },
+    { "OUTBOX", mqtt_cmd_outbox },
+    { "QOS", mqtt_cmd_qos },
+};
+
 /**
  * @brief MQTT 이벤트 핸들러
  */
@@ -29,6 +558,10 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG_MQTT, "MQTT Connected to broker");
         mqtt_connected = true;
+#if MQTT_PROTOCOL_V5
+        // 토픽 별칭은 연결마다 새로 (다음 메시지부터 다시 전체 토픽 + 별칭)
+        alias_generation++;
+#endif
 
         // 명령 토픽 구독
         int msg_id = esp_mqtt_client_subscribe(mqtt_client, MQTT_TOPIC_COMMAND, 1);
@@ -38,30 +571,32 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(TAG_MQTT, "MQTT Disconnected");
         mqtt_connected = false;
+        latency_clear_pending();
         break;
 
     case MQTT_EVENT_SUBSCRIBED:
         ESP_LOGI(TAG_MQTT, "MQTT Subscribed, msg_id=%d", event->msg_id);
         break;
 
+    case MQTT_EVENT_PUBLISHED:
+        // QoS 1 PUBACK 수신 (추적 중인 6축 메시지면 지연 기록)
+        latency_on_puback(event->msg_id, esp_timer_get_time());
+        break;
+
+    case MQTT_EVENT_DELETED:
+        // 만료 시간(CONFIG_MQTT_OUTBOX_EXPIRED_TIMEOUT_MS) 안에 전송하지 못해 outbox에서 지운 메시지
+        outbox_stats.expired++;
+        ESP_LOGW(TAG_MQTT, "Outbox message expired (msg_id=%d)", event->msg_id);
+        break;
+
     case MQTT_EVENT_DATA:
-        // 명령 수신
-        ESP_LOGI(TAG_MQTT, "MQTT Data received");
-        printf("TOPIC: %.*s\n", event->topic_len, event->topic);
-        printf("DATA: %.*s\n", event->data_len, event->data);
-
-        // 전송 주기 변경 명령 처리
-        if (strncmp(event->data, "INTERVAL:", 9) == 0) {
-            uint32_t new_interval = atoi(event->data + 9);
-            sensor_set_publish_interval(new_interval);
-
-            // 응답 메시지 발행
-            char response[64];
-            snprintf(response, sizeof(response),
-                    "{\"status\":\"ok\",\"interval\":%lu}",
-                    sensor_get_publish_interval());
-            esp_mqtt_client_publish(mqtt_client, MQTT_TOPIC_RESPONSE, response, 0, 1, 0);
+        // 명령 수신 (조각을 슬롯에 모아 명령 태스크로 넘김, 이 태스크에서는 실행하지 않음)
+        if (event->current_data_offset == 0) {
+            ESP_LOGI(TAG_MQTT, "MQTT Data received on %.*s (%d bytes)", event->topic_len, event->topic,
+                     event->total_data_len);
         }
+        ESP_LOGD(TAG_MQTT, "DATA: %.*s", event->data_len, event->data);
+        command_receive(event->data, event->data_len, event->current_data_offset, event->total_data_len);
         break;
 
     case MQTT_EVENT_ERROR:
@@ -86,11 +621,46 @@ void mqtt_init_and_start(void)
 {
     esp_mqtt_client_config_t mqtt_cfg = {
         .broker.address.uri = MQTT_BROKER_URL,
+        .outbox.limit = MQTT_OUTBOX_LIMIT + MQTT_OUTBOX_RESERVE,
+        .buffer.size = MQTT_BUFFER_SIZE,
+        .buffer.out_size = MQTT_BUFFER_SIZE,
+        .task.stack_size = MQTT_TASK_STACK_SIZE,
+#if MQTT_PROTOCOL_V5
+        .session.protocol_ver = MQTT_PROTOCOL_V_5,
+#endif
     };
 
+    for (int i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        payload_format[i] = MQTT_PAYLOAD_BINARY_DEFAULT ? MQTT_FORMAT_BINARY : MQTT_FORMAT_JSON;
+    }
+
+#if SPOOL_ENABLE
+    // 플래시를 쓸 수 없어도 RAM 링으로 동작
+    spool_init();
+#endif
+
+#if MQTT_PROTOCOL_V5
+#if APP_STATIC_ALLOC
+    publish_lock = xSemaphoreCreateMutexStatic(&publish_lock_buffer);
+#else
+    publish_lock = xSemaphoreCreateMutex();
+#endif
+#endif
+
+    // 명령 태스크는 클라이언트보다 먼저 시작 (연결 직후 받은 명령도 처리)
+    command_register(mqtt_commands, sizeof(mqtt_commands) / sizeof(mqtt_commands[0]));
+    command_init(mqtt_publish_response);
+
     mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     esp_mqtt_client_register_event(mqtt_client, ESP_EVENT_ANY_ID, mqtt_event_handler, NULL);
     esp_mqtt_client_start(mqtt_client);
+    metrics_register_task(xTaskGetHandle("mqtt_task"));
+
+    // 클라이언트 버퍼와 태스크 스택은 시작할 때 한 번 힙에 할당 (outbox는 메시지마다)
+    metrics_add_ram_budget("mqtt_client", 2 * MQTT_BUFFER_SIZE + MQTT_TASK_STACK_SIZE);
+    metrics_add_ram_budget("mqtt", sizeof(batches) + sizeof(batch_payload) + MQTT_BENCH_RAM + MQTT_METRICS_RAM +
+                           sizeof(traffic_stats) + MQTT_ALIAS_RAM);
+    metrics_add_ram_budget("latency", latency_trace_ram_size());
 
     ESP_LOGI(TAG_MQTT, "MQTT client started, broker: %s", MQTT_BROKER_URL);
 }
@@ -111,45 +681,1099 @@ esp_mqtt_client_handle_t mqtt_get_client(void)
     return mqtt_client;
 }
 
+/**
+ * @brief MQTT 가변 길이 정수(remaining length / 속성 길이) 바이트 수
+ */
+static size_t mqtt_varint_size(size_t value)
+{
+    size_t size = 1;
+    while (value >= 128) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/**
+ * @brief 토픽 종류별 트래픽 기록 (PUBLISH 패킷 크기는 MQTT 형식으로 계산, TCP/TLS 헤더 제외)
+ *
+ * @param topic_len 보낸 토픽 길이 (별칭만 보냈으면 0)
+ * @param property_len v5 속성 바이트 수 (속성 길이 필드 제외)
+ */
+static void mqtt_count_traffic(mqtt_topic_class_t cls, size_t topic_len, size_t payload_len, int qos,
+                               size_t property_len)
+{
+    size_t remaining = 2 + topic_len + (qos > 0 ? 2 : 0) + payload_len;
+#if MQTT_PROTOCOL_V5
+    remaining += mqtt_varint_size(property_len) + property_len;
+#else
+    (void)property_len;
+#endif
+    const uint32_t bytes = 1 + mqtt_varint_size(remaining) + remaining;
+
+    portENTER_CRITICAL(&traffic_lock);
+    traffic_stats[cls].messages++;
+    traffic_stats[cls].bytes += bytes;
+    traffic_stats[cls].packets += qos > 0 ? 2 : 1;     // QoS 1: PUBLISH + PUBACK
+    if (topic_len == 0) {
+        traffic_stats[cls].aliased++;
+    }
+    portEXIT_CRITICAL(&traffic_lock);
+}
+
+#if MQTT_PROTOCOL_V5
+/**
+ * @brief 토픽 별칭 조회, 처음 보는 토픽이면 배정 (발행 잠금 안에서 호출)
+ *
+ * @param alias_id 별칭 번호 (1부터, 자리가 없으면 0)
+ * @return 별칭 항목, 자리가 없으면 NULL
+ */
+static mqtt_topic_alias_t *mqtt_topic_alias(const char *topic, uint16_t *alias_id)
+{
+    size_t i = 0;
+    while (i < topic_alias_count && strcmp(topic_aliases[i].topic, topic) != 0) {
+        i++;
+    }
+    if (i == topic_alias_count) {
+        if (topic_alias_count + 1 > MQTT_TOPIC_ALIAS_MAX || strlen(topic) >= sizeof(topic_aliases[0].topic)) {
+            *alias_id = 0;
+            return NULL;
+        }
+        snprintf(topic_aliases[i].topic, sizeof(topic_aliases[i].topic), "%s", topic);
+        topic_aliases[i].sent_generation = 0;
+        topic_alias_count++;
+    }
+    *alias_id = i + 1;
+    return &topic_aliases[i];
+}
+
+/**
+ * @brief 발행 속성 설정 (브로커의 Topic Alias Maximum을 넘는 등 실패하면 별칭 없이 다시 설정)
+ */
+static void mqtt_set_publish_property(esp_mqtt5_publish_property_config_t *property)
+{
+    if (esp_mqtt5_client_set_publish_property(mqtt_client, property) != ESP_OK && property->topic_alias != 0) {
+        property->topic_alias = 0;
+        esp_mqtt5_client_set_publish_property(mqtt_client, property);
+    }
+}
+#endif
+
+/**
+ * @brief 토픽 종류 설정(메시지 만료 / 토픽 별칭)으로 outbox에 넣고 트래픽 기록 (전송은 MQTT 태스크)
+ *
+ * MQTT 태스크(이벤트 핸들러)에서는 호출하지 않습니다. 이벤트 핸들러는 클라이언트 잠금을 쥔 채 호출되므로
+ * 발행 잠금을 기다리면 교착합니다 (명령 거절 응답도 명령 태스크가 보냄).
+ * 발행 잠금을 쥔 동안 네트워크를 기다리지 않도록 항상 esp_mqtt_client_enqueue()를 사용합니다.
+ *
+ * @param qos 발행 QoS (보통 class_qos[cls], 보관 샘플 재전송은 1)
+ * @param len 데이터 길이 (0이면 문자열 길이)
+ * @return msg_id (QoS 0은 0), 실패 시 -1, 클라이언트 outbox 가득 참 -2
+ */
+static int mqtt_send(mqtt_topic_class_t cls, int qos, const char *topic, const char *payload, int len)
+{
+    const char *wire_topic = topic;
+    size_t property_len = 0;
+    int msg_id;
+
+    if (len == 0) {
+        len = strlen(payload);
+    }
+
+#if MQTT_PROTOCOL_V5
+    esp_mqtt5_publish_property_config_t property = {
+        .message_expiry_interval = class_expiry_s[cls],
+    };
+    mqtt_topic_alias_t *alias = NULL;
+
+    xSemaphoreTake(publish_lock, portMAX_DELAY);
+
+    // 별칭은 QoS 0만 (QoS 1은 재연결 후 다시 보내므로 새 연결에서 모르는 별칭이 될 수 있음)
+    if (qos == 0) {
+        alias = mqtt_topic_alias(topic, &property.topic_alias);
+    }
+    mqtt_set_publish_property(&property);
+    if (property.topic_alias == 0) {
+        alias = NULL;
+    } else if (alias->sent_generation == alias_generation && esp_mqtt_client_get_outbox_size(mqtt_client) == 0) {
+        // 이번 연결에서 토픽을 보냈으면 별칭만 (outbox에 쌓인 채로 연결이 끊기면 새 연결에 별칭만 남지 않도록 비었을 때만)
+        wire_topic = "";
+    }
+
+    msg_id = esp_mqtt_client_enqueue(mqtt_client, wire_topic, payload, len, qos, 0, true);
+
+    if (alias != NULL && msg_id >= 0 && wire_topic == topic) {
+        alias->sent_generation = alias_generation;
+    }
+    xSemaphoreGive(publish_lock);
+    property_len = (property.message_expiry_interval ? 5 : 0) + (property.topic_alias ? 3 : 0);
+#else
+    msg_id = esp_mqtt_client_enqueue(mqtt_client, topic, payload, len, qos, 0, true);
+#endif
+
+    if (msg_id >= 0) {
+        mqtt_count_traffic(cls, strlen(wire_topic), len, qos, property_len);
+    }
+    return msg_id;
+}
+
+/**
+ * @brief 토픽 종류별 QoS 설정
+ */
+esp_err_t mqtt_set_class_qos(mqtt_topic_class_t cls, int qos)
+{
+    if (cls < 0 || cls >= MQTT_CLASS_COUNT || qos < 0 || qos > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    class_qos[cls] = qos;
+    ESP_LOGI(TAG_MQTT, "QoS %d for %s topics", qos, mqtt_class_names[cls]);
+    return ESP_OK;
+}
+
+/**
+ * @brief 토픽 종류별 발행 트래픽 조회
+ */
+void mqtt_get_traffic_stats(mqtt_traffic_stats_t stats[MQTT_CLASS_COUNT], uint32_t *window_ms, bool reset)
+{
+    const int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&traffic_lock);
+    memcpy(stats, traffic_stats, sizeof(traffic_stats));
+    *window_ms = (now_us - traffic_window_start_us) / 1000;
+    if (reset) {
+        memset(traffic_stats, 0, sizeof(traffic_stats));
+        traffic_window_start_us = now_us;
+    }
+    portEXIT_CRITICAL(&traffic_lock);
+
+    for (int i = 0; i < MQTT_CLASS_COUNT; i++) {
+        stats[i].qos = class_qos[i];
+    }
+}
+
+/**
+ * @brief 토픽 종류별 발행 트래픽 JSON 생성
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_traffic_stats(bool reset, char *buf, size_t size)
+{
+    mqtt_traffic_stats_t stats[MQTT_CLASS_COUNT];
+    uint32_t window_ms;
+    mqtt_get_traffic_stats(stats, &window_ms, reset);
+
+    int len = snprintf(buf, size, "{\"protocol\":%d,\"window_ms\":%lu", MQTT_PROTOCOL_V5 ? 5 : 3,
+                       (unsigned long)window_ms);
+    for (int i = 0; i < MQTT_CLASS_COUNT && len < (int)size; i++) {
+        len += snprintf(buf + len, size - len,
+                        ",\"%s\":{\"qos\":%d,\"msgs\":%lu,\"bytes\":%lu,\"packets\":%lu,\"aliased\":%lu}",
+                        mqtt_class_names[i], stats[i].qos, (unsigned long)stats[i].messages,
+                        (unsigned long)stats[i].bytes, (unsigned long)stats[i].packets,
+                        (unsigned long)stats[i].aliased);
+    }
+    if (len < (int)size) {
+        len += snprintf(buf + len, size - len, "}");
+    }
+    return len < (int)size ? len : (int)size - 1;
+}
+
+/**
+ * @brief 명령 응답 발행
+ */
+void mqtt_publish_response(const char *response)
+{
+    if (!mqtt_connected || mqtt_client == NULL) {
+        ESP_LOGW(TAG_MQTT, "MQTT not connected, dropping response");
+        return;
+    }
+    mqtt_send(MQTT_CLASS_RESPONSE, class_qos[MQTT_CLASS_RESPONSE], MQTT_TOPIC_RESPONSE, response, 0);
+}
+
+/**
+ * @brief 바이너리 로그 프레임 발행
+ */
+bool mqtt_publish_log(const uint8_t *frame, size_t len)
+{
+    if (!mqtt_connected || mqtt_client == NULL ||
+        esp_mqtt_client_get_outbox_size(mqtt_client) + (int)len > (int)outbox_limit) {
+        return false;
+    }
+    return mqtt_send(MQTT_CLASS_STATS, class_qos[MQTT_CLASS_STATS], MQTT_TOPIC_LOG, (const char *)frame, len) >= 0;
+}
+
+/**
+ * @brief 발행 태스크의 메시지를 outbox에 넣기 (전송은 MQTT 태스크, 상한 정책 적용)
+ *
+ * @param cls 토픽 종류 (QoS / 메시지 만료 / 별칭)
+ * @param device_id 다운샘플링 단위 (6축 / 자세 메시지)
+ * @param samples 메시지에 담긴 6축 샘플 수 (통계 메시지는 0, 다운샘플링 제외)
+ * @return msg_id (QoS 0은 0), 정책에 따라 버렸으면 MQTT_OUTBOX_DROPPED, 실패 시 -1
+ */
+static int mqtt_enqueue(mqtt_topic_class_t cls, uint8_t device_id, size_t samples, const char *topic,
+                        const char *payload, int len)
+{
+    if (len == 0) {
+        len = strlen(payload);
+    }
+
+    const uint32_t outbox = esp_mqtt_client_get_outbox_size(mqtt_client);
+    const uint32_t limit = outbox_limit;
+    if (outbox > outbox_stats.peak) {
+        outbox_stats.peak = outbox;
+    }
+    if (samples > 0) {
+        outbox_last_len = len;
+    }
+
+    bool drop = outbox + len > limit;
+    if (!drop && samples > 0 && outbox_policy == MQTT_OUTBOX_DOWNSAMPLE && device_id < MPU6050_MAX_DEVICES) {
+        if (outbox > (uint64_t)limit * MQTT_OUTBOX_DOWNSAMPLE_START_PCT / 100) {
+            // 디바이스별로 N개 중 첫 번째만 발행
+            if (outbox_downsample_count[device_id]++ % MQTT_OUTBOX_DOWNSAMPLE_FACTOR != 0) {
+                outbox_stats.downsampled++;
+                outbox_stats.dropped_samples += samples;
+                return MQTT_OUTBOX_DROPPED;
+            }
+        } else {
+            outbox_downsample_count[device_id] = 0;
+        }
+    }
+
+    int msg_id = drop ? -2 : mqtt_send(cls, class_qos[cls], topic, payload, len);
+    if (msg_id == -2) {
+        // 상한 초과 (클라이언트 outbox 상한도 -2)
+        outbox_stats.dropped++;
+        outbox_stats.dropped_samples += samples;
+        return MQTT_OUTBOX_DROPPED;
+    }
+    if (msg_id >= 0) {
+        outbox_stats.enqueued++;
+    }
+    return msg_id;
+}
+
+/**
+ * @brief 발행 태스크가 샘플 큐에서 다음 샘플을 꺼내도 되는지 확인
+ */
+bool mqtt_outbox_ready(void)
+{
+    if (outbox_policy != MQTT_OUTBOX_DROP_OLDEST || !mqtt_connected || mqtt_client == NULL) {
+        outbox_backpressure = false;
+        return true;
+    }
+
+    bool ready = esp_mqtt_client_get_outbox_size(mqtt_client) + outbox_last_len <= outbox_limit;
+    if (!ready && !outbox_backpressure) {
+        outbox_stats.backpressure++;
+        ESP_LOGW(TAG_MQTT, "Outbox full, holding samples in queue");
+    }
+    outbox_backpressure = !ready;
+    return ready;
+}
+
+/**
+ * @brief outbox 상한 정책 설정
+ */
+esp_err_t mqtt_set_outbox_policy(mqtt_outbox_policy_t policy, uint32_t limit)
+{
+    if (policy < 0 || policy >= MQTT_OUTBOX_POLICY_COUNT || limit < MQTT_BUFFER_SIZE || limit > MQTT_OUTBOX_LIMIT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    outbox_policy = policy;
+    outbox_limit = limit;
+    ESP_LOGI(TAG_MQTT, "Outbox policy %s, limit %lu bytes", mqtt_outbox_policy_names[policy], (unsigned long)limit);
+    return ESP_OK;
+}
+
+/**
+ * @brief outbox 통계 조회
+ */
+void mqtt_get_outbox_stats(mqtt_outbox_stats_t *stats, bool reset)
+{
+    // 단일 값 갱신만 하므로 잠금 없이 복사 (조회 도중 바뀐 값은 다음 구간에 반영)
+    *stats = outbox_stats;
+    stats->policy = outbox_policy;
+    stats->limit = outbox_limit;
+    stats->bytes = mqtt_client ? esp_mqtt_client_get_outbox_size(mqtt_client) : 0;
+    if (reset) {
+        memset(&outbox_stats, 0, sizeof(outbox_stats));
+    }
+}
+
+/**
+ * @brief outbox 통계 JSON 생성
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_outbox_stats(bool reset, char *buf, size_t size)
+{
+    mqtt_outbox_stats_t stats;
+    mqtt_get_outbox_stats(&stats, reset);
+    return snprintf(buf, size,
+                    "{\"policy\":\"%s\",\"limit\":%lu,\"bytes\":%lu,\"peak\":%lu,\"enqueued\":%lu,"
+                    "\"dropped\":%lu,\"downsampled\":%lu,\"dropped_samples\":%lu,\"backpressure\":%lu,"
+                    "\"expired\":%lu}",
+                    mqtt_outbox_policy_names[stats.policy], (unsigned long)stats.limit,
+                    (unsigned long)stats.bytes, (unsigned long)stats.peak, (unsigned long)stats.enqueued,
+                    (unsigned long)stats.dropped, (unsigned long)stats.downsampled,
+                    (unsigned long)stats.dropped_samples, (unsigned long)stats.backpressure,
+                    (unsigned long)stats.expired);
+}
+
+/**
+ * @brief 샘플링 주기 오차 통계 JSON 생성
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_sched_stats(const sample_sched_stats_t *stats, char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "{\"period_us\":%lu,\"rate_hz\":%.3f,\"samples\":%lu,\"missed\":%lu,"
+                    "\"err_us\":{\"min\":%ld,\"max\":%ld,\"mean\":%.2f,\"p99\":%lu},\"window_ms\":%lu}",
+                    (unsigned long)stats->period_us, stats->rate_hz,
+                    (unsigned long)stats->samples, (unsigned long)stats->missed,
+                    (long)stats->err_min_us, (long)stats->err_max_us, stats->err_mean_us,
+                    (unsigned long)stats->err_p99_us, (unsigned long)stats->window_ms);
+}
+
+/**
+ * @brief 샘플링 주기 오차 통계 발행
+ */
+void mqtt_publish_sched_stats(const sample_sched_stats_t *stats)
+{
+    if (!mqtt_connected || mqtt_client == NULL) {
+        return;
+    }
+
+    char payload[192];
+    int len = mqtt_format_sched_stats(stats, payload, sizeof(payload));
+    mqtt_enqueue(MQTT_CLASS_STATS, 0, 0, MQTT_TOPIC_SENSOR_STATS, payload, len);
+    ESP_LOGI(TAG_MQTT, "Sampling %.3f Hz (period %lu us), error min %ld / max %ld / p99 %lu us, missed %lu",
+             stats->rate_hz, (unsigned long)stats->period_us, (long)stats->err_min_us,
+             (long)stats->err_max_us, (unsigned long)stats->err_p99_us, (unsigned long)stats->missed);
+}
+
+/**
+ * @brief PUBACK 지연 통계와 시계 차이 JSON 생성 (중괄호 없는 필드 목록)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_latency_stats(bool reset, char *buf, size_t size)
+{
+    latency_stats_t stats;
+    latency_sync_t sync;
+
+    latency_get_stats(&stats, reset);
+    latency_sync_get(&sync);
+    // QoS 0 텔레메트리는 PUBACK이 없어 측정되지 않음 (untracked, qos로 표시)
+    int len = snprintf(buf, size,
+                       "\"latency_us\":{\"qos\":%d,\"count\":%lu,\"untracked\":%lu,\"evicted\":%lu,"
+                       "\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"max\":%lu}",
+                       class_qos[MQTT_CLASS_TELEMETRY], (unsigned long)stats.count,
+                       (unsigned long)stats.untracked, (unsigned long)stats.evicted,
+                       (unsigned long)stats.p50_us, (unsigned long)stats.p90_us,
+                       (unsigned long)stats.p99_us, (unsigned long)stats.max_us);
+    if (sync.valid) {
+        len += snprintf(buf + len, size - len, ",\"sync\":{\"offset_us\":%lld,\"rtt_us\":%lu,\"exchanges\":%lu}",
+                        (long long)sync.offset_us, (unsigned long)sync.rtt_us, (unsigned long)sync.exchanges);
+    }
+    return len;
+}
+
+/**
+ * @brief PUBACK 지연 통계 발행
+ */
+void mqtt_publish_latency_stats(void)
+{
+    if (!mqtt_connected || mqtt_client == NULL) {
+        return;
+    }
+
+    char payload[256];
+    int len = snprintf(payload, sizeof(payload), "{");
+    len += mqtt_format_latency_stats(true, payload + len, sizeof(payload) - len);
+    len += snprintf(payload + len, sizeof(payload) - len, "}");
+    mqtt_enqueue(MQTT_CLASS_STATS, 0, 0, MQTT_TOPIC_SENSOR_STATS, payload, len);
+    ESP_LOGI(TAG_MQTT, "Latency %s", payload);
+}
+
+/**
+ * @brief 단계별 처리 사이클, 힙, 태스크 스택 여유 JSON 생성
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_metrics(bool reset, char *buf, size_t size)
+{
+    metrics_snapshot_t snapshot;
+    metrics_get(&snapshot, reset);
+
+    int len = snprintf(buf, size, "{\"cycles_per_us\":%lu,\"window_ms\":%lu,\"stages\":{",
+                       (unsigned long)snapshot.cycles_per_us, (unsigned long)snapshot.window_ms);
+    bool first = true;
+    for (size_t s = 0; s < METRICS_STAGE_COUNT && len < (int)size; s++) {
+        const metrics_stage_stats_t *stage = &snapshot.stages[s];
+        if (stage->count == 0) {
+            continue;   // 현재 모드에서 쓰지 않는 단계는 생략
+        }
+        len += snprintf(buf + len, size - len, "%s\"%s\":{\"n\":%lu,\"mean\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu}",
+                        first ? "" : ",", metrics_stage_name(s), (unsigned long)stage->count,
+                        (unsigned long)stage->mean, (unsigned long)stage->p50,
+                        (unsigned long)stage->p99, (unsigned long)stage->max);
+        first = false;
+    }
+    if (len < (int)size && snapshot.heap_valid) {
+        len += snprintf(buf + len, size - len, "},\"heap\":{\"free\":%lu,\"min_free\":%lu",
+                        (unsigned long)snapshot.heap_free, (unsigned long)snapshot.heap_min_free);
+    }
+    if (len < (int)size) {
+        len += snprintf(buf + len, size - len, "},\"stack_free\":{");
+    }
+    for (size_t i = 0; i < snapshot.task_count && len < (int)size; i++) {
+        len += snprintf(buf + len, size - len, "%s\"%s\":%lu", i ? "," : "",
+                        snapshot.tasks[i].name, (unsigned long)snapshot.tasks[i].stack_free);
+        if (reset && snapshot.tasks[i].stack_free < APP_STACK_MARGIN) {
+            ESP_LOGW(TAG_MQTT, "Task %s stack low: %lu bytes free", snapshot.tasks[i].name,
+                     (unsigned long)snapshot.tasks[i].stack_free);
+        }
+    }
+    if (len < (int)size) {
+        len += snprintf(buf + len, size - len, "},\"outbox\":");
+    }
+    if (len < (int)size) {
+        len += mqtt_format_outbox_stats(reset, buf + len, size - len);
+    }
+    if (len < (int)size) {
+        len += snprintf(buf + len, size - len, ",\"traffic\":");
+    }
+    if (len < (int)size) {
+        len += mqtt_format_traffic_stats(reset, buf + len, size - len);
+    }
+    if (len < (int)size) {
+        len += snprintf(buf + len, size - len, "}");
+    }
+    return len < (int)size ? len : (int)size - 1;
+}
+
+/**
+ * @brief 단계별 처리 사이클, 힙, 태스크 스택 여유 발행
+ */
+void mqtt_publish_metrics(void)
+{
+    static char payload[MQTT_METRICS_PAYLOAD_SIZE];   // 발행 태스크에서만 사용
+
+    if (!mqtt_connected || mqtt_client == NULL) {
+        return;
+    }
+
+    int len = mqtt_format_metrics(true, payload, sizeof(payload));
+    mqtt_enqueue(MQTT_CLASS_STATS, 0, 0, MQTT_TOPIC_METRICS, payload, len);
+    ESP_LOGD(TAG_MQTT, "Metrics %s", payload);
+}
+
+/**
+ * @brief 시계 차이 측정용 ping 발행
+ */
+void mqtt_latency_sync_poll(int64_t now_us)
+{
+    static int64_t last_ping_us = 0;
+
+    if (LATENCY_SYNC_INTERVAL_MS == 0 || !mqtt_connected || mqtt_client == NULL ||
+        (last_ping_us != 0 && now_us - last_ping_us < (int64_t)LATENCY_SYNC_INTERVAL_MS * 1000)) {
+        return;
+    }
+    last_ping_us = now_us;
+
+    // outbox에 넣기 직전 시각을 t1로 사용 (outbox 대기는 RTT에 더해지므로 RTT가 가장 짧은 결과를 쓰면 걸러짐)
+    char payload[80];
+    const uint32_t id = latency_sync_next_ping();
+    snprintf(payload, sizeof(payload), "{\"ping\":{\"id\":%lu,\"t1\":%lld}}",
+             (unsigned long)id, (long long)esp_timer_get_time());
+    mqtt_send(MQTT_CLASS_SYNC, class_qos[MQTT_CLASS_SYNC], MQTT_TOPIC_RESPONSE, payload, 0);
+}
+
+/**
+ * @brief 디바이스별 센서 데이터 토픽
+ *
+ * 첫 번째 디바이스는 기존 토픽, 나머지는 토픽 뒤에 디바이스 번호를 붙임
+ */
+static void mqtt_sensor_topic(uint8_t device_id, char *topic, size_t size)
+{
+    if (device_id == 0) {
+        snprintf(topic, size, "%s", MQTT_TOPIC_SENSOR_DATA);
+    } else {
+        snprintf(topic, size, "%s/%u", MQTT_TOPIC_SENSOR_DATA, device_id);
+    }
+}
+
+/**
+ * @brief 샘플 하나의 JSON 생성 (MQTT_JSON_FAST에 따라 고정 소수점 작성기 또는 snprintf)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_sample_json(const mpu6050_data_t *data, const mqtt_sample_info_t *info, char *buf, size_t size)
+{
+#if MQTT_JSON_FAST
+    return mqtt_format_sample_json_fast(data, info, buf, size);
+#else
+    return mqtt_format_sample_json_snprintf(data, info, buf, size);
+#endif
+}
+
+/**
+ * @brief 샘플 하나의 JSON 생성 (고정 소수점 작성기, snprintf 경로와 같은 바이트)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_sample_json_fast(const mpu6050_data_t *data, const mqtt_sample_info_t *info,
+                                        char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_put_literal(&w, "{\"sensor\":\"MPU6050\",\"accel\":{\"x\":");
+    json_put_fixed(&w, data->accel_x, 3);
+    json_put_literal(&w, ",\"y\":");
+    json_put_fixed(&w, data->accel_y, 3);
+    json_put_literal(&w, ",\"z\":");
+    json_put_fixed(&w, data->accel_z, 3);
+    json_put_literal(&w, "},\"gyro\":{\"x\":");
+    json_put_fixed(&w, data->gyro_x, 2);
+    json_put_literal(&w, ",\"y\":");
+    json_put_fixed(&w, data->gyro_y, 2);
+    json_put_literal(&w, ",\"z\":");
+    json_put_fixed(&w, data->gyro_z, 2);
+    json_put_literal(&w, "},\"temp\":");
+    json_put_fixed(&w, data->temperature, 2);
+    json_put_literal(&w, ",\"seq\":");
+    json_put_u32(&w, info->seq);
+    json_put_literal(&w, ",\"ts_us\":");
+    json_put_i64(&w, info->timestamp_us);
+    json_put_literal(&w, ",\"timestamp\":");
+    json_put_i64(&w, info->timestamp_us / 1000000);
+    json_put_literal(&w, "}");
+    return json_writer_finish(&w);
+}
+
+/**
+ * @brief 샘플 하나의 JSON 생성 (snprintf, 비교 기준)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_sample_json_snprintf(const mpu6050_data_t *data, const mqtt_sample_info_t *info,
+                                            char *buf, size_t size)
+{
+    return snprintf(buf, size,
+                    "{\"sensor\":\"MPU6050\","
+                    "\"accel\":{\"x\":%.3f,\"y\":%.3f,\"z\":%.3f},"
+                    "\"gyro\":{\"x\":%.2f,\"y\":%.2f,\"z\":%.2f},"
+                    "\"temp\":%.2f,"
+                    "\"seq\":%lu,\"ts_us\":%lld,"
+                    "\"timestamp\":%lld}",
+                    data->accel_x, data->accel_y, data->accel_z,
+                    data->gyro_x, data->gyro_y, data->gyro_z,
+                    data->temperature,
+                    (unsigned long)info->seq, (long long)info->timestamp_us,
+                    (long long)(info->timestamp_us / 1000000));
+}
+
 /**
  * @brief MPU6050 센서 데이터 발행
  */
-void mqtt_publish_mpu6050_data(const mpu6050_data_t *data)
+void mqtt_publish_mpu6050_data(uint8_t device_id, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale,
+                               const mqtt_sample_info_t *info)
 {
     if (!mqtt_connected || mqtt_client == NULL) {
+#if SPOOL_ENABLE
+        ESP_LOGD(TAG_MQTT, "MQTT not connected, spooling sample");
+        spool_push(device_id, info->seq, raw, scale);
+#else
         ESP_LOGW(TAG_MQTT, "MQTT not connected, skipping publish");
+#endif
         return;
     }
 
-    // JSON 형식으로 MPU6050 데이터 생성
+    // 캡처 시점 측정 범위로 물리 단위 변환 후 디바이스 설정에 따라 JSON 또는 바이너리 생성
+    mpu6050_data_t converted;
+    const mpu6050_data_t *data = &converted;
     char payload[256];
-    int64_t timestamp = esp_timer_get_time() / 1000000;
-    snprintf(payload, sizeof(payload),
-             "{\"sensor\":\"MPU6050\","
-             "\"accel\":{\"x\":%.3f,\"y\":%.3f,\"z\":%.3f},"
-             "\"gyro\":{\"x\":%.2f,\"y\":%.2f,\"z\":%.2f},"
-             "\"temp\":%.2f,"
-             "\"timestamp\":%lld}",
-             data->accel_x, data->accel_y, data->accel_z,
-             data->gyro_x, data->gyro_y, data->gyro_z,
-             data->temperature,
-             (long long)timestamp);
-
-    // MQTT 발행
-    int msg_id = esp_mqtt_client_publish(mqtt_client,
-                                          MQTT_TOPIC_SENSOR_DATA,
-                                          payload,
-                                          0,    // 길이 (0 = 자동)
-                                          1,    // QoS 1
-                                          0);   // retain 플래그
-
-    if (msg_id != -1) {
-        ESP_LOGI(TAG_MQTT, "Published MPU6050 data (msg_id=%d)", msg_id);
-        ESP_LOGI(TAG_MQTT, "Accel(g): X=%.3f Y=%.3f Z=%.3f | Gyro(°/s): X=%.2f Y=%.2f Z=%.2f | Temp: %.2f°C",
+    int len;
+    esp_cpu_cycle_count_t start = METRICS_START();
+    mpu6050_convert_scaled(scale, raw, &converted, 1);
+    mqtt_payload_format_t format = mqtt_get_payload_format(device_id);
+    if (format != MQTT_FORMAT_JSON) {
+        len = mqtt_encode_binary(device_id, format == MQTT_FORMAT_BINARY_DELTA, scale, info->timestamp_us,
+                                 info->seq, raw, NULL, 1, (uint8_t *)payload, sizeof(payload));
+    } else {
+        len = mqtt_format_sample_json(data, info, payload, sizeof(payload));
+    }
+    METRICS_STOP(METRICS_STAGE_FORMAT, start);
+
+    char topic[64];
+    mqtt_sensor_topic(device_id, topic, sizeof(topic));
+
+    // outbox에 넣기 (길이는 바이너리에 0이 들어갈 수 있으므로 명시)
+    start = METRICS_START();
+    int msg_id = mqtt_enqueue(MQTT_CLASS_TELEMETRY, device_id, 1, topic, payload, len);
+    METRICS_STOP(METRICS_STAGE_PUBLISH, start);
+
+    if (msg_id >= 0) {
+        latency_track_publish(msg_id, info->enqueue_us);
+        start = METRICS_START();
+        ESP_LOGI(TAG_MQTT, "Published MPU6050 #%u data (seq=%lu, msg_id=%d)",
+                 device_id, (unsigned long)info->seq, msg_id);
+        // 샘플마다 부동소수점 형식화는 비싸므로 DEBUG에서만 (BINLOG_ENABLE 0이어도 INFO 로그 비용이 작도록)
+        ESP_LOGD(TAG_MQTT, "Accel(g): X=%.3f Y=%.3f Z=%.3f | Gyro(°/s): X=%.2f Y=%.2f Z=%.2f | Temp: %.2f°C",
                  data->accel_x, data->accel_y, data->accel_z,
                  data->gyro_x, data->gyro_y, data->gyro_z,
                  data->temperature);
+        METRICS_STOP(METRICS_STAGE_LOG, start);
+    } else if (msg_id == MQTT_OUTBOX_DROPPED) {
+        ESP_LOGD(TAG_MQTT, "Outbox limit, dropped MPU6050 #%u sample (seq=%lu)", device_id, (unsigned long)info->seq);
     } else {
         ESP_LOGE(TAG_MQTT, "Failed to publish MPU6050 data");
+#if SPOOL_ENABLE
+        spool_push(device_id, info->seq, raw, scale);
+#endif
+    }
+}
+
+/**
+ * @brief MPU6050 자세(센서 퓨전 결과) 발행
+ */
+void mqtt_publish_orientation(uint8_t device_id, const imu_quaternion_t *q, const imu_euler_t *euler,
+                              const mqtt_sample_info_t *info)
+{
+    if (!mqtt_connected || mqtt_client == NULL) {
+        ESP_LOGW(TAG_MQTT, "MQTT not connected, skipping publish");
+        return;
+    }
+
+    // JSON 형식으로 자세 데이터 생성
+    char payload[256];
+    esp_cpu_cycle_count_t start = METRICS_START();
+    snprintf(payload, sizeof(payload),
+             "{\"sensor\":\"MPU6050\","
+             "\"quat\":{\"w\":%.4f,\"x\":%.4f,\"y\":%.4f,\"z\":%.4f},"
+             "\"euler\":{\"roll\":%.2f,\"pitch\":%.2f,\"yaw\":%.2f},"
+             "\"seq\":%lu,\"ts_us\":%lld,"
+             "\"timestamp\":%lld}",
+             q->w, q->x, q->y, q->z,
+             euler->roll, euler->pitch, euler->yaw,
+             (unsigned long)info->seq, (long long)info->timestamp_us,
+             (long long)(info->timestamp_us / 1000000));
+    METRICS_STOP(METRICS_STAGE_FORMAT, start);
+
+    char topic[64];
+    mqtt_sensor_topic(device_id, topic, sizeof(topic));
+
+    start = METRICS_START();
+    int msg_id = mqtt_enqueue(MQTT_CLASS_TELEMETRY, device_id, 1, topic, payload, 0);
+    METRICS_STOP(METRICS_STAGE_PUBLISH, start);
+    if (msg_id >= 0) {
+        latency_track_publish(msg_id, info->enqueue_us);
+        start = METRICS_START();
+        ESP_LOGD(TAG_MQTT, "Published MPU6050 #%u orientation (msg_id=%d): roll=%.2f pitch=%.2f yaw=%.2f",
+                 device_id, msg_id, euler->roll, euler->pitch, euler->yaw);
+        METRICS_STOP(METRICS_STAGE_LOG, start);
+    } else if (msg_id != MQTT_OUTBOX_DROPPED) {
+        ESP_LOGE(TAG_MQTT, "Failed to publish MPU6050 orientation");
+    }
+}
+
+/**
+ * @brief 배치 크기 설정
+ */
+esp_err_t mqtt_set_batch_size(uint32_t size)
+{
+    if (size < 1 || size > MQTT_BATCH_MAX_SAMPLES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    batch_size = size;
+    ESP_LOGI(TAG_MQTT, "Batch size changed to %lu samples", (unsigned long)size);
+    return ESP_OK;
+}
+
+/**
+ * @brief 배치 최대 대기 시간 설정
+ */
+esp_err_t mqtt_set_batch_flush_ms(uint32_t flush_ms)
+{
+    if (flush_ms < 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    batch_flush_ms = flush_ms;
+    ESP_LOGI(TAG_MQTT, "Batch flush timeout changed to %lu ms", (unsigned long)flush_ms);
+    return ESP_OK;
+}
+
+uint32_t mqtt_get_batch_size(void)
+{
+    return batch_size;
+}
+
+uint32_t mqtt_get_batch_flush_ms(void)
+{
+    return batch_flush_ms;
+}
+
+bool mqtt_batch_enabled(void)
+{
+    return batch_size > 1;
+}
+
+/**
+ * @brief 배치 JSON 생성
+ *
+ * {"sensor":"MPU6050","base_us":<첫 샘플 시각>,"seq":<첫 샘플 번호>,"count":N,
+ *  "samples":[[offset_us,ax,ay,az,gx,gy,gz,temp],...]}  (i번째 샘플 번호 = seq + i)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_batch_json(const mqtt_batch_t *batch, char *buf, size_t size)
+{
+#if MQTT_JSON_FAST
+    return mqtt_format_batch_json_fast(batch, buf, size);
+#else
+    return mqtt_format_batch_json_snprintf(batch, buf, size);
+#endif
+}
+
+/**
+ * @brief 배치 JSON 생성 (고정 소수점 작성기, snprintf 경로와 같은 바이트)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_batch_json_fast(const mqtt_batch_t *batch, char *buf, size_t size)
+{
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_put_literal(&w, "{\"sensor\":\"MPU6050\",\"base_us\":");
+    json_put_i64(&w, batch->base_us);
+    json_put_literal(&w, ",\"seq\":");
+    json_put_u32(&w, batch->first_seq);
+    json_put_literal(&w, ",\"count\":");
+    json_put_u32(&w, batch->count);
+    json_put_literal(&w, ",\"samples\":[");
+    for (size_t i = 0; i < batch->count; i++) {
+        mpu6050_data_t converted;
+        const mpu6050_data_t *data = &converted;
+        mpu6050_convert_scaled(&batch->scale, &batch->samples[i], &converted, 1);
+        if (i) {
+            json_put_literal(&w, ",");
+        }
+        json_put_literal(&w, "[");
+        json_put_u32(&w, batch->offset_us[i]);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->accel_x, 3);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->accel_y, 3);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->accel_z, 3);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->gyro_x, 2);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->gyro_y, 2);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->gyro_z, 2);
+        json_put_literal(&w, ",");
+        json_put_fixed(&w, data->temperature, 2);
+        json_put_literal(&w, "]");
+    }
+    json_put_literal(&w, "]}");
+    return json_writer_finish(&w);
+}
+
+/**
+ * @brief 배치 JSON 생성 (snprintf, 비교 기준)
+ *
+ * @return 문자열 길이
+ */
+static int mqtt_format_batch_json_snprintf(const mqtt_batch_t *batch, char *buf, size_t size)
+{
+    int len = snprintf(buf, size,
+                       "{\"sensor\":\"MPU6050\",\"base_us\":%lld,\"seq\":%lu,\"count\":%u,\"samples\":[",
+                       (long long)batch->base_us, (unsigned long)batch->first_seq, (unsigned)batch->count);
+    for (size_t i = 0; i < batch->count; i++) {
+        mpu6050_data_t converted;
+        const mpu6050_data_t *data = &converted;
+        mpu6050_convert_scaled(&batch->scale, &batch->samples[i], &converted, 1);
+        len += snprintf(buf + len, size - len,
+                        "%s[%lu,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f]",
+                        i ? "," : "", (unsigned long)batch->offset_us[i],
+                        data->accel_x, data->accel_y, data->accel_z,
+                        data->gyro_x, data->gyro_y, data->gyro_z,
+                        data->temperature);
+    }
+    len += snprintf(buf + len, size - len, "]}");
+    return len;
+}
+
+/**
+ * @brief 반올림 경계 / 부호 있는 0 등에서 고정 소수점 출력이 snprintf와 같은지 확인 (ENCODE_BENCH)
+ *
+ * @return 모두 같으면 true
+ */
+static bool mqtt_json_edge_check(void)
+{
+    static const float values[] = {
+        0.0f, -0.0f, -0.0004f, 0.0005f, 0.0015f, 0.0625f, -0.125f, 0.005f, 0.015f, 1e-7f,
+        1.0005f, -15.9995f, 2.675f, 27.41f, 85.0f, -40.0f, 1999.995f, -2000.0f, 4294967.0f, 1e10f,
+    };
+    char fast[48];
+    char ref[48];
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        for (unsigned decimals = 2; decimals <= 3; decimals++) {
+            json_writer_t w;
+            json_writer_init(&w, fast, sizeof(fast));
+            json_put_fixed(&w, values[i], decimals);
+            json_writer_finish(&w);
+            snprintf(ref, sizeof(ref), "%.*f", (int)decimals, values[i]);
+            if (strcmp(fast, ref) != 0) {
+                ESP_LOGW(TAG_MQTT, "JSON fixed-point mismatch: %s != %s", fast, ref);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 샘플 바이너리 인코딩 (raw 값을 그대로, 헤더 감도는 캡처 시점 측정 범위, telemetry.h 형식)
+ *
+ * @return 바이트 수 (실패 시 0)
+ */
+static size_t mqtt_encode_binary(uint8_t device_id, bool delta, const mpu6050_scale_t *scale, int64_t base_us,
+                                 uint32_t first_seq, const mpu6050_raw_sample_t *samples, const uint32_t *offset_us,
+                                 size_t count, uint8_t *buf, size_t size)
+{
+    telemetry_meta_t meta;
+
+    telemetry_meta_init(device_id, scale, base_us, first_seq, &meta);
+    if (delta) {
+        return telemetry_encode_delta(&meta, samples, offset_us, count, buf, size);
+    }
+    return telemetry_encode(&meta, samples, offset_us, count, buf, size);
+}
+
+/**
+ * @brief 배치를 지정한 형식으로 인코딩
+ *
+ * @return 바이트 수 (실패 시 0)
+ */
+static int mqtt_encode_batch(uint8_t device_id, mqtt_payload_format_t format, const mqtt_batch_t *batch,
+                             char *buf, size_t size)
+{
+    if (format == MQTT_FORMAT_JSON) {
+        return mqtt_format_batch_json(batch, buf, size);
+    }
+    return mqtt_encode_binary(device_id, format == MQTT_FORMAT_BINARY_DELTA, &batch->scale, batch->base_us,
+                              batch->first_seq, batch->samples, batch->offset_us, batch->count, (uint8_t *)buf, size);
+}
+
+#if SPOOL_ENABLE
+/**
+ * @brief 발행하지 못한 배치를 스풀에 보관
+ */
+static void mqtt_spool_batch(uint8_t device_id, const mqtt_batch_t *batch)
+{
+    for (size_t i = 0; i < batch->count; i++) {
+        spool_push(device_id, batch->first_seq + i, &batch->samples[i], &batch->scale);
+    }
+}
+#endif
+
+/**
+ * @brief 디바이스 배치를 메시지 하나로 발행하고 비움 (디바이스 설정에 따라 JSON 또는 바이너리)
+ */
+static void mqtt_batch_flush(uint8_t device_id)
+{
+    mqtt_batch_t *batch = &batches[device_id];
+    if (batch->count == 0) {
+        return;
+    }
+    if (!mqtt_connected || mqtt_client == NULL) {
+#if SPOOL_ENABLE
+        ESP_LOGD(TAG_MQTT, "MQTT not connected, spooling batch of %u samples", (unsigned)batch->count);
+        mqtt_spool_batch(device_id, batch);
+#else
+        ESP_LOGW(TAG_MQTT, "MQTT not connected, dropping batch of %u samples", (unsigned)batch->count);
+#endif
+        batch->count = 0;
+        return;
+    }
+
+    esp_cpu_cycle_count_t start = METRICS_START();
+    int len = mqtt_encode_batch(device_id, payload_format[device_id], batch, batch_payload, sizeof(batch_payload));
+    METRICS_STOP(METRICS_STAGE_FORMAT, start);
+
+    char topic[64];
+    mqtt_sensor_topic(device_id, topic, sizeof(topic));
+
+    start = METRICS_START();
+    int msg_id = mqtt_enqueue(MQTT_CLASS_TELEMETRY, device_id, batch->count, topic, batch_payload, len);
+    METRICS_STOP(METRICS_STAGE_PUBLISH, start);
+    if (msg_id >= 0) {
+        latency_track_publish(msg_id, batch->enqueue_us);
+        start = METRICS_START();
+        ESP_LOGI(TAG_MQTT, "Published MPU6050 #%u batch of %u samples (seq=%lu, msg_id=%d, %d bytes)",
+                 device_id, (unsigned)batch->count, (unsigned long)batch->first_seq, msg_id, len);
+        METRICS_STOP(METRICS_STAGE_LOG, start);
+    } else if (msg_id == MQTT_OUTBOX_DROPPED) {
+        ESP_LOGD(TAG_MQTT, "Outbox limit, dropped MPU6050 #%u batch of %u samples",
+                 device_id, (unsigned)batch->count);
+    } else {
+        ESP_LOGE(TAG_MQTT, "Failed to publish MPU6050 batch");
+#if SPOOL_ENABLE
+        mqtt_spool_batch(device_id, batch);
+#endif
+    }
+    batch->count = 0;
+}
+
+/**
+ * @brief 배치에 샘플 추가 (배치가 차거나 최대 대기 시간을 넘으면 발행)
+ */
+void mqtt_batch_add_mpu6050_data(uint8_t device_id, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale,
+                                 const mqtt_sample_info_t *info)
+{
+    if (device_id >= MPU6050_MAX_DEVICES) {
+        return;
+    }
+    mqtt_batch_t *batch = &batches[device_id];
+    const int64_t timestamp_us = info->timestamp_us;
+
+    // 한 배치가 최대 대기 시간보다 긴 구간을 담지 않도록, 또 샘플 번호가 끊기거나 측정 범위가 바뀌면 먼저 발행
+    if (batch->count > 0 &&
+        (timestamp_us < batch->base_us || timestamp_us - batch->base_us >= (int64_t)batch_flush_ms * 1000 ||
+         info->seq != batch->first_seq + batch->count ||
+         scale->accel_range != batch->scale.accel_range || scale->gyro_range != batch->scale.gyro_range)) {
+        mqtt_batch_flush(device_id);
+    }
+
+    if (batch->count == 0) {
+        batch->base_us = timestamp_us;
+        batch->enqueue_us = info->enqueue_us;
+        batch->first_seq = info->seq;
+        batch->scale = *scale;
+    }
+    batch->offset_us[batch->count] = (uint32_t)(timestamp_us - batch->base_us);
+    batch->samples[batch->count] = *raw;
+    batch->count++;
+
+    if (batch->count >= batch_size) {
+        mqtt_batch_flush(device_id);
     }
 }
+
+/**
+ * @brief 최대 대기 시간이 지났거나 배치가 꺼진 디바이스의 배치 발행
+ */
+bool mqtt_batch_flush_expired(int64_t now_us)
+{
+    bool pending = false;
+
+    for (uint8_t i = 0; i < MPU6050_MAX_DEVICES; i++) {
+        mqtt_batch_t *batch = &batches[i];
+        if (batch->count == 0) {
+            continue;
+        }
+        if (!mqtt_batch_enabled() || batch->count >= batch_size ||
+            now_us - batch->base_us >= (int64_t)batch_flush_ms * 1000) {
+            mqtt_batch_flush(i);
+        } else {
+            pending = true;
+        }
+    }
+
+    return pending;
+}
+
+/**
+ * @brief 보관한 샘플 재전송
+ */
+bool mqtt_spool_replay(int64_t now_us)
+{
+#if SPOOL_ENABLE
+    // 재전송용 버퍼 (발행 태스크에서만 접근)
+    static spool_record_t records[MQTT_BATCH_MAX_SAMPLES];
+    static mqtt_batch_t replay_batch;
+    static int64_t last_replay_us = 0;
+
+    if (!mqtt_connected || mqtt_client == NULL || !spool_pending()) {
+        return false;
+    }
+    if (now_us - last_replay_us < (int64_t)SPOOL_REPLAY_INTERVAL_MS * 1000 ||
+        esp_mqtt_client_get_outbox_size(mqtt_client) > SPOOL_REPLAY_MAX_OUTBOX) {
+        return true;
+    }
+    last_replay_us = now_us;
+
+    size_t count = spool_peek(records, MQTT_BATCH_MAX_SAMPLES);
+    if (count == 0) {
+        return spool_pending();
+    }
+
+    // 같은 디바이스의 번호가 연속되고 측정 범위가 같은 샘플을 배치 하나로 (원래 캡처 시각 / 번호 유지)
+    const uint8_t device_id = records[0].raw.device_id;
+    replay_batch.base_us = records[0].raw.timestamp_us;
+    replay_batch.first_seq = records[0].seq;
+    replay_batch.scale = records[0].scale;
+    replay_batch.count = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t offset = records[i].raw.timestamp_us - replay_batch.base_us;
+        if (records[i].raw.device_id != device_id || offset < 0 || offset > UINT32_MAX ||
+            records[i].seq != replay_batch.first_seq + i ||
+            records[i].scale.accel_range != replay_batch.scale.accel_range ||
+            records[i].scale.gyro_range != replay_batch.scale.gyro_range) {
+            break;
+        }
+        replay_batch.offset_us[replay_batch.count] = (uint32_t)offset;
+        replay_batch.samples[replay_batch.count] = records[i].raw;
+        replay_batch.count++;
+    }
+
+    if (device_id >= MPU6050_MAX_DEVICES) {
+        // 설정이 바뀌어 없어진 디바이스의 샘플은 버림
+        spool_consume(replay_batch.count);
+        return spool_pending();
+    }
+
+    int len = mqtt_encode_batch(device_id, payload_format[device_id], &replay_batch,
+                                batch_payload, sizeof(batch_payload));
+    char topic[64];
+    mqtt_sensor_topic(device_id, topic, sizeof(topic));
+
+    // 재전송 샘플은 정책으로 버리지 않고 QoS 1로 (outbox가 비면 다시 시도)
+    int msg_id = mqtt_send(MQTT_CLASS_TELEMETRY, 1, topic, batch_payload, len);
+    if (msg_id < 0) {
+        ESP_LOGW(TAG_MQTT, "Failed to replay spooled batch, retrying later");
+        return true;
+    }
+    spool_consume(replay_batch.count);
+    ESP_LOGI(TAG_MQTT, "Replayed MPU6050 #%u batch of %u spooled samples (msg_id=%d)",
+             device_id, (unsigned)replay_batch.count, msg_id);
+    return spool_pending();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 디바이스 6축 데이터 형식 설정
+ */
+esp_err_t mqtt_set_payload_format(uint8_t device_id, mqtt_payload_format_t format)
+{
+    if (device_id >= MPU6050_MAX_DEVICES ||
+        format < 0 || format >= MQTT_FORMAT_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    payload_format[device_id] = format;
+    return ESP_OK;
+}
+
+/**
+ * @brief 디바이스 6축 데이터 형식 조회
+ */
+mqtt_payload_format_t mqtt_get_payload_format(uint8_t device_id)
+{
+    return device_id < MPU6050_MAX_DEVICES ? payload_format[device_id] : MQTT_FORMAT_JSON;
+}
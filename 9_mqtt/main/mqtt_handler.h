@@ -8,6 +8,63 @@
 #include <stdbool.h>
 #include "mqtt_client.h"
 #include "mpu6050.h"
+#include "imu_fusion.h"
+#include "sample_sched.h"
+
+// 6축 데이터 발행 형식 (디바이스별로 선택)
+typedef enum {
+    MQTT_FORMAT_JSON = 0,   // JSON 문자열
+    MQTT_FORMAT_BINARY,     // 리틀 엔디안 int16 바이너리 (telemetry.h)
+    MQTT_FORMAT_BINARY_DELTA,   // 바이너리 + 축별 델타 / zigzag / varint 압축
+    MQTT_FORMAT_COUNT,
+} mqtt_payload_format_t;
+
+// outbox가 상한(MQTT_OUTBOX_LIMIT)에 이르렀을 때의 처리
+typedef enum {
+    MQTT_OUTBOX_DROP_NEWEST = 0,    // 새 메시지를 버림
+    MQTT_OUTBOX_DROP_OLDEST,        // 샘플 큐에서 꺼내지 않음 (큐가 가장 오래된 샘플부터 덮어씀, SENSOR_QUEUE_OVERWRITE)
+    MQTT_OUTBOX_DOWNSAMPLE,         // 상한의 MQTT_OUTBOX_DOWNSAMPLE_START_PCT부터 디바이스별 N개 중 1개만 발행
+    MQTT_OUTBOX_POLICY_COUNT,
+} mqtt_outbox_policy_t;
+
+// outbox 통계 (마지막 조회 이후, bytes / limit / policy는 현재 값)
+typedef struct {
+    mqtt_outbox_policy_t policy;
+    uint32_t limit;             // 텔레메트리 상한 (바이트)
+    uint32_t bytes;             // 현재 outbox 크기 (PUBACK을 기다리는 QoS 1 메시지 포함)
+    uint32_t peak;              // 최대 outbox 크기
+    uint32_t enqueued;          // outbox에 넣은 메시지
+    uint32_t dropped;           // 상한을 넘어 버린 메시지
+    uint32_t downsampled;       // 다운샘플링으로 건너뛴 메시지
+    uint32_t dropped_samples;   // 버리거나 건너뛴 메시지의 6축 샘플 수
+    uint32_t backpressure;      // DROP_OLDEST: 샘플 큐 소비를 멈춘 횟수
+    uint32_t expired;           // 전송하지 못하고 만료된 메시지 (MQTT_EVENT_DELETED)
+} mqtt_outbox_stats_t;
+
+// 발행 토픽 종류 (종류별 QoS / 메시지 만료 / 토픽 별칭, config.h MQTT_QOS_*)
+typedef enum {
+    MQTT_CLASS_TELEMETRY = 0,   // 6축 / 자세 / 배치 / 재전송
+    MQTT_CLASS_STATS,           // 주기 통계 / 계측
+    MQTT_CLASS_RESPONSE,        // 명령 응답 / 이벤트
+    MQTT_CLASS_SYNC,            // 시계 차이 ping / sync
+    MQTT_CLASS_COUNT,
+} mqtt_topic_class_t;
+
+// 토픽 종류별 발행 트래픽 (마지막 조회 이후, qos는 현재 값)
+typedef struct {
+    int qos;
+    uint32_t messages;          // 발행한 메시지
+    uint32_t bytes;             // 예상 PUBLISH 패킷 크기 합 (고정 헤더 + 토픽 / 별칭 + 속성 + 데이터)
+    uint32_t packets;           // 예상 제어 패킷 수 (PUBLISH + QoS 1의 PUBACK)
+    uint32_t aliased;           // 토픽 대신 별칭만 보낸 메시지
+} mqtt_traffic_stats_t;
+
+// 샘플 추적 정보 (수집 태스크에서 기록)
+typedef struct {
+    uint32_t seq;           // 디바이스별 샘플 번호 (큐에서 버려진 샘플도 번호를 차지하므로 빈 번호 = 손실)
+    int64_t timestamp_us;   // 샘플 캡처 시각 (esp_timer, µs)
+    int64_t enqueue_us;     // 샘플 큐에 넣은 시각 (PUBACK 지연 측정 기준)
+} mqtt_sample_info_t;
 
 /**
  * @brief MQTT 초기화 및 시작
@@ -31,8 +88,209 @@ esp_mqtt_client_handle_t mqtt_get_client(void);
 /**
  * @brief MPU6050 센서 데이터 발행
  *
- * @param data MPU6050 센서 데이터
+ * 디바이스 0은 MQTT_TOPIC_SENSOR_DATA, 나머지는 MQTT_TOPIC_SENSOR_DATA/<번호> 토픽으로 발행합니다.
+ * 형식은 디바이스별 설정(JSON 또는 바이너리)을 따르고, 물리 단위 변환은 캡처 시점 측정 범위로 여기서 합니다.
+ *
+ * @param device_id 디바이스 번호
+ * @param raw 보정 적용된 raw 샘플
+ * @param scale 캡처 시점 측정 범위
+ * @param info 샘플 번호 / 캡처 시각
+ */
+void mqtt_publish_mpu6050_data(uint8_t device_id, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale,
+                               const mqtt_sample_info_t *info);
+
+/**
+ * @brief MPU6050 자세(센서 퓨전 결과) 발행
+ *
+ * 6축 값과 같은 토픽으로 발행합니다.
+ *
+ * @param device_id 디바이스 번호
+ * @param q 자세 쿼터니언
+ * @param euler 오일러각 (도)
+ * @param info 샘플 번호 / 캡처 시각
+ */
+void mqtt_publish_orientation(uint8_t device_id, const imu_quaternion_t *q, const imu_euler_t *euler,
+                              const mqtt_sample_info_t *info);
+
+/**
+ * @brief 배치에 6축 샘플 추가
+ *
+ * 배치가 MQTT_BATCH 크기만큼 차거나 첫 샘플 후 최대 대기 시간이 지나면
+ * 샘플별 상대 시각과 함께 메시지 하나로 발행합니다. 샘플 번호가 이어지지 않으면(큐에서 버려진 샘플)
+ * 쌓인 배치를 먼저 발행하므로 한 메시지의 샘플 번호는 항상 첫 번호부터 연속입니다.
+ * 측정 범위가 바뀌어도 먼저 발행하므로 한 배치의 샘플은 모두 같은 감도입니다.
+ * 발행 태스크에서만 호출해야 합니다.
+ *
+ * @param device_id 디바이스 번호 (MPU6050_MAX_DEVICES 미만)
+ * @param raw 보정 적용된 raw 샘플
+ * @param scale 캡처 시점 측정 범위
+ * @param info 샘플 번호 / 캡처 시각
+ */
+void mqtt_batch_add_mpu6050_data(uint8_t device_id, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale,
+                                 const mqtt_sample_info_t *info);
+
+/**
+ * @brief 최대 대기 시간이 지난 배치 발행 (배치가 꺼졌으면 남은 샘플 모두 발행)
+ *
+ * @param now_us 현재 시각 (esp_timer, µs)
+ * @return true 아직 발행하지 않은 배치가 남아 있음
+ */
+bool mqtt_batch_flush_expired(int64_t now_us);
+
+/**
+ * @brief 연결이 끊긴 동안 보관한 샘플 재전송 (SPOOL_REPLAY_INTERVAL_MS마다 배치 메시지 하나)
+ *
+ * 발행 태스크에서 주기적으로 호출합니다. MQTT outbox가 SPOOL_REPLAY_MAX_OUTBOX를 넘으면
+ * 실시간 발행이 밀리지 않도록 다음 호출로 미룹니다.
+ *
+ * @param now_us 현재 시각 (esp_timer, µs)
+ * @return true 연결되어 있고 재전송할 샘플이 남아 있음
+ */
+bool mqtt_spool_replay(int64_t now_us);
+
+/**
+ * @brief 배치 크기 설정
+ *
+ * @param size 메시지당 샘플 수 (1: 배치 사용 안 함, 최대 MQTT_BATCH_MAX_SAMPLES)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 범위 밖
+ */
+esp_err_t mqtt_set_batch_size(uint32_t size);
+
+/**
+ * @brief 배치 최대 대기 시간 설정
+ *
+ * @param flush_ms 첫 샘플 후 발행까지 최대 시간 (ms, 1 이상)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 범위 밖
+ */
+esp_err_t mqtt_set_batch_flush_ms(uint32_t flush_ms);
+
+/**
+ * @brief 현재 배치 크기 조회
+ */
+uint32_t mqtt_get_batch_size(void);
+
+/**
+ * @brief 현재 배치 최대 대기 시간 조회 (ms)
+ */
+uint32_t mqtt_get_batch_flush_ms(void);
+
+/**
+ * @brief 배치 사용 여부 (배치 크기 > 1)
+ */
+bool mqtt_batch_enabled(void);
+
+/**
+ * @brief 디바이스 6축 데이터 형식 설정 (샘플 단위 / 배치 발행 모두 적용, 자세는 항상 JSON)
+ *
+ * @param device_id 디바이스 번호
+ * @param format MQTT_FORMAT_JSON, MQTT_FORMAT_BINARY 또는 MQTT_FORMAT_BINARY_DELTA
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 잘못된 번호/형식
+ */
+esp_err_t mqtt_set_payload_format(uint8_t device_id, mqtt_payload_format_t format);
+
+/**
+ * @brief 디바이스 6축 데이터 형식 조회
+ */
+mqtt_payload_format_t mqtt_get_payload_format(uint8_t device_id);
+
+/**
+ * @brief 데이터 형식 이름(json / binary / delta, 대소문자 무시)으로 찾기 (FORMAT 명령, SET:format=)
+ *
+ * @return 형식, 모르는 이름이면 MQTT_FORMAT_COUNT
+ */
+mqtt_payload_format_t mqtt_payload_format_from_name(const char *name);
+
+/**
+ * @brief 데이터 형식 이름 (응답 JSON용 소문자)
+ */
+const char *mqtt_payload_format_name(mqtt_payload_format_t format);
+
+/**
+ * @brief outbox 상한 정책 설정
+ *
+ * @param policy 상한에 이르렀을 때의 처리
+ * @param limit 텔레메트리 상한 (바이트, MQTT_BUFFER_SIZE ~ MQTT_OUTBOX_LIMIT)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 잘못된 정책/크기
+ */
+esp_err_t mqtt_set_outbox_policy(mqtt_outbox_policy_t policy, uint32_t limit);
+
+/**
+ * @brief outbox 통계 조회
+ *
+ * @param stats 결과를 저장할 포인터
+ * @param reset true면 조회 후 누적 값과 최대 크기 초기화
+ */
+void mqtt_get_outbox_stats(mqtt_outbox_stats_t *stats, bool reset);
+
+/**
+ * @brief 발행 태스크가 샘플 큐에서 다음 샘플을 꺼내도 되는지 확인
+ *
+ * DROP_OLDEST 정책에서 outbox에 메시지 하나를 더 넣을 자리가 없으면 false를 반환합니다.
+ * 그동안 샘플은 큐에 쌓이고, 큐가 가득 차면 수집 태스크가 가장 오래된 샘플부터 덮어씁니다.
+ *
+ * @return true 꺼내도 됨
+ */
+bool mqtt_outbox_ready(void);
+
+/**
+ * @brief 토픽 종류별 QoS 설정
+ *
+ * @param cls 토픽 종류
+ * @param qos 0 또는 1
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 잘못된 종류/QoS
+ */
+esp_err_t mqtt_set_class_qos(mqtt_topic_class_t cls, int qos);
+
+/**
+ * @brief 토픽 종류별 발행 트래픽 조회
+ *
+ * @param stats 결과를 저장할 배열 (MQTT_CLASS_COUNT개)
+ * @param window_ms 집계 구간 (ms)
+ * @param reset true면 조회 후 초기화
+ */
+void mqtt_get_traffic_stats(mqtt_traffic_stats_t stats[MQTT_CLASS_COUNT], uint32_t *window_ms, bool reset);
+
+/**
+ * @brief 명령 응답 발행 (MQTT_TOPIC_RESPONSE, MQTT_QOS_RESPONSE)
+ *
+ * @param response 응답 문자열 (JSON)
+ */
+void mqtt_publish_response(const char *response);
+
+/**
+ * @brief 바이너리 로그 프레임 발행 (MQTT_TOPIC_LOG, 통계 토픽과 같은 QoS / 만료)
+ *
+ * @param frame 프레임
+ * @param len 길이
+ * @return true outbox에 넣음, false 연결 안 됨 또는 outbox가 텔레메트리 상한을 넘음 (호출한 쪽에서 UART로 출력)
+ */
+bool mqtt_publish_log(const uint8_t *frame, size_t len);
+
+/**
+ * @brief 샘플링 주기 오차 통계 발행 (MQTT_TOPIC_SENSOR_STATS, MQTT_QOS_STATS)
+ *
+ * @param stats 발행할 통계
+ */
+void mqtt_publish_sched_stats(const sample_sched_stats_t *stats);
+
+/**
+ * @brief PUBACK 지연 통계와 시계 차이 발행 (MQTT_TOPIC_SENSOR_STATS, MQTT_QOS_STATS, 히스토그램 초기화)
+ */
+void mqtt_publish_latency_stats(void);
+
+/**
+ * @brief 단계별 처리 사이클, 힙, 태스크 스택 여유 발행 (MQTT_TOPIC_METRICS, MQTT_QOS_STATS, 히스토그램 초기화)
+ */
+void mqtt_publish_metrics(void);
+
+/**
+ * @brief 시계 차이 측정용 ping 발행 (MQTT_TOPIC_RESPONSE, LATENCY_SYNC_INTERVAL_MS마다)
+ *
+ * 수신 쪽은 PONG:<id>:<t1>:<t2>:<t3> 명령으로 응답합니다 (t2: ping 수신 시각, t3: 응답 시각, µs).
+ * 발행 태스크에서 주기적으로 호출합니다.
+ *
+ * @param now_us 현재 시각 (esp_timer, µs)
  */
-void mqtt_publish_mpu6050_data(const mpu6050_data_t *data);
+void mqtt_latency_sync_poll(int64_t now_us);
 
 #endif // MQTT_HANDLER_H
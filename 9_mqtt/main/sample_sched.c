@@ -0,0 +1,236 @@
+/* 샘플링 스케줄러 구현 */
+
+#include "sample_sched.h"
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+
+/**
+ * @brief 통계 구간 초기화 (lock을 잡은 상태에서 호출)
+ */
+static void sample_sched_reset_locked(sample_sched_t *sched, int64_t now_us)
+{
+    sched->last_us = 0;
+    sched->window_start_us = now_us;
+    sched->samples = 0;
+    sched->intervals = 0;
+    sched->missed = 0;
+    sched->err_sum_us = 0;
+    sched->interval_sum_us = 0;
+    sched->err_min_us = INT32_MAX;
+    sched->err_max_us = INT32_MIN;
+    memset(sched->hist, 0, sizeof(sched->hist));
+}
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+/**
+ * @brief 타이머 콜백 (ISR에서 바로 실행, esp_timer 태스크 지연 없음)
+ */
+static void IRAM_ATTR sample_sched_timer_cb(void *arg)
+{
+    sample_sched_t *sched = arg;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sched->task, &higher_priority_task_woken);
+    if (higher_priority_task_woken) {
+        esp_timer_isr_dispatch_need_yield();
+    }
+}
+#else
+/**
+ * @brief 타이머 콜백 (esp_timer 태스크에서 실행)
+ */
+static void sample_sched_timer_cb(void *arg)
+{
+    sample_sched_t *sched = arg;
+    xTaskNotifyGive(sched->task);
+}
+#endif
+
+/**
+ * @brief 오차 통계만 초기화
+ */
+void sample_sched_init(sample_sched_t *sched, uint32_t period_us)
+{
+    const portMUX_TYPE unlocked = portMUX_INITIALIZER_UNLOCKED;
+
+    memset(sched, 0, sizeof(*sched));
+    sched->lock = unlocked;
+    sched->period_us = period_us;
+    sample_sched_reset_locked(sched, esp_timer_get_time());
+}
+
+/**
+ * @brief 주기 타이머 시작
+ */
+esp_err_t sample_sched_start(sample_sched_t *sched, uint32_t period_us)
+{
+    if (period_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sample_sched_init(sched, period_us);
+    sched->task = xTaskGetCurrentTaskHandle();
+
+    const esp_timer_create_args_t args = {
+        .callback = sample_sched_timer_cb,
+        .arg = sched,
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+        .dispatch_method = ESP_TIMER_ISR,
+#else
+        .dispatch_method = ESP_TIMER_TASK,
+#endif
+        .name = "sample_sched",
+        .skip_unhandled_events = false,   // 늦어진 주기도 알림으로 쌓아서 놓친 주기로 셈
+    };
+    esp_err_t ret = esp_timer_create(&args, &sched->timer);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    return esp_timer_start_periodic(sched->timer, period_us);
+}
+
+/**
+ * @brief 샘플 주기 변경
+ */
+esp_err_t sample_sched_set_period(sample_sched_t *sched, uint32_t period_us)
+{
+    if (period_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&sched->lock);
+    sched->period_us = period_us;
+    sample_sched_reset_locked(sched, esp_timer_get_time());
+    const bool paused = sched->paused;
+    portEXIT_CRITICAL(&sched->lock);
+
+    if (sched->timer == NULL || paused) {
+        return ESP_OK;
+    }
+    esp_timer_stop(sched->timer);
+    return esp_timer_start_periodic(sched->timer, period_us);
+}
+
+/**
+ * @brief 주기 타이머 일시 정지
+ */
+esp_err_t sample_sched_pause(sample_sched_t *sched)
+{
+    if (sched->timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&sched->lock);
+    sched->paused = true;
+    portEXIT_CRITICAL(&sched->lock);
+    esp_timer_stop(sched->timer);
+
+    // 정지 직전에 쌓인 알림 제거 (정지 중 대기는 다른 알림으로 깨어나도록)
+    ulTaskNotifyTake(pdTRUE, 0);
+    return ESP_OK;
+}
+
+/**
+ * @brief 주기 타이머 재개
+ */
+esp_err_t sample_sched_resume(sample_sched_t *sched)
+{
+    if (sched->timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&sched->lock);
+    sched->paused = false;
+    sched->last_us = 0;     // 정지했던 간격은 오차 통계에서 제외
+    const uint32_t period_us = sched->period_us;
+    portEXIT_CRITICAL(&sched->lock);
+
+    ulTaskNotifyTake(pdTRUE, 0);
+    return esp_timer_start_periodic(sched->timer, period_us);
+}
+
+/**
+ * @brief 다음 주기까지 대기
+ */
+uint32_t sample_sched_wait(sample_sched_t *sched)
+{
+    uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    sample_sched_record(sched, esp_timer_get_time(), ticks > 1 ? ticks - 1 : 0);
+    return ticks;
+}
+
+/**
+ * @brief 샘플 시각 기록
+ */
+void sample_sched_record(sample_sched_t *sched, int64_t timestamp_us, uint32_t missed)
+{
+    portENTER_CRITICAL(&sched->lock);
+    sched->samples++;
+    sched->missed += missed;
+    if (sched->last_us != 0) {
+        // 놓친 주기는 missed로 따로 세고, 오차는 지난 주기 수 기준으로 계산
+        const int64_t interval = timestamp_us - sched->last_us;
+        const int64_t err64 = interval - (int64_t)sched->period_us * (missed + 1);
+        const int32_t err = err64 > INT32_MAX ? INT32_MAX : (err64 < INT32_MIN ? INT32_MIN : (int32_t)err64);
+        const uint32_t abs_err = err < 0 ? -(int64_t)err : err;
+        const uint32_t bucket = abs_err / SAMPLE_SCHED_HIST_BUCKET_US;
+
+        sched->intervals++;
+        sched->interval_sum_us += interval;
+        sched->err_sum_us += err;
+        if (err < sched->err_min_us) {
+            sched->err_min_us = err;
+        }
+        if (err > sched->err_max_us) {
+            sched->err_max_us = err;
+        }
+        sched->hist[bucket < SAMPLE_SCHED_HIST_BUCKETS ? bucket : SAMPLE_SCHED_HIST_BUCKETS]++;
+    }
+    sched->last_us = timestamp_us;
+    portEXIT_CRITICAL(&sched->lock);
+}
+
+/**
+ * @brief 주기 오차 통계 조회
+ */
+void sample_sched_get_stats(sample_sched_t *sched, sample_sched_stats_t *stats, bool reset)
+{
+    const int64_t now_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&sched->lock);
+    const uint32_t intervals = sched->intervals;
+    stats->period_us = sched->period_us;
+    stats->samples = sched->samples;
+    stats->missed = sched->missed;
+    stats->err_min_us = intervals ? sched->err_min_us : 0;
+    stats->err_max_us = intervals ? sched->err_max_us : 0;
+    stats->err_mean_us = intervals ? (float)sched->err_sum_us / intervals : 0.0f;
+    stats->rate_hz = sched->interval_sum_us > 0 ? intervals * 1e6f / sched->interval_sum_us : 0.0f;
+    stats->window_ms = (now_us - sched->window_start_us) / 1000;
+
+    // 99백분위: 누적 개수가 99%에 이르는 첫 구간의 상한 (범위 밖이면 최대 오차)
+    stats->err_p99_us = 0;
+    const uint32_t target = intervals - intervals / 100;
+    uint32_t cumulative = 0;
+    for (int i = 0; i <= SAMPLE_SCHED_HIST_BUCKETS && intervals > 0; i++) {
+        cumulative += sched->hist[i];
+        if (cumulative >= target) {
+            if (i < SAMPLE_SCHED_HIST_BUCKETS) {
+                stats->err_p99_us = (i + 1) * SAMPLE_SCHED_HIST_BUCKET_US;
+            } else {
+                stats->err_p99_us = -(int64_t)stats->err_min_us > stats->err_max_us ?
+                                    -(int64_t)stats->err_min_us : stats->err_max_us;
+            }
+            break;
+        }
+    }
+
+    if (reset) {
+        // 다음 구간의 첫 간격이 끊기지 않도록 직전 샘플 시각은 유지
+        const int64_t last_us = sched->last_us;
+        sample_sched_reset_locked(sched, now_us);
+        sched->last_us = last_us;
+    }
+    portEXIT_CRITICAL(&sched->lock);
+}
@@ -0,0 +1,122 @@
+/* 샘플링 스케줄러 헤더
+ * esp_timer 주기 콜백으로 수집 태스크를 깨워서 처리 시간과 관계없이 일정한 주기로 샘플링하고,
+ * 실제 샘플 간격의 오차(최소/최대/평균/99백분위)와 놓친 주기 수를 기록합니다.
+ *
+ * 주기는 µs 단위 (1ms 미만 가능). 타이머 없이 오차 통계만 사용할 수도 있습니다 (DATA_RDY 인터럽트 등).
+ */
+
+#ifndef SAMPLE_SCHED_H
+#define SAMPLE_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// |주기 오차| 히스토그램 (99백분위 계산용, 범위를 넘으면 최대 오차로 보고)
+#define SAMPLE_SCHED_HIST_BUCKET_US 5
+#define SAMPLE_SCHED_HIST_BUCKETS 200     // 0 ~ 1ms
+
+// 주기 오차 통계 (마지막 초기화 이후 구간)
+typedef struct {
+    uint32_t period_us;     // 설정 주기
+    uint32_t samples;       // 샘플 수
+    uint32_t missed;        // 처리가 늦어 놓친 주기 수
+    int32_t err_min_us;     // (실제 간격 - 설정 주기) 최소
+    int32_t err_max_us;     // (실제 간격 - 설정 주기) 최대
+    float err_mean_us;      // 평균
+    uint32_t err_p99_us;    // |오차| 99백분위 (SAMPLE_SCHED_HIST_BUCKET_US 단위로 올림)
+    float rate_hz;          // 측정 샘플링 주파수
+    uint32_t window_ms;     // 통계 구간 길이
+} sample_sched_stats_t;
+
+// 스케줄러 상태 (호출자가 메모리 제공)
+typedef struct {
+    esp_timer_handle_t timer;
+    TaskHandle_t task;
+    uint32_t period_us;
+    bool paused;            // sample_sched_pause() 후 타이머 정지 상태
+    portMUX_TYPE lock;
+    int64_t last_us;        // 직전 샘플 시각 (0: 없음)
+    int64_t window_start_us;
+    uint32_t samples;
+    uint32_t intervals;
+    uint32_t missed;
+    int64_t err_sum_us;
+    int64_t interval_sum_us;
+    int32_t err_min_us;
+    int32_t err_max_us;
+    uint32_t hist[SAMPLE_SCHED_HIST_BUCKETS + 1];
+} sample_sched_t;
+
+/**
+ * @brief 오차 통계만 초기화 (타이머 없음, sample_sched_record()로 샘플 시각 기록)
+ *
+ * @param sched 스케줄러 상태
+ * @param period_us 기대 샘플 주기 (µs)
+ */
+void sample_sched_init(sample_sched_t *sched, uint32_t period_us);
+
+/**
+ * @brief 주기 타이머 시작 (호출한 태스크를 주기마다 태스크 알림으로 깨움)
+ *
+ * @param sched 스케줄러 상태
+ * @param period_us 샘플 주기 (µs)
+ * @return esp_err_t ESP_OK 성공
+ */
+esp_err_t sample_sched_start(sample_sched_t *sched, uint32_t period_us);
+
+/**
+ * @brief 샘플 주기 변경 (통계 초기화, 다른 태스크에서 호출 가능)
+ *
+ * @param sched 스케줄러 상태
+ * @param period_us 새 주기 (µs)
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 주기가 0
+ */
+esp_err_t sample_sched_set_period(sample_sched_t *sched, uint32_t period_us);
+
+/**
+ * @brief 주기 타이머 일시 정지 (움직임이 없을 때 등, 정지 중 주기 변경은 재개할 때 적용)
+ *
+ * @param sched 스케줄러 상태
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_STATE 타이머 없음
+ */
+esp_err_t sample_sched_pause(sample_sched_t *sched);
+
+/**
+ * @brief 주기 타이머 재개 (정지했던 시간은 주기 오차 / 놓친 주기로 세지 않음)
+ *
+ * @param sched 스케줄러 상태
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_STATE 타이머 없음
+ */
+esp_err_t sample_sched_resume(sample_sched_t *sched);
+
+/**
+ * @brief 다음 주기까지 대기하고 깨어난 시각을 통계에 기록
+ *
+ * @param sched 스케줄러 상태
+ * @return 지난 주기 수 (1: 정상, 2 이상: 처리가 늦어 주기를 놓침)
+ */
+uint32_t sample_sched_wait(sample_sched_t *sched);
+
+/**
+ * @brief 샘플 시각 기록 (직전 샘플과의 간격으로 주기 오차 계산)
+ *
+ * @param sched 스케줄러 상태
+ * @param timestamp_us 샘플 시각 (esp_timer, µs)
+ * @param missed 직전 샘플 이후 놓친 주기 수
+ */
+void sample_sched_record(sample_sched_t *sched, int64_t timestamp_us, uint32_t missed);
+
+/**
+ * @brief 주기 오차 통계 조회
+ *
+ * @param sched 스케줄러 상태
+ * @param stats 결과를 저장할 포인터
+ * @param reset true면 조회 후 새 구간 시작
+ */
+void sample_sched_get_stats(sample_sched_t *sched, sample_sched_stats_t *stats, bool reset);
+
+#endif // SAMPLE_SCHED_H
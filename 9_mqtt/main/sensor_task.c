@@ -2,32 +2,180 @@
 
 #include "sensor_task.h"
 #include "mqtt_handler.h"
+#include "command_handler.h"
 #include "mpu6050.h"
+#include "imu_fusion.h"
+#include "dsp_filter.h"
+#include "sample_sched.h"
+#include "metrics.h"
 #include "config.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/gpio.h"
+
+#define ESP_INTR_FLAG_DEFAULT 0
+
+// 배치가 남아 있을 때 발행 태스크가 최대 대기 시간을 확인하는 주기
+#define SENSOR_BATCH_POLL_MS 10
+
+// 샘플이 없을 때 발행 태스크가 통계 발행 / 시계 차이 ping 시각을 확인하는 주기
+#define SENSOR_PUB_IDLE_MS 1000
+
+// 움직임 감지 인터럽트 대기는 폴링 모드에서만 사용 (다른 모드는 INT 핀 / 타이머로 계속 수집)
+#define SENSOR_MOTION_WAKE (SENSOR_MOTION_WAKE_ENABLE && SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_POLL)
+
+// 폴링을 멈춘 동안 MQTT 명령(설정 변경, 보정)을 확인하는 주기
+#define SENSOR_MOTION_CHECK_MS 1000
+
+// 단일 코어 빌드에서는 모든 태스크를 코어 0에 고정
+#if portNUM_PROCESSORS > 1
+#define SENSOR_TASK_CORE(core) (core)
+#else
+#define SENSOR_TASK_CORE(core) 0
+#endif
 
 // 센서 데이터 전송 주기 (동적 변경 가능)
 static uint32_t publish_interval_ms = DEFAULT_PUBLISH_INTERVAL_MS;
 
-// MPU6050 초기화 상태
-static bool mpu6050_initialized = false;
+// 수집 주기 스케줄러 (폴링: 샘플 주기, FIFO: 비우는 주기, DATA_RDY: 인터럽트 간격 통계만)
+static sample_sched_t sensor_sched;
+static uint32_t poll_period_us = DEFAULT_PUBLISH_INTERVAL_MS * 1000;
+
+// 연결된 MPU6050 인스턴스 (디바이스 번호 = 배열 인덱스)
+static const uint8_t device_addresses[] = MPU6050_DEVICE_ADDRESSES;
+#define SENSOR_DEVICE_COUNT (sizeof(device_addresses) / sizeof(device_addresses[0]))
+_Static_assert(SENSOR_DEVICE_COUNT <= MPU6050_MAX_DEVICES, "Too many MPU6050 devices");
+
+static i2c_master_bus_handle_t sensor_bus = NULL;
+static mpu6050_handle_t sensor_devices[MPU6050_MAX_DEVICES];
+static size_t sensor_device_count = 0;
+
+#if SENSOR_FUSION_ENABLE
+// 디바이스별 자세 추정 상태
+static imu_fusion_t sensor_fusion[MPU6050_MAX_DEVICES];
+#define SENSOR_FUSION_RAM sizeof(sensor_fusion)
+_Static_assert(SENSOR_FUSION_COMP_ALPHA > 0.0f && SENSOR_FUSION_COMP_ALPHA < 1.0f,
+               "SENSOR_FUSION_COMP_ALPHA must be in (0, 1)");
+_Static_assert(SENSOR_FUSION_MADGWICK_BETA > 0.0f && SENSOR_FUSION_MADGWICK_BETA <= 1.0f,
+               "SENSOR_FUSION_MADGWICK_BETA must be in (0, 1]");
+// 선택한 알고리즘의 이득
+#define SENSOR_FUSION_GAIN \
+    (SENSOR_FUSION_ALGORITHM == IMU_FUSION_MADGWICK ? SENSOR_FUSION_MADGWICK_BETA : SENSOR_FUSION_COMP_ALPHA)
+#else
+#define SENSOR_FUSION_RAM 0
+#endif
+
+#if SENSOR_DSP_ENABLE
+// 디바이스별 발행 전 필터 (FIFO / DATA_RDY 모드에서만 동작)
+_Static_assert(SENSOR_FIFO_MAX_SAMPLES <= DSP_BLOCK_MAX_SAMPLES, "FIFO drain exceeds DSP block size");
+static dsp_pipeline_t sensor_dsp[MPU6050_MAX_DEVICES];
+static bool sensor_dsp_ready[MPU6050_MAX_DEVICES];
+static int64_t sensor_dsp_output_period_us[MPU6050_MAX_DEVICES];   // 필터 출력 간격 (데시메이션 반영)
+#ifdef SENSOR_DSP_FIR_COEFFS
+static const float sensor_dsp_fir_taps[] = SENSOR_DSP_FIR_COEFFS;
+#endif
+#if APP_STATIC_ALLOC
+// DSP_BENCH 측정용 작업 메모리
+static dsp_pipeline_t sensor_dsp_bench_pipeline;
+static dsp_block_t sensor_dsp_bench_block;
+#define SENSOR_DSP_RAM (sizeof(sensor_dsp) + sizeof(sensor_dsp_bench_pipeline) + sizeof(sensor_dsp_bench_block))
+#else
+#define SENSOR_DSP_RAM sizeof(sensor_dsp)
+#endif
+#else
+#define SENSOR_DSP_RAM 0
+#endif
+static bool sensor_dsp_active = false;
+
+// 6축 값 대신 자세(쿼터니언, 오일러각) 발행 여부 (동적 변경 가능)
+static bool publish_orientation = SENSOR_FUSION_ENABLE && SENSOR_PUBLISH_ORIENTATION;
+
+// 수집 태스크 핸들 (인터럽트에서 태스크 알림에 사용)
+static TaskHandle_t sensor_task_handle = NULL;
+static TaskHandle_t sensor_publish_task_handle = NULL;
+
+// 수집 태스크 → 발행 태스크로 넘기는 샘플 (물리 단위 변환은 발행 태스크에서, 자세는 수집 시점 값을 복사)
+typedef struct {
+    uint8_t device_id;
+    bool orientation;
+    mqtt_sample_info_t info;    // 샘플 번호, 캡처 시각, 큐에 넣은 시각
+    union {
+        struct {
+            mpu6050_raw_sample_t raw;   // 보정 적용된 LSB
+            mpu6050_scale_t scale;      // 캡처 시점 측정 범위
+        } sample;
+#if SENSOR_FUSION_ENABLE
+        struct {
+            imu_quaternion_t q;
+            imu_euler_t euler;
+        } pose;
+#endif
+    };
+} sensor_sample_msg_t;
+
+// 발행할 샘플 (변환한 샘플 또는 필터 출력)
+// 큐에는 raw / scale만 넣고, data는 데드밴드 판단에만 사용
+typedef struct {
+    mpu6050_raw_sample_t raw;   // 보정 적용된 LSB + 캡처 시각 (필터 출력은 같은 감도로 다시 양자화)
+    mpu6050_scale_t scale;      // 변환에 사용한 측정 범위
+    mpu6050_data_t data;        // 물리 단위
+} sensor_output_t;
+
+static QueueHandle_t sample_queue = NULL;
+static sensor_queue_stats_t queue_stats;
+
+// 디바이스별 다음 샘플 번호 (수집 태스크에서만 증가, 큐에서 버려진 샘플도 번호를 차지)
+static uint32_t sample_seq[MPU6050_MAX_DEVICES];
+
+// 명령 태스크에서 요청한 MPU6050 설정 (I2C 접근이 겹치지 않도록 센서 태스크에서 적용)
+static portMUX_TYPE request_lock = portMUX_INITIALIZER_UNLOCKED;
+static mpu6050_config_t pending_config;
+static bool config_pending = false;
+static bool calibration_pending = false;
+
+// 변화 기반 발행 설정 (명령 태스크에서 요청, 센서 태스크에서 적용)
+static sensor_rbe_config_t rbe_request;
+static bool rbe_pending = false;
+static sensor_rbe_config_t rbe_config = {
+    .enabled = SENSOR_RBE_ENABLE,
+    .accel_deadband_g = SENSOR_RBE_ACCEL_DEADBAND_G,
+    .gyro_deadband_dps = SENSOR_RBE_GYRO_DEADBAND_DPS,
+    .heartbeat_ms = SENSOR_RBE_HEARTBEAT_MS,
+};
+
+// 디바이스별 데드밴드 기준 (마지막으로 발행했거나 변화로 판단한 값)
+typedef struct {
+    mpu6050_data_t ref;
+    int64_t ref_us;         // 기준 값의 캡처 시각 (heartbeat 판단)
+    bool valid;
+} sensor_rbe_state_t;
+
+static sensor_rbe_state_t rbe_state[MPU6050_MAX_DEVICES];
+static int64_t rbe_last_change_us = 0;   // 모든 디바이스 중 마지막으로 데드밴드를 넘은 시각
+static sensor_rbe_stats_t rbe_stats;
 
 /**
  * @brief 센서 데이터 읽기 (MPU6050)
  */
 bool sensor_read_data(mpu6050_data_t *data)
 {
-    if (!mpu6050_initialized) {
+    if (sensor_device_count == 0) {
         ESP_LOGE(TAG_SENSOR, "MPU6050 not initialized");
         return false;
     }
 
-    // MPU6050 센서 데이터 읽기
-    esp_err_t ret = mpu6050_read_data(data);
+    // 첫 번째 MPU6050 센서 데이터 읽기
+    esp_err_t ret = mpu6050_read_data(sensor_devices[0], data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG_SENSOR, "Failed to read MPU6050 data");
         return false;
@@ -48,6 +196,35 @@ void sensor_set_publish_interval(uint32_t interval_ms)
         publish_interval_ms = interval_ms;
         ESP_LOGI(TAG_SENSOR, "Publish interval changed to %lu ms", publish_interval_ms);
     }
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_POLL
+    // 폴링 모드는 전송 주기가 곧 샘플 주기
+    sensor_set_sample_period_us(publish_interval_ms * 1000);
+#endif
+}
+
+/**
+ * @brief 폴링 모드 샘플 주기 설정 (µs)
+ */
+esp_err_t sensor_set_sample_period_us(uint32_t period_us)
+{
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_POLL
+    if (period_us < SENSOR_SCHED_MIN_PERIOD_US) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    poll_period_us = period_us;
+    ESP_LOGI(TAG_SENSOR, "Sample period changed to %lu us", (unsigned long)period_us);
+    return sample_sched_set_period(&sensor_sched, period_us);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief 샘플링 주기 오차 통계 조회
+ */
+void sensor_get_sched_stats(sample_sched_stats_t *stats, bool reset)
+{
+    sample_sched_get_stats(&sensor_sched, stats, reset);
 }
 
 /**
@@ -59,43 +236,1446 @@ uint32_t sensor_get_publish_interval(void)
 }
 
 /**
- * @brief 센서 태스크 (주기적으로 센서 값 읽고 발행)
+ * @brief 발행 데이터 선택 (6축 값 또는 자세)
+ */
+esp_err_t sensor_set_publish_orientation(bool enable)
+{
+    if (enable && !SENSOR_FUSION_ENABLE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    publish_orientation = enable;
+    ESP_LOGI(TAG_SENSOR, "Publishing %s", enable ? "orientation" : "raw axes");
+    return ESP_OK;
+}
+
+/**
+ * @brief 자세 발행 여부 조회
+ */
+bool sensor_get_publish_orientation(void)
+{
+    return publish_orientation;
+}
+
+/**
+ * @brief MPU6050 설정 변경 요청
+ */
+void sensor_request_mpu6050_config(const mpu6050_config_t *config)
+{
+    portENTER_CRITICAL(&request_lock);
+    pending_config = *config;
+    config_pending = true;
+    portEXIT_CRITICAL(&request_lock);
+}
+
+/**
+ * @brief MPU6050 재보정 요청
+ */
+void sensor_request_calibration(void)
+{
+    portENTER_CRITICAL(&request_lock);
+    calibration_pending = true;
+    portEXIT_CRITICAL(&request_lock);
+}
+
+/**
+ * @brief 변화 기반 발행 설정 변경 요청
+ */
+esp_err_t sensor_set_rbe_config(const sensor_rbe_config_t *config)
+{
+    if (!(config->accel_deadband_g >= 0.0f) || !(config->gyro_deadband_dps >= 0.0f) ||
+        config->heartbeat_ms < 100) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&request_lock);
+    rbe_request = *config;
+    rbe_pending = true;
+    portEXIT_CRITICAL(&request_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief 변화 기반 발행 설정 조회 (적용 대기 중인 요청이 있으면 그 값)
+ */
+void sensor_get_rbe_config(sensor_rbe_config_t *config)
+{
+    portENTER_CRITICAL(&request_lock);
+    *config = rbe_pending ? rbe_request : rbe_config;
+    portEXIT_CRITICAL(&request_lock);
+}
+
+/**
+ * @brief 변화 기반 발행 통계 조회
+ */
+void sensor_get_rbe_stats(sensor_rbe_stats_t *stats)
+{
+    *stats = rbe_stats;
+}
+
+/**
+ * @brief MPU6050 설정 조회 (적용 대기 중인 요청이 있으면 그 값)
+ */
+void sensor_get_mpu6050_config(mpu6050_config_t *config)
+{
+    bool pending;
+
+    portENTER_CRITICAL(&request_lock);
+    pending = config_pending;
+    if (pending) {
+        *config = pending_config;
+    }
+    portEXIT_CRITICAL(&request_lock);
+
+    if (!pending && sensor_device_count > 0) {
+        mpu6050_get_config(sensor_devices[0], config);
+    }
+}
+
+#if SENSOR_DSP_ENABLE
+/**
+ * @brief 디바이스 샘플링 주파수에 맞춘 DSP 파이프라인 설정
+ *
+ * 요청한 주파수가 아니라 분주 후 실제 샘플 주기를 기준으로 합니다.
+ */
+static void sensor_dsp_get_config(size_t device, dsp_pipeline_config_t *config)
+{
+    const int64_t period_us = mpu6050_get_sample_period_us(sensor_devices[device]);
+
+    *config = (dsp_pipeline_config_t) {
+        .sample_rate_hz = 1000000.0f / period_us,
+        .biquad_cutoff_hz = SENSOR_DSP_BIQUAD_CUTOFF_HZ,
+        .moving_average_window = SENSOR_DSP_MA_WINDOW,
+        .decimation = SENSOR_DSP_DECIMATION,
+#ifdef SENSOR_DSP_FIR_COEFFS
+        .fir_num_taps = sizeof(sensor_dsp_fir_taps) / sizeof(sensor_dsp_fir_taps[0]),
+        .fir_taps = sensor_dsp_fir_taps,
+#else
+        .fir_num_taps = SENSOR_DSP_FIR_TAPS,
+#endif
+    };
+}
+#endif
+
+/**
+ * @brief 현재 샘플링 주파수로 모든 디바이스의 DSP 파이프라인 (재)초기화
+ */
+static void sensor_dsp_start(void)
+{
+    sensor_dsp_active = true;
+#if SENSOR_DSP_ENABLE
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        dsp_pipeline_config_t config;
+        sensor_dsp_get_config(i, &config);
+        sensor_dsp_ready[i] = dsp_pipeline_init(&sensor_dsp[i], &config);
+        sensor_dsp_output_period_us[i] = mpu6050_get_sample_period_us(sensor_devices[i]) * config.decimation;
+        if (!sensor_dsp_ready[i]) {
+            ESP_LOGE(TAG_SENSOR, "Invalid DSP config for %.0f Hz, filter bypassed", config.sample_rate_hz);
+        }
+    }
+#endif
+}
+
+#if SENSOR_ACQ_MODE != SENSOR_ACQ_MODE_POLL
+/**
+ * @brief 변환된 샘플 블록을 필터링해서 출력 샘플을 out에 저장
+ *
+ * 필터를 거치지 않으면 raw 샘플을 그대로, 필터 출력은 변환에 쓴 측정 범위(scale)로 다시 양자화해서 담습니다.
+ *
+ * @return 출력 샘플 수 (데시메이션 중이면 입력보다 적거나 0일 수 있음)
+ */
+static size_t sensor_dsp_filter(size_t device, const mpu6050_raw_sample_t *raw, const mpu6050_data_t *data,
+                                size_t count, const mpu6050_scale_t *scale, sensor_output_t *out)
+{
+    if (count == 0) {
+        return 0;
+    }
+
+#if SENSOR_DSP_ENABLE
+    if (sensor_dsp_active && sensor_dsp_ready[device]) {
+        static dsp_block_t block;
+
+        // 배열-구조체 → 구조체-배열 (채널별 연속 배치)
+        for (size_t i = 0; i < count; i++) {
+            block.ch[DSP_CH_ACCEL_X][i] = data[i].accel_x;
+            block.ch[DSP_CH_ACCEL_Y][i] = data[i].accel_y;
+            block.ch[DSP_CH_ACCEL_Z][i] = data[i].accel_z;
+            block.ch[DSP_CH_GYRO_X][i] = data[i].gyro_x;
+            block.ch[DSP_CH_GYRO_Y][i] = data[i].gyro_y;
+            block.ch[DSP_CH_GYRO_Z][i] = data[i].gyro_z;
+        }
+        block.count = count;
+
+        dsp_pipeline_process(&sensor_dsp[device], &block);
+
+        // 출력 시각은 마지막 입력 시각에서 출력 간격만큼 거슬러 올라가며 계산
+        for (size_t k = 0; k < block.count; k++) {
+            out[k].data.accel_x = block.ch[DSP_CH_ACCEL_X][k];
+            out[k].data.accel_y = block.ch[DSP_CH_ACCEL_Y][k];
+            out[k].data.accel_z = block.ch[DSP_CH_ACCEL_Z][k];
+            out[k].data.gyro_x = block.ch[DSP_CH_GYRO_X][k];
+            out[k].data.gyro_y = block.ch[DSP_CH_GYRO_Y][k];
+            out[k].data.gyro_z = block.ch[DSP_CH_GYRO_Z][k];
+            out[k].data.temperature = data[count - 1].temperature;
+            out[k].raw.timestamp_us = raw[count - 1].timestamp_us -
+                                      (int64_t)(block.count - 1 - k) * sensor_dsp_output_period_us[device];
+            out[k].raw.device_id = raw[count - 1].device_id;
+            mpu6050_quantize_samples(scale, &out[k].data, &out[k].raw, 1);
+            out[k].scale = *scale;
+        }
+        return block.count;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        out[i].raw = raw[i];
+        out[i].scale = *scale;
+        out[i].data = data[i];
+    }
+    return count;
+}
+#endif
+
+/**
+ * @brief 현재 설정의 DSP 파이프라인 처리 속도 측정
+ */
+uint32_t sensor_dsp_benchmark(size_t block_size)
+{
+#if SENSOR_DSP_ENABLE
+    if (sensor_device_count == 0) {
+        return 0;
+    }
+    dsp_pipeline_config_t config;
+    sensor_dsp_get_config(0, &config);
+#if APP_STATIC_ALLOC
+    // 명령 태스크(DSP_BENCH 명령)에서만 호출
+    return dsp_pipeline_benchmark(&config, &sensor_dsp_bench_pipeline, &sensor_dsp_bench_block,
+                                  block_size, SENSOR_DSP_BENCH_ITERATIONS);
+#else
+    // 태스크 스택을 쓰지 않도록 힙에 할당
+    dsp_pipeline_t *pipeline = malloc(sizeof(dsp_pipeline_t));
+    dsp_block_t *block = malloc(sizeof(dsp_block_t));
+    uint32_t cycles = dsp_pipeline_benchmark(&config, pipeline, block, block_size, SENSOR_DSP_BENCH_ITERATIONS);
+    free(pipeline);
+    free(block);
+    return cycles;
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 대기 중인 요청을 센서 태스크에서 적용
+ */
+static void sensor_apply_pending_requests(void)
+{
+    mpu6050_config_t config;
+    bool pending;
+    bool calibrate;
+    bool applied = false;
+
+    portENTER_CRITICAL(&request_lock);
+    pending = config_pending;
+    config = pending_config;
+    config_pending = false;
+    calibrate = calibration_pending;
+    calibration_pending = false;
+    if (rbe_pending) {
+        rbe_config = rbe_request;
+        rbe_pending = false;
+    }
+    portEXIT_CRITICAL(&request_lock);
+
+    for (size_t i = 0; i < sensor_device_count && pending; i++) {
+        if (mpu6050_set_config(sensor_devices[i], &config) == ESP_OK) {
+            applied = true;
+        } else {
+            ESP_LOGE(TAG_SENSOR, "Failed to apply MPU6050 #%u config", (unsigned)i);
+        }
+    }
+
+    // 샘플링 주파수가 바뀌었을 수 있으므로 필터 계수와 DATA_RDY 간격 기준을 실제 샘플 주기로 다시 계산
+    if (applied && sensor_dsp_active) {
+        sensor_dsp_start();
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_DRDY
+        // DATA_RDY 루프가 돌 때만 sensor_dsp_active (폴링으로 대체되면 스케줄러는 폴링 타이머)
+        sample_sched_set_period(&sensor_sched, mpu6050_get_sample_period_us(sensor_devices[0]));
+#endif
+    }
+
+    for (size_t i = 0; i < sensor_device_count && calibrate; i++) {
+        char response[160];
+        mpu6050_calibration_t offsets;
+
+        if (mpu6050_recalibrate(sensor_devices[i]) == ESP_OK) {
+            mpu6050_get_calibration(sensor_devices[i], &offsets);
+            snprintf(response, sizeof(response),
+                     "{\"status\":\"ok\",\"device\":%u,"
+                     "\"calibration\":{\"accel\":[%d,%d,%d],\"gyro\":[%d,%d,%d]}}",
+                     (unsigned)i,
+                     offsets.accel_x_offset, offsets.accel_y_offset, offsets.accel_z_offset,
+                     offsets.gyro_x_offset, offsets.gyro_y_offset, offsets.gyro_z_offset);
+        } else {
+            ESP_LOGE(TAG_SENSOR, "MPU6050 #%u recalibration failed", (unsigned)i);
+            snprintf(response, sizeof(response),
+                     "{\"status\":\"error\",\"device\":%u,\"command\":\"CALIBRATE\"}", (unsigned)i);
+        }
+        mqtt_publish_response(response);
+    }
+}
+
+#if SENSOR_FUSION_ENABLE
+/**
+ * @brief 변환된 샘플로 디바이스별 자세 갱신 (모든 샘플에 대해 순서대로 호출)
+ */
+static void sensor_fusion_update(const mpu6050_raw_sample_t *raw, const mpu6050_data_t *data, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        imu_fusion_update(&sensor_fusion[raw[i].device_id],
+                          data[i].accel_x, data[i].accel_y, data[i].accel_z,
+                          data[i].gyro_x, data[i].gyro_y, data[i].gyro_z,
+                          raw[i].timestamp_us);
+    }
+}
+#endif
+
+/**
+ * @brief 디바이스별 읽기 결과 확인 (실패한 디바이스만 로그를 남기고 나머지는 계속 사용)
+ *
+ * @param results mpu6050_read_raw_all*()의 디바이스별 결과
+ * @param valid 디바이스별 샘플 유효 여부를 저장할 배열
+ * @return size_t 읽기에 성공한 디바이스 수
+ */
+static size_t sensor_check_reads(const esp_err_t *results, bool *valid)
+{
+    size_t ok = 0;
+
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        valid[i] = results[i] == ESP_OK;
+        if (valid[i]) {
+            ok++;
+        } else {
+            ESP_LOGE(TAG_SENSOR, "Failed to read MPU6050 #%u: %s", (unsigned)i, esp_err_to_name(results[i]));
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief 디바이스별 샘플 1개씩을 물리 단위로 변환하고 변환에 쓴 측정 범위 기록 (읽기에 성공한 디바이스만)
+ *
+ * 변환은 현재 측정 범위를 쓰므로 설정 변경 요청을 적용하기 전에 끝내야 합니다.
+ */
+static void sensor_convert_valid(const mpu6050_raw_sample_t *samples, const bool *valid, mpu6050_data_t *data,
+                                 mpu6050_scale_t *scale)
+{
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        esp_cpu_cycle_count_t start = METRICS_START();
+        mpu6050_convert_samples(sensor_devices[i], &samples[i], &data[i], 1);
+        mpu6050_get_scale(sensor_devices[i], &scale[i]);
+        METRICS_STOP(METRICS_STAGE_CONVERT, start);
+    }
+}
+
+#if SENSOR_ACQ_MODE != SENSOR_ACQ_MODE_POLL
+/**
+ * @brief 모든 샘플을 발행할지 여부 (6축 값 배치 발행 중)
+ *
+ * false면 전송 주기마다 최신 샘플 하나만 발행합니다. 폴링 모드는 항상 읽은 샘플을 모두 발행합니다.
+ */
+static bool sensor_streaming(void)
+{
+    return mqtt_batch_enabled() && !publish_orientation;
+}
+#endif
+
+/**
+ * @brief 변환된 디바이스별 샘플 1개씩으로 자세 갱신 (읽기에 성공한 디바이스만)
+ */
+static void sensor_fuse_valid(const mpu6050_raw_sample_t *samples, const bool *valid, const mpu6050_data_t *data)
+{
+#if SENSOR_FUSION_ENABLE
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (!valid[i]) {
+            continue;
+        }
+        esp_cpu_cycle_count_t start = METRICS_START();
+        sensor_fusion_update(&samples[i], &data[i], 1);
+        METRICS_STOP(METRICS_STAGE_FUSION, start);
+    }
+#endif
+}
+
+/**
+ * @brief 디바이스별 샘플 1개씩을 물리 단위로 변환하고 자세 갱신 (읽기에 성공한 디바이스만)
+ */
+static void sensor_process_samples(const mpu6050_raw_sample_t *samples, const bool *valid, sensor_output_t *out)
+{
+    mpu6050_data_t data[MPU6050_MAX_DEVICES];
+    mpu6050_scale_t scale[MPU6050_MAX_DEVICES];
+
+    sensor_convert_valid(samples, valid, data, scale);
+    sensor_fuse_valid(samples, valid, data);
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (valid[i]) {
+            out[i] = (sensor_output_t) { .raw = samples[i], .scale = scale[i], .data = data[i] };
+        }
+    }
+}
+
+/**
+ * @brief 데드밴드 / heartbeat 판단 (변화 기반 발행이 꺼져 있으면 항상 발행)
+ *
+ * 어느 한 축이라도 기준 값과의 차이가 데드밴드를 넘으면 변화로 봅니다. 기준 값은 발행할 때만 바꾸므로
+ * 데드밴드보다 느린 변화도 누적되면 발행됩니다. 움직임 대기 판단을 위해 꺼져 있어도 변화 시각은 기록합니다.
+ *
+ * @return true 발행, false 버림
+ */
+static bool sensor_rbe_filter(uint8_t device_id, const mpu6050_data_t *data, int64_t timestamp_us)
+{
+    sensor_rbe_state_t *state = &rbe_state[device_id];
+    const float da = rbe_config.accel_deadband_g;
+    const float dg = rbe_config.gyro_deadband_dps;
+    const bool changed = !state->valid ||
+                         fabsf(data->accel_x - state->ref.accel_x) > da ||
+                         fabsf(data->accel_y - state->ref.accel_y) > da ||
+                         fabsf(data->accel_z - state->ref.accel_z) > da ||
+                         fabsf(data->gyro_x - state->ref.gyro_x) > dg ||
+                         fabsf(data->gyro_y - state->ref.gyro_y) > dg ||
+                         fabsf(data->gyro_z - state->ref.gyro_z) > dg;
+    const bool heartbeat = timestamp_us - state->ref_us >= (int64_t)rbe_config.heartbeat_ms * 1000;
+
+    if (changed) {
+        rbe_last_change_us = timestamp_us;
+    } else if (rbe_config.enabled && !heartbeat) {
+        rbe_stats.suppressed++;
+        return false;
+    }
+
+    if (changed || rbe_config.enabled) {
+        state->ref = *data;
+        state->ref_us = timestamp_us;
+        state->valid = true;
+    }
+    if (rbe_config.enabled) {
+        rbe_stats.published++;
+        rbe_stats.heartbeats += !changed;
+    }
+    return true;
+}
+
+/**
+ * @brief 디바이스 하나의 데이터를 발행 큐에 넣음 (설정에 따라 6축 값 또는 자세)
+ *
+ * 큐가 가득 차도 기다리지 않으므로 수집 타이밍은 브로커 지연과 무관합니다.
+ * 변화 기반 발행 중이면 데드밴드 안의 샘플은 번호를 받지 않고 버립니다 (수신 쪽에서 손실로 보이지 않음).
+ */
+static void sensor_publish(uint8_t device_id, const sensor_output_t *out)
+{
+    const int64_t timestamp_us = out->raw.timestamp_us;
+
+    if (!sensor_rbe_filter(device_id, &out->data, timestamp_us)) {
+        return;
+    }
+
+    sensor_sample_msg_t msg = {
+        .device_id = device_id,
+        .orientation = publish_orientation,
+        .info = {
+            .seq = sample_seq[device_id]++,
+            .timestamp_us = timestamp_us,
+        },
+    };
+
+#if SENSOR_FUSION_ENABLE
+    if (msg.orientation) {
+        imu_fusion_get_quaternion(&sensor_fusion[device_id], &msg.pose.q);
+        imu_fusion_get_euler(&sensor_fusion[device_id], &msg.pose.euler);
+    } else
+#endif
+    {
+        msg.sample.raw = out->raw;
+        msg.sample.scale = out->scale;
+    }
+
+    esp_cpu_cycle_count_t start = METRICS_START();
+    msg.info.enqueue_us = esp_timer_get_time();
+    if (xQueueSend(sample_queue, &msg, 0) != pdTRUE) {
+#if SENSOR_QUEUE_OVERWRITE
+        // 가장 오래된 샘플을 버리고 새 샘플을 넣음 (수집 태스크만 넣으므로 다시 실패하지 않음)
+        sensor_sample_msg_t oldest;
+        if (xQueueReceive(sample_queue, &oldest, 0) == pdTRUE) {
+            queue_stats.overwritten++;
+        }
+        xQueueSend(sample_queue, &msg, 0);
+#else
+        queue_stats.dropped++;
+        METRICS_STOP(METRICS_STAGE_ENQUEUE, start);
+        return;
+#endif
+    }
+    METRICS_STOP(METRICS_STAGE_ENQUEUE, start);
+    queue_stats.enqueued++;
+
+    uint32_t depth = uxQueueMessagesWaiting(sample_queue);
+    if (depth > queue_stats.peak_depth) {
+        queue_stats.peak_depth = depth;
+    }
+}
+
+/**
+ * @brief 읽기에 성공한 디바이스의 데이터를 발행 큐에 넣음
+ */
+static void sensor_publish_all(const sensor_output_t *out, const bool *valid)
+{
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (valid[i]) {
+            sensor_publish(i, &out[i]);
+        }
+    }
+}
+
+/**
+ * @brief 샘플 큐 통계 조회
+ */
+void sensor_get_queue_stats(sensor_queue_stats_t *stats)
+{
+    *stats = queue_stats;
+}
+
+/**
+ * @brief 발행 태스크 (샘플 큐에서 꺼내 MQTT로 발행, 네트워크 대기는 이 태스크에서만 발생)
+ */
+static void sensor_publish_task(void *pvParameters)
+{
+    sensor_sample_msg_t msg;
+    bool batch_pending = false;
+    bool replay_pending = false;
+#if SENSOR_SCHED_STATS_PERIOD_MS > 0
+    int64_t last_stats_us = esp_timer_get_time();
+#endif
+#if LATENCY_STATS_PERIOD_MS > 0
+    int64_t last_latency_us = esp_timer_get_time();
+#endif
+#if METRICS_ENABLE && METRICS_PERIOD_MS > 0
+    int64_t last_metrics_us = esp_timer_get_time();
+#endif
+    const TickType_t idle_wait = pdMS_TO_TICKS(SENSOR_PUB_IDLE_MS);
+
+    while (1) {
+        // 발행하지 않은 배치나 재전송할 샘플이 있으면 주기적으로 깨어남
+        TickType_t wait = (batch_pending || replay_pending) ? pdMS_TO_TICKS(SENSOR_BATCH_POLL_MS) : idle_wait;
+        if (!mqtt_outbox_ready()) {
+            // outbox가 비워질 때까지 큐에서 꺼내지 않음 (큐가 가득 차면 가장 오래된 샘플부터 덮어씀)
+            vTaskDelay(pdMS_TO_TICKS(SENSOR_BATCH_POLL_MS));
+        } else if (xQueueReceive(sample_queue, &msg, wait) == pdTRUE) {
+#if SENSOR_FUSION_ENABLE
+            if (msg.orientation) {
+                mqtt_publish_orientation(msg.device_id, &msg.pose.q, &msg.pose.euler, &msg.info);
+            } else
+#endif
+            if (mqtt_batch_enabled()) {
+                mqtt_batch_add_mpu6050_data(msg.device_id, &msg.sample.raw, &msg.sample.scale, &msg.info);
+            } else {
+                mqtt_publish_mpu6050_data(msg.device_id, &msg.sample.raw, &msg.sample.scale, &msg.info);
+            }
+            queue_stats.published++;
+        }
+        int64_t now_us = esp_timer_get_time();
+        batch_pending = mqtt_batch_flush_expired(now_us);
+        replay_pending = mqtt_spool_replay(now_us);
+        mqtt_latency_sync_poll(now_us);
+
+#if SENSOR_SCHED_STATS_PERIOD_MS > 0
+        // 샘플링 주기 오차 통계를 주기적으로 발행하고 새 구간 시작
+        if (now_us - last_stats_us >= (int64_t)SENSOR_SCHED_STATS_PERIOD_MS * 1000) {
+            sample_sched_stats_t stats;
+            sample_sched_get_stats(&sensor_sched, &stats, true);
+            mqtt_publish_sched_stats(&stats);
+            last_stats_us = now_us;
+        }
+#endif
+#if LATENCY_STATS_PERIOD_MS > 0
+        // 큐 → PUBACK 지연 통계도 같은 방식으로 주기 발행
+        if (now_us - last_latency_us >= (int64_t)LATENCY_STATS_PERIOD_MS * 1000) {
+            mqtt_publish_latency_stats();
+            last_latency_us = now_us;
+        }
+#endif
+#if METRICS_ENABLE && METRICS_PERIOD_MS > 0
+        // 단계별 처리 사이클 / 힙 / 스택 여유
+        if (now_us - last_metrics_us >= (int64_t)METRICS_PERIOD_MS * 1000) {
+            mqtt_publish_metrics();
+            last_metrics_us = now_us;
+        }
+#endif
+    }
+}
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_DRDY || SENSOR_MOTION_WAKE
+/**
+ * @brief MPU6050 INT 핀 ISR - 센서 태스크를 알림으로 깨움
+ */
+static void IRAM_ATTR mpu6050_int_isr_handler(void *arg)
+{
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sensor_task_handle, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/**
+ * @brief MPU6050 INT 핀을 상승엣지 인터럽트로 설정하고 ISR 설치
+ */
+static esp_err_t sensor_int_pin_init(void)
+{
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << MPU6050_INT_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    esp_err_t ret = gpio_config(&io_conf);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // gpio isr 서비스 설치 후 INT 핀에 핸들러 등록
+    ret = gpio_install_isr_service(ESP_INTR_FLAG_DEFAULT);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {  // 이미 설치된 경우 무시
+        return ret;
+    }
+    return gpio_isr_handler_add(MPU6050_INT_PIN, mpu6050_int_isr_handler, NULL);
+}
+#endif
+
+#if SENSOR_MOTION_WAKE
+/**
+ * @brief 첫 번째 MPU6050의 움직임 감지 인터럽트 설정 (폴링 중에는 GPIO 인터럽트를 꺼 둠)
+ */
+static esp_err_t sensor_motion_init(void)
+{
+    esp_err_t ret = sensor_int_pin_init();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = mpu6050_enable_motion_interrupt(sensor_devices[0], SENSOR_MOTION_THRESHOLD_MG,
+                                          SENSOR_MOTION_DURATION_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    // 샘플링 타이머도 같은 태스크 알림을 쓰므로 대기할 때만 켬
+    return gpio_intr_disable(MPU6050_INT_PIN);
+}
+
+/**
+ * @brief 변화 기반 발행 중 SENSOR_MOTION_IDLE_MS 동안 변화가 없었는지 확인
+ */
+static bool sensor_motion_idle(void)
+{
+    return rbe_config.enabled &&
+           esp_timer_get_time() - rbe_last_change_us >= (int64_t)SENSOR_MOTION_IDLE_MS * 1000;
+}
+
+/**
+ * @brief 샘플링 타이머를 멈추고 움직임 인터럽트, heartbeat 시각 또는 변화 기반 발행이 꺼질 때까지 대기
+ */
+static void sensor_motion_sleep(void)
+{
+    const int64_t start_us = esp_timer_get_time();
+    bool motion = false;
+    uint8_t status;
+
+    if (sample_sched_pause(&sensor_sched) != ESP_OK) {
+        return;
+    }
+    mpu6050_read_int_status(sensor_devices[0], &status);   // 폴링 중에 쌓인 상태 해제
+    gpio_intr_enable(MPU6050_INT_PIN);
+    rbe_stats.sleeps++;
+    ESP_LOGD(TAG_SENSOR, "No motion for %d ms, sampling paused", SENSOR_MOTION_IDLE_MS);
+
+    while (rbe_config.enabled &&
+           esp_timer_get_time() - start_us < (int64_t)rbe_config.heartbeat_ms * 1000) {
+        // 명령이 heartbeat 시간만큼 늦어지지 않도록 나눠서 대기
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SENSOR_MOTION_CHECK_MS)) > 0 &&
+            mpu6050_read_int_status(sensor_devices[0], &status) == ESP_OK &&
+            (status & MPU6050_INT_STATUS_MOT)) {
+            motion = true;
+            break;
+        }
+        sensor_apply_pending_requests();
+    }
+
+    gpio_intr_disable(MPU6050_INT_PIN);
+    const int64_t now_us = esp_timer_get_time();
+    rbe_stats.sleep_ms += (now_us - start_us) / 1000;
+    if (motion) {
+        rbe_stats.motion_wakeups++;
+        rbe_last_change_us = now_us;   // 움직임이 시작되면 최소 SENSOR_MOTION_IDLE_MS 동안 폴링
+    }
+    sample_sched_resume(&sensor_sched);
+}
+#endif
+
+/**
+ * @brief 폴링 모드: 전송 주기마다 모든 디바이스에서 1샘플씩 읽고 발행
+ *
+ * 움직임 감지 대기를 사용하면 변화가 없는 동안 타이머를 멈추고, 깨어나면 주기를 기다리지 않고 바로 읽습니다.
+ */
+static void sensor_poll_loop(void)
+{
+    // esp_timer 주기 콜백으로 깨어나므로 읽기 / 발행 시간이 주기에 더해지지 않음
+    if (sample_sched_start(&sensor_sched, poll_period_us) != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "Failed to start sampling timer");
+        return;
+    }
+
+#if SENSOR_MOTION_WAKE
+    const bool motion_wake = sensor_motion_init() == ESP_OK;
+    if (!motion_wake) {
+        ESP_LOGE(TAG_SENSOR, "Motion interrupt setup failed, polling continuously");
+    }
+#endif
+    bool wait = true;
+
+    while (1) {
+        if (wait) {
+            uint32_t ticks = sample_sched_wait(&sensor_sched);
+            if (ticks > 1) {
+                ESP_LOGD(TAG_SENSOR, "Sampling fell behind by %lu periods", (unsigned long)(ticks - 1));
+            }
+        }
+        wait = true;
+
+        mpu6050_raw_sample_t samples[MPU6050_MAX_DEVICES];
+        sensor_output_t out[MPU6050_MAX_DEVICES];
+        esp_err_t results[MPU6050_MAX_DEVICES];
+        bool valid[MPU6050_MAX_DEVICES];
+
+        sensor_apply_pending_requests();
+
+        // 센서 데이터 읽기 (한 디바이스가 실패해도 나머지는 발행)
+        esp_cpu_cycle_count_t start = METRICS_START();
+        mpu6050_read_raw_all(sensor_devices, sensor_device_count, samples, results);
+        METRICS_STOP(METRICS_STAGE_I2C_READ, start);
+        if (sensor_check_reads(results, valid) > 0) {
+            // MQTT로 발행
+            sensor_process_samples(samples, valid, out);
+            sensor_publish_all(out, valid);
+        }
+
+#if SENSOR_MOTION_WAKE
+        if (motion_wake && sensor_motion_idle()) {
+            // 움직임 또는 heartbeat로 깨어나면 바로 다음 샘플을 읽음
+            sensor_motion_sleep();
+            wait = false;
+        }
+#endif
+    }
+}
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_FIFO
+/**
+ * @brief FIFO 모드: 주기적으로 디바이스별 FIFO를 한 번에 비우고 전송 주기마다 최신 샘플 발행
+ */
+static void sensor_fifo_loop(void)
+{
+    static mpu6050_raw_sample_t samples[SENSOR_FIFO_MAX_SAMPLES];
+    static mpu6050_data_t data[SENSOR_FIFO_MAX_SAMPLES];
+    static sensor_output_t filtered[SENSOR_FIFO_MAX_SAMPLES];
+    sensor_output_t latest[MPU6050_MAX_DEVICES];
+    bool have_latest[MPU6050_MAX_DEVICES] = {0};
+    TickType_t last_publish = xTaskGetTickCount();
+
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (mpu6050_fifo_enable(sensor_devices[i], SENSOR_FIFO_SAMPLE_RATE_HZ) != ESP_OK) {
+            ESP_LOGE(TAG_SENSOR, "FIFO enable failed, falling back to polling");
+            sensor_poll_loop();
+            return;
+        }
+    }
+    sensor_dsp_start();
+
+    // FIFO를 비우는 주기도 타이머로 맞춤 (샘플 시각은 센서 클럭 기준)
+    if (sample_sched_start(&sensor_sched, SENSOR_FIFO_DRAIN_MS * 1000) != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "Failed to start FIFO drain timer");
+        return;
+    }
+
+    while (1) {
+        sample_sched_wait(&sensor_sched);
+        sensor_apply_pending_requests();
+
+        for (size_t i = 0; i < sensor_device_count; i++) {
+            size_t count = 0;
+            esp_cpu_cycle_count_t start = METRICS_START();
+            esp_err_t ret = mpu6050_fifo_read(sensor_devices[i], samples, SENSOR_FIFO_MAX_SAMPLES, &count);
+            METRICS_STOP(METRICS_STAGE_I2C_READ, start);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG_SENSOR, "Failed to drain MPU6050 #%u FIFO", (unsigned)i);
+                continue;
+            }
+            ESP_LOGD(TAG_SENSOR, "FIFO #%u drained %u samples", (unsigned)i, (unsigned)count);
+
+            if (count > 0) {
+                // 자세 추정과 필터는 모든 샘플이 필요하므로 블록 전체를 한 번에 변환
+                mpu6050_scale_t scale;
+                start = METRICS_START();
+                mpu6050_convert_samples(sensor_devices[i], samples, data, count);
+                mpu6050_get_scale(sensor_devices[i], &scale);
+                METRICS_STOP(METRICS_STAGE_CONVERT, start);
+#if SENSOR_FUSION_ENABLE
+                start = METRICS_START();
+                sensor_fusion_update(samples, data, count);
+                METRICS_STOP(METRICS_STAGE_FUSION, start);
+#endif
+                start = METRICS_START();
+                size_t out_count = sensor_dsp_filter(i, samples, data, count, &scale, filtered);
+                METRICS_STOP(METRICS_STAGE_DSP, start);
+                if (out_count == 0) {
+                    continue;
+                }
+                if (sensor_streaming()) {
+                    // 배치 발행: 모든 필터 출력을 큐에 넣음
+                    for (size_t k = 0; k < out_count; k++) {
+                        sensor_publish(i, &filtered[k]);
+                    }
+                } else {
+                    latest[i] = filtered[out_count - 1];
+                    have_latest[i] = true;
+                }
+            }
+        }
+
+        if ((xTaskGetTickCount() - last_publish) >= pdMS_TO_TICKS(publish_interval_ms)) {
+            for (size_t i = 0; i < sensor_device_count; i++) {
+                if (!have_latest[i]) {
+                    continue;
+                }
+                sensor_publish(i, &latest[i]);
+                have_latest[i] = false;
+            }
+            last_publish = xTaskGetTickCount();
+        }
+    }
+}
+#endif
+
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_DRDY
+/**
+ * @brief DATA_RDY 모드: 센서 샘플 클럭에 맞춰 인터럽트마다 1샘플 읽고 전송 주기마다 발행
+ *
+ * 드라이버 수신 버퍼가 이번 프레임을 받는 동안 지난 인터럽트에서 읽어 둔 샘플(samples / data)의
+ * 자세 추정과 필터를 처리하는 2단 파이프라인입니다 (지연 1샘플).
+ */
+static void sensor_drdy_loop(void)
+{
+    TickType_t last_publish = xTaskGetTickCount();
+    // 지난 인터럽트에서 읽고 변환까지 마친 샘플 (valid[]인 디바이스만, have_samples면 아직 처리 전)
+    mpu6050_raw_sample_t samples[MPU6050_MAX_DEVICES];
+    mpu6050_data_t data[MPU6050_MAX_DEVICES];
+    mpu6050_scale_t scale[MPU6050_MAX_DEVICES];
+    esp_err_t results[MPU6050_MAX_DEVICES];
+    bool valid[MPU6050_MAX_DEVICES];
+    bool have_samples = false;
+    // 필터 출력 (다음 샘플을 읽는 동안 발행)
+    sensor_output_t latest[MPU6050_MAX_DEVICES];
+    bool have_latest[MPU6050_MAX_DEVICES] = {0};
+    size_t latest_count = 0;
+
+    sensor_task_handle = xTaskGetCurrentTaskHandle();
+    if (sensor_int_pin_init() != ESP_OK) {
+        ESP_LOGE(TAG_SENSOR, "DATA_RDY interrupt setup failed, falling back to polling");
+        sensor_poll_loop();
+        return;
+    }
+
+    // 모든 디바이스를 같은 샘플링 주파수로 맞추고, 첫 번째 디바이스의 INT 핀으로 타이밍을 잡음
+    for (size_t i = 0; i < sensor_device_count; i++) {
+        if (mpu6050_enable_data_ready_interrupt(sensor_devices[i], SENSOR_DRDY_SAMPLE_RATE_HZ) != ESP_OK) {
+            ESP_LOGE(TAG_SENSOR, "DATA_RDY interrupt setup failed, falling back to polling");
+            sensor_poll_loop();
+            return;
+        }
+    }
+    sensor_dsp_start();
+
+    // 타이밍은 센서 클럭이 정하므로 인터럽트 간격 오차 통계만 기록 (첫 번째 디바이스 INT 기준)
+    sample_sched_init(&sensor_sched, mpu6050_get_sample_period_us(sensor_devices[0]));
+
+    while (1) {
+        // 인터럽트가 올 때까지 대기 (반환값 = 처리하지 못하고 쌓인 알림 수)
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SENSOR_DRDY_TIMEOUT_MS));
+        sensor_apply_pending_requests();
+        if (pending == 0) {
+            ESP_LOGW(TAG_SENSOR, "No DATA_RDY interrupt within %d ms", SENSOR_DRDY_TIMEOUT_MS);
+            continue;
+        }
+        sample_sched_record(&sensor_sched, esp_timer_get_time(), pending - 1);
+        if (pending > 1) {
+            ESP_LOGD(TAG_SENSOR, "Missed %lu samples", (unsigned long)(pending - 1));
+        }
+
+        // 이번 샘플 읽기를 버스 큐에 넣고, 전송되는 동안 지난 샘플을 처리해서 발행 큐에 넣음
+        // (시작에 실패한 디바이스는 finish 결과에 반영되므로 여기서는 로그를 남기지 않음)
+        mpu6050_read_raw_all_start(sensor_devices, sensor_device_count, NULL);
+
+        if (have_samples) {
+            sensor_fuse_valid(samples, valid, data);
+            esp_cpu_cycle_count_t start = METRICS_START();
+            for (size_t i = 0; i < sensor_device_count; i++) {
+                if (valid[i] && sensor_dsp_filter(i, &samples[i], &data[i], 1, &scale[i], &latest[i]) > 0) {
+                    latest_count += !have_latest[i];
+                    have_latest[i] = true;
+                }
+            }
+            METRICS_STOP(METRICS_STAGE_DSP, start);
+            have_samples = false;
+        }
+
+        if (latest_count > 0 && (sensor_streaming() ||
+                                 (xTaskGetTickCount() - last_publish) >= pdMS_TO_TICKS(publish_interval_ms))) {
+            // 배치 발행 중이면 새 필터 출력마다, 아니면 전송 주기마다 (새 출력이 있는 디바이스만)
+            sensor_publish_all(latest, have_latest);
+            memset(have_latest, 0, sizeof(have_latest));
+            latest_count = 0;
+            last_publish = xTaskGetTickCount();
+        }
+
+        esp_cpu_cycle_count_t start = METRICS_START();
+        mpu6050_read_raw_all_finish(sensor_devices, sensor_device_count, samples, results);
+        METRICS_STOP(METRICS_STAGE_I2C_READ, start);
+        if (sensor_check_reads(results, valid) > 0) {
+            // 다음 인터럽트에서 설정 변경을 적용하기 전에 지금 측정 범위로 변환만 해 둠
+            sensor_convert_valid(samples, valid, data, scale);
+            have_samples = true;
+        }
+    }
+}
+#endif
+
+/**
+ * @brief I2C 버스 생성 후 설정된 주소의 MPU6050 인스턴스 생성
+ */
+static esp_err_t sensor_devices_init(void)
+{
+    esp_err_t ret = mpu6050_bus_init(I2C_MASTER_NUM, I2C_MASTER_SDA_IO, I2C_MASTER_SCL_IO, &sensor_bus);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    for (size_t i = 0; i < SENSOR_DEVICE_COUNT; i++) {
+        mpu6050_device_config_t device_config = {
+            .i2c_address = device_addresses[i],
+            .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+            .device_id = i,
+            .config = {
+                .accel_range = MPU6050_DEFAULT_ACCEL_RANGE,
+                .gyro_range = MPU6050_DEFAULT_GYRO_RANGE,
+                .dlpf = MPU6050_DEFAULT_DLPF,
+                .sample_rate_hz = MPU6050_DEFAULT_SAMPLE_RATE_HZ,
+            },
+        };
+
+        ret = mpu6050_create(sensor_bus, &device_config, &sensor_devices[sensor_device_count]);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG_SENSOR, "MPU6050 #%u (0x%02X) init failed", (unsigned)i, device_addresses[i]);
+            return ret;
+        }
+        sensor_device_count++;
+#if SENSOR_FUSION_ENABLE
+        imu_fusion_init(&sensor_fusion[i], SENSOR_FUSION_ALGORITHM, SENSOR_FUSION_GAIN);
+#endif
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief 수집 태스크 (센서 값을 읽어 샘플 큐에 넣음)
  */
 static void sensor_task(void *pvParameters)
 {
-    ESP_LOGI(TAG_SENSOR, "Sensor task started with interval: %lu ms", publish_interval_ms);
+    ESP_LOGI(TAG_SENSOR, "Sensor task started on core %d with interval: %lu ms",
+             xPortGetCoreID(), publish_interval_ms);
 
     // MPU6050 초기화
-    esp_err_t ret = mpu6050_init_sensor();
-    if (ret != ESP_OK) {
+    if (sensor_devices_init() != ESP_OK) {
         ESP_LOGE(TAG_SENSOR, "MPU6050 initialization failed, halting sensor task");
         vTaskDelete(NULL);
         return;
     }
-    mpu6050_initialized = true;
-    ESP_LOGI(TAG_SENSOR, "MPU6050 initialized successfully");
+    ESP_LOGI(TAG_SENSOR, "%u MPU6050 initialized successfully", (unsigned)sensor_device_count);
+    metrics_log_ram_budget();   // 모든 서브시스템 초기화 완료
 
-    while (1) {
-        mpu6050_data_t sensor_data;
+#if SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_FIFO
+    sensor_fifo_loop();
+#elif SENSOR_ACQ_MODE == SENSOR_ACQ_MODE_DRDY
+    sensor_drdy_loop();
+#else
+    sensor_poll_loop();
+#endif
 
-        // 센서 데이터 읽기
-        if (sensor_read_data(&sensor_data)) {
-            // MQTT로 발행
-            mqtt_publish_mpu6050_data(&sensor_data);
+    // 타이머를 시작하지 못하면 여기로 돌아옴
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief INTERVAL:<ms> (센서 데이터 전송 주기)
+ */
+static esp_err_t sensor_cmd_interval(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t interval_ms;
+    if (!command_parse_u32(cmd->args, UINT32_MAX, &interval_ms)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sensor_set_publish_interval(interval_ms);
+    snprintf(response, size, "{\"status\":\"ok\",\"interval\":%lu}", sensor_get_publish_interval());
+    return ESP_OK;
+}
+
+/**
+ * @brief PERIOD_US:<µs> (폴링 모드 샘플 주기, 1ms 미만 가능)
+ */
+static esp_err_t sensor_cmd_period_us(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t period_us;
+    if (!command_parse_u32(cmd->args, UINT32_MAX, &period_us)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = sensor_set_sample_period_us(period_us);
+    if (ret == ESP_OK) {
+        snprintf(response, size, "{\"status\":\"ok\",\"period_us\":%lu}", (unsigned long)period_us);
+    } else {
+        snprintf(response, size, "{\"status\":\"error\",\"reason\":\"%s\"}",
+                 ret == ESP_ERR_NOT_SUPPORTED ? "poll mode only" : "period too short");
+    }
+    return ret;
+}
+
+/**
+ * @brief OUTPUT:<RAW|ORIENTATION> (발행 데이터 선택)
+ */
+static esp_err_t sensor_cmd_output(const command_t *cmd, char *response, size_t size)
+{
+    bool orientation = cmd->args && strcmp(cmd->args, "ORIENTATION") == 0;
+    if (cmd->args == NULL || (!orientation && strcmp(cmd->args, "RAW") != 0) ||
+        sensor_set_publish_orientation(orientation) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    snprintf(response, size, "{\"status\":\"ok\",\"output\":\"%s\"}", orientation ? "orientation" : "raw");
+    return ESP_OK;
+}
+
+/**
+ * @brief DSP_BENCH[:<블록 크기>]
+ */
+static esp_err_t sensor_cmd_dsp_bench(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t block_size = SENSOR_FIFO_MAX_SAMPLES;
+    if (cmd->args != NULL && !command_parse_u32(cmd->args, UINT16_MAX, &block_size)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t cycles = block_size > 0 ? sensor_dsp_benchmark(block_size) : 0;
+    if (cycles == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    snprintf(response, size, "{\"status\":\"ok\",\"block\":%lu,\"cycles_per_sample\":%lu}",
+             (unsigned long)block_size, (unsigned long)cycles);
+    return ESP_OK;
+}
+
+/**
+ * @brief FUSION_BENCH (알고리즘별 샘플 1개 갱신 비용)
+ */
+static esp_err_t sensor_cmd_fusion_bench(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t complementary = imu_fusion_benchmark(IMU_FUSION_COMPLEMENTARY, SENSOR_FUSION_BENCH_ITERATIONS);
+    uint32_t madgwick = imu_fusion_benchmark(IMU_FUSION_MADGWICK, SENSOR_FUSION_BENCH_ITERATIONS);
+
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"cycles_per_update\":{\"complementary\":%lu,\"madgwick\":%lu}}",
+             (unsigned long)complementary, (unsigned long)madgwick);
+    return ESP_OK;
+}
+
+/**
+ * @brief QUEUE_STATS (수집 → 발행 샘플 큐 상태)
+ */
+static esp_err_t sensor_cmd_queue_stats(const command_t *cmd, char *response, size_t size)
+{
+    sensor_queue_stats_t stats;
+    sensor_get_queue_stats(&stats);
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"queue\":{\"enqueued\":%lu,\"published\":%lu,"
+             "\"dropped\":%lu,\"overwritten\":%lu,\"peak\":%lu,\"length\":%d}}",
+             (unsigned long)stats.enqueued, (unsigned long)stats.published,
+             (unsigned long)stats.dropped, (unsigned long)stats.overwritten,
+             (unsigned long)stats.peak_depth, SENSOR_QUEUE_LENGTH);
+    return ESP_OK;
+}
+
+/**
+ * @brief RBE (조회), RBE:ON, RBE:OFF, RBE:<가속도 g>:<각속도 °/s>[:<heartbeat ms>] (변화 기반 발행)
+ */
+static esp_err_t sensor_cmd_rbe(const command_t *cmd, char *response, size_t size)
+{
+    sensor_rbe_config_t config;
+    sensor_get_rbe_config(&config);
+
+    if (cmd->args != NULL) {
+        unsigned long heartbeat_ms = config.heartbeat_ms;
+        if (strcmp(cmd->args, "ON") == 0 || strcmp(cmd->args, "OFF") == 0) {
+            config.enabled = cmd->args[1] == 'N';
+        } else if (sscanf(cmd->args, "%f:%f:%lu", &config.accel_deadband_g,
+                          &config.gyro_deadband_dps, &heartbeat_ms) >= 2) {
+            config.enabled = true;
+            config.heartbeat_ms = heartbeat_ms;
+        } else {
+            return ESP_ERR_INVALID_ARG;
+        }
+        esp_err_t ret = sensor_set_rbe_config(&config);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+    }
+
+    sensor_rbe_stats_t stats;
+    sensor_get_rbe_stats(&stats);
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"rbe\":{\"enabled\":%s,\"accel_g\":%.3f,\"gyro_dps\":%.2f,"
+             "\"heartbeat_ms\":%lu,\"published\":%lu,\"suppressed\":%lu,\"heartbeats\":%lu,"
+             "\"sleeps\":%lu,\"motion_wakeups\":%lu,\"sleep_ms\":%lu}}",
+             config.enabled ? "true" : "false", config.accel_deadband_g, config.gyro_deadband_dps,
+             (unsigned long)config.heartbeat_ms, (unsigned long)stats.published,
+             (unsigned long)stats.suppressed, (unsigned long)stats.heartbeats,
+             (unsigned long)stats.sleeps, (unsigned long)stats.motion_wakeups,
+             (unsigned long)stats.sleep_ms);
+    return ESP_OK;
+}
+
+/**
+ * @brief CALIBRATE (보정은 약 1초가 걸리므로 센서 태스크에서 수행 후 응답)
+ */
+static esp_err_t sensor_cmd_calibrate(const command_t *cmd, char *response, size_t size)
+{
+    sensor_request_calibration();
+    return ESP_OK;
+}
+
+/**
+ * @brief MPU6050 설정 응답 JSON
+ */
+static void sensor_format_mpu6050_config(const mpu6050_config_t *config, char *response, size_t size)
+{
+    snprintf(response, size, "{\"status\":\"ok\",\"accel_range\":%u,\"gyro_range\":%u,\"dlpf\":%u,\"rate\":%u}",
+             mpu6050_accel_range_to_g(config->accel_range), mpu6050_gyro_range_to_dps(config->gyro_range),
+             mpu6050_dlpf_to_hz(config->dlpf), config->sample_rate_hz);
+}
+
+/**
+ * @brief MPU6050 설정 값 검사 후 config에 반영 (ACCEL_RANGE / GYRO_RANGE / DLPF / RATE와 SET: 키가 같이 사용)
+ *
+ * @param setting 0: 가속도 범위(g), 1: 각속도 범위(°/s), 2: DLPF(Hz), 3: 샘플링 속도(Hz)
+ */
+static esp_err_t sensor_apply_mpu6050_setting(int setting, const char *value, mpu6050_config_t *config)
+{
+    uint32_t number;
+    if (!command_parse_u32(value, UINT16_MAX, &number)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    switch (setting) {
+    case 0:
+        return mpu6050_accel_range_from_g(number, &config->accel_range);
+    case 1:
+        return mpu6050_gyro_range_from_dps(number, &config->gyro_range);
+    case 2:
+        return mpu6050_dlpf_from_hz(number, &config->dlpf);
+    default:
+        // DLPF와 함께 바뀔 수 있으므로 분주 가능 여부는 sensor_resolve_mpu6050_rate()에서 확인
+        config->sample_rate_hz = number;
+        return ESP_OK;
+    }
+}
+
+/**
+ * @brief 최종 DLPF로 샘플링 주파수를 확인하고 실제로 동작할 주파수로 바꿈
+ *
+ * DLPF만 바꿔도 기존 주파수가 분주 범위를 벗어날 수 있으므로(예: 260Hz로 바꾸면 32Hz 미만 불가)
+ * 모든 설정을 반영한 뒤 호출합니다. 실패하면 센서 태스크가 적용할 수 없으므로 요청하지 않습니다.
+ */
+static esp_err_t sensor_resolve_mpu6050_rate(mpu6050_config_t *config, char *response, size_t size)
+{
+    esp_err_t ret = mpu6050_check_sample_rate(config->dlpf, config->sample_rate_hz, &config->sample_rate_hz);
+    if (ret != ESP_OK) {
+        snprintf(response, size,
+                 "{\"status\":\"error\",\"key\":\"rate\",\"reason\":\"not achievable with dlpf\",\"rate\":%u,\"dlpf\":%u}",
+                 config->sample_rate_hz, mpu6050_dlpf_to_hz(config->dlpf));
+    }
+    return ret;
+}
+
+/**
+ * @brief MPU6050 설정 명령 처리
+ *
+ * ACCEL_RANGE:<2|4|8|16>, GYRO_RANGE:<250|500|1000|2000>,
+ * DLPF:<260|184|94|44|21|10|5>, RATE:<Hz>
+ */
+static esp_err_t sensor_cmd_mpu6050_config(const command_t *cmd, char *response, size_t size)
+{
+    static const char *const names[] = { "ACCEL_RANGE", "GYRO_RANGE", "DLPF", "RATE" };
+    mpu6050_config_t config;
+    int setting = 0;
+
+    while (strcmp(cmd->name, names[setting]) != 0) {
+        setting++;
+    }
+    sensor_get_mpu6050_config(&config);
+    esp_err_t ret = sensor_apply_mpu6050_setting(setting, cmd->args, &config);
+    if (ret == ESP_OK) {
+        ret = sensor_resolve_mpu6050_rate(&config, response, size);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    sensor_request_mpu6050_config(&config);
+    sensor_format_mpu6050_config(&config, response, size);
+    return ESP_OK;
+}
+
+// SET: 키 (적용 / 응답 순서)
+typedef enum {
+    SENSOR_SET_PERIOD_US = 0,
+    SENSOR_SET_OUTPUT,
+    SENSOR_SET_INTERVAL,
+    SENSOR_SET_BATCH,
+    SENSOR_SET_FLUSH_MS,
+    SENSOR_SET_FORMAT,
+    SENSOR_SET_ACCEL_RANGE,       // MPU6050 설정 (순서는 sensor_apply_mpu6050_setting과 같음)
+    SENSOR_SET_GYRO_RANGE,
+    SENSOR_SET_DLPF,
+    SENSOR_SET_RATE,
+    SENSOR_SET_KEY_COUNT,
+} sensor_set_key_t;
+
+static const char *const sensor_set_keys[SENSOR_SET_KEY_COUNT] = {
+    "period_us", "output", "interval", "batch", "flush_ms", "format", "accel_range", "gyro_range", "dlpf", "rate",
+};
+
+/**
+ * @brief SET:<키>=<값>[,<키>=<값>...] (한 메시지로 여러 설정 변경)
+ *
+ * 모든 키를 먼저 해석 / 검사하고 하나라도 틀리면 아무것도 바꾸지 않습니다.
+ * 수집 방식이나 빌드 설정에 따라 적용할 수 없는 값(폴링 모드가 아닌데 period_us, 융합이 꺼졌는데 output=orientation)도
+ * 검사 단계에서 거절하므로 적용 단계는 실패하지 않습니다.
+ * MPU6050 설정(accel_range / gyro_range / dlpf / rate)은 모아서 센서 태스크에 한 번만 요청하고,
+ * rate는 실제로 동작할 주파수(분주 후)로 응답합니다.
+ */
+static esp_err_t sensor_cmd_set(const command_t *cmd, char *response, size_t size)
+{
+    uint32_t values[SENSOR_SET_KEY_COUNT];
+    uint32_t mask = 0;
+    mpu6050_config_t config;
+    char *cursor = cmd->args;
+    const char *key;
+    const char *value;
+
+    sensor_get_mpu6050_config(&config);
+
+    // 1단계: 해석 / 검사
+    while (command_next_pair(&cursor, &key, &value)) {
+        int k = 0;
+        while (k < SENSOR_SET_KEY_COUNT && strcmp(key, sensor_set_keys[k]) != 0) {
+            k++;
+        }
+
+        bool ok;
+        const char *reason = "invalid value";
+        if (k == SENSOR_SET_KEY_COUNT) {
+            ok = false;
+            reason = "unknown key";
+        } else if (k == SENSOR_SET_PERIOD_US) {
+            ok = command_parse_u32(value, UINT32_MAX, &values[k]);
+            if (ok && SENSOR_ACQ_MODE != SENSOR_ACQ_MODE_POLL) {
+                ok = false;
+                reason = "poll mode only";
+            } else if (ok && values[k] < SENSOR_SCHED_MIN_PERIOD_US) {
+                ok = false;
+                reason = "period too short";
+            }
+        } else if (k == SENSOR_SET_OUTPUT) {
+            values[k] = strcasecmp(value, "orientation") == 0;
+            ok = values[k] || strcasecmp(value, "raw") == 0;
+            if (ok && values[k] && !SENSOR_FUSION_ENABLE) {
+                ok = false;
+                reason = "fusion disabled";
+            }
+        } else if (k == SENSOR_SET_FORMAT) {
+            values[k] = mqtt_payload_format_from_name(value);
+            ok = values[k] < MQTT_FORMAT_COUNT;
+        } else if (k >= SENSOR_SET_ACCEL_RANGE) {
+            ok = sensor_apply_mpu6050_setting(k - SENSOR_SET_ACCEL_RANGE, value, &config) == ESP_OK;
         } else {
-            ESP_LOGE(TAG_SENSOR, "Failed to read sensor data");
+            ok = command_parse_u32(value, UINT32_MAX, &values[k]) &&
+                 (k != SENSOR_SET_BATCH || (values[k] >= 1 && values[k] <= MQTT_BATCH_MAX_SAMPLES)) &&
+                 (k != SENSOR_SET_FLUSH_MS || values[k] >= 1);
+        }
+        if (!ok) {
+            snprintf(response, size, "{\"status\":\"error\",\"key\":\"%.32s\",\"reason\":\"%s\"}", key, reason);
+            return ESP_ERR_INVALID_ARG;
+        }
+        mask |= 1u << k;
+    }
+    if (mask == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if ((mask >> SENSOR_SET_ACCEL_RANGE) && sensor_resolve_mpu6050_rate(&config, response, size) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 2단계: 적용 (1단계에서 모두 검사했으므로 실패하지 않음)
+    int k;
+    for (k = 0; k < SENSOR_SET_ACCEL_RANGE; k++) {
+        if ((mask & (1u << k)) == 0) {
+            continue;
+        }
+        switch (k) {
+        case SENSOR_SET_PERIOD_US:
+            sensor_set_sample_period_us(values[k]);
+            break;
+        case SENSOR_SET_OUTPUT:
+            sensor_set_publish_orientation(values[k]);
+            break;
+        case SENSOR_SET_INTERVAL:
+            sensor_set_publish_interval(values[k]);
+            break;
+        case SENSOR_SET_BATCH:
+            mqtt_set_batch_size(values[k]);
+            break;
+        case SENSOR_SET_FLUSH_MS:
+            mqtt_set_batch_flush_ms(values[k]);
+            break;
+        case SENSOR_SET_FORMAT:
+            for (int i = 0; i < MPU6050_MAX_DEVICES; i++) {
+                mqtt_set_payload_format(i, (mqtt_payload_format_t)values[k]);
+            }
+            break;
         }
+    }
+    if (mask >> SENSOR_SET_ACCEL_RANGE) {
+        sensor_request_mpu6050_config(&config);
+    }
 
-        // 동적 전송 주기로 대기
-        vTaskDelay(pdMS_TO_TICKS(publish_interval_ms));
+    int len = snprintf(response, size, "{\"status\":\"ok\",\"set\":{");
+    const char *separator = "";
+    for (k = 0; k < SENSOR_SET_KEY_COUNT && len < (int)size; k++) {
+        if ((mask & (1u << k)) == 0) {
+            continue;
+        }
+        len += snprintf(response + len, size - len, "%s\"%s\":", separator, sensor_set_keys[k]);
+        separator = ",";
+        if (len >= (int)size) {
+            break;
+        }
+        switch (k) {
+        case SENSOR_SET_OUTPUT:
+            len += snprintf(response + len, size - len, "\"%s\"", values[k] ? "orientation" : "raw");
+            break;
+        case SENSOR_SET_FORMAT:
+            len += snprintf(response + len, size - len, "\"%s\"", mqtt_payload_format_name((mqtt_payload_format_t)values[k]));
+            break;
+        case SENSOR_SET_ACCEL_RANGE:
+            len += snprintf(response + len, size - len, "%u", mpu6050_accel_range_to_g(config.accel_range));
+            break;
+        case SENSOR_SET_GYRO_RANGE:
+            len += snprintf(response + len, size - len, "%u", mpu6050_gyro_range_to_dps(config.gyro_range));
+            break;
+        case SENSOR_SET_DLPF:
+            len += snprintf(response + len, size - len, "%u", mpu6050_dlpf_to_hz(config.dlpf));
+            break;
+        case SENSOR_SET_RATE:
+            len += snprintf(response + len, size - len, "%u", config.sample_rate_hz);
+            break;
+        default:
+            len += snprintf(response + len, size - len, "%lu", (unsigned long)values[k]);
+            break;
+        }
     }
+    if (len < (int)size) {
+        snprintf(response + len, size - len, "}}");
+    }
+    return ESP_OK;
 }
 
+// 명령 등록 표 (수집 / 발행 설정, MPU6050 설정, 벤치마크)
+static const command_def_t sensor_commands[] = {
+    { "INTERVAL", sensor_cmd_interval },
+    { "PERIOD_US", sensor_cmd_period_us },
+    { "SET", sensor_cmd_set },
+    { "OUTPUT", sensor_cmd_output },
+    { "DSP_BENCH", sensor_cmd_dsp_bench },
+    { "FUSION_BENCH", sensor_cmd_fusion_bench },
+    { "QUEUE_STATS", sensor_cmd_queue_stats },
+    { "RBE", sensor_cmd_rbe },
+    { "CALIBRATE", sensor_cmd_calibrate },
+    { "ACCEL_RANGE", sensor_cmd_mpu6050_config },
+    { "GYRO_RANGE", sensor_cmd_mpu6050_config },
+    { "DLPF", sensor_cmd_mpu6050_config },
+    { "RATE", sensor_cmd_mpu6050_config },
+};
+
 /**
- * @brief 센서 태스크 시작
+ * @brief 수집 태스크와 발행 태스크 시작
  */
 void sensor_task_start(void)
 {
-    xTaskCreate(sensor_task, "sensor_task", 8192, NULL, 5, NULL);
-    ESP_LOGI(TAG_SENSOR, "Sensor task created");
+#if APP_STATIC_ALLOC
+    static StaticQueue_t queue_buffer;
+    static uint8_t queue_storage[SENSOR_QUEUE_LENGTH * sizeof(sensor_sample_msg_t)];
+    static StaticTask_t publish_task_buffer;
+    static StackType_t publish_task_stack[SENSOR_PUB_TASK_STACK_SIZE / sizeof(StackType_t)];
+    static StaticTask_t acq_task_buffer;
+    static StackType_t acq_task_stack[SENSOR_ACQ_TASK_STACK_SIZE / sizeof(StackType_t)];
+
+    sample_queue = xQueueCreateStatic(SENSOR_QUEUE_LENGTH, sizeof(sensor_sample_msg_t), queue_storage, &queue_buffer);
+#else
+    sample_queue = xQueueCreate(SENSOR_QUEUE_LENGTH, sizeof(sensor_sample_msg_t));
+#endif
+    if (sample_queue == NULL) {
+        ESP_LOGE(TAG_SENSOR, "Failed to create sample queue");
+        return;
+    }
+
+    // 발행 태스크는 Wi-Fi / MQTT와 같은 코어, 수집 태스크는 다른 코어에서 더 높은 우선순위로 실행
+#if APP_STATIC_ALLOC
+    sensor_publish_task_handle = xTaskCreateStaticPinnedToCore(sensor_publish_task, "sensor_pub",
+                                                               SENSOR_PUB_TASK_STACK_SIZE, NULL,
+                                                               SENSOR_PUB_TASK_PRIORITY, publish_task_stack,
+                                                               &publish_task_buffer,
+                                                               SENSOR_TASK_CORE(SENSOR_PUB_TASK_CORE));
+    sensor_task_handle = xTaskCreateStaticPinnedToCore(sensor_task, "sensor_task", SENSOR_ACQ_TASK_STACK_SIZE, NULL,
+                                                       SENSOR_ACQ_TASK_PRIORITY, acq_task_stack, &acq_task_buffer,
+                                                       SENSOR_TASK_CORE(SENSOR_ACQ_TASK_CORE));
+#else
+    xTaskCreatePinnedToCore(sensor_publish_task, "sensor_pub", SENSOR_PUB_TASK_STACK_SIZE, NULL,
+                            SENSOR_PUB_TASK_PRIORITY, &sensor_publish_task_handle,
+                            SENSOR_TASK_CORE(SENSOR_PUB_TASK_CORE));
+    xTaskCreatePinnedToCore(sensor_task, "sensor_task", SENSOR_ACQ_TASK_STACK_SIZE, NULL,
+                            SENSOR_ACQ_TASK_PRIORITY, &sensor_task_handle, SENSOR_TASK_CORE(SENSOR_ACQ_TASK_CORE));
+#endif
+
+    // 동적 할당 모드에서도 같은 크기를 힙에서 받으므로 함께 보고
+    metrics_add_ram_budget("sensor_tasks", SENSOR_PUB_TASK_STACK_SIZE + SENSOR_ACQ_TASK_STACK_SIZE +
+                                           2 * sizeof(StaticTask_t));
+    metrics_add_ram_budget("sample_queue", SENSOR_QUEUE_LENGTH * sizeof(sensor_sample_msg_t) + sizeof(StaticQueue_t));
+    metrics_add_ram_budget("sensor", SENSOR_FUSION_RAM + sizeof(rbe_state) + sizeof(sensor_sched) +
+                                     sizeof(sensor_devices) + sizeof(sample_seq) + sizeof(queue_stats));
+    metrics_add_ram_budget("dsp", SENSOR_DSP_RAM);
+    command_register(sensor_commands, sizeof(sensor_commands) / sizeof(sensor_commands[0]));
+    metrics_register_task(sensor_task_handle);
+    metrics_register_task(sensor_publish_task_handle);
+    ESP_LOGI(TAG_SENSOR, "Sensor tasks created (queue %d samples)", SENSOR_QUEUE_LENGTH);
 }
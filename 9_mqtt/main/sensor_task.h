@@ -7,10 +7,40 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
 #include "mpu6050.h"
+#include "sample_sched.h"
+
+// 수집 태스크 → 발행 태스크 샘플 큐 통계
+typedef struct {
+    uint32_t enqueued;      // 큐에 넣은 샘플 수
+    uint32_t published;     // 발행 태스크가 꺼내서 발행한 샘플 수
+    uint32_t dropped;       // 큐가 가득 차서 버린 새 샘플 수 (SENSOR_QUEUE_OVERWRITE 0)
+    uint32_t overwritten;   // 큐가 가득 차서 버린 가장 오래된 샘플 수 (SENSOR_QUEUE_OVERWRITE 1)
+    uint32_t peak_depth;    // 최대 대기 샘플 수
+} sensor_queue_stats_t;
+
+// 변화 기반 발행(report-by-exception) 설정
+typedef struct {
+    bool enabled;               // false: 모든 샘플 발행
+    float accel_deadband_g;     // 가속도 축별 변화 임계값 (g)
+    float gyro_deadband_dps;    // 각속도 축별 변화 임계값 (°/s)
+    uint32_t heartbeat_ms;      // 변화가 없어도 이 시간이 지나면 1샘플 발행
+} sensor_rbe_config_t;
+
+// 변화 기반 발행 통계 (부팅 이후 누적)
+typedef struct {
+    uint32_t published;         // 발행한 샘플 수 (변화 + heartbeat)
+    uint32_t suppressed;        // 데드밴드 안이라 버린 샘플 수
+    uint32_t heartbeats;        // 변화 없이 heartbeat로 발행한 샘플 수
+    uint32_t sleeps;            // 움직임이 없어 샘플링을 멈춘 횟수
+    uint32_t motion_wakeups;    // 움직임 감지 인터럽트로 깨어난 횟수
+    uint32_t sleep_ms;          // 샘플링을 멈춘 누적 시간
+} sensor_rbe_stats_t;
 
 /**
- * @brief 센서 태스크 시작
+ * @brief 수집 태스크와 발행 태스크 시작 (config.h의 코어에 고정)
  */
 void sensor_task_start(void);
 
@@ -36,4 +66,99 @@ void sensor_set_publish_interval(uint32_t interval_ms);
  */
 uint32_t sensor_get_publish_interval(void);
 
+/**
+ * @brief 폴링 모드 샘플 주기 설정 (1ms 미만 가능, 전송 주기도 같이 바뀜)
+ *
+ * @param period_us 샘플 주기 (µs), 최소 SENSOR_SCHED_MIN_PERIOD_US
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 너무 짧음, ESP_ERR_NOT_SUPPORTED 폴링 모드가 아님
+ */
+esp_err_t sensor_set_sample_period_us(uint32_t period_us);
+
+/**
+ * @brief 샘플링 주기 오차 통계 조회
+ *
+ * 폴링 모드는 샘플 간격, FIFO 모드는 FIFO를 비우는 간격, DATA_RDY 모드는 인터럽트 간격 기준입니다.
+ *
+ * @param stats 통계를 저장할 포인터
+ * @param reset true면 조회 후 새 구간 시작
+ */
+void sensor_get_sched_stats(sample_sched_stats_t *stats, bool reset);
+
+/**
+ * @brief 발행 데이터 선택
+ *
+ * @param enable true: 자세(쿼터니언, 오일러각), false: 6축 값
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_NOT_SUPPORTED 센서 퓨전이 꺼져 있음
+ */
+esp_err_t sensor_set_publish_orientation(bool enable);
+
+/**
+ * @brief 자세 발행 여부 조회
+ *
+ * @return true 자세 발행, false 6축 값 발행
+ */
+bool sensor_get_publish_orientation(void);
+
+/**
+ * @brief MPU6050 설정(범위, DLPF, 샘플링 주파수) 변경 요청
+ *
+ * 요청은 센서 태스크의 다음 루프에서 적용됩니다.
+ *
+ * @param config 적용할 설정
+ */
+void sensor_request_mpu6050_config(const mpu6050_config_t *config);
+
+/**
+ * @brief MPU6050 재보정 요청
+ *
+ * 센서 태스크의 다음 루프에서 보정을 수행하고 NVS에 저장한 뒤 응답 토픽으로 결과를 발행합니다.
+ */
+void sensor_request_calibration(void);
+
+/**
+ * @brief MPU6050 설정 조회
+ *
+ * @param config 설정을 저장할 포인터 (적용 대기 중인 요청이 있으면 그 값)
+ */
+void sensor_get_mpu6050_config(mpu6050_config_t *config);
+
+/**
+ * @brief 변화 기반 발행 설정 변경 요청 (센서 태스크의 다음 루프에서 적용)
+ *
+ * @param config 적용할 설정
+ * @return esp_err_t ESP_OK 성공, ESP_ERR_INVALID_ARG 음수 임계값 또는 heartbeat 100ms 미만
+ */
+esp_err_t sensor_set_rbe_config(const sensor_rbe_config_t *config);
+
+/**
+ * @brief 변화 기반 발행 설정 조회
+ *
+ * @param config 설정을 저장할 포인터 (적용 대기 중인 요청이 있으면 그 값)
+ */
+void sensor_get_rbe_config(sensor_rbe_config_t *config);
+
+/**
+ * @brief 변화 기반 발행 통계 조회
+ *
+ * @param stats 통계를 저장할 포인터
+ */
+void sensor_get_rbe_stats(sensor_rbe_stats_t *stats);
+
+/**
+ * @brief 현재 설정의 DSP 필터 처리 속도 측정
+ *
+ * 실행 중인 필터와 별개의 인스턴스로 합성 데이터를 처리합니다.
+ *
+ * @param block_size 블록당 샘플 수 (최대 DSP_BLOCK_MAX_SAMPLES)
+ * @return 6축 샘플 1개당 CPU 사이클 (DSP가 꺼져 있거나 실패 시 0)
+ */
+uint32_t sensor_dsp_benchmark(size_t block_size);
+
+/**
+ * @brief 샘플 큐 통계 조회
+ *
+ * @param stats 통계를 저장할 포인터
+ */
+void sensor_get_queue_stats(sensor_queue_stats_t *stats);
+
 #endif // SENSOR_TASK_H
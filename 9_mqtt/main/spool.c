@@ -0,0 +1,413 @@
+/* 오프라인 스풀 구현 */
+
+#include "spool.h"
+#include "metrics.h"
+#include "command_handler.h"
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#if CONFIG_IDF_TARGET_LINUX
+#include <errno.h>
+#else
+#include "esp_spiffs.h"
+#endif
+
+#define SPOOL_RECORD_SIZE sizeof(spool_record_t)
+#define SPOOL_SEGMENT_RECORDS (SPOOL_SEGMENT_BLOCKS * SPOOL_BLOCK_RECORDS)
+
+_Static_assert(sizeof(spool_record_t) == 32, "Spool record layout changed, old segments would be misread");
+_Static_assert(SPOOL_BLOCK_RECORDS <= SPOOL_RAM_RECORDS, "Spool block must fit in the RAM ring");
+
+// RAM 링 (가장 최근 샘플)
+static spool_record_t ram_ring[SPOOL_RAM_RECORDS];
+static size_t ram_head = 0;     // 다음에 쓸 위치
+static size_t ram_count = 0;
+
+// 플래시에 쓸 블록을 모으는 버퍼 (링이 한 바퀴 돌아도 한 번에 쓰도록)
+static spool_record_t block_buf[SPOOL_BLOCK_RECORDS];
+
+// 플래시 세그먼트 (seg_first ~ seg_last 파일, seg_first부터 읽고 seg_last에 이어 씀)
+static bool flash_ok = false;
+static uint32_t seg_first = 0;
+static uint32_t seg_last = 0;
+static size_t seg_last_records = 0;     // 쓰는 중인 세그먼트의 샘플 수
+static size_t read_offset = 0;          // seg_first에서 이미 재전송한 샘플 수
+static uint32_t flash_records = 0;
+
+// 마지막 spool_peek()이 플래시에서 읽었는지 (spool_consume()에서 사용)
+static bool peek_from_flash = false;
+
+static spool_stats_t stats;
+
+// 기록 형식이 바뀌면 파일 이름도 바꿔서 이전 형식의 세그먼트를 읽지 않도록 함 (seg*.bin: 물리 단위 48바이트)
+static void segment_path(uint32_t index, char *path, size_t size)
+{
+    snprintf(path, size, "%s/raw%05lu.bin", SPOOL_BASE_PATH, (unsigned long)index);
+}
+
+/**
+ * @brief 세그먼트 파일의 샘플 수 (쓰다가 끊긴 마지막 샘플은 제외)
+ */
+static size_t segment_records(uint32_t index)
+{
+    char path[64];
+    struct stat st;
+
+    segment_path(index, path, sizeof(path));
+    if (stat(path, &st) != 0) {
+        return 0;
+    }
+    return st.st_size / SPOOL_RECORD_SIZE;
+}
+
+/**
+ * @brief 가장 오래된 세그먼트 삭제 (남은 샘플은 버림 또는 재전송 완료)
+ */
+static void segment_remove_first(void)
+{
+    char path[64];
+    segment_path(seg_first, path, sizeof(path));
+    remove(path);
+
+    if (seg_first == seg_last) {
+        // 마지막 세그먼트까지 비었으면 다음 번호부터 새로 시작
+        seg_last++;
+        seg_last_records = 0;
+    }
+    seg_first++;
+    read_offset = 0;
+}
+
+/**
+ * @brief 가장 오래된 세그먼트를 버려서 공간 확보
+ *
+ * @return 버릴 세그먼트가 있었는지
+ */
+static bool segment_drop_oldest(void)
+{
+    if (seg_first == seg_last) {
+        return false;
+    }
+
+    size_t total = segment_records(seg_first);
+    size_t remaining = total > read_offset ? total - read_offset : 0;
+    ESP_LOGW(TAG_MQTT, "Spool full, dropping segment %lu (%u samples)",
+             (unsigned long)seg_first, (unsigned)remaining);
+    stats.dropped += remaining;
+    flash_records -= remaining < flash_records ? remaining : flash_records;
+    segment_remove_first();
+    return true;
+}
+
+/**
+ * @brief 블록을 쓰는 중인 세그먼트 끝에 추가 (블록 하나 = fwrite 한 번)
+ *
+ * @return 기록한 샘플 수 (count보다 작으면 나머지는 버려짐)
+ */
+static size_t flash_write_block(const spool_record_t *records, size_t count)
+{
+    size_t total = 0;
+
+    if (flash_records == 0) {
+        // 비어 있으면 읽기 위치도 쓰는 세그먼트로 맞춤
+        seg_first = seg_last;
+        read_offset = 0;
+    }
+    if (seg_last_records + count > SPOOL_SEGMENT_RECORDS) {
+        seg_last++;
+        seg_last_records = 0;
+    }
+    if (seg_last - seg_first + 1 > SPOOL_MAX_SEGMENTS) {
+        segment_drop_oldest();
+    }
+
+    // 파티션이 가득 차서 실패하면 가장 오래된 세그먼트를 버리고 한 번 더 시도
+    for (int attempt = 0; attempt < 2 && total < count; attempt++) {
+        char path[64];
+        segment_path(seg_last, path, sizeof(path));
+
+        size_t written = 0;
+        FILE *f = fopen(path, "ab");
+        if (f != NULL) {
+            setvbuf(f, NULL, _IONBF, 0);
+            written = fwrite(records + total, SPOOL_RECORD_SIZE, count - total, f);
+            fclose(f);
+        }
+        total += written;
+        flash_records += written;
+        seg_last_records += written;
+        if (total == count) {
+            break;
+        }
+
+        // 일부만 쓰인 세그먼트에는 이어 쓰지 않음
+        ESP_LOGW(TAG_MQTT, "Spool write to %s stopped after %u samples", path, (unsigned)written);
+        seg_last++;
+        seg_last_records = 0;
+        if (!segment_drop_oldest()) {
+            break;
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief RAM 링이 가득 찼을 때 가장 오래된 블록을 플래시로 내보냄 (플래시가 없으면 가장 오래된 샘플을 버림)
+ */
+static void spool_spill(void)
+{
+    size_t tail = (ram_head + SPOOL_RAM_RECORDS - ram_count) % SPOOL_RAM_RECORDS;
+
+    if (!flash_ok) {
+        ram_count--;
+        stats.dropped++;
+        return;
+    }
+
+    for (size_t i = 0; i < SPOOL_BLOCK_RECORDS; i++) {
+        block_buf[i] = ram_ring[(tail + i) % SPOOL_RAM_RECORDS];
+    }
+    size_t written = flash_write_block(block_buf, SPOOL_BLOCK_RECORDS);
+    if (written < SPOOL_BLOCK_RECORDS) {
+        ESP_LOGE(TAG_MQTT, "Spool flash write failed, dropping %u samples", (unsigned)(SPOOL_BLOCK_RECORDS - written));
+        stats.dropped += SPOOL_BLOCK_RECORDS - written;
+    } else {
+        stats.flash_blocks++;
+    }
+    ram_count -= SPOOL_BLOCK_RECORDS;
+}
+
+/**
+ * @brief 이전 부팅에서 남은 세그먼트 찾기
+ */
+static void spool_scan_segments(void)
+{
+    DIR *dir = opendir(SPOOL_BASE_PATH);
+    if (dir == NULL) {
+        return;
+    }
+
+    bool found = false;
+    uint32_t first = 0, last = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned long index;
+        if (sscanf(entry->d_name, "seg%lu.bin", &index) == 1) {
+            // 이전 형식 세그먼트는 재전송할 수 없으므로 공간만 돌려받음
+            char path[64];
+            snprintf(path, sizeof(path), "%s/%s", SPOOL_BASE_PATH, entry->d_name);
+            remove(path);
+            ESP_LOGW(TAG_MQTT, "Spool removed old-format segment %s", entry->d_name);
+            continue;
+        }
+        if (sscanf(entry->d_name, "raw%lu.bin", &index) != 1) {
+            continue;
+        }
+        if (!found || index < first) {
+            first = index;
+        }
+        if (!found || index > last) {
+            last = index;
+        }
+        found = true;
+    }
+    closedir(dir);
+
+    if (!found) {
+        return;
+    }
+
+    seg_first = first;
+    seg_last = last;
+    for (uint32_t i = first; i <= last; i++) {
+        flash_records += segment_records(i);
+    }
+    seg_last_records = segment_records(last);
+    if (seg_last_records % SPOOL_BLOCK_RECORDS != 0) {
+        // 블록 중간에 끊긴 세그먼트에는 이어 쓰지 않음
+        seg_last_records = SPOOL_SEGMENT_RECORDS;
+    }
+    ESP_LOGI(TAG_MQTT, "Spool resumed %lu samples in segments %lu..%lu from previous boot",
+             (unsigned long)flash_records, (unsigned long)first, (unsigned long)last);
+}
+
+/**
+ * @brief SPOOL_STATS (연결이 끊긴 동안 보관 / 재전송 / 버린 샘플 수)
+ */
+static esp_err_t spool_cmd_stats(const command_t *cmd, char *response, size_t size)
+{
+    spool_stats_t stats;
+    spool_get_stats(&stats);
+    snprintf(response, size,
+             "{\"status\":\"ok\",\"spool\":{\"spooled\":%lu,\"replayed\":%lu,\"dropped\":%lu,"
+             "\"ram\":%lu,\"flash\":%lu,\"flash_blocks\":%lu,\"flash_ok\":%s}}",
+             (unsigned long)stats.spooled, (unsigned long)stats.replayed,
+             (unsigned long)stats.dropped, (unsigned long)stats.ram_records,
+             (unsigned long)stats.flash_records, (unsigned long)stats.flash_blocks,
+             stats.flash_ok ? "true" : "false");
+    return ESP_OK;
+}
+
+static const command_def_t spool_commands[] = {
+    { "SPOOL_STATS", spool_cmd_stats },
+};
+
+/**
+ * @brief 스풀 초기화
+ */
+esp_err_t spool_init(void)
+{
+    esp_err_t ret;
+
+    metrics_add_ram_budget("spool", sizeof(ram_ring) + sizeof(block_buf));
+    command_register(spool_commands, sizeof(spool_commands) / sizeof(spool_commands[0]));
+
+#if CONFIG_IDF_TARGET_LINUX
+    // 호스트 시뮬레이션: SPOOL_BASE_PATH 디렉터리를 그대로 사용
+    ret = (mkdir(SPOOL_BASE_PATH, 0755) == 0 || errno == EEXIST) ? ESP_OK : ESP_FAIL;
+#else
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = SPOOL_BASE_PATH,
+        .partition_label = SPOOL_PARTITION_LABEL,
+        .max_files = 2,
+        .format_if_mount_failed = true,
+    };
+    ret = esp_vfs_spiffs_register(&conf);
+#endif
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG_MQTT, "Spool flash unavailable (%s), using RAM ring only", esp_err_to_name(ret));
+        return ret;
+    }
+
+    flash_ok = true;
+    spool_scan_segments();
+    ESP_LOGI(TAG_MQTT, "Spool ready: RAM %d samples, flash %d x %d-sample segments at %s",
+             SPOOL_RAM_RECORDS, SPOOL_MAX_SEGMENTS, SPOOL_SEGMENT_RECORDS, SPOOL_BASE_PATH);
+    return ESP_OK;
+}
+
+/**
+ * @brief 샘플 하나 보관
+ */
+void spool_push(uint8_t device_id, uint32_t seq, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale)
+{
+    if (ram_count == SPOOL_RAM_RECORDS) {
+        spool_spill();
+    }
+
+    ram_ring[ram_head] = (spool_record_t) {
+        .raw = *raw,
+        .seq = seq,
+        .scale = *scale,
+    };
+    ram_ring[ram_head].raw.device_id = device_id;
+    ram_head = (ram_head + 1) % SPOOL_RAM_RECORDS;
+    ram_count++;
+    stats.spooled++;
+}
+
+/**
+ * @brief 가장 오래된 샘플부터 읽기 (플래시에 남은 샘플이 있으면 플래시 먼저)
+ */
+size_t spool_peek(spool_record_t *records, size_t max_count)
+{
+    for (;;) {
+        // 이미 다 읽은 세그먼트 정리 (중간 번호가 빠진 경우 포함)
+        while (flash_records > 0 && read_offset >= segment_records(seg_first) && seg_first != seg_last) {
+            segment_remove_first();
+        }
+        if (flash_records == 0) {
+            break;
+        }
+
+        size_t available = segment_records(seg_first);
+        size_t count = available > read_offset ? available - read_offset : 0;
+        if (count > max_count) {
+            count = max_count;
+        }
+
+        char path[64];
+        segment_path(seg_first, path, sizeof(path));
+        FILE *f = fopen(path, "rb");
+        if (f != NULL) {
+            if (fseek(f, (long)(read_offset * SPOOL_RECORD_SIZE), SEEK_SET) == 0) {
+                count = fread(records, SPOOL_RECORD_SIZE, count, f);
+            } else {
+                count = 0;
+            }
+            fclose(f);
+        } else {
+            count = 0;
+        }
+
+        if (count == 0) {
+            // 읽을 수 없는 세그먼트는 버리고 다음 세그먼트 (재귀 대신 반복: 스택 깊이가 세그먼트 수와 무관)
+            ESP_LOGW(TAG_MQTT, "Spool segment %s unreadable, skipping", path);
+            size_t remaining = available > read_offset ? available - read_offset : 0;
+            stats.dropped += remaining;
+            flash_records -= remaining < flash_records ? remaining : flash_records;
+            if (seg_first == seg_last) {
+                flash_records = 0;
+            }
+            segment_remove_first();
+            continue;
+        }
+        peek_from_flash = true;
+        return count;
+    }
+
+    size_t count = ram_count < max_count ? ram_count : max_count;
+    size_t tail = (ram_head + SPOOL_RAM_RECORDS - ram_count) % SPOOL_RAM_RECORDS;
+    for (size_t i = 0; i < count; i++) {
+        records[i] = ram_ring[(tail + i) % SPOOL_RAM_RECORDS];
+    }
+    peek_from_flash = false;
+    return count;
+}
+
+/**
+ * @brief 재전송한 샘플 제거
+ */
+void spool_consume(size_t count)
+{
+    if (peek_from_flash) {
+        if (count > flash_records) {
+            count = flash_records;
+        }
+        read_offset += count;
+        flash_records -= count;
+        if (flash_records == 0 || read_offset >= segment_records(seg_first)) {
+            segment_remove_first();
+        }
+    } else {
+        if (count > ram_count) {
+            count = ram_count;
+        }
+        ram_count -= count;
+    }
+    stats.replayed += count;
+}
+
+/**
+ * @brief 재전송할 샘플이 있는지 확인
+ */
+bool spool_pending(void)
+{
+    return ram_count > 0 || flash_records > 0;
+}
+
+/**
+ * @brief 스풀 통계 조회
+ */
+void spool_get_stats(spool_stats_t *out)
+{
+    *out = stats;
+    out->ram_records = ram_count;
+    out->flash_records = flash_records;
+    out->flash_ok = flash_ok;
+}
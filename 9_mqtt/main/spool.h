@@ -0,0 +1,86 @@
+/* 오프라인 스풀 헤더
+ * MQTT 연결이 끊긴 동안 발행하지 못한 6축 샘플을 보관했다가 다시 연결되면 재전송합니다.
+ *
+ * 짧은 끊김은 RAM 링(SPOOL_RAM_RECORDS)에서 처리하고, 링이 가득 차면 가장 오래된
+ * SPOOL_BLOCK_RECORDS개를 한 번에 플래시(SPIFFS 'spool' 파티션)의 세그먼트 파일로 내보냅니다.
+ * 꺼낼 때는 항상 가장 오래된 샘플부터 (플래시 → RAM 순서) 나옵니다.
+ *
+ * 발행 태스크에서만 호출합니다 (통계 조회 제외).
+ */
+
+#ifndef SPOOL_H
+#define SPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "mpu6050.h"
+
+// 보관 단위 (플래시에도 이 형식 그대로 기록, 32바이트)
+typedef struct {
+    mpu6050_raw_sample_t raw;   // 보정 적용된 LSB + 캡처 시각(부팅 후 µs) + 디바이스 번호
+    uint32_t seq;               // 디바이스별 샘플 번호
+    mpu6050_scale_t scale;      // 캡처 시점 측정 범위 (재전송할 때 같은 감도로 변환)
+    uint8_t reserved[2];
+} spool_record_t;
+
+// 스풀 통계
+typedef struct {
+    uint32_t spooled;       // 보관한 샘플 수
+    uint32_t replayed;      // 재전송한 샘플 수
+    uint32_t dropped;       // 공간이 없어 버린 샘플 수 (가장 오래된 샘플부터)
+    uint32_t flash_blocks;  // 플래시에 쓴 블록 수
+    uint32_t ram_records;   // 현재 RAM 링에 있는 샘플 수
+    uint32_t flash_records; // 현재 플래시에 있는 샘플 수
+    bool flash_ok;          // 플래시 파티션 사용 가능 여부
+} spool_stats_t;
+
+/**
+ * @brief 스풀 초기화 (SPIFFS 마운트, 이전 부팅에서 남은 세그먼트 이어서 사용)
+ *
+ * 플래시를 사용할 수 없으면 RAM 링만 사용합니다.
+ *
+ * @return esp_err_t ESP_OK 성공, 그 외 플래시 마운트 실패 (RAM 링은 사용 가능)
+ */
+esp_err_t spool_init(void);
+
+/**
+ * @brief 샘플 하나 보관
+ *
+ * @param device_id 디바이스 번호
+ * @param seq 샘플 번호
+ * @param raw 6축 raw 샘플 (캡처 시각 포함)
+ * @param scale 캡처 시점 측정 범위
+ */
+void spool_push(uint8_t device_id, uint32_t seq, const mpu6050_raw_sample_t *raw, const mpu6050_scale_t *scale);
+
+/**
+ * @brief 가장 오래된 샘플부터 꺼내지 않고 읽기
+ *
+ * @param records 결과를 저장할 배열
+ * @param max_count 최대 개수
+ * @return 읽은 샘플 수 (0: 비어 있음)
+ */
+size_t spool_peek(spool_record_t *records, size_t max_count);
+
+/**
+ * @brief spool_peek()로 읽은 샘플 중 앞의 count개 제거 (재전송 완료)
+ *
+ * @param count 제거할 샘플 수
+ */
+void spool_consume(size_t count);
+
+/**
+ * @brief 재전송할 샘플이 있는지 확인
+ */
+bool spool_pending(void);
+
+/**
+ * @brief 스풀 통계 조회
+ *
+ * @param stats 통계를 저장할 포인터
+ */
+void spool_get_stats(spool_stats_t *stats);
+
+#endif // SPOOL_H
@@ -0,0 +1,278 @@
+/* 바이너리 텔레메트리 인코더 구현 */
+
+#include "telemetry.h"
+
+static const uint16_t accel_lsb_per_g[] = { 16384, 8192, 4096, 2048 };
+static const uint16_t gyro_lsb_per_dps_x10[] = { 1310, 655, 328, 164 };
+
+// 리틀 엔디안 쓰기 (정렬과 호스트 엔디안에 무관)
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, (uint16_t)v);
+    return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static uint8_t *put_u64(uint8_t *p, uint64_t v)
+{
+    p = put_u32(p, (uint32_t)v);
+    return put_u32(p, (uint32_t)(v >> 32));
+}
+
+/**
+ * @brief 샘플 하나의 LSB 값 7개 (accel x/y/z, temp, gyro x/y/z 순서)
+ */
+static void sample_axes(const mpu6050_raw_sample_t *s, int16_t out[TELEMETRY_AXES])
+{
+    out[0] = s->accel_x;
+    out[1] = s->accel_y;
+    out[2] = s->accel_z;
+    out[3] = s->temp;
+    out[4] = s->gyro_x;
+    out[5] = s->gyro_y;
+    out[6] = s->gyro_z;
+}
+
+static uint8_t *put_header(uint8_t *p, const telemetry_meta_t *meta, uint8_t flags, size_t count)
+{
+    *p++ = TELEMETRY_MAGIC;
+    *p++ = TELEMETRY_VERSION;
+    *p++ = meta->device_id;
+    *p++ = flags;
+    p = put_u16(p, (uint16_t)count);
+    p = put_u16(p, meta->accel_lsb_per_g);
+    p = put_u16(p, meta->gyro_lsb_per_dps_x10);
+    p = put_u64(p, (uint64_t)meta->base_us);
+    return put_u32(p, meta->first_seq);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+// LEB128 varint (7비트씩, 하위 바이트 먼저)
+static uint8_t *put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v)
+{
+    uint64_t result = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t byte = *p++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// 부호 있는 값을 작은 절댓값이 작은 부호 없는 값이 되도록 변환 (0, -1, 1, -2, ... → 0, 1, 2, 3, ...)
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/**
+ * @brief 측정 범위에 맞는 감도로 메시지 정보 채우기
+ */
+void telemetry_meta_init(uint8_t device_id, const mpu6050_scale_t *scale, int64_t base_us,
+                         uint32_t first_seq, telemetry_meta_t *meta)
+{
+    meta->device_id = device_id;
+    meta->accel_lsb_per_g = accel_lsb_per_g[scale->accel_range & 0x03];
+    meta->gyro_lsb_per_dps_x10 = gyro_lsb_per_dps_x10[scale->gyro_range & 0x03];
+    meta->base_us = base_us;
+    meta->first_seq = first_seq;
+}
+
+/**
+ * @brief Raw 샘플을 바이너리 메시지로 인코딩
+ */
+size_t telemetry_encode(const telemetry_meta_t *meta, const mpu6050_raw_sample_t *samples,
+                        const uint32_t *offset_us, size_t count, uint8_t *buf, size_t size)
+{
+    const size_t total = telemetry_encoded_size(count);
+    if (count > UINT16_MAX || total > size) {
+        return 0;
+    }
+
+    uint8_t *p = put_header(buf, meta, 0, count);
+
+    for (size_t i = 0; i < count; i++) {
+        int16_t raw[TELEMETRY_AXES];
+        sample_axes(&samples[i], raw);
+        p = put_u32(p, offset_us ? offset_us[i] : 0);
+        for (int axis = 0; axis < TELEMETRY_AXES; axis++) {
+            p = put_u16(p, (uint16_t)raw[axis]);
+        }
+    }
+
+    return total;
+}
+
+/**
+ * @brief 델타 압축 인코딩 시작
+ */
+bool telemetry_delta_begin(telemetry_delta_encoder_t *enc, const telemetry_meta_t *meta, uint8_t *buf, size_t size)
+{
+    if (size < TELEMETRY_HEADER_SIZE) {
+        return false;
+    }
+
+    *enc = (telemetry_delta_encoder_t) {
+        .buf = buf,
+        .size = size,
+        .len = TELEMETRY_HEADER_SIZE,
+    };
+    put_header(buf, meta, TELEMETRY_FLAG_DELTA, 0);
+    return true;
+}
+
+/**
+ * @brief 델타 압축 인코더에 샘플 하나 추가
+ */
+bool telemetry_delta_add(telemetry_delta_encoder_t *enc, const mpu6050_raw_sample_t *sample, uint32_t offset_us)
+{
+    // 최악의 경우 크기로 확인해서 샘플 중간에 잘리지 않도록 함
+    if (enc->size - enc->len < TELEMETRY_DELTA_SAMPLE_MAX_SIZE || enc->count == UINT16_MAX) {
+        return false;
+    }
+
+    int16_t raw[TELEMETRY_AXES];
+    sample_axes(sample, raw);
+
+    // 시각은 간격의 변화량 (샘플링 주기가 일정하면 0)
+    uint8_t *p = enc->buf + enc->len;
+    const int64_t step_us = (int64_t)offset_us - enc->prev_offset_us;
+    p = put_varint(p, zigzag(step_us - enc->prev_step_us));
+    enc->prev_offset_us = offset_us;
+    enc->prev_step_us = step_us;
+
+    for (int axis = 0; axis < TELEMETRY_AXES; axis++) {
+        p = put_varint(p, zigzag((int32_t)raw[axis] - enc->prev[axis]));
+        enc->prev[axis] = raw[axis];
+    }
+
+    enc->len = p - enc->buf;
+    enc->count++;
+    return true;
+}
+
+/**
+ * @brief 델타 압축 인코딩 완료
+ */
+size_t telemetry_delta_finish(telemetry_delta_encoder_t *enc)
+{
+    put_u16(enc->buf + 4, enc->count);
+    return enc->len;
+}
+
+/**
+ * @brief 샘플 배열을 델타 압축 메시지로 인코딩
+ */
+size_t telemetry_encode_delta(const telemetry_meta_t *meta, const mpu6050_raw_sample_t *samples,
+                              const uint32_t *offset_us, size_t count, uint8_t *buf, size_t size)
+{
+    telemetry_delta_encoder_t enc;
+
+    if (!telemetry_delta_begin(&enc, meta, buf, size)) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!telemetry_delta_add(&enc, &samples[i], offset_us ? offset_us[i] : 0)) {
+            return 0;
+        }
+    }
+    return telemetry_delta_finish(&enc);
+}
+
+/**
+ * @brief 바이너리 메시지 디코딩
+ */
+bool telemetry_decode(const uint8_t *buf, size_t len, telemetry_meta_t *meta, int16_t (*raw)[TELEMETRY_AXES],
+                      uint32_t *offset_us, size_t max_count, size_t *count)
+{
+    if (len < TELEMETRY_HEADER_SIZE || buf[0] != TELEMETRY_MAGIC || buf[1] != TELEMETRY_VERSION ||
+        (buf[3] & ~TELEMETRY_FLAG_DELTA) != 0) {
+        return false;
+    }
+
+    const size_t n = get_u16(buf + 4);
+    if (n > max_count) {
+        return false;
+    }
+    meta->device_id = buf[2];
+    meta->accel_lsb_per_g = get_u16(buf + 6);
+    meta->gyro_lsb_per_dps_x10 = get_u16(buf + 8);
+    meta->base_us = (int64_t)(get_u32(buf + 10) | ((uint64_t)get_u32(buf + 14) << 32));
+    meta->first_seq = get_u32(buf + 18);
+
+    const uint8_t *p = buf + TELEMETRY_HEADER_SIZE;
+    const uint8_t *end = buf + len;
+
+    if (!(buf[3] & TELEMETRY_FLAG_DELTA)) {
+        if (len != telemetry_encoded_size(n)) {
+            return false;
+        }
+        for (size_t i = 0; i < n; i++, p += TELEMETRY_SAMPLE_SIZE) {
+            if (offset_us) {
+                offset_us[i] = get_u32(p);
+            }
+            for (int axis = 0; axis < TELEMETRY_AXES; axis++) {
+                raw[i][axis] = (int16_t)get_u16(p + 4 + 2 * axis);
+            }
+        }
+        *count = n;
+        return true;
+    }
+
+    int64_t offset = 0;
+    int64_t step = 0;
+    int32_t prev[TELEMETRY_AXES] = {0};
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v;
+        if ((p = get_varint(p, end, &v)) == NULL) {
+            return false;
+        }
+        step += unzigzag(v);
+        offset += step;
+        if (offset_us) {
+            offset_us[i] = (uint32_t)offset;
+        }
+        for (int axis = 0; axis < TELEMETRY_AXES; axis++) {
+            if ((p = get_varint(p, end, &v)) == NULL) {
+                return false;
+            }
+            prev[axis] += (int32_t)unzigzag(v);
+            raw[i][axis] = (int16_t)prev[axis];
+        }
+    }
+    *count = n;
+    return p == end;
+}
@@ -0,0 +1,169 @@
+/* 바이너리 텔레메트리 인코더 헤더
+ * MPU6050 raw 샘플(보정 적용된 LSB)을 리틀 엔디안 int16로 묶는 버전 있는 형식 (JSON 대비 약 1/5 크기)
+ * 샘플 값은 다시 양자화하지 않고 그대로 쓰며, 헤더의 감도는 캡처 시점 측정 범위로 채웁니다.
+ * 형식이 바뀌면 TELEMETRY_VERSION을 올리고 tools/telemetry_codec.py도 함께 수정해야 합니다.
+ *
+ * 헤더 (22바이트)
+ *   0  u8   magic (0xA6, JSON의 '{'와 구분)
+ *   1  u8   version
+ *   2  u8   device_id
+ *   3  u8   flags (TELEMETRY_FLAG_*)
+ *   4  u16  샘플 수
+ *   6  u16  가속도 감도 (LSB/g)
+ *   8  u16  자이로 감도 x10 (LSB/(°/s) x 10)
+ *   10 i64  base_us (첫 샘플 캡처 시각, 부팅 후 µs)
+ *   18 u32  첫 샘플 번호 (디바이스별, 메시지 안의 샘플 번호는 연속)
+ *
+ * 샘플 (18바이트, 헤더 뒤에 연속)
+ *   0  u32  offset_us (base_us 기준 상대 시각)
+ *   4  i16  accel x, y, z (LSB)
+ *   10 i16  temp (LSB, °C = temp / 340 + 36.53)
+ *   12 i16  gyro x, y, z (LSB)
+ *
+ * 델타 압축 (flags에 TELEMETRY_FLAG_DELTA, 헤더 뒤에 샘플마다 가변 길이)
+ *   varint  zigzag(offset_us 간격의 변화량)   (간격이 일정하면 1바이트)
+ *   varint  zigzag(이전 샘플 대비 변화량) x 7 (accel x/y/z, temp, gyro x/y/z 순서, 첫 샘플은 0 기준)
+ *   varint는 LEB128 (7비트씩, 하위 바이트 먼저), 샘플 하나는 최대 TELEMETRY_DELTA_SAMPLE_MAX_SIZE 바이트
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mpu6050.h"
+
+#define TELEMETRY_MAGIC 0xA6
+#define TELEMETRY_VERSION 2
+#define TELEMETRY_HEADER_SIZE 22
+#define TELEMETRY_SAMPLE_SIZE 18
+#define TELEMETRY_DELTA_SAMPLE_MAX_SIZE 26  // 시각 5바이트 + 축 7 x 3바이트
+#define TELEMETRY_AXES 7
+
+// flags
+#define TELEMETRY_FLAG_DELTA 0x01
+
+// 인코딩할 메시지 정보
+typedef struct {
+    uint8_t device_id;
+    uint16_t accel_lsb_per_g;       // 16384 (±2g) ~ 2048 (±16g)
+    uint16_t gyro_lsb_per_dps_x10;  // 1310 (±250°/s) ~ 164 (±2000°/s)
+    int64_t base_us;
+    uint32_t first_seq;             // 첫 샘플 번호
+} telemetry_meta_t;
+
+// 델타 압축 스트리밍 인코더 (버퍼는 호출자가 제공, 동적 할당 없음)
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t len;
+    uint16_t count;
+    int16_t prev[TELEMETRY_AXES];
+    uint32_t prev_offset_us;
+    int64_t prev_step_us;
+} telemetry_delta_encoder_t;
+
+/**
+ * @brief 측정 범위에 맞는 감도로 메시지 정보 채우기
+ *
+ * @param device_id 디바이스 번호
+ * @param scale 샘플을 캡처한 시점의 측정 범위 (가속도/자이로)
+ * @param base_us 첫 샘플 캡처 시각
+ * @param first_seq 첫 샘플 번호
+ * @param meta 결과를 저장할 포인터
+ */
+void telemetry_meta_init(uint8_t device_id, const mpu6050_scale_t *scale, int64_t base_us,
+                         uint32_t first_seq, telemetry_meta_t *meta);
+
+/**
+ * @brief 인코딩 결과 크기
+ *
+ * @param count 샘플 수
+ * @return 바이트 수
+ */
+static inline size_t telemetry_encoded_size(size_t count)
+{
+    return TELEMETRY_HEADER_SIZE + count * TELEMETRY_SAMPLE_SIZE;
+}
+
+/**
+ * @brief 델타 압축 결과 최대 크기 (버퍼를 이만큼 주면 항상 성공)
+ *
+ * @param count 샘플 수
+ * @return 바이트 수
+ */
+static inline size_t telemetry_delta_max_size(size_t count)
+{
+    return TELEMETRY_HEADER_SIZE + count * TELEMETRY_DELTA_SAMPLE_MAX_SIZE;
+}
+
+/**
+ * @brief Raw 샘플을 바이너리 메시지로 인코딩 (LSB 값을 그대로 기록)
+ *
+ * @param meta 메시지 정보 (샘플을 캡처한 시점의 감도)
+ * @param samples Raw 샘플 배열 (캡처 시각과 디바이스 번호는 쓰지 않음)
+ * @param offset_us 샘플별 base_us 기준 상대 시각 (NULL이면 모두 0)
+ * @param count 샘플 수 (최대 65535)
+ * @param buf 출력 버퍼
+ * @param size 출력 버퍼 크기
+ * @return 인코딩한 바이트 수 (버퍼가 작으면 0)
+ */
+size_t telemetry_encode(const telemetry_meta_t *meta, const mpu6050_raw_sample_t *samples,
+                        const uint32_t *offset_us, size_t count, uint8_t *buf, size_t size);
+
+/**
+ * @brief 델타 압축 인코딩 시작 (헤더 기록)
+ *
+ * @param enc 인코더 상태
+ * @param meta 메시지 정보
+ * @param buf 출력 버퍼 (인코딩이 끝날 때까지 유지)
+ * @param size 출력 버퍼 크기
+ * @return true 성공, false 버퍼가 헤더보다 작음
+ */
+bool telemetry_delta_begin(telemetry_delta_encoder_t *enc, const telemetry_meta_t *meta, uint8_t *buf, size_t size);
+
+/**
+ * @brief 델타 압축 인코더에 샘플 하나 추가
+ *
+ * 남은 공간이 최악의 경우 크기보다 작거나 샘플 수가 65535개면 추가하지 않습니다.
+ *
+ * @param enc 인코더 상태
+ * @param sample Raw 샘플
+ * @param offset_us base_us 기준 상대 시각
+ * @return true 추가됨, false 공간 부족
+ */
+bool telemetry_delta_add(telemetry_delta_encoder_t *enc, const mpu6050_raw_sample_t *sample, uint32_t offset_us);
+
+/**
+ * @brief 델타 압축 인코딩 완료 (헤더의 샘플 수 기록)
+ *
+ * @param enc 인코더 상태
+ * @return 메시지 전체 바이트 수
+ */
+size_t telemetry_delta_finish(telemetry_delta_encoder_t *enc);
+
+/**
+ * @brief 샘플 배열을 델타 압축 메시지로 인코딩 (begin / add / finish를 한 번에)
+ *
+ * @return 인코딩한 바이트 수 (버퍼가 작아 일부 샘플이 빠지면 0)
+ */
+size_t telemetry_encode_delta(const telemetry_meta_t *meta, const mpu6050_raw_sample_t *samples,
+                              const uint32_t *offset_us, size_t count, uint8_t *buf, size_t size);
+
+/**
+ * @brief 바이너리 메시지 디코딩 (일반 / 델타 압축 모두)
+ *
+ * @param buf 메시지
+ * @param len 메시지 길이
+ * @param meta 헤더 정보를 저장할 포인터
+ * @param raw 샘플별 LSB 값 (accel x/y/z, temp, gyro x/y/z)
+ * @param offset_us 샘플별 상대 시각 (NULL 가능)
+ * @param max_count raw / offset_us 배열 크기
+ * @param count 디코딩한 샘플 수
+ * @return true 성공, false 형식 오류 또는 배열이 작음
+ */
+bool telemetry_decode(const uint8_t *buf, size_t len, telemetry_meta_t *meta, int16_t (*raw)[TELEMETRY_AXES],
+                      uint32_t *offset_us, size_t max_count, size_t *count);
+
+#endif // TELEMETRY_H
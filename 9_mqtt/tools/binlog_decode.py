@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""바이너리 로그 디코더 (main/binlog.h 형식)
+
+디바이스는 ESP_LOGx를 문자열로 만들지 않고 형식 문자열 주소와 인자 원본만 보내므로,
+같은 빌드의 ELF에서 형식 문자열(과 플래시에 있는 %s 문자열)을 찾아 원래 로그 줄을 복원합니다.
+
+사용법:
+  python3 binlog_decode.py decode build/9_mqtt.elf monitor.log     # 저장한 콘솔 출력 (BINLOG: 줄만 복원, 나머지는 그대로)
+  python3 binlog_decode.py decode build/9_mqtt.elf --port /dev/ttyUSB0   # 시리얼 직접 읽기 (pyserial 필요)
+  idf.py monitor | python3 binlog_decode.py decode build/9_mqtt.elf      # 표준 입력
+  python3 binlog_decode.py listen build/9_mqtt.elf --host 127.0.0.1     # esp32/log 구독 (paho-mqtt 필요)
+
+ELF가 디바이스 빌드와 다르면 binlog_anchor 주소가 맞지 않아 경고를 출력합니다.
+호스트 시뮬레이션(PIE 실행 파일)은 같은 방법으로 로드 주소 차이를 계산해서 보정합니다.
+"""
+
+import argparse
+import base64
+import re
+import struct
+import sys
+
+FRAME_MAGIC = b"BL"
+VERSION = 1
+LINE_PREFIX = "BINLOG:"
+FLAG_TRUNCATED = 0x01
+STRING_IN_FLASH = 0xFF
+
+# 디바이스 binlog_put_args()와 같은 변환 지정자 규칙
+SPEC = re.compile(r"%%|%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                  r"(?P<len>hh|h|ll|l|q|j|z|t|L)?(?P<conv>[diouxXcsfFeEgGaApn])")
+
+SHF_ALLOC = 0x2
+SHT_SYMTAB = 2
+SHT_NOBITS = 8
+
+
+class Elf:
+    """할당 섹션 읽기와 심볼 찾기만 하는 최소 ELF 파서 (32 / 64비트, 리틀 엔디언)"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[5] != 1:
+            raise ValueError(f"{path}: not a little-endian ELF file")
+        self.is64 = self.data[4] == 2
+        if self.is64:
+            shoff, = struct.unpack_from("<Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x3A)
+            shdr = struct.Struct("<IIQQQQIIQQ")
+        else:
+            shoff, = struct.unpack_from("<I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+            shdr = struct.Struct("<IIIIIIIIII")
+
+        # (이름 위치, 종류, 플래그, 주소, 파일 위치, 크기, link)
+        sections = [shdr.unpack_from(self.data, shoff + i * shentsize)[:7] for i in range(shnum)]
+        self.regions = [(addr, size, offset) for _, stype, flags, addr, offset, size, _ in sections
+                        if flags & SHF_ALLOC and stype != SHT_NOBITS and addr != 0]
+        self.anchor = None
+        for _, stype, _, _, offset, size, link in sections:
+            if stype == SHT_SYMTAB:
+                self.anchor = self._find_symbol(offset, size, sections[link][4], "binlog_anchor")
+
+    def _find_symbol(self, offset, size, strtab, wanted):
+        sym = struct.Struct("<IBBHQQ" if self.is64 else "<IIIBBH")
+        name_bytes = wanted.encode() + b"\0"
+        for pos in range(offset, offset + size, sym.size):
+            fields = sym.unpack_from(self.data, pos)
+            name = fields[0]
+            if self.data[strtab + name:strtab + name + len(name_bytes)] == name_bytes:
+                return fields[4] if self.is64 else fields[1]
+        return None
+
+    def string(self, addr):
+        for start, size, offset in self.regions:
+            if start <= addr < start + size:
+                pos = offset + addr - start
+                end = self.data.find(b"\0", pos, offset + size)
+                return self.data[pos:end if end >= 0 else offset + size].decode("utf-8", "replace")
+        return None
+
+
+class _Args:
+    """레코드 인자 읽기 (부족하면 IndexError)"""
+
+    def __init__(self, data, ptr_size):
+        self.data = data
+        self.pos = 0
+        self.ptr_size = ptr_size
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise IndexError
+        chunk = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return chunk
+
+    def int(self, size, signed):
+        return int.from_bytes(self.take(size), "little", signed=signed)
+
+    def double(self):
+        return struct.unpack("<d", self.take(8))[0]
+
+
+def _int_size(length, ptr_size):
+    if length in ("ll", "q", "j"):
+        return 8
+    if length in ("l", "z", "t"):
+        return ptr_size     # long / size_t / ptrdiff_t (ESP32 4바이트, 64비트 호스트 8바이트)
+    return 4
+
+
+def format_record(fmt, data, ptr_size, elf, slide):
+    """형식 문자열과 인자 원본으로 printf 결과 만들기
+
+    Returns:
+        (문자열, 인자가 모자랐는지)
+    """
+    args = _Args(data, ptr_size)
+    out = []
+    last = 0
+    missing = False
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        if m.group(0) == "%%":
+            out.append("%")
+            continue
+        if missing:
+            out.append("<?>")
+            continue
+
+        flags, width, prec, length, conv = m.group("flags", "width", "prec", "len", "conv")
+        try:
+            if width == "*":
+                width = args.int(4, True)
+                if width < 0:
+                    flags, width = flags + "-", -width
+                width = str(width)
+            if prec == "*":
+                prec = args.int(4, True)
+                prec = None if prec < 0 else str(prec)
+            spec = "%" + flags + (width or "") + ("." + (prec or "0") if prec is not None else "")
+
+            if conv in "diouxXc":
+                value = args.int(_int_size(length, ptr_size), conv in "di")
+                out.append((spec + ("d" if conv in "iu" else conv)) % value)
+            elif conv in "fFeEgG":
+                out.append((spec + conv) % args.double())
+            elif conv in "aA":
+                text = args.double().hex()
+                out.append(("%" + flags + (width or "") + "s") % (text.upper() if conv == "A" else text))
+            elif conv == "s":
+                n = args.int(1, False)
+                if n == STRING_IN_FLASH:
+                    addr = args.int(ptr_size, False)
+                    text = elf.string(addr - slide)
+                    text = f"<0x{addr:x}>" if text is None else text
+                else:
+                    text = args.take(n).decode("utf-8", "replace")
+                out.append((spec + "s") % text)
+            elif conv == "p":
+                out.append("0x%x" % args.int(ptr_size, False))
+        except IndexError:
+            missing = True
+            out.append("<?>")
+    out.append(fmt[last:])
+    return "".join(out), missing
+
+
+class Decoder:
+    """프레임 → 로그 줄"""
+
+    def __init__(self, elf, timestamps=False):
+        self.elf = elf
+        self.timestamps = timestamps
+        self.dropped = 0
+        self.warned = False
+
+    def frame(self, frame):
+        if len(frame) < 8 or frame[:2] != FRAME_MAGIC or frame[2] != VERSION:
+            raise ValueError("not a binlog frame")
+        ptr_size = frame[3]
+        dropped, = struct.unpack_from("<I", frame, 4)
+        anchor = int.from_bytes(frame[8:8 + ptr_size], "little")
+        slide = anchor - self.elf.anchor if self.elf.anchor is not None else 0
+        # 디바이스는 주소 그대로, 호스트 PIE는 페이지 단위로만 옮겨짐
+        if (slide != 0 and ptr_size == 4 or slide % 4096 != 0) and not self.warned:
+            print(f"warning: binlog_anchor 0x{anchor:x} does not match the ELF, decoding may be wrong",
+                  file=sys.stderr)
+            self.warned = True
+
+        lines = []
+        if dropped > self.dropped:
+            lines.append(f"<{dropped - self.dropped} log(s) dropped, ring full>")
+        self.dropped = dropped
+
+        pos = 8 + ptr_size
+        while pos + 4 + ptr_size + 4 <= len(frame):
+            header, = struct.unpack_from("<I", frame, pos)
+            size = header & 0xFFFF
+            if size < 4 + ptr_size + 4 or pos + size > len(frame):
+                lines.append("<corrupt record>")
+                break
+            fmt_addr = int.from_bytes(frame[pos + 4:pos + 4 + ptr_size], "little")
+            ts_us, = struct.unpack_from("<I", frame, pos + 4 + ptr_size)
+            data = frame[pos + 8 + ptr_size:pos + size]
+            pos += size
+
+            fmt = self.elf.string(fmt_addr - slide)
+            if fmt is None:
+                text = f"<unknown format 0x{fmt_addr:x}> {data.hex()}"
+            else:
+                text, missing = format_record(fmt, data, ptr_size, self.elf, slide)
+                text = text.rstrip("\r\n")
+                if missing or header >> 24 & FLAG_TRUNCATED:
+                    text += " [truncated]"
+            lines.append(f"[{ts_us:10d}] {text}" if self.timestamps else text)
+        return lines
+
+    def line(self, text):
+        """콘솔 한 줄 (BINLOG: 줄은 복원, 나머지는 그대로)"""
+        index = text.find(LINE_PREFIX)
+        if index < 0:
+            return [text.rstrip("\r\n")]
+        try:
+            frame = base64.b64decode(text[index + len(LINE_PREFIX):].strip(), validate=True)
+            return ([text[:index]] if text[:index].strip() else []) + self.frame(frame)
+        except ValueError as err:
+            return [f"<binlog decode error: {err}> {text.rstrip()}"]
+
+
+def decode_stream(decoder, lines):
+    for text in lines:
+        for out in decoder.line(text):
+            print(out, flush=True)
+
+
+def listen(decoder, host, port, topic):
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        sys.exit("listen requires paho-mqtt (pip install paho-mqtt)")
+
+    def on_message(_client, _userdata, message):
+        try:
+            for out in decoder.frame(message.payload):
+                print(out, flush=True)
+        except ValueError as err:
+            print(message.topic, "decode error:", err, file=sys.stderr)
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(host, port)
+    client.subscribe(topic)
+    client.loop_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p_decode = sub.add_parser("decode")
+    p_decode.add_argument("elf")
+    p_decode.add_argument("file", nargs="?", default="-")
+    p_decode.add_argument("--port", help="시리얼 포트 (pyserial 필요)")
+    p_decode.add_argument("--baud", type=int, default=115200)
+    p_listen = sub.add_parser("listen")
+    p_listen.add_argument("elf")
+    p_listen.add_argument("--host", default="127.0.0.1")
+    p_listen.add_argument("--port", type=int, default=1883)
+    p_listen.add_argument("--topic", default="esp32/log")
+    for p in (p_decode, p_listen):
+        p.add_argument("--timestamps", action="store_true", help="레코드의 µs 시각(esp_timer 하위 32비트) 표시")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    if elf.anchor is None:
+        print("warning: binlog_anchor symbol not found in the ELF (stripped?)", file=sys.stderr)
+    decoder = Decoder(elf, args.timestamps)
+
+    if args.command == "listen":
+        listen(decoder, args.host, args.port, args.topic)
+    elif args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("--port requires pyserial (pip install pyserial)")
+        with serial.Serial(args.port, args.baud) as port:
+            decode_stream(decoder, (raw.decode("utf-8", "replace") for raw in port))
+    elif args.file == "-":
+        decode_stream(decoder, sys.stdin)
+    else:
+        with open(args.file, encoding="utf-8", errors="replace") as f:
+            decode_stream(decoder, f)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""수신 쪽(Jetson 등) 지연 / 손실 모니터
+
+디바이스의 시계 차이 측정 ping({"ping":{"id","t1"}}, esp32/response)에 PONG 명령으로 응답하고,
+6축 메시지의 샘플 번호(seq)와 µs 캡처 시각(ts_us / base_us)으로 디바이스별 손실, 순서 바뀜, 중복과
+캡처 → 수신 지연(디바이스가 보고한 시계 차이로 보정)을 주기적으로 출력합니다.
+
+사용법 (paho-mqtt 필요):
+  python3 latency_monitor.py --host 127.0.0.1 --interval 10
+
+시계 차이 (디바이스 latency_trace.h와 같은 방식, t2 / t3는 이 프로그램의 time.time_ns() µs)
+  offset = ((t2 - t1) + (t3 - t4)) / 2,  수신 쪽 시각 = 디바이스 시각 + offset
+디바이스는 pong을 받을 때마다 {"sync":{"offset_us","rtt_us"}}를 발행하고 그 값을 지연 보정에 씁니다.
+"""
+
+import argparse
+import json
+import os
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from telemetry_codec import decode_payload  # noqa: E402
+
+SEQ_MOD = 2**32
+
+
+def now_us():
+    return time.time_ns() // 1000
+
+
+def percentile(sorted_values, percent):
+    if not sorted_values:
+        return None
+    index = min(len(sorted_values) - 1, max(0, -(-len(sorted_values) * percent // 100) - 1))
+    return sorted_values[index]
+
+
+class DeviceTracker:
+    """디바이스 하나의 샘플 번호 / 지연 집계 (출력할 때마다 초기화, 기대 번호는 유지)"""
+
+    def __init__(self):
+        self.expected = None    # 다음에 올 샘플 번호
+        self.reset()
+
+    def reset(self):
+        self.received = 0
+        self.lost = 0
+        self.reordered = 0
+        self.duplicates = 0
+        self.latencies = []
+
+    def add(self, seq, t_us, recv_us, offset_us):
+        self.received += 1
+        if offset_us is not None:
+            self.latencies.append(recv_us - (t_us + offset_us))
+        if self.expected is None:
+            self.expected = (seq + 1) % SEQ_MOD
+            return
+
+        gap = (seq - self.expected) % SEQ_MOD
+        if gap == 0:
+            self.expected = (seq + 1) % SEQ_MOD
+        elif gap < SEQ_MOD // 2:
+            # 번호를 건너뜀: 일단 손실로 세고, 나중에 오면(재전송 등) 순서 바뀜으로 정정
+            self.lost += gap
+            self.expected = (seq + 1) % SEQ_MOD
+        else:
+            # 이미 지난 번호: 손실로 셌던 샘플이 늦게 도착 (또는 중복)
+            if self.lost > 0:
+                self.lost -= 1
+                self.reordered += 1
+            else:
+                self.duplicates += 1
+
+    def summary(self):
+        values = sorted(self.latencies)
+        result = {"received": self.received, "lost": self.lost, "reordered": self.reordered,
+                  "duplicates": self.duplicates}
+        if values:
+            result["latency_us"] = {"p50": percentile(values, 50), "p90": percentile(values, 90),
+                                    "p99": percentile(values, 99), "max": values[-1]}
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--data-topic", default="esp32/sensor/data/#")
+    parser.add_argument("--command-topic", default="esp32/command")
+    parser.add_argument("--response-topic", default="esp32/response")
+    parser.add_argument("--interval", type=float, default=10.0, help="통계 출력 주기 (초)")
+    args = parser.parse_args()
+
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        sys.exit("latency_monitor requires paho-mqtt (pip install paho-mqtt)")
+
+    data_prefix = args.data_topic.rstrip("#").rstrip("/")
+    trackers = {}
+    sync = {"offset_us": None, "rtt_us": None}
+
+    def on_message(client, _userdata, message):
+        recv_us = now_us()
+        if message.topic == args.response_topic:
+            try:
+                msg = json.loads(message.payload)
+            except ValueError:
+                return
+            if "ping" in msg:
+                ping = msg["ping"]
+                t3 = now_us()
+                client.publish(args.command_topic, "PONG:%d:%d:%d:%d" % (ping["id"], ping["t1"], recv_us, t3))
+            elif "sync" in msg:
+                sync.update(msg["sync"])
+            return
+
+        suffix = message.topic[len(data_prefix):].lstrip("/")
+        device_id = int(suffix) if suffix.isdigit() else 0
+        try:
+            decoded = decode_payload(message.payload, device_id)
+        except (ValueError, KeyError) as err:
+            print(message.topic, "decode error:", err, file=sys.stderr)
+            return
+        tracker = trackers.setdefault(device_id, DeviceTracker())
+        for sample in decoded.get("samples", []):
+            tracker.add(sample["seq"], sample["t_us"], recv_us, sync["offset_us"])
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(args.host, args.port)
+    client.subscribe(args.data_topic, qos=1)
+    client.subscribe(args.response_topic, qos=0)
+    client.loop_start()
+
+    try:
+        while True:
+            time.sleep(args.interval)
+            report = {"sync": dict(sync), "devices": {}}
+            for device_id, tracker in sorted(trackers.items()):
+                report["devices"][device_id] = tracker.summary()
+                tracker.reset()
+            print(json.dumps(report), flush=True)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        client.loop_stop()
+
+
+if __name__ == "__main__":
+    main()
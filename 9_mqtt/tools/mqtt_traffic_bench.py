@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""MQTT 발행 정책별 트래픽 측정 (패킷 수 / 메시지당 바이트)
+
+펌웨어의 6축 발행과 같은 토픽 / 데이터 / QoS / 토픽 별칭 / 메시지 만료 정책으로 같은 시간 동안 발행하고,
+클라이언트와 브로커 사이의 TCP 중계에서 실제로 오간 MQTT 제어 패킷과 바이트를 셉니다.
+
+  before: MQTT 3.1.1, QoS 1, 매번 전체 토픽 (QoS / 별칭 정책 이전 펌웨어)
+  qos1:   MQTT 5, QoS 1, 전체 토픽 + 만료 (QOS:TELEMETRY:1)
+  after:  MQTT 5, QoS 0, 첫 메시지만 전체 토픽 + 별칭, 이후 별칭만 + 만료 (기본 설정)
+
+사용법 (paho-mqtt 필요):
+  python3 mqtt_traffic_bench.py --broker 127.0.0.1:1883 --rate 100 --seconds 10
+  python3 mqtt_traffic_bench.py --rate 100 --seconds 10        # 브로커가 없으면 내장 수신 전용 브로커
+
+내장 브로커는 CONNECT / PUBLISH / PINGREQ / SUBSCRIBE에 응답하고(Topic Alias Maximum 10) 메시지를 버립니다.
+별칭만 온 메시지가 등록된 별칭인지 확인하므로 별칭 정책 검증에도 쓸 수 있습니다.
+"""
+
+import argparse
+import asyncio
+import os
+import socket
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from telemetry_codec import encode  # noqa: E402
+
+TOPIC = "esp32/sensor/data"     # config.h MQTT_TOPIC_SENSOR_DATA
+EXPIRY_S = 10                   # config.h MQTT_EXPIRY_TELEMETRY_S
+TOPIC_ALIAS_MAX = 10            # mosquitto 기본 max_topic_alias
+
+PUBLISH, PUBACK = 3, 4
+
+PROFILES = {
+    "before": {"v5": False, "qos": 1, "alias": False},
+    "qos1": {"v5": True, "qos": 1, "alias": False},
+    "after": {"v5": True, "qos": 0, "alias": True},
+}
+
+
+def _read_varint(buf, pos):
+    """MQTT 가변 길이 정수 → (값, 다음 위치), 아직 다 오지 않았으면 None"""
+    value = shift = 0
+    while pos < len(buf):
+        byte = buf[pos]
+        value |= (byte & 0x7F) << shift
+        pos += 1
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+    return None
+
+
+def _split_packets(buf):
+    """바이트 스트림 → (완성된 패킷 목록, 남은 바이트)"""
+    packets = []
+    pos = 0
+    while pos < len(buf):
+        length = _read_varint(buf, pos + 1)
+        if length is None or length[1] + length[0] > len(buf):
+            break
+        end = length[1] + length[0]
+        packets.append(bytes(buf[pos:end]))
+        pos = end
+    return packets, buf[pos:]
+
+
+class PacketCounter:
+    """한 방향의 MQTT 제어 패킷 종류별 개수 / 바이트 (고정 헤더 포함)"""
+
+    def __init__(self):
+        self.pending = b""
+        self.packets = {}
+        self.bytes = {}
+
+    def feed(self, data):
+        packets, self.pending = _split_packets(self.pending + data)
+        for packet in packets:
+            kind = packet[0] >> 4
+            self.packets[kind] = self.packets.get(kind, 0) + 1
+            self.bytes[kind] = self.bytes.get(kind, 0) + len(packet)
+
+
+# ---------------------------------------------------------------- 내장 수신 전용 브로커
+
+async def _sink_session(reader, writer, stats):
+    pending = b""
+    v5 = False
+    aliases = set()
+    while True:
+        data = await reader.read(65536)
+        if not data:
+            break
+        packets, pending = _split_packets(pending + data)
+        for packet in packets:
+            kind, flags = packet[0] >> 4, packet[0] & 0x0F
+            body = packet[_read_varint(packet, 1)[1]:]
+            if kind == 1:       # CONNECT: 프로토콜 이름(2 + 4) 뒤 버전
+                v5 = body[6] == 5
+                writer.write(bytes([0x20, 6, 0, 0, 3, 0x22]) + struct.pack(">H", TOPIC_ALIAS_MAX) if v5
+                             else bytes([0x20, 2, 0, 0]))
+            elif kind == 3:     # PUBLISH
+                topic_len, = struct.unpack_from(">H", body)
+                pos = 2 + topic_len
+                qos = (flags >> 1) & 0x03
+                packet_id = body[pos:pos + 2]
+                pos += 2 if qos else 0
+                if v5:
+                    props_len, pos = _read_varint(body, pos)
+                    alias = _find_topic_alias(body[pos:pos + props_len])
+                    if alias is not None:
+                        if topic_len:
+                            aliases.add(alias)
+                        elif alias not in aliases:
+                            stats["alias_errors"] += 1
+                if qos:
+                    writer.write(bytes([0x40, 2]) + packet_id)
+            elif kind == 8:     # SUBSCRIBE: 모두 QoS 0으로 승인
+                writer.write(bytes([0x90, 3 + v5]) + body[:2] + (b"\x00" if v5 else b"") + b"\x00")
+            elif kind == 12:    # PINGREQ
+                writer.write(bytes([0xD0, 0]))
+            elif kind == 14:    # DISCONNECT
+                writer.close()
+                return
+        await writer.drain()
+    writer.close()
+
+
+def _find_topic_alias(props):
+    """PUBLISH 속성에서 Topic Alias(0x23) 찾기"""
+    pos = 0
+    sizes = {0x01: 1, 0x02: 4, 0x23: 2}
+    while pos < len(props):
+        prop = props[pos]
+        pos += 1
+        if prop == 0x23:
+            return struct.unpack_from(">H", props, pos)[0]
+        if prop not in sizes:
+            return None     # 이 측정에서 쓰지 않는 속성
+        pos += sizes[prop]
+    return None
+
+
+def _start_sink(stats):
+    """내장 브로커를 별도 스레드에서 시작하고 포트 반환"""
+    loop = asyncio.new_event_loop()
+    ready = threading.Event()
+    port = []
+
+    async def serve():
+        server = await asyncio.start_server(lambda r, w: _sink_session(r, w, stats), "127.0.0.1", 0)
+        port.append(server.sockets[0].getsockname()[1])
+        ready.set()
+        await server.serve_forever()
+
+    threading.Thread(target=lambda: loop.run_until_complete(serve()), daemon=True).start()
+    ready.wait()
+    return port[0]
+
+
+# ---------------------------------------------------------------- 측정용 TCP 중계
+
+def _pipe(src, dst, counter):
+    while True:
+        try:
+            data = src.recv(65536)
+        except OSError:
+            data = b""
+        if not data:
+            try:
+                dst.shutdown(socket.SHUT_WR)
+            except OSError:
+                pass
+            return
+        counter.feed(data)
+        dst.sendall(data)
+
+
+def _start_relay(broker_host, broker_port, up, down):
+    """클라이언트 한 개를 브로커로 중계하면서 양방향 패킷을 세는 중계 포트 반환"""
+    listener = socket.socket()
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(1)
+
+    def accept():
+        client, _ = listener.accept()
+        upstream = socket.create_connection((broker_host, broker_port))
+        for sock in (client, upstream):
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        threading.Thread(target=_pipe, args=(upstream, client, down), daemon=True).start()
+        _pipe(client, upstream, up)
+        listener.close()
+
+    threading.Thread(target=accept, daemon=True).start()
+    return listener.getsockname()[1]
+
+
+# ---------------------------------------------------------------- 발행
+
+def _payload(kind, seq):
+    """펌웨어가 샘플 하나에 발행하는 데이터 (JSON 또는 바이너리)"""
+    ts_us = 12345678901 + seq * 10000
+    if kind == "binary":
+        return encode(0, ts_us, [(0, 0.012, -0.437, 0.981, 12.34, -3.21, 0.56, 27.41)], first_seq=seq)
+    return ('{"sensor":"MPU6050","accel":{"x":0.012,"y":-0.437,"z":0.981},"gyro":{"x":12.34,"y":-3.21,"z":0.56},'
+            '"temp":27.41,"seq":%d,"ts_us":%d,"timestamp":%d}' % (seq, ts_us, ts_us // 1000000)).encode()
+
+
+def run_profile(name, profile, broker, args):
+    import paho.mqtt.client as mqtt
+    from paho.mqtt.packettypes import PacketTypes
+    from paho.mqtt.properties import Properties
+
+    up, down = PacketCounter(), PacketCounter()
+    relay_port = _start_relay(broker[0], broker[1], up, down)
+
+    client = mqtt.Client(mqtt.CallbackAPIVersion.VERSION2, client_id="traffic_bench_" + name,
+                         protocol=mqtt.MQTTv5 if profile["v5"] else mqtt.MQTTv311)
+    client.max_inflight_messages_set(65535)
+    client.connect("127.0.0.1", relay_port)
+    client.loop_start()
+    while not client.is_connected():
+        time.sleep(0.01)
+
+    count = int(args.rate * args.seconds)
+    start = time.monotonic()
+    info = None
+    for seq in range(count):
+        delay = start + seq / args.rate - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        topic = TOPIC
+        properties = None
+        if profile["v5"]:
+            properties = Properties(PacketTypes.PUBLISH)
+            properties.MessageExpiryInterval = EXPIRY_S
+            if profile["alias"]:
+                properties.TopicAlias = 1
+                topic = TOPIC if seq == 0 else ""   # 연결의 첫 메시지만 전체 토픽
+        info = client.publish(topic, _payload(args.payload, seq), qos=profile["qos"], properties=properties)
+    if info is not None:
+        info.wait_for_publish(10)
+    elapsed = time.monotonic() - start
+    time.sleep(0.2)     # 마지막 PUBACK 중계
+    client.disconnect()
+    client.loop_stop()
+
+    publishes = up.packets.get(PUBLISH, 0)
+    pubacks = down.packets.get(PUBACK, 0)
+    return {
+        "profile": name,
+        "messages": publishes,
+        "msgs_per_s": publishes / elapsed,
+        "packets_per_s": (publishes + pubacks) / elapsed,
+        "publish_bytes": up.bytes.get(PUBLISH, 0) / max(publishes, 1),
+        "puback_bytes": down.bytes.get(PUBACK, 0) / max(publishes, 1),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--broker", help="host:port (없으면 내장 수신 전용 브로커)")
+    parser.add_argument("--rate", type=float, default=100.0, help="초당 메시지 수")
+    parser.add_argument("--seconds", type=float, default=10.0)
+    parser.add_argument("--payload", choices=["json", "binary"], default="json")
+    parser.add_argument("--profiles", default="before,qos1,after")
+    args = parser.parse_args()
+
+    try:
+        import paho.mqtt.client  # noqa: F401
+    except ImportError:
+        sys.exit("mqtt_traffic_bench requires paho-mqtt (pip install paho-mqtt)")
+
+    sink_stats = {"alias_errors": 0}
+    if args.broker:
+        host, _, port = args.broker.rpartition(":")
+        broker = (host, int(port))
+    else:
+        broker = ("127.0.0.1", _start_sink(sink_stats))
+
+    payload_len = len(_payload(args.payload, 0))
+    print("broker %s, %s payload %d B, %.0f msg/s for %.0f s" % (
+        args.broker or "built-in sink", args.payload, payload_len, args.rate, args.seconds))
+    print("%-8s %9s %8s %10s %14s %13s %12s" % ("profile", "messages", "msg/s", "packets/s", "PUBLISH B/msg",
+                                                "PUBACK B/msg", "MQTT B/msg"))
+    for name in args.profiles.split(","):
+        r = run_profile(name, PROFILES[name], broker, args)
+        print("%-8s %9d %8.1f %10.1f %14.1f %13.1f %12.1f" % (
+            r["profile"], r["messages"], r["msgs_per_s"], r["packets_per_s"], r["publish_bytes"],
+            r["puback_bytes"], r["publish_bytes"] + r["puback_bytes"]))
+    if not args.broker and sink_stats["alias_errors"]:
+        sys.exit("%d alias-only messages used an unknown alias" % sink_stats["alias_errors"])
+
+
+if __name__ == "__main__":
+    main()
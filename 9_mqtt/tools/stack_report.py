@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""태스크별 최대 스택 사용량 정적 분석
+
+GCC의 -fstack-usage -fcallgraph-info=su 출력(.ci)을 읽어 태스크 진입 함수부터 호출 그래프를 따라가며
+가장 깊은 경로의 스택 합계를 계산합니다. config.h의 *_TASK_STACK_SIZE를 정할 때 esp32/metrics의
+stack_free(실행 중 최소 여유)와 함께 사용합니다.
+
+- 프레임 크기는 컴파일러가 계산한 값(static / dynamic,bounded)을 그대로 더합니다.
+- 소스가 없는 함수(newlib, ESP-IDF)는 LIBRARY_ESTIMATES(없으면 --extern-default) 값을 더합니다.
+  printf 계열이 가장 크므로 로그 / snprintf가 있는 경로는 이 추정값에 크게 좌우됩니다.
+- 함수 포인터 호출(명령 처리 함수, 응답 콜백)은 --indirect 정규식에 맞는 함수 중 가장 깊은 것으로 봅니다.
+- 재귀가 있으면 그 경로는 "recursive"로 표시하고 한 번만 더합니다.
+
+사용법:
+  # ESP-IDF 빌드 (Xtensa 프레임 크기)
+  idf.py -DCMAKE_C_FLAGS="-fstack-usage -fcallgraph-info=su" build
+  python3 tools/stack_report.py build/esp-idf/main
+  # 툴체인이 없으면 호스트 gcc로 main/*.c만 컴파일 (x86-64 프레임 + Xtensa 창 레지스터 저장 영역 근사)
+  gcc -c -O2 -fstack-usage -fcallgraph-info=su -Imain -I<ESP-IDF 헤더> main/*.c
+  python3 tools/stack_report.py . --frame-overhead 32 --path
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# 소스 없는 함수의 스택 추정값 (바이트, Xtensa, ESP-IDF v5 기준 보수적으로)
+# printf 계열은 newlib vfprintf(부동소수점 포함) 프레임 + 변환 버퍼
+LIBRARY_ESTIMATES = {
+    "snprintf": 1152,
+    "vsnprintf": 1152,
+    "printf": 1152,
+    "vprintf": 1152,
+    "fprintf": 1152,
+    "sscanf": 1152,
+    "*__isoc99_sscanf": 1152,    # 호스트 glibc 이름
+    "esp_log_write": 1280,       # esp_log_writev + vprintf (BINLOG_ENABLE이면 --extern으로 낮추고 --edge로 훅 연결)
+    "esp_mqtt_client_enqueue": 640,
+    "esp_mqtt_client_publish": 640,
+    "i2c_master_transmit_receive": 512,
+    "i2c_master_transmit": 512,
+    "i2c_master_receive": 512,
+    "xQueueSend": 256,
+    "xQueueReceive": 256,
+    "xQueueGenericSend": 256,
+    "xQueueGenericSendFromISR": 256,
+    "xTaskNotifyWait": 256,
+    "vTaskDelay": 256,
+    "vTaskDelayUntil": 256,
+    "xSemaphoreTake": 256,
+    "xSemaphoreGive": 256,
+    "ulTaskNotifyTake": 256,
+    "esp_timer_get_time": 64,
+    "esp_cpu_get_cycle_count": 0,
+    "xTaskGetTickCount": 64,
+    "portENTER_CRITICAL": 64,
+    "portEXIT_CRITICAL": 64,
+    "sinf": 128,
+    "cosf": 128,
+    "sincosf": 128,
+    "asinf": 128,
+    "atan2f": 128,
+    "fopen": 768,                # SPIFFS VFS
+    "fread": 768,
+    "fwrite": 768,
+    "fclose": 768,
+    "remove": 768,
+    "opendir": 768,
+    "readdir": 768,
+}
+
+# 기본 태스크 (이름 = 진입 함수)
+DEFAULT_TASKS = {
+    "sensor_task": "sensor_task.c:sensor_task",
+    "sensor_pub": "sensor_task.c:sensor_publish_task",
+    "command_task": "command_handler.c:command_task",
+    "binlog_task": "binlog.c:binlog_task",
+    "mqtt_task(handler)": "mqtt_handler.c:mqtt_event_handler",
+}
+DEFAULT_INDIRECT = r"(_cmd_|^mqtt_publish_response$)"
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+BYTES_RE = re.compile(r"\\n(\d+) bytes \(([^)]+)\)")
+
+
+def load_graph(paths):
+    """.ci 파일(또는 디렉터리)을 읽어 {함수: 프레임 바이트}, {함수: set(호출 대상)} 반환"""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for base, _, names in os.walk(path):
+                files.extend(os.path.join(base, n) for n in names if n.endswith(".ci"))
+        else:
+            files.append(path)
+    if not files:
+        raise SystemExit("no .ci files (build with -fstack-usage -fcallgraph-info=su)")
+
+    def title(name):
+        # 정적 함수는 "경로/파일.c:함수" -> "파일.c:함수" (빌드 디렉터리에 관계없이 같은 이름)
+        path, sep, func = name.rpartition(":")
+        return os.path.basename(path) + sep + func
+
+    frames = {}
+    calls = {}
+    for name in files:
+        with open(name, encoding="utf-8", errors="replace") as f:
+            for line in f:
+                m = NODE_RE.search(line)
+                if m:
+                    size = BYTES_RE.search(m.group(2))
+                    if size:
+                        frames[title(m.group(1))] = int(size.group(1))
+                    continue
+                m = EDGE_RE.search(line)
+                if m:
+                    calls.setdefault(title(m.group(1)), set()).add(title(m.group(2)))
+    return frames, calls
+
+
+class Analyzer:
+    def __init__(self, frames, calls, indirect, externs, extern_default, frame_overhead=0):
+        self.frames = {name: size + frame_overhead for name, size in frames.items()}
+        self.calls = calls
+        self.indirect = sorted(f for f in frames if indirect and re.search(indirect, f.split(":")[-1]))
+        self.externs = externs
+        self.extern_default = extern_default
+        self.memo = {}
+        self.recursive = set()
+
+    def cost(self, func, stack=()):
+        """func부터 가장 깊은 경로의 (바이트, 경로) 반환"""
+        if func in self.memo:
+            return self.memo[func]
+        if func in stack:
+            self.recursive.add(func)
+            return 0, [func + " (recursive)"]
+        if func not in self.frames:
+            if func == "__indirect_call":
+                best = (0, ["<indirect: none>"])
+                for target in self.indirect:
+                    best = max(best, self.cost(target, stack), key=lambda c: c[0])
+                return best
+            if func.startswith(("__builtin", "mem", "str")) or func in ("abs", "fabsf", "sqrtf"):
+                return 0, []
+            size = self.externs.get(func, self.extern_default)
+            best = (0, [])
+            for callee in self.calls.get(func, ()):     # --edge로 추가한 콜백
+                best = max(best, self.cost(callee, stack + (func,)), key=lambda c: c[0])
+            return size + best[0], ["%s (~%d, estimate)" % (func, size)] + best[1]
+
+        best = (0, [])
+        for callee in self.calls.get(func, ()):
+            best = max(best, self.cost(callee, stack + (func,)), key=lambda c: c[0])
+        result = (self.frames[func] + best[0], ["%s (%d)" % (func, self.frames[func])] + best[1])
+        if not stack or func not in self.recursive:
+            self.memo[func] = result
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Per-task worst-case stack depth from GCC call graph info")
+    parser.add_argument("paths", nargs="+", help=".ci files or directories")
+    parser.add_argument("--task", action="append", default=[], metavar="NAME=FUNC",
+                        help="task entry (FUNC is the .ci title, static functions are file.c:name)")
+    parser.add_argument("--indirect", default=DEFAULT_INDIRECT,
+                        help="regex of functions an indirect call may reach (default: %(default)s)")
+    parser.add_argument("--extern", action="append", default=[], metavar="NAME=BYTES",
+                        help="stack estimate for a function without source")
+    parser.add_argument("--extern-default", type=int, default=384,
+                        help="estimate for other functions without source (default: %(default)s)")
+    parser.add_argument("--edge", action="append", default=[], metavar="CALLER=CALLEE",
+                        help="extra call edge (callbacks registered at run time)")
+    parser.add_argument("--frame-overhead", type=int, default=0,
+                        help="bytes added to every frame, e.g. 32 to approximate Xtensa window spill "
+                             "when the .ci files come from a host build (default: %(default)s)")
+    parser.add_argument("--path", action="store_true", help="print the deepest call path")
+    args = parser.parse_args()
+
+    frames, calls = load_graph(args.paths)
+    for edge in args.edge:
+        caller, callee = edge.split("=", 1)
+        calls.setdefault(caller, set()).add(callee)
+    externs = dict(LIBRARY_ESTIMATES)
+    for item in args.extern:
+        name, size = item.split("=", 1)
+        externs[name] = int(size)
+
+    tasks = dict(item.split("=", 1) for item in args.task) if args.task else DEFAULT_TASKS
+    analyzer = Analyzer(frames, calls, args.indirect, externs, args.extern_default, args.frame_overhead)
+    print("%-20s %8s %8s  %s" % ("task", "peak", "own", "deepest leaf"))
+    for name, func in tasks.items():
+        if func not in frames:
+            print("%-20s %8s  (%s not found)" % (name, "-", func))
+            continue
+        total, path = analyzer.cost(func)
+        own = sum(int(re.search(r"\((\d+)\)$", p).group(1)) for p in path if re.search(r"\((\d+)\)$", p))
+        print("%-20s %8d %8d  %s" % (name, total, own, path[-1] if path else "-"))
+        if args.path:
+            for step in path:
+                print("    " + step)
+    if analyzer.recursive:
+        print("recursive:", ", ".join(sorted(analyzer.recursive)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
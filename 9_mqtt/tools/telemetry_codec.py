@@ -0,0 +1,325 @@
+#!/usr/bin/env python3
+"""MPU6050 바이너리 텔레메트리 참조 인코더/디코더 (main/telemetry.h 형식)
+
+사용법:
+  python3 telemetry_codec.py selftest                  # 인코딩 → 디코딩 왕복 검사
+  python3 telemetry_codec.py decode payload.bin        # 파일 하나 디코딩 (JSON도 가능)
+  python3 telemetry_codec.py listen --host 127.0.0.1   # 브로커 구독 후 디코딩 출력 (paho-mqtt 필요)
+  python3 telemetry_codec.py bench ../host_sim/motion/pitch_step.csv --batch 50
+                                                       # 녹화된 모션으로 형식별 크기 / 인코딩 시간 비교
+
+수집 쪽에서는 decode_payload()를 가져다 쓰면 JSON / 바이너리를 구분해서 같은 형태로 돌려줍니다.
+"""
+
+import argparse
+import json
+import random
+import struct
+import sys
+import time
+
+MAGIC = 0xA6
+VERSION = 2
+HEADER = struct.Struct("<BBBBHHHqI")  # magic, version, device_id, flags, count, accel_lsb, gyro_lsb_x10, base_us, first_seq
+SAMPLE = struct.Struct("<I7h")        # offset_us, ax, ay, az, temp, gx, gy, gz
+FLAG_DELTA = 0x01                     # 축별 델타 + zigzag + varint 압축
+DELTA_SAMPLE_MAX_SIZE = 26            # 시각 5바이트 + 축 7 x 3바이트
+
+ACCEL_LSB_PER_G = {2: 16384, 4: 8192, 8: 4096, 16: 2048}
+GYRO_LSB_PER_DPS_X10 = {250: 1310, 500: 655, 1000: 328, 2000: 164}
+
+
+def _quantize(value, scale):
+    return max(-32768, min(32767, round(value * scale)))
+
+
+def _zigzag(value):
+    return (value << 1) ^ (value >> 63)
+
+
+def _unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def _put_varint(out, value):
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+def _get_varint(payload, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(payload) or shift > 63:
+            raise ValueError("truncated varint at byte %d" % pos)
+        byte = payload[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            return value, pos
+        shift += 7
+
+
+def encode(device_id, base_us, samples, accel_range_g=2, gyro_range_dps=250, delta=False, first_seq=0):
+    """samples: [(offset_us, ax, ay, az, gx, gy, gz, temp_c), ...] (펌웨어와 같은 방식으로 양자화)"""
+    accel_lsb = ACCEL_LSB_PER_G[accel_range_g]
+    gyro_lsb_x10 = GYRO_LSB_PER_DPS_X10[gyro_range_dps]
+    gyro_scale = gyro_lsb_x10 / 10.0
+    out = bytearray(HEADER.pack(MAGIC, VERSION, device_id, FLAG_DELTA if delta else 0, len(samples),
+                                accel_lsb, gyro_lsb_x10, base_us, first_seq))
+    prev_raw = [0] * 7
+    prev_offset = prev_step = 0
+    for offset_us, ax, ay, az, gx, gy, gz, temp in samples:
+        raw = [_quantize(ax, accel_lsb), _quantize(ay, accel_lsb), _quantize(az, accel_lsb),
+               _quantize(temp - 36.53, 340.0),
+               _quantize(gx, gyro_scale), _quantize(gy, gyro_scale), _quantize(gz, gyro_scale)]
+        if not delta:
+            out += SAMPLE.pack(offset_us, *raw)
+            continue
+        step = offset_us - prev_offset
+        _put_varint(out, _zigzag(step - prev_step))
+        prev_offset, prev_step = offset_us, step
+        for axis in range(7):
+            _put_varint(out, _zigzag(raw[axis] - prev_raw[axis]))
+        prev_raw = raw
+    return bytes(out)
+
+
+def _decode_delta(payload, pos, count):
+    """델타 압축 본문 (pos부터) → [(offset_us, ax, ay, az, temp, gx, gy, gz), ...] (LSB)"""
+    rows = []
+    offset = step = 0
+    raw = [0] * 7
+    for _ in range(count):
+        value, pos = _get_varint(payload, pos)
+        step += _unzigzag(value)
+        offset += step
+        for axis in range(7):
+            value, pos = _get_varint(payload, pos)
+            raw[axis] += _unzigzag(value)
+        rows.append((offset, *raw))
+    if pos != len(payload):
+        raise ValueError("%d trailing bytes after %d samples" % (len(payload) - pos, count))
+    return rows
+
+
+def decode(payload):
+    """바이너리 메시지 → {"device", "base_us", "samples": [{"seq", "t_us", "accel", "gyro", "temp"}, ...]}"""
+    if len(payload) < HEADER.size:
+        raise ValueError("payload shorter than header")
+    magic, version, device_id, flags, count, accel_lsb, gyro_lsb_x10, base_us, first_seq = HEADER.unpack_from(payload)
+    if magic != MAGIC:
+        raise ValueError("bad magic 0x%02X" % magic)
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+    if flags & ~FLAG_DELTA:
+        raise ValueError("unknown flags 0x%02X" % flags)
+
+    if flags & FLAG_DELTA:
+        rows = _decode_delta(payload, HEADER.size, count)
+    else:
+        if len(payload) != HEADER.size + count * SAMPLE.size:
+            raise ValueError("length %d does not match %d samples" % (len(payload), count))
+        rows = [SAMPLE.unpack_from(payload, HEADER.size + i * SAMPLE.size) for i in range(count)]
+
+    gyro_scale = gyro_lsb_x10 / 10.0
+    samples = []
+    for i, (offset_us, ax, ay, az, temp, gx, gy, gz) in enumerate(rows):
+        samples.append({
+            "seq": (first_seq + i) & 0xFFFFFFFF,
+            "t_us": base_us + offset_us,
+            "accel": [ax / accel_lsb, ay / accel_lsb, az / accel_lsb],
+            "gyro": [gx / gyro_scale, gy / gyro_scale, gz / gyro_scale],
+            "temp": temp / 340.0 + 36.53,
+        })
+    return {"device": device_id, "base_us": base_us, "samples": samples}
+
+
+def decode_payload(payload, device_id=None):
+    """JSON(샘플 / 배치) 또는 바이너리 메시지를 decode()와 같은 형태로 변환"""
+    if payload[:1] != b"{":
+        return decode(payload)
+
+    msg = json.loads(payload)
+    if "samples" in msg:
+        samples = [{"seq": (msg["seq"] + i) & 0xFFFFFFFF, "t_us": msg["base_us"] + s[0],
+                    "accel": s[1:4], "gyro": s[4:7], "temp": s[7]}
+                   for i, s in enumerate(msg["samples"])]
+        return {"device": device_id, "base_us": msg["base_us"], "samples": samples}
+    if "accel" in msg:
+        a, g = msg["accel"], msg["gyro"]
+        t_us = msg["ts_us"]
+        return {"device": device_id, "base_us": t_us, "samples": [
+            {"seq": msg["seq"], "t_us": t_us, "accel": [a["x"], a["y"], a["z"]], "gyro": [g["x"], g["y"], g["z"]],
+             "temp": msg["temp"]}]}
+    return {"device": device_id, "message": msg}
+
+
+def selftest(iterations=200):
+    rng = random.Random(1)
+    for n in range(iterations):
+        accel_range = rng.choice(list(ACCEL_LSB_PER_G))
+        gyro_range = rng.choice(list(GYRO_LSB_PER_DPS_X10))
+        count = rng.randint(0, 50)
+        base_us = rng.randint(0, 2**40)
+        # int16로 표현 가능한 범위 (예: ±2000°/s 범위는 실제로 ±1998°/s)
+        accel_max = 32767 / ACCEL_LSB_PER_G[accel_range]
+        gyro_max = 32767 / (GYRO_LSB_PER_DPS_X10[gyro_range] / 10.0)
+        samples = [(i * 2000,
+                    rng.uniform(-accel_max, accel_max), rng.uniform(-accel_max, accel_max),
+                    rng.uniform(-accel_max, accel_max),
+                    rng.uniform(-gyro_max, gyro_max), rng.uniform(-gyro_max, gyro_max),
+                    rng.uniform(-gyro_max, gyro_max), rng.uniform(-20.0, 80.0))
+                   for i in range(count)]
+
+        first_seq = rng.randint(0, 2**32 - 1)
+        payload = encode(n % 4, base_us, samples, accel_range, gyro_range, first_seq=first_seq)
+        decoded = decode(payload)
+        assert len(payload) == HEADER.size + count * SAMPLE.size
+        assert decoded["device"] == n % 4 and decoded["base_us"] == base_us
+        assert [s["seq"] for s in decoded["samples"]] == [(first_seq + i) % 2**32 for i in range(count)]
+
+        # 델타 압축은 같은 값으로 복원 (무손실), 최악의 경우에도 상한 이하
+        packed = encode(n % 4, base_us, samples, accel_range, gyro_range, delta=True, first_seq=first_seq)
+        assert decode(packed) == decoded
+        assert len(packed) <= HEADER.size + count * DELTA_SAMPLE_MAX_SIZE
+
+        # 오차는 양자화 간격 이하
+        accel_step = 1.0 / ACCEL_LSB_PER_G[accel_range]
+        gyro_step = 10.0 / GYRO_LSB_PER_DPS_X10[gyro_range]
+        for src, dst in zip(samples, decoded["samples"]):
+            assert dst["t_us"] == base_us + src[0]
+            for axis in range(3):
+                assert abs(dst["accel"][axis] - src[1 + axis]) <= accel_step
+                assert abs(dst["gyro"][axis] - src[4 + axis]) <= gyro_step
+            assert abs(dst["temp"] - src[7]) <= 1.0 / 340.0
+
+        # 다시 인코딩하면 같은 바이트
+        again = [(s["t_us"] - base_us, *s["accel"], *s["gyro"], s["temp"]) for s in decoded["samples"]]
+        assert encode(n % 4, base_us, again, accel_range, gyro_range, first_seq=first_seq) == payload
+
+    json_size = len(json.dumps({"sensor": "MPU6050", "accel": {"x": 0.012, "y": -0.437, "z": 0.981},
+                                "gyro": {"x": 12.34, "y": -3.21, "z": 0.56}, "temp": 27.41,
+                                "seq": 123456, "ts_us": 12345678901, "timestamp": 12345},
+                               separators=(",", ":")))
+    # 최악의 경우: 매 샘플 부호가 뒤집히는 최대 진폭 + 불규칙한 시각
+    extreme = [(i * 2000 + (0 if i % 2 else 0xFFFFF), *([1.99 if i % 2 else -2.0] * 3),
+                *([249.0 if i % 2 else -250.0] * 3), 80.0 if i % 2 else -20.0) for i in range(50)]
+    worst = encode(0, 0, extreme, delta=True)
+    assert decode(worst) == decode(encode(0, 0, extreme))
+    assert len(worst) <= HEADER.size + 50 * DELTA_SAMPLE_MAX_SIZE
+
+    print("selftest ok: %d round trips, single sample %d B binary vs %d B JSON, worst-case delta %d B / 50 samples"
+          % (iterations, HEADER.size + SAMPLE.size, json_size, len(worst)))
+
+
+def load_motion_csv(path, rate_hz=None):
+    """host_sim 모션 CSV (time_s,ax,ay,az,gx,gy,gz[,temp]) → [(offset_us, ax, ay, az, gx, gy, gz, temp), ...]"""
+    samples = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            v = [float(x) for x in line.split(",")]
+            temp = v[7] if len(v) > 7 else 25.0
+            samples.append((round(v[0] * 1e6), *v[1:7], temp))
+    if not samples:
+        raise ValueError("no samples in %s" % path)
+    return samples
+
+
+def _json_batch(base_us, samples, first_seq=0):
+    # 펌웨어 mqtt_format_batch_json()과 같은 형식 / 자릿수
+    rows = ",".join("[%d,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f]" % s for s in samples)
+    return ('{"sensor":"MPU6050","base_us":%d,"seq":%d,"count":%d,"samples":[%s]}'
+            % (base_us, first_seq, len(samples), rows)).encode()
+
+
+def bench(path, batch, repeat):
+    """녹화된 모션을 배치로 나눠 형식별 샘플당 바이트 / 인코딩·디코딩 시간 비교"""
+    motion = load_motion_csv(path)
+    batches = []
+    for start in range(0, len(motion), batch):
+        chunk = motion[start:start + batch]
+        base = chunk[0][0]
+        batches.append((base, [(s[0] - base, *s[1:]) for s in chunk]))
+
+    formats = {
+        "json": (lambda b, s: _json_batch(b, s), lambda p: json.loads(p)),
+        "binary": (lambda b, s: encode(0, b, s), decode),
+        "delta": (lambda b, s: encode(0, b, s, delta=True), decode),
+    }
+    result = {"file": path, "samples": len(motion), "batch": batch}
+    for name, (enc, dec) in formats.items():
+        start = time.perf_counter()
+        for _ in range(repeat):
+            payloads = [enc(b, s) for b, s in batches]
+        encode_s = time.perf_counter() - start
+        start = time.perf_counter()
+        for _ in range(repeat):
+            for p in payloads:
+                dec(p)
+        decode_s = time.perf_counter() - start
+        result[name] = {
+            "bytes_per_sample": round(sum(len(p) for p in payloads) / len(motion), 2),
+            "encode_us_per_sample": round(encode_s * 1e6 / (repeat * len(motion)), 3),
+            "decode_us_per_sample": round(decode_s * 1e6 / (repeat * len(motion)), 3),
+        }
+
+    # 델타 압축은 일반 바이너리와 같은 값으로 복원되어야 함
+    result["lossless"] = all(decode(encode(0, b, s, delta=True)) == decode(encode(0, b, s)) for b, s in batches)
+    print(json.dumps(result, indent=2))
+
+
+def listen(host, port, topic):
+    try:
+        import paho.mqtt.client as mqtt
+    except ImportError:
+        sys.exit("listen requires paho-mqtt (pip install paho-mqtt)")
+
+    def on_message(_client, _userdata, message):
+        suffix = message.topic.rsplit("/", 1)[-1]
+        device_id = int(suffix) if suffix.isdigit() else 0
+        try:
+            print(message.topic, json.dumps(decode_payload(message.payload, device_id)))
+        except ValueError as err:
+            print(message.topic, "decode error:", err, file=sys.stderr)
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(host, port)
+    client.subscribe(topic)
+    client.loop_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("selftest")
+    p_decode = sub.add_parser("decode")
+    p_decode.add_argument("file")
+    p_listen = sub.add_parser("listen")
+    p_listen.add_argument("--host", default="127.0.0.1")
+    p_listen.add_argument("--port", type=int, default=1883)
+    p_listen.add_argument("--topic", default="esp32/sensor/data/#")
+    p_bench = sub.add_parser("bench")
+    p_bench.add_argument("file")
+    p_bench.add_argument("--batch", type=int, default=50)
+    p_bench.add_argument("--repeat", type=int, default=20)
+    args = parser.parse_args()
+
+    if args.command == "selftest":
+        selftest()
+    elif args.command == "bench":
+        bench(args.file, args.batch, args.repeat)
+    elif args.command == "decode":
+        with open(args.file, "rb") as f:
+            print(json.dumps(decode_payload(f.read()), indent=2))
+    else:
+        listen(args.host, args.port, args.topic)
+
+
+if __name__ == "__main__":
+    main()